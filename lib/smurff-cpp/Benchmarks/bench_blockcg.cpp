@@ -0,0 +1,89 @@
+// Block-CG solve of (F'F + reg * I) X' = B' as in MacauPrior::sample_beta_cg,
+// with the blocks of right-hand sides solved one after the other (all threads
+// per block) or in parallel (one thread per block), for a sweep over the
+// number of features, num_latent and the number of threads.
+//
+// usage: bench_blockcg [nsamples] [nnz-per-feature] [repeats]
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <SmurffCpp/SideInfo/SparseDoubleFeatSideInfo.h>
+#include <SmurffCpp/Utils/counters.h>
+#include <SmurffCpp/Utils/omp_util.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+static std::shared_ptr<ISideInfo> random_side_info(int nsamples, int nfeat, int nnz_per_feat)
+{
+   auto cfg = random_sparse_config(nsamples, nfeat, nnz_per_feat, false, 4321);
+   return std::make_shared<SparseDoubleFeatSideInfo>(cfg->getNRow(), cfg->getNCol(), cfg->getNNZ(),
+                                                     cfg->getRows().data(), cfg->getCols().data(), cfg->getValues().data());
+}
+
+// seconds per solve of K right-hand sides
+static double bench_solve(ISideInfo& side_info, int K, bool parallel_blocks, int repeats, int& iter)
+{
+   std::mt19937 gen(1234);
+   std::normal_distribution<double> dist;
+   Eigen::MatrixXd B(K, side_info.cols());
+   for (int i = 0; i < B.size(); i++) B(i) = dist(gen);
+
+   linop::BlockCGParams params;
+   params.parallel_blocks = parallel_blocks;
+
+   Eigen::MatrixXd X(K, side_info.cols());
+   double residual;
+
+   double start = tick();
+   for (int r = 0; r < repeats; r++)
+      iter = side_info.solve_blockcg(X, 10.0, B, 1e-6, 32, 8, params, residual);
+   return (tick() - start) / repeats;
+}
+
+int main(int argc, char** argv)
+{
+   int nsamples      = argc > 1 ? std::stoi(argv[1]) : 20000;
+   int nnz_per_feat  = argc > 2 ? std::stoi(argv[2]) : 50;
+   int repeats       = argc > 3 ? std::stoi(argv[3]) : 3;
+
+   const int max_threads = threads::get_max_threads();
+   std::vector<int> nthreads;
+   for (int t = 1; t < max_threads; t *= 2)
+      nthreads.push_back(t);
+   nthreads.push_back(max_threads);
+
+   std::cout << "block-CG: " << nsamples << " samples, " << nnz_per_feat << " nnz per feature" << std::endl;
+   std::cout << std::setw(8) << "nfeat" << std::setw(6) << "K" << std::setw(9) << "threads"
+             << std::setw(14) << "sequential" << std::setw(14) << "parallel" << std::setw(7) << "iter" << std::endl;
+
+   for (int nfeat : { 1000, 5000, 20000 })
+   {
+      auto side_info = random_side_info(nsamples, nfeat, nnz_per_feat);
+      for (int K : { 32, 64, 128, 256 })
+      {
+         for (int t : nthreads)
+         {
+            threads::init(0, t);
+
+            int iter;
+            double seq = bench_solve(*side_info, K, false, repeats, iter);
+            double par = bench_solve(*side_info, K, true, repeats, iter);
+
+            std::cout << std::setw(8) << nfeat << std::setw(6) << K << std::setw(9) << t
+                      << std::fixed << std::setprecision(4)
+                      << std::setw(12) << seq << " s" << std::setw(12) << par << " s"
+                      << std::setw(7) << iter << std::endl;
+         }
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,94 @@
+// TensorData (one SparseMode per mode) against CSFTensorData (one compressed
+// sparse fiber tree per mode) on random sparse tensors: bytes used by the
+// train data and time per Gibbs iteration with normal priors.
+//
+// usage: bench_csf_tensor [nnz] [num-latent] [iterations]
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/DataTensors/CSFTensorData.h>
+#include <SmurffCpp/DataTensors/TensorData.h>
+#include <SmurffCpp/Sessions/SessionFactory.h>
+#include <SmurffCpp/Utils/counters.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+static std::uint64_t tensor_data_bytes(const TensorData& data)
+{
+   std::uint64_t ret = 0;
+   for (std::uint64_t m = 0; m < data.nmode(); m++)
+   {
+      auto sview = data.Y(m);
+      ret += sview->getIndices().size() * sizeof(std::uint32_t);
+      ret += sview->getValues().size() * sizeof(double);
+      ret += (sview->getNPlanes() + 1) * sizeof(std::uint64_t);
+   }
+   return ret;
+}
+
+static double bench_session(std::shared_ptr<TensorConfig> train, int K, int iterations, bool csf)
+{
+   Config config;
+   config.setTrain(train);
+   config.setPriorTypes(std::vector<PriorTypes>(train->getNModes(), PriorTypes::normal));
+   config.setNumLatent(K);
+   config.setBurnin(iterations);
+   config.setNSamples(0);
+   config.setVerbose(0);
+   config.setRandomSeed(1234);
+   config.setCSFTensor(csf);
+
+   std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+   session->init();
+
+   double start = tick();
+   while (session->step())
+      ;
+   return (tick() - start) / iterations;
+}
+
+int main(int argc, char** argv)
+{
+   std::uint64_t nnz = argc > 1 ? std::stoull(argv[1]) : 1000000;
+   int K             = argc > 2 ? std::stoi(argv[2]) : 16;
+   int iterations    = argc > 3 ? std::stoi(argv[3]) : 5;
+
+   // short fibers, long fibers in a small mode, and four modes
+   const std::vector<std::vector<std::uint64_t> > shapes = {
+      { 5000, 5000, 5000 },
+      { 2000, 50, 1000 },
+      { 1000, 20, 20, 1000 },
+   };
+
+   std::cout << "nnz = " << nnz << ", K = " << K << std::endl;
+   std::cout << std::setw(24) << "dims" << std::setw(14) << "TensorData" << std::setw(14) << "CSF"
+             << std::setw(14) << "TensorData" << std::setw(14) << "CSF" << std::endl;
+   std::cout << std::setw(24) << "" << std::setw(14) << "MB" << std::setw(14) << "MB"
+             << std::setw(14) << "s/iter" << std::setw(14) << "s/iter" << std::endl;
+
+   for (const auto& dims : shapes)
+   {
+      auto train = random_sparse_tensor_config(dims, nnz);
+
+      std::string name;
+      for (auto d : dims)
+         name += (name.empty() ? "" : " x ") + std::to_string(d);
+
+      const double coo_mb = tensor_data_bytes(TensorData(*train)) / 1e6;
+      const double csf_mb = CSFTensorData(*train).bytes() / 1e6;
+      const double coo_time = bench_session(train, K, iterations, false);
+      const double csf_time = bench_session(train, K, iterations, true);
+
+      std::cout << std::setw(24) << name << std::fixed
+                << std::setprecision(1) << std::setw(14) << coo_mb << std::setw(14) << csf_mb
+                << std::setprecision(4) << std::setw(14) << coo_time << std::setw(14) << csf_time << std::endl;
+   }
+
+   return 0;
+}
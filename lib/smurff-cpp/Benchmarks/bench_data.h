@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <SmurffCpp/Configs/MatrixConfig.h>
+#include <SmurffCpp/Configs/TensorConfig.h>
+
+namespace smurff
+{
+   // random sparse nrows x ncols matrix with nnz_per_col distinct rows
+   // in every column and normally distributed values
+   inline std::shared_ptr<MatrixConfig> random_sparse_config(int nrows, int ncols, int nnz_per_col, bool isScarce, unsigned seed = 1234)
+   {
+      std::mt19937 gen(seed);
+      std::uniform_int_distribution<std::uint32_t> row_dist(0, nrows - 1);
+      std::normal_distribution<double> val_dist;
+
+      std::vector<std::uint32_t> rows, cols;
+      std::vector<double> vals;
+      for (int c = 0; c < ncols; c++)
+      {
+         std::set<std::uint32_t> col_rows;
+         while ((int)col_rows.size() < std::min(nnz_per_col, nrows))
+            col_rows.insert(row_dist(gen));
+
+         for (auto r : col_rows)
+         {
+            rows.push_back(r);
+            cols.push_back(c);
+            vals.push_back(val_dist(gen));
+         }
+      }
+
+      NoiseConfig ncfg(NoiseTypes::fixed);
+      return std::make_shared<MatrixConfig>(nrows, ncols, std::move(rows), std::move(cols), std::move(vals), ncfg, isScarce);
+   }
+
+   // random sparse tensor with nnz entries at uniformly distributed
+   // coordinates (duplicates possible) and normally distributed values
+   inline std::shared_ptr<TensorConfig> random_sparse_tensor_config(const std::vector<std::uint64_t>& dims, std::uint64_t nnz, unsigned seed = 1234)
+   {
+      std::mt19937 gen(seed);
+      std::normal_distribution<double> val_dist;
+
+      std::vector<std::uint32_t> columns(dims.size() * nnz);
+      for (std::size_t m = 0; m < dims.size(); m++)
+      {
+         std::uniform_int_distribution<std::uint32_t> idx_dist(0, dims[m] - 1);
+         for (std::uint64_t i = 0; i < nnz; i++)
+            columns[m * nnz + i] = idx_dist(gen);
+      }
+
+      std::vector<double> vals(nnz);
+      for (auto& v : vals)
+         v = val_dist(gen);
+
+      NoiseConfig ncfg(NoiseTypes::fixed);
+      return std::make_shared<TensorConfig>(std::vector<std::uint64_t>(dims), std::move(columns), std::move(vals), ncfg, true);
+   }
+}
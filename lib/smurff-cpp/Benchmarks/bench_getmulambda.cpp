@@ -0,0 +1,139 @@
+// ScarceMatrixData::getMuLambda with the panel kernel (one rank-b update of MM
+// per panel of gathered columns of V) against the one-item-at-a-time rank-1
+// update it replaced, for all columns of each mode, with Gaussian and probit
+// noise and a sweep over num_latent.
+//
+// usage: bench_getmulambda [train.mm] [repeats]
+//
+// without a file a random matrix of the size of the ChEMBL example
+// (15073 x 346, 59280 nnz) is used.
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <Eigen/Dense>
+
+#include <SmurffCpp/ConstVMatrixExprIterator.hpp>
+#include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/Configs/NoiseConfig.h>
+#include <SmurffCpp/DataMatrices/ScarceMatrixData.h>
+#include <SmurffCpp/IO/MatrixIO.h>
+#include <SmurffCpp/Model.h>
+#include <SmurffCpp/Noises/NoiseFactory.h>
+#include <SmurffCpp/Utils/Distribution.h>
+#include <SmurffCpp/Utils/MatrixUtils.h>
+#include <SmurffCpp/Utils/NumLatent.hpp>
+#include <SmurffCpp/Utils/Panel.hpp>
+#include <SmurffCpp/Utils/counters.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+// rr and MM of column n of mode, one item at a time
+template<int K>
+struct ReferenceKernel
+{
+   typedef Eigen::Matrix<double, K, 1> Vector;
+   typedef Eigen::Matrix<double, K, K> Matrix;
+
+   static void run(const ScarceMatrixData& data, const SubModel& model, int mode, int n, Eigen::VectorXd& rr, Eigen::MatrixXd& MM)
+   {
+      const int num_latent = model.nlatent();
+      auto& Y = data.Y();
+      auto Vf = *model.CVbegin(mode);
+      auto& ns = data.noise();
+
+      Vector my_rr = Vector::Zero(num_latent);
+      Matrix my_MM = Matrix::Zero(num_latent, num_latent);
+
+      for (std::uint64_t i = Y.begin(mode, n); i < Y.end(mode, n); ++i)
+      {
+         Eigen::Map<const Vector> col(Vf.col(Y.index(mode, i)).data(), num_latent);
+         double noisy_val = ns.sample(model, data.pos(mode, n, Y.index(mode, i)), Y.value(mode, i));
+         my_rr.noalias() += col * noisy_val;
+         my_MM.template triangularView<Eigen::Lower>() += ns.getAlpha() * col * col.transpose();
+      }
+      my_MM.template triangularView<Eigen::Upper>() = my_MM.transpose();
+
+      rr += my_rr;
+      MM += my_MM;
+   }
+};
+
+// seconds for all columns of mode, the sum of all MM in MMs
+static double bench_mode(const ScarceMatrixData& data, const SubModel& model, int mode, bool reference, int repeats, Eigen::MatrixXd& MMs)
+{
+   const int K = model.nlatent();
+   Eigen::VectorXd rr(K);
+   Eigen::MatrixXd MM(K, K);
+
+   double start = tick();
+   for (int r = 0; r < repeats; r++)
+   {
+      MMs.setZero();
+      for (int n = 0; n < data.dim().at(mode); n++)
+      {
+         rr.setZero();
+         MM.setZero();
+         if (reference)
+            dispatch_num_latent<ReferenceKernel>(K, data, model, mode, n, rr, MM);
+         else
+            data.getMuLambda(model, mode, n, rr, MM);
+         MMs += MM;
+      }
+   }
+   return (tick() - start) / repeats;
+}
+
+int main(int argc, char** argv)
+{
+   std::string train = argc > 1 ? argv[1] : "";
+   int repeats       = argc > 2 ? std::stoi(argv[2]) : 3;
+
+   init_bmrng(1234);
+
+   std::shared_ptr<MatrixConfig> cfg = train.empty()
+      ? random_sparse_config(15073, 346, 171, true)
+      : matrix_io::read_matrix(train, true);
+
+   std::cout << "getMuLambda: " << cfg->getNRow() << " x " << cfg->getNCol() << ", " << cfg->getNNZ() << " nnz, "
+             << "panel " << PANEL_BYTES << " bytes" << std::endl;
+   std::cout << std::setw(8) << "noise" << std::setw(6) << "mode" << std::setw(6) << "K" << std::setw(14) << "rank-1"
+             << std::setw(14) << "panel" << std::setw(10) << "speedup" << std::setw(12) << "max diff" << std::endl;
+
+   for (auto noise : { NoiseTypes::fixed, NoiseTypes::probit })
+   {
+      NoiseConfig ncfg(noise);
+      ncfg.setThreshold(5.0);
+
+      ScarceMatrixData data{SparseStorage(*cfg)};
+      data.setNoiseModel(NoiseFactory::create_noise_model(ncfg));
+      data.init();
+
+      for (int mode = 0; mode < 2; mode++)
+      {
+         for (int K : { 8, 16, 32, 64, 96 })
+         {
+            Model model;
+            model.init(K, data.dim(), ModelInitTypes::random);
+            SubModel sub(model);
+
+            Eigen::MatrixXd MM_ref(K, K), MM_panel(K, K);
+            double ref = bench_mode(data, sub, mode, true, repeats, MM_ref);
+            double panel = bench_mode(data, sub, mode, false, repeats, MM_panel);
+
+            std::cout << std::setw(8) << noiseTypeToString(noise) << std::setw(6) << mode << std::setw(6) << K
+                      << std::fixed << std::setprecision(4)
+                      << std::setw(12) << ref << " s" << std::setw(12) << panel << " s"
+                      << std::setprecision(2) << std::setw(9) << ref / panel << "x"
+                      << std::scientific << std::setw(12) << (MM_ref - MM_panel).cwiseAbs().maxCoeff() / MM_ref.cwiseAbs().maxCoeff()
+                      << std::defaultfloat << std::endl;
+         }
+      }
+   }
+
+   return 0;
+}
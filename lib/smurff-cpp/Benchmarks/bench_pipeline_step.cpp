@@ -0,0 +1,63 @@
+// Compares the sequential Gibbs step with the pipelined step, where the
+// hyper-parameter update of a mode (for Macau: sampling beta with block-CG)
+// runs while the latents of the next mode are sampled.
+//
+// usage: bench_pipeline_step [nrows] [ncols] [num-features] [num-latent] [iterations]
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/Sessions/SessionFactory.h>
+#include <SmurffCpp/Utils/counters.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+// Macau prior with sparse side info on the rows, normal prior on the columns
+static double bench_session(int nrows, int ncols, int nfeat, int K, int iterations, bool pipeline)
+{
+   Config config;
+   config.setTrain(random_sparse_config(nrows, ncols, 20, true));
+   config.setPriorTypes({ PriorTypes::macau, PriorTypes::normal });
+
+   auto side_info = std::make_shared<SideInfoConfig>();
+   side_info->setSideInfo(random_sparse_config(nrows, nfeat, std::max(1, nrows / 100), false, 4321));
+   side_info->setDirect(false);
+   config.addSideInfoConfig(0, side_info);
+
+   config.setNumLatent(K);
+   config.setBurnin(iterations);
+   config.setNSamples(0);
+   config.setVerbose(0);
+   config.setRandomSeed(1234);
+   config.setPipelineStep(pipeline);
+
+   std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+   session->init();
+
+   double start = tick();
+   while (session->step())
+      ;
+   return (tick() - start) / iterations;
+}
+
+int main(int argc, char** argv)
+{
+   int nrows      = argc > 1 ? std::stoi(argv[1]) : 10000;
+   int ncols      = argc > 2 ? std::stoi(argv[2]) : 10000;
+   int nfeat      = argc > 3 ? std::stoi(argv[3]) : 5000;
+   int K          = argc > 4 ? std::stoi(argv[4]) : 32;
+   int iterations = argc > 5 ? std::stoi(argv[5]) : 5;
+
+   std::cout << "macau: " << nrows << " x " << ncols << ", " << nfeat << " features, K = " << K << std::endl;
+   for (bool pipeline : { false, true })
+   {
+      std::cout << "  " << std::setw(10) << (pipeline ? "pipelined" : "sequential") << ": "
+                << std::fixed << std::setprecision(4) << bench_session(nrows, ncols, nfeat, K, iterations, pipeline) << " s/iter" << std::endl;
+   }
+
+   return 0;
+}
@@ -0,0 +1,97 @@
+// Single-entry predictions of a PredictSession: every sample read from its
+// step file for every prediction, against the samples kept in the cache,
+// and against one batch prediction of all entries.
+//
+// usage: bench_predict_cache [nrows] [ncols] [num-latent] [num-samples] [num-predictions]
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/Sessions/SessionFactory.h>
+#include <SmurffCpp/Predict/PredictSession.h>
+#include <SmurffCpp/Predict/SampleCache.h>
+#include <SmurffCpp/Utils/RootFile.h>
+#include <SmurffCpp/Utils/counters.h>
+#include <SmurffCpp/ResultItem.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+static void report(const std::string& name, std::size_t n, double secs)
+{
+   std::cout << "  " << std::setw(10) << name << ": " << std::fixed << std::setprecision(3) << secs << " s, "
+             << std::setprecision(0) << n / secs << " predictions/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+   int nrows    = argc > 1 ? std::stoi(argv[1]) : 20000;
+   int ncols    = argc > 2 ? std::stoi(argv[2]) : 5000;
+   int K        = argc > 3 ? std::stoi(argv[3]) : 32;
+   int nsamples = argc > 4 ? std::stoi(argv[4]) : 50;
+   int npred    = argc > 5 ? std::stoi(argv[5]) : 200;
+
+   Config config;
+   config.setTrain(random_sparse_config(nrows, ncols, 20, true));
+   config.setPriorTypes({ PriorTypes::normal, PriorTypes::normal });
+   config.setNumLatent(K);
+   config.setBurnin(2);
+   config.setNSamples(nsamples);
+   config.setVerbose(0);
+   config.setRandomSeed(1234);
+   config.setSaveFreq(1);
+   config.setSavePrefix("bench_predict_cache");
+
+   std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+   session->run();
+
+   auto rf = std::make_shared<RootFile>(session->getRootFile()->getRootFileName());
+
+   std::mt19937 gen(1234);
+   std::uniform_int_distribution<int> row_dist(0, nrows - 1), col_dist(0, ncols - 1);
+   std::vector<ResultItem> items;
+   for (int i = 0; i < npred; i++)
+      items.push_back(ResultItem{PVec<>({ row_dist(gen), col_dist(gen) })});
+
+   std::cout << nrows << " x " << ncols << ", K = " << K << ", " << nsamples << " samples, " << npred << " predictions" << std::endl;
+
+   // former path: the step files of the root file opened for every prediction
+   {
+      PredictSession s(rf);
+      std::vector<ResultItem> res(items);
+      double start = tick();
+      for (auto& r : res)
+         for (const auto& sf : rf->openSampleStepFiles())
+            s.predict(r, *sf);
+      report("step files", res.size(), tick() - start);
+   }
+
+   for (bool mapped : { false, true })
+   {
+      PredictSession s(rf);
+      s.setCacheMapped(mapped);
+
+      double start = tick();
+      s.preload();
+      std::cout << "  " << (mapped ? "mapped" : "read") << " samples: preload " << std::setprecision(3) << tick() - start << " s, "
+                << s.getCache()->bytes() / 1e6 << " MB" << std::endl;
+
+      std::vector<ResultItem> res(items);
+      start = tick();
+      for (auto& r : res)
+         s.predict(r);
+      report("cached", res.size(), tick() - start);
+
+      res = items;
+      start = tick();
+      s.predict(res);
+      report("batch", res.size(), tick() - start);
+   }
+
+   return 0;
+}
@@ -0,0 +1,98 @@
+// Predictions for a test set: one sample at a time over all test items,
+// against all samples stacked per mode and the test items sorted by row.
+//
+// usage: bench_predict_stacked [nrows] [ncols] [num-latent] [num-samples] [num-test]
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/Sessions/SessionFactory.h>
+#include <SmurffCpp/Predict/PredictSession.h>
+#include <SmurffCpp/Predict/SampleCache.h>
+#include <SmurffCpp/Predict/StackedSamples.h>
+#include <SmurffCpp/Utils/RootFile.h>
+#include <SmurffCpp/Utils/omp_util.h>
+#include <SmurffCpp/Utils/counters.h>
+#include <SmurffCpp/result.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+static void report(const std::string& name, std::size_t n, double secs)
+{
+   std::cout << "  " << std::setw(12) << name << ": " << std::fixed << std::setprecision(3) << secs << " s, "
+             << std::setprecision(0) << n / secs << " predictions/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+   int nrows    = argc > 1 ? std::stoi(argv[1]) : 20000;
+   int ncols    = argc > 2 ? std::stoi(argv[2]) : 5000;
+   int K        = argc > 3 ? std::stoi(argv[3]) : 32;
+   int nsamples = argc > 4 ? std::stoi(argv[4]) : 50;
+   int ntest    = argc > 5 ? std::stoi(argv[5]) : 1000000;
+
+   Config config;
+   config.setTrain(random_sparse_config(nrows, ncols, 20, true));
+   config.setPriorTypes({ PriorTypes::normal, PriorTypes::normal });
+   config.setNumLatent(K);
+   config.setBurnin(2);
+   config.setNSamples(nsamples);
+   config.setVerbose(0);
+   config.setRandomSeed(1234);
+   config.setSaveFreq(1);
+   config.setSavePrefix("bench_predict_stacked");
+
+   std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+   session->run();
+
+   auto rf = std::make_shared<RootFile>(session->getRootFile()->getRootFileName());
+   auto test = random_sparse_config(nrows, ncols, std::max(1, ntest / ncols), false, 4321);
+
+   std::cout << nrows << " x " << ncols << ", K = " << K << ", " << nsamples << " samples, "
+             << test->getNNZ() << " test items, threads = " << threads::get_max_threads() << std::endl;
+
+   PredictSession s(rf);
+   const std::size_t npred = test->getNNZ() * s.getNumSteps();
+
+   double rmse_per_sample;
+   {
+      SampleCache cache(rf->openSampleStepFiles(), PredictSession::CACHE_BUDGET_DEFAULT_VALUE, true);
+      cache.preload();
+
+      Result res(test);
+      double start = tick();
+      for (std::size_t i = 0; i < cache.size(); ++i)
+         res.update(*cache.get(i));
+      report("per sample", npred, tick() - start);
+      rmse_per_sample = res.rmse_avg;
+   }
+
+   {
+      double start = tick();
+      auto stacked = s.getStackedSamples();
+      std::cout << "  stacking: " << std::setprecision(3) << tick() - start << " s, " << stacked->bytes() / 1e6 << " MB" << std::endl;
+
+      Result res(test);
+      start = tick();
+      res.update(*stacked);
+      report("stacked", npred, tick() - start);
+      std::cout << "  rmse_avg " << std::setprecision(6) << rmse_per_sample << " / " << res.rmse_avg << std::endl;
+
+      std::vector<PVec<> > coords;
+      for (std::uint64_t i = 0; i < test->getNNZ(); ++i)
+         coords.push_back(test->get(i).first);
+
+      Eigen::VectorXd mean, var;
+      Eigen::MatrixXd quantiles;
+      start = tick();
+      s.predict(coords, { 0.05, 0.5, 0.95 }, mean, var, quantiles);
+      report("+ quantiles", npred, tick() - start);
+   }
+
+   return 0;
+}
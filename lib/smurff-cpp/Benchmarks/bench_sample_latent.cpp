@@ -0,0 +1,135 @@
+// Compares per-column latent sampling in NormalPrior (one Eigen::LLT per
+// column) with the batched path (interleaved Cholesky on a tile of columns).
+//
+// usage: bench_sample_latent [nrows] [ncols] [num-latent] [nnz-per-col] [iterations]
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/Sessions/SessionFactory.h>
+#include <SmurffCpp/Utils/Distribution.h>
+#include <SmurffCpp/Utils/chol.h>
+#include <SmurffCpp/Utils/counters.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+// kernels only: ncols random K x K SPD systems
+static double bench_kernels(int ncols, int K, int batch)
+{
+   std::vector<Eigen::MatrixXd> MMs(ncols);
+   Eigen::MatrixXd rrs(K, ncols);
+
+   std::mt19937 gen(1234);
+   std::normal_distribution<double> dist;
+   for (int n = 0; n < ncols; n++)
+   {
+      Eigen::MatrixXd X(K, K);
+      for (int i = 0; i < X.size(); i++) X(i) = dist(gen);
+      MMs[n] = X * X.transpose() + K * Eigen::MatrixXd::Identity(K, K);
+      for (int i = 0; i < K; i++) rrs(i, n) = dist(gen);
+   }
+
+   Eigen::MatrixXd U(K, ncols);
+   double start = tick();
+
+   if (batch <= 1)
+   {
+      for (int n = 0; n < ncols; n++)
+      {
+         Eigen::VectorXd rr = rrs.col(n);
+         Eigen::LLT<Eigen::MatrixXd> chol = MMs[n].llt();
+         chol.matrixL().solveInPlace(rr);
+         rr.noalias() += nrandn(K);
+         chol.matrixU().solveInPlace(rr);
+         U.col(n) = rr;
+      }
+   }
+   else
+   {
+      Eigen::MatrixXd MMb(batch, K * K);
+      Eigen::MatrixXd rrb(batch, K);
+      for (int from = 0; from < ncols; from += batch)
+      {
+         const int w = std::min(batch, ncols - from);
+         Eigen::Map<Eigen::MatrixXd> MMw(MMb.data(), w, K * K);
+         Eigen::Map<Eigen::MatrixXd> rrw(rrb.data(), w, K);
+         for (int l = 0; l < w; l++)
+         {
+            for (int j = 0; j < K; j++)
+               for (int i = j; i < K; i++)
+                  MMw(l, j * K + i) = MMs[from + l](i, j);
+            rrw.row(l) = rrs.col(from + l).transpose();
+         }
+
+         chol_decomp_batch(MMw.data(), K, w);
+         chol_solve_L_batch(MMw.data(), rrw.data(), K, w);
+         rrw.array() += nrandn(w, K);
+         chol_solve_Lt_batch(MMw.data(), rrw.data(), K, w);
+
+         U.block(0, from, K, w) = rrw.transpose();
+      }
+   }
+
+   return tick() - start;
+}
+
+// full Gibbs iterations with two normal priors on a random sparse matrix
+static double bench_session(int nrows, int ncols, int K, int nnz_per_col, int iterations, int batch)
+{
+   auto train = random_sparse_config(nrows, ncols, nnz_per_col, true);
+
+   Config config;
+   config.setTrain(train);
+   config.setPriorTypes({ PriorTypes::normal, PriorTypes::normal });
+   config.setNumLatent(K);
+   config.setBurnin(iterations);
+   config.setNSamples(0);
+   config.setVerbose(0);
+   config.setRandomSeed(1234);
+   config.setSampleBatch(batch);
+
+   std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+   session->init();
+
+   double start = tick();
+   while (session->step())
+      ;
+   return (tick() - start) / iterations;
+}
+
+int main(int argc, char** argv)
+{
+   int nrows       = argc > 1 ? std::stoi(argv[1]) : 20000;
+   int ncols       = argc > 2 ? std::stoi(argv[2]) : 20000;
+   int K           = argc > 3 ? std::stoi(argv[3]) : 32;
+   int nnz_per_col = argc > 4 ? std::stoi(argv[4]) : 20;
+   int iterations  = argc > 5 ? std::stoi(argv[5]) : 5;
+
+   init_bmrng(1234);
+
+   const std::vector<int> batches = { 0, 4, 8, 16, 32 };
+
+   std::cout << "kernels: " << ncols << " columns, K = " << K << std::endl;
+   for (int b : batches)
+   {
+      std::cout << "  batch " << std::setw(3) << b << ": "
+                << std::fixed << std::setprecision(4) << bench_kernels(ncols, K, b) << " s" << std::endl;
+   }
+
+   std::cout << "session: " << nrows << " x " << ncols << ", " << nnz_per_col << " nnz per column, K = " << K << std::endl;
+   for (int b : batches)
+   {
+      std::cout << "  batch " << std::setw(3) << b << ": "
+                << std::fixed << std::setprecision(4) << bench_session(nrows, ncols, K, nnz_per_col, iterations, b) << " s/iter" << std::endl;
+   }
+
+   return 0;
+}
@@ -0,0 +1,86 @@
+// construction of TensorData from a TensorConfig: the former path through an
+// [nnz x nmodes] staging matrix and one SparseMode per mode built from it,
+// against the modes built straight from the columns of the config.
+//
+// usage: bench_tensor_data [nnz] [reference|streaming|both]
+//
+// peak memory is per process, run reference and streaming separately to
+// compare it
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/DataTensors/TensorData.h>
+#include <SmurffCpp/Utils/omp_util.h>
+#include <SmurffCpp/Utils/counters.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+// the former TensorData constructor
+static std::vector<std::shared_ptr<SparseMode> > reference_modes(const TensorConfig& tc)
+{
+   const std::uint64_t nnz = tc.getNNZ();
+   const std::uint64_t nmodes = tc.getNModes();
+
+   MatrixXui32 idx(nnz, nmodes);
+   for (std::uint64_t row = 0; row < nnz; row++)
+      for (std::uint64_t col = 0; col < nmodes; col++)
+         idx(row, col) = tc.getColumns()[col * nnz + row];
+
+   std::vector<std::shared_ptr<SparseMode> > modes;
+   for (std::uint64_t mode = 0; mode < nmodes; mode++)
+      modes.push_back(std::make_shared<SparseMode>(idx, tc.getValues(), mode, tc.getDims()[mode]));
+   return modes;
+}
+
+static bool same(const std::vector<std::shared_ptr<SparseMode> >& expected, const TensorData& actual)
+{
+   for (std::uint64_t m = 0; m < expected.size(); m++)
+   {
+      if (expected[m]->getIndices() != actual.Y(m)->getIndices() || expected[m]->getValues() != actual.Y(m)->getValues())
+         return false;
+
+      for (std::uint64_t h = 0; h <= expected[m]->getNPlanes(); h++)
+         if (expected[m]->beginPlane(h) != actual.Y(m)->beginPlane(h))
+            return false;
+   }
+   return true;
+}
+
+int main(int argc, char** argv)
+{
+   std::uint64_t nnz = argc > 1 ? std::stoull(argv[1]) : 20000000;
+   std::string which = argc > 2 ? argv[2] : "both";
+
+   const std::vector<std::uint64_t> dims = { 1000000, 200000, 1000 };
+   auto train = random_sparse_tensor_config(dims, nnz);
+
+   const double config_mb = (train->getColumns().size() * sizeof(std::uint32_t) + train->getValues().size() * sizeof(double)) / 1e6;
+   std::cout << "nnz = " << nnz << ", dims = 1000000 x 200000 x 1000, threads = " << threads::get_max_threads()
+             << ", config " << std::fixed << std::setprecision(1) << config_mb << " MB" << std::endl;
+
+   std::vector<std::shared_ptr<SparseMode> > expected;
+   if (which != "streaming")
+   {
+      double start = tick();
+      expected = reference_modes(*train);
+      std::cout << std::setw(12) << "reference" << std::setw(10) << std::setprecision(3) << tick() - start << " s" << std::endl;
+   }
+
+   if (which != "reference")
+   {
+      double start = tick();
+      TensorData data(*train);
+      std::cout << std::setw(12) << "streaming" << std::setw(10) << std::setprecision(3) << tick() - start << " s";
+      if (!expected.empty())
+         std::cout << (same(expected, data) ? "  ok" : "  DIFF");
+      std::cout << std::endl;
+   }
+
+   std::cout << "peak rss " << std::setprecision(1) << peak_rss() / 1e6 << " MB" << std::endl;
+   return 0;
+}
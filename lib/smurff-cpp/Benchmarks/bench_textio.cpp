@@ -0,0 +1,161 @@
+// matrix_io::read_matrix on .mtx and tensor_io::read_tensor on .tns (file
+// mapped, parsed in parallel by text_io) against the line by line istream
+// readers they replaced, with 1 thread up to the maximum.
+//
+// usage: bench_textio [nrows] [ncols] [nnz-per-col] [repeats]
+//
+// the files are written to the current directory and removed afterwards.
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include <SmurffCpp/IO/MatrixIO.h>
+#include <SmurffCpp/IO/TensorIO.h>
+#include <SmurffCpp/Utils/omp_util.h>
+#include <SmurffCpp/Utils/counters.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+// the former matrix_io::read_matrix_market for coordinate real matrices
+static std::shared_ptr<MatrixConfig> reference_read_mtx(const std::string& filename)
+{
+   std::ifstream in(filename);
+
+   std::string header;
+   std::getline(in, header);
+
+   while (in.peek() == '%' || in.peek() == '\n')
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+   std::uint64_t nrows, ncols, nnz;
+   in >> nrows >> ncols >> nnz;
+
+   std::vector<std::uint32_t> rows(nnz);
+   std::vector<std::uint32_t> cols(nnz);
+   std::vector<double> vals(nnz);
+
+   for (std::uint64_t i = 0; i < nnz; i++)
+   {
+      while (in.peek() == '%' || in.peek() == '\n')
+         in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+      std::uint32_t row, col;
+      in >> row >> col >> vals[i];
+      rows[i] = row - 1;
+      cols[i] = col - 1;
+   }
+
+   return std::make_shared<MatrixConfig>(nrows, ncols, std::move(rows), std::move(cols), std::move(vals), NoiseConfig(), true);
+}
+
+// the former tensor_io::read_sparse_float64_tns, values read as double
+static std::shared_ptr<TensorConfig> reference_read_tns(const std::string& filename)
+{
+   std::ifstream in(filename);
+   std::string line, cell;
+
+   std::uint64_t nmodes, nnz;
+   std::getline(in, line);
+   nmodes = std::stoull(line);
+
+   std::vector<std::uint64_t> dims;
+   std::getline(in, line);
+   std::stringstream dimStream(line);
+   while (std::getline(dimStream, cell, '\t'))
+      dims.push_back(std::stoull(cell));
+
+   std::getline(in, line);
+   nnz = std::stoull(line);
+
+   std::vector<std::uint32_t> columns;
+   columns.reserve(nmodes * nnz);
+   std::getline(in, line);
+   std::stringstream colStream(line);
+   while (std::getline(colStream, cell, '\t'))
+      columns.push_back(std::stoul(cell) - 1);
+
+   std::vector<double> values;
+   values.reserve(nnz);
+   std::getline(in, line);
+   std::stringstream valStream(line);
+   while (std::getline(valStream, cell, '\t'))
+      values.push_back(std::stod(cell));
+
+   return std::make_shared<TensorConfig>(std::move(dims), std::move(columns), std::move(values), NoiseConfig(), true);
+}
+
+template<typename F>
+static double seconds(F f, int repeats)
+{
+   double start = tick();
+   for (int r = 0; r < repeats; r++)
+      f();
+   return (tick() - start) / repeats;
+}
+
+static void print(const std::string& name, std::uint64_t bytes, int threads, double secs, double ref_secs, bool same)
+{
+   std::cout << std::setw(6) << name << std::setw(10) << bytes / (1024 * 1024) << std::setw(9) << threads
+             << std::setw(12) << std::fixed << std::setprecision(3) << ref_secs
+             << std::setw(12) << secs
+             << std::setw(10) << std::setprecision(1) << ref_secs / secs
+             << std::setw(8) << (same ? "ok" : "DIFF") << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+   int nrows       = argc > 1 ? std::stoi(argv[1]) : 200000;
+   int ncols       = argc > 2 ? std::stoi(argv[2]) : 5000;
+   int nnz_per_col = argc > 3 ? std::stoi(argv[3]) : 400;
+   int repeats     = argc > 4 ? std::stoi(argv[4]) : 1;
+
+   const std::string mtx = "bench_textio.mtx";
+   const std::string tns = "bench_textio.tns";
+
+   auto matrix = random_sparse_config(nrows, ncols, nnz_per_col, true);
+   matrix_io::write_matrix(mtx, matrix);
+   tensor_io::write_tensor(tns, matrix);
+
+   std::uint64_t mtx_bytes = MappedFile(mtx).size();
+   std::uint64_t tns_bytes = MappedFile(tns).size();
+
+   std::cout << "text readers: " << nrows << " x " << ncols << ", " << matrix->getNNZ() << " nnz" << std::endl;
+   std::cout << std::setw(6) << "file" << std::setw(10) << "MB" << std::setw(9) << "threads" << std::setw(12) << "istream"
+             << std::setw(12) << "text_io" << std::setw(10) << "speedup" << std::setw(8) << "check" << std::endl;
+
+   std::shared_ptr<MatrixConfig> ref_matrix;
+   double ref_mtx = seconds([&] { ref_matrix = reference_read_mtx(mtx); }, repeats);
+
+   std::shared_ptr<TensorConfig> ref_tensor;
+   double ref_tns = seconds([&] { ref_tensor = reference_read_tns(tns); }, repeats);
+
+   const int max_threads = threads::get_max_threads();
+   for (int t = 1; t <= max_threads; t *= 2)
+   {
+      threads::init(0, t);
+
+      std::shared_ptr<MatrixConfig> m;
+      double secs = seconds([&] { m = matrix_io::read_matrix(mtx, true); }, repeats);
+      bool same = m->getRows() == ref_matrix->getRows() && m->getCols() == ref_matrix->getCols() && m->getValues() == ref_matrix->getValues();
+      print("mtx", mtx_bytes, t, secs, ref_mtx, same);
+
+      std::shared_ptr<TensorConfig> tc;
+      secs = seconds([&] { tc = tensor_io::read_tensor(tns, true); }, repeats);
+      same = tc->getColumns() == ref_tensor->getColumns() && tc->getValues() == ref_tensor->getValues();
+      print("tns", tns_bytes, t, secs, ref_tns, same);
+
+      if (t < max_threads && 2 * t > max_threads)
+         t = max_threads / 2;
+   }
+
+   std::remove(mtx.c_str());
+   std::remove(tns.c_str());
+   return 0;
+}
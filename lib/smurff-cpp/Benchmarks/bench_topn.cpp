@@ -0,0 +1,99 @@
+// Top-N queries over the posterior: the predictions of all columns of a
+// row materialized with the stacked samples and partially sorted, against
+// PredictSession::topN, which multiplies a batch of query rows with the
+// column latents of every sample and keeps a bounded heap per row.
+//
+// usage: bench_topn [nrows] [ncols] [num-latent] [num-samples] [num-queries] [N]
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/Sessions/SessionFactory.h>
+#include <SmurffCpp/Predict/PredictSession.h>
+#include <SmurffCpp/Utils/RootFile.h>
+#include <SmurffCpp/Utils/omp_util.h>
+#include <SmurffCpp/Utils/counters.h>
+#include <SmurffCpp/ResultItem.h>
+
+#include "bench_data.h"
+
+using namespace smurff;
+
+static void report(const std::string& name, std::size_t n, double secs)
+{
+   std::cout << "  " << std::setw(16) << name << ": " << std::fixed << std::setprecision(3) << secs << " s, "
+             << std::setprecision(1) << n / secs << " queries/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+   int nrows    = argc > 1 ? std::stoi(argv[1]) : 20000;
+   int ncols    = argc > 2 ? std::stoi(argv[2]) : 20000;
+   int K        = argc > 3 ? std::stoi(argv[3]) : 32;
+   int nsamples = argc > 4 ? std::stoi(argv[4]) : 20;
+   int nqueries = argc > 5 ? std::stoi(argv[5]) : 1000;
+   int N        = argc > 6 ? std::stoi(argv[6]) : 10;
+
+   auto train = random_sparse_config(nrows, ncols, 20, true);
+
+   Config config;
+   config.setTrain(train);
+   config.setPriorTypes({ PriorTypes::normal, PriorTypes::normal });
+   config.setNumLatent(K);
+   config.setBurnin(2);
+   config.setNSamples(nsamples);
+   config.setVerbose(0);
+   config.setRandomSeed(1234);
+   config.setSaveFreq(1);
+   config.setSavePrefix("bench_topn");
+
+   std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+   session->run();
+
+   PredictSession s(std::make_shared<RootFile>(session->getRootFile()->getRootFileName()));
+   s.preload();
+
+   std::mt19937 gen(1234);
+   std::uniform_int_distribution<int> row_dist(0, nrows - 1);
+   std::vector<int> rows(nqueries);
+   for (auto& r : rows)
+      r = row_dist(gen);
+
+   std::cout << nrows << " x " << ncols << ", K = " << K << ", " << nsamples << " samples, "
+             << nqueries << " queries, N = " << N << ", threads = " << threads::get_max_threads() << std::endl;
+
+   // former path: all predictions of a row, then the best N
+   {
+      const int nbaseline = std::max(1, nqueries / 20);
+      double start = tick();
+      for (int q = 0; q < nbaseline; q++)
+      {
+         std::vector<ResultItem> items;
+         for (int col = 0; col < ncols; col++)
+            items.push_back(ResultItem{PVec<>({ rows[q], col })});
+         s.predict(items);
+         std::partial_sort(items.begin(), items.begin() + N, items.end(),
+            [](const ResultItem& a, const ResultItem& b) { return a.pred_avg > b.pred_avg; });
+      }
+      report("materialized", nbaseline, tick() - start);
+   }
+
+   double start = tick();
+   auto by_mean = s.topN(rows, N);
+   report("topN mean", rows.size(), tick() - start);
+
+   start = tick();
+   auto by_ucb = s.topN(rows, N, 1.0);
+   report("topN ucb", rows.size(), tick() - start);
+
+   start = tick();
+   auto unseen = s.topN(rows, N, 0.0, train);
+   report("topN excluded", rows.size(), tick() - start);
+
+   return 0;
+}
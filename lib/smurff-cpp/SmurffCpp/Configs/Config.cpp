@@ -14,6 +14,7 @@
 
 #include <SmurffCpp/Version.h>
 #include <SmurffCpp/Utils/Error.h>
+#include <SmurffCpp/Utils/NumModes.hpp>
 #include <SmurffCpp/Utils/TensorUtils.h>
 #include <SmurffCpp/IO/INIFile.h>
 #include <SmurffCpp/DataMatrices/Data.h>
@@ -38,6 +39,10 @@
 #define NSAMPLES_TAG "nsamples"
 #define NUM_LATENT_TAG "num_latent"
 #define NUM_THREADS_TAG "num_threads"
+#define SAMPLE_BATCH_TAG "sample_batch"
+#define PIPELINE_STEP_TAG "pipeline_step"
+#define CSF_TENSOR_TAG "csf_tensor"
+#define REORDER_TAG "reorder"
 #define RANDOM_SEED_SET_TAG "random_seed_set"
 #define RANDOM_SEED_TAG "random_seed"
 #define INIT_MODEL_TAG "init_model"
@@ -132,6 +137,10 @@ const char* Config::STATUS_DEFAULT_VALUE = "";
 bool Config::ENABLE_BETA_PRECISION_SAMPLING_DEFAULT_VALUE = true;
 double Config::THRESHOLD_DEFAULT_VALUE = 0.0;
 int Config::RANDOM_SEED_DEFAULT_VALUE = 0;
+int Config::SAMPLE_BATCH_DEFAULT_VALUE = 0; // one column at a time
+bool Config::PIPELINE_STEP_DEFAULT_VALUE = false;
+bool Config::CSF_TENSOR_DEFAULT_VALUE = false;
+ReorderTypes Config::REORDER_DEFAULT_VALUE = ReorderTypes::none;
 
 Config::Config()
 {
@@ -151,6 +160,10 @@ Config::Config()
    m_nsamples = Config::NSAMPLES_DEFAULT_VALUE;
    m_num_latent = Config::NUM_LATENT_DEFAULT_VALUE;
    m_num_threads = Config::NUM_THREADS_DEFAULT_VALUE;
+   m_sample_batch = Config::SAMPLE_BATCH_DEFAULT_VALUE;
+   m_pipeline_step = Config::PIPELINE_STEP_DEFAULT_VALUE;
+   m_csf_tensor = Config::CSF_TENSOR_DEFAULT_VALUE;
+   m_reorder_type = Config::REORDER_DEFAULT_VALUE;
 
    m_threshold = Config::THRESHOLD_DEFAULT_VALUE;
    m_classify = false;
@@ -200,6 +213,11 @@ bool Config::validate() const
       THROWERROR("Missing train data");
    }
 
+   if (!is_supported_num_modes(m_train->getNModes()))
+   {
+      THROWERROR("Train data should have between " + std::to_string(MIN_NUM_MODES) + " and " + std::to_string(MAX_NUM_MODES) + " dimensions");
+   }
+
    auto train_pos = PVec<>(m_train->getNModes());
    if (!m_train->hasPos())
    {
@@ -225,6 +243,11 @@ bool Config::validate() const
       THROWERROR("Number of priors should equal to number of dimensions in train data");
    }
 
+   if (m_sample_batch < 0)
+   {
+      THROWERROR("Sample batch size should be zero or positive");
+   }
+
    if (m_train->getNModes() > 2)
    {
 
@@ -239,6 +262,19 @@ bool Config::validate() const
       }
    }
 
+   if (m_reorder_type != ReorderTypes::none)
+   {
+      if (m_train->isDense())
+      {
+         THROWERROR("Reordering needs sparse train data");
+      }
+
+      if (!m_auxData.empty())
+      {
+         THROWERROR("Reordering is not supported with aux data");
+      }
+   }
+
    for (auto p : m_sideInfoConfigs)
    {
       int mode = p.first;
@@ -382,6 +418,10 @@ void Config::save(std::string fname) const
    ini.appendItem(GLOBAL_SECTION_TAG, NSAMPLES_TAG, std::to_string(m_nsamples));
    ini.appendItem(GLOBAL_SECTION_TAG, NUM_LATENT_TAG, std::to_string(m_num_latent));
    ini.appendItem(GLOBAL_SECTION_TAG, NUM_THREADS_TAG, std::to_string(m_num_threads));
+   ini.appendItem(GLOBAL_SECTION_TAG, SAMPLE_BATCH_TAG, std::to_string(m_sample_batch));
+   ini.appendItem(GLOBAL_SECTION_TAG, PIPELINE_STEP_TAG, std::to_string(m_pipeline_step));
+   ini.appendItem(GLOBAL_SECTION_TAG, CSF_TENSOR_TAG, std::to_string(m_csf_tensor));
+   ini.appendItem(GLOBAL_SECTION_TAG, REORDER_TAG, reorderTypeToString(m_reorder_type));
    ini.appendItem(GLOBAL_SECTION_TAG, RANDOM_SEED_SET_TAG, std::to_string(m_random_seed_set));
    ini.appendItem(GLOBAL_SECTION_TAG, RANDOM_SEED_TAG, std::to_string(m_random_seed));
    ini.appendItem(GLOBAL_SECTION_TAG, INIT_MODEL_TAG, modelInitTypeToString(m_model_init_type));
@@ -489,6 +529,10 @@ bool Config::restore(std::string fname)
    m_nsamples = reader.getInteger(GLOBAL_SECTION_TAG, NSAMPLES_TAG, Config::NSAMPLES_DEFAULT_VALUE);
    m_num_latent = reader.getInteger(GLOBAL_SECTION_TAG, NUM_LATENT_TAG, Config::NUM_LATENT_DEFAULT_VALUE);
    m_num_threads = reader.getInteger(GLOBAL_SECTION_TAG, NUM_THREADS_TAG, Config::NUM_THREADS_DEFAULT_VALUE);
+   m_sample_batch = reader.getInteger(GLOBAL_SECTION_TAG, SAMPLE_BATCH_TAG, Config::SAMPLE_BATCH_DEFAULT_VALUE);
+   m_pipeline_step = reader.getBoolean(GLOBAL_SECTION_TAG, PIPELINE_STEP_TAG, Config::PIPELINE_STEP_DEFAULT_VALUE);
+   m_csf_tensor = reader.getBoolean(GLOBAL_SECTION_TAG, CSF_TENSOR_TAG, Config::CSF_TENSOR_DEFAULT_VALUE);
+   m_reorder_type = stringToReorderType(reader.get(GLOBAL_SECTION_TAG, REORDER_TAG, reorderTypeToString(Config::REORDER_DEFAULT_VALUE)));
    m_random_seed_set = reader.getBoolean(GLOBAL_SECTION_TAG, RANDOM_SEED_SET_TAG,  false);
    m_random_seed = reader.getInteger(GLOBAL_SECTION_TAG, RANDOM_SEED_TAG, Config::RANDOM_SEED_DEFAULT_VALUE);
    m_model_init_type = stringToModelInitType(reader.get(GLOBAL_SECTION_TAG, INIT_MODEL_TAG, modelInitTypeToString(Config::INIT_MODEL_DEFAULT_VALUE)));
@@ -523,6 +567,26 @@ std::ostream& Config::info(std::ostream &os, std::string indent) const
 {
    os << indent << "  Iterations: " << getBurnin() << " burnin + " << getNSamples() << " samples\n";
 
+   if (getSampleBatch() > 1)
+   {
+      os << indent << "  Sample batch: " << getSampleBatch() << " latent vectors\n";
+   }
+
+   if (getPipelineStep())
+   {
+      os << indent << "  Pipelined step: update_prior overlaps with sampling of the next mode\n";
+   }
+
+   if (getCSFTensor())
+   {
+      os << indent << "  Tensor storage: compressed sparse fiber trees\n";
+   }
+
+   if (getReorderType() != ReorderTypes::none)
+   {
+      os << indent << "  Reorder: " << getReorderTypeAsString() << "\n";
+   }
+
    if (getSaveFreq() != 0 || getCheckpointFreq() != 0)
    {
       if (getSaveFreq() > 0)
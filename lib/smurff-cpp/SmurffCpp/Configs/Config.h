@@ -6,6 +6,7 @@
 
 #include <SmurffCpp/Utils/PVec.hpp>
 #include <SmurffCpp/Utils/Error.h>
+#include <SmurffCpp/Utils/Reordering.h>
 #include "MatrixConfig.h"
 #include "SideInfoConfig.h"
 
@@ -73,6 +74,10 @@ public:
    static bool ENABLE_BETA_PRECISION_SAMPLING_DEFAULT_VALUE;
    static double THRESHOLD_DEFAULT_VALUE;
    static int RANDOM_SEED_DEFAULT_VALUE;
+   static int SAMPLE_BATCH_DEFAULT_VALUE;
+   static bool PIPELINE_STEP_DEFAULT_VALUE;
+   static bool CSF_TENSOR_DEFAULT_VALUE;
+   static ReorderTypes REORDER_DEFAULT_VALUE;
 
 private:
    ActionTypes m_action;
@@ -107,6 +112,10 @@ private:
    int m_nsamples;
    int m_num_latent;
    int m_num_threads; 
+   int m_sample_batch;
+   bool m_pipeline_step;
+   bool m_csf_tensor;
+   ReorderTypes m_reorder_type;
 
    //-- binary classification
    bool m_classify;
@@ -341,6 +350,56 @@ public:
       m_num_latent = value;
    }
 
+   int getSampleBatch() const
+   {
+      return m_sample_batch;
+   }
+
+   void setSampleBatch(int value)
+   {
+      m_sample_batch = value;
+   }
+
+   bool getPipelineStep() const
+   {
+      return m_pipeline_step;
+   }
+
+   void setPipelineStep(bool value)
+   {
+      m_pipeline_step = value;
+   }
+
+   bool getCSFTensor() const
+   {
+      return m_csf_tensor;
+   }
+
+   void setCSFTensor(bool value)
+   {
+      m_csf_tensor = value;
+   }
+
+   ReorderTypes getReorderType() const
+   {
+      return m_reorder_type;
+   }
+
+   void setReorderType(ReorderTypes value)
+   {
+      m_reorder_type = value;
+   }
+
+   std::string getReorderTypeAsString() const
+   {
+      return reorderTypeToString(m_reorder_type);
+   }
+
+   void setReorderType(std::string value)
+   {
+      m_reorder_type = stringToReorderType(value);
+   }
+
    bool getClassify() const
    {
       return m_classify;
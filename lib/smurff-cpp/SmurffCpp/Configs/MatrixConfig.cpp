@@ -366,6 +366,15 @@ const std::vector<std::uint32_t>& MatrixConfig::getCols() const
    return *m_cols;
 }
 
+void MatrixConfig::releaseData()
+{
+   TensorConfig::releaseData();
+
+   //empty, not null: getRows and getCols would rebuild them from the columns
+   m_rows = std::make_shared<std::vector<std::uint32_t> >();
+   m_cols = std::make_shared<std::vector<std::uint32_t> >();
+}
+
 std::shared_ptr<Data> MatrixConfig::create(std::shared_ptr<IDataCreator> creator) const
 {
    //have to use dynamic cast here but only because shared_from_this() can only return base pointer even from child
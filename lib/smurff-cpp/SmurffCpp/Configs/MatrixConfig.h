@@ -107,6 +107,8 @@ namespace smurff
       const std::vector<std::uint32_t>& getRows() const;
       const std::vector<std::uint32_t>& getCols() const;
 
+      void releaseData() override;
+
    public:
       std::shared_ptr<Data> create(std::shared_ptr<IDataCreator> creator) const override;
 
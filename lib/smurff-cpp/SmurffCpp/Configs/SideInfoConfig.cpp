@@ -14,18 +14,30 @@
 #define TOL_TAG "tol"
 #define DIRECT_TAG "direct"
 #define THROW_ON_CHOLESKY_ERROR_TAG "throw_on_cholesky_error"
+#define MAX_ITER_TAG "max_iter"
+#define WARM_START_TAG "warm_start"
+#define PRECONDITIONER_TAG "preconditioner"
+#define PARALLEL_BLOCKS_TAG "parallel_blocks"
 #define SIDE_INFO_PREFIX "side_info"
 
 using namespace smurff;
 
 double SideInfoConfig::BETA_PRECISION_DEFAULT_VALUE = 10.0;
 double SideInfoConfig::TOL_DEFAULT_VALUE = 1e-6;
+int SideInfoConfig::MAX_ITER_DEFAULT_VALUE = 10;
+bool SideInfoConfig::WARM_START_DEFAULT_VALUE = false;
+PreconditionerTypes SideInfoConfig::PRECONDITIONER_DEFAULT_VALUE = PreconditionerTypes::none;
+bool SideInfoConfig::PARALLEL_BLOCKS_DEFAULT_VALUE = false;
 
 SideInfoConfig::SideInfoConfig()
 {
    m_tol = SideInfoConfig::TOL_DEFAULT_VALUE;
    m_direct = false;
    m_throw_on_cholesky_error = false;
+   m_max_iter = SideInfoConfig::MAX_ITER_DEFAULT_VALUE;
+   m_warm_start = SideInfoConfig::WARM_START_DEFAULT_VALUE;
+   m_preconditioner = SideInfoConfig::PRECONDITIONER_DEFAULT_VALUE;
+   m_parallel_blocks = SideInfoConfig::PARALLEL_BLOCKS_DEFAULT_VALUE;
 }
 
 void SideInfoConfig::save(INIFile& writer, std::size_t prior_index, std::size_t config_item_index) const
@@ -39,6 +51,10 @@ void SideInfoConfig::save(INIFile& writer, std::size_t prior_index, std::size_t
    writer.appendItem(sectionName, TOL_TAG, std::to_string(m_tol));
    writer.appendItem(sectionName, DIRECT_TAG, std::to_string(m_direct));
    writer.appendItem(sectionName, THROW_ON_CHOLESKY_ERROR_TAG, std::to_string(m_throw_on_cholesky_error));
+   writer.appendItem(sectionName, MAX_ITER_TAG, std::to_string(m_max_iter));
+   writer.appendItem(sectionName, WARM_START_TAG, std::to_string(m_warm_start));
+   writer.appendItem(sectionName, PRECONDITIONER_TAG, preconditionerTypeToString(m_preconditioner));
+   writer.appendItem(sectionName, PARALLEL_BLOCKS_TAG, std::to_string(m_parallel_blocks));
 
    writer.endSection();
 
@@ -69,6 +85,10 @@ bool SideInfoConfig::restore(const INIFile& reader, std::size_t prior_index, std
    m_tol = reader.getReal(section.str(), TOL_TAG, SideInfoConfig::TOL_DEFAULT_VALUE);
    m_direct = reader.getBoolean(section.str(), DIRECT_TAG, false);
    m_throw_on_cholesky_error = reader.getBoolean(section.str(), THROW_ON_CHOLESKY_ERROR_TAG, false);
+   m_max_iter = reader.getInteger(section.str(), MAX_ITER_TAG, SideInfoConfig::MAX_ITER_DEFAULT_VALUE);
+   m_warm_start = reader.getBoolean(section.str(), WARM_START_TAG, SideInfoConfig::WARM_START_DEFAULT_VALUE);
+   m_preconditioner = stringToPreconditionerType(reader.get(section.str(), PRECONDITIONER_TAG, preconditionerTypeToString(SideInfoConfig::PRECONDITIONER_DEFAULT_VALUE)));
+   m_parallel_blocks = reader.getBoolean(section.str(), PARALLEL_BLOCKS_TAG, SideInfoConfig::PARALLEL_BLOCKS_DEFAULT_VALUE);
 
    std::stringstream ss;
    ss << SIDE_INFO_PREFIX << "_" << prior_index;
@@ -5,6 +5,7 @@
 #include <string>
 
 #include <SmurffCpp/IO/INIFile.h>
+#include <SmurffCpp/Utils/Preconditioner.h>
 
 #include "MatrixConfig.h"
 
@@ -15,11 +16,21 @@ namespace smurff
    public:
       static double BETA_PRECISION_DEFAULT_VALUE;
       static double TOL_DEFAULT_VALUE;
+      static int MAX_ITER_DEFAULT_VALUE;
+      static bool WARM_START_DEFAULT_VALUE;
+      static PreconditionerTypes PRECONDITIONER_DEFAULT_VALUE;
+      static bool PARALLEL_BLOCKS_DEFAULT_VALUE;
    private:
       double m_tol;
       bool m_direct;
       bool m_throw_on_cholesky_error;
 
+      // block-CG solver settings
+      int m_max_iter;
+      bool m_warm_start;
+      PreconditionerTypes m_preconditioner;
+      bool m_parallel_blocks;
+
       std::shared_ptr<MatrixConfig> m_sideInfo; //side info matrix for macau and macauone prior
 
    public:
@@ -66,6 +77,51 @@ namespace smurff
          m_throw_on_cholesky_error = value;
       }
 
+      int getMaxIter() const
+      {
+         return m_max_iter;
+      }
+
+      void setMaxIter(int value)
+      {
+         m_max_iter = value;
+      }
+
+      bool getWarmStart() const
+      {
+         return m_warm_start;
+      }
+
+      void setWarmStart(bool value)
+      {
+         m_warm_start = value;
+      }
+
+      PreconditionerTypes getPreconditioner() const
+      {
+         return m_preconditioner;
+      }
+
+      void setPreconditioner(PreconditionerTypes value)
+      {
+         m_preconditioner = value;
+      }
+
+      void setPreconditioner(std::string value)
+      {
+         m_preconditioner = stringToPreconditionerType(value);
+      }
+
+      bool getParallelBlocks() const
+      {
+         return m_parallel_blocks;
+      }
+
+      void setParallelBlocks(bool value)
+      {
+         m_parallel_blocks = value;
+      }
+
    public:
       void save(INIFile& writer, std::size_t prior_index, std::size_t config_item_index) const;
 
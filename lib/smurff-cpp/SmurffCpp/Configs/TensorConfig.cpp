@@ -292,6 +292,26 @@ TensorConfig::TensorConfig( std::shared_ptr<std::vector<std::uint64_t> > dims
    m_values = std::make_shared<std::vector<double> >(m_nnz, 1);
 }
 
+//
+// Sparse tensor without data
+//
+
+TensorConfig::TensorConfig( const std::vector<std::uint64_t>& dims
+                          , std::uint64_t nnz
+                          , bool isBinary
+                          , const NoiseConfig& noiseConfig
+                          , bool isScarce
+                          )
+   : TensorConfig(false, isBinary, isScarce, dims.size(), nnz, noiseConfig)
+{
+   if (dims.size() == 0)
+   {
+      THROWERROR("Cannot create TensorConfig instance: 'dims' size cannot be zero");
+   }
+
+   m_dims = std::make_shared<std::vector<std::uint64_t> >(dims);
+}
+
 TensorConfig::~TensorConfig()
 {
 }
@@ -363,6 +383,17 @@ const std::vector<double>& TensorConfig::getValues() const
    return *m_values;
 }
 
+void TensorConfig::releaseData()
+{
+   m_columns = std::make_shared<std::vector<std::uint32_t> >();
+   m_values = std::make_shared<std::vector<double> >();
+}
+
+bool TensorConfig::hasData() const
+{
+   return m_nnz == 0 || !m_columns->empty() || !m_values->empty();
+}
+
 /*
 std::shared_ptr<std::vector<std::uint64_t> > TensorConfig::getDimsPtr() const
 {
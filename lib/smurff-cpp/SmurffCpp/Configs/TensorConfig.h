@@ -80,6 +80,14 @@ namespace smurff
       TensorConfig(std::shared_ptr<std::vector<std::uint64_t> > dims, std::shared_ptr<std::vector<std::uint32_t> > columns,
                    const NoiseConfig& noiseConfig, bool isScarce);
 
+   //
+   // Sparse tensor of which only dims and nnz are known, the columns
+   // and values stay in the file (see tensor_io::read_tensor_header)
+   //
+   public:
+      TensorConfig(const std::vector<std::uint64_t>& dims, std::uint64_t nnz, bool isBinary,
+                   const NoiseConfig& noiseConfig, bool isScarce);
+
    public:
       virtual ~TensorConfig();
 
@@ -101,6 +109,14 @@ namespace smurff
       const std::vector<std::uint32_t>& getColumns() const;
       const std::vector<double>& getValues() const;
 
+      // drops the reference to the columns and values, once the data
+      // has been created from them, dims and nnz are kept
+      virtual void releaseData();
+
+      // false if only dims and nnz are known, after releaseData or
+      // for the header of a file
+      bool hasData() const;
+
      // std::shared_ptr<std::vector<std::uint64_t> > getDimsPtr() const;
      // std::shared_ptr<std::vector<std::uint32_t> > getColumnsPtr() const;
      // std::shared_ptr<std::vector<std::uint32_t> > getCoordsPtr(int mode) const;
@@ -68,6 +68,18 @@ void Data::setNoiseModel(std::shared_ptr<INoiseModel> nm)
    noise_ptr = nm;
 }
 
+std::uint64_t Data::col_nnz(uint32_t mode, int d) const
+{
+   return 1;
+}
+
+//by default a column can not be split: the first part does all the work
+void Data::getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const
+{
+   if (from == 0)
+      getMuLambda(model, mode, d, rr, MM);
+}
+
 //#### info functions ####
 
 std::ostream& Data::info(std::ostream& os, std::string indent)
@@ -69,6 +69,15 @@ namespace smurff
       virtual void update_pnm(const SubModel& model, uint32_t mode) = 0;
       virtual void getMuLambda(const SubModel& model, uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const = 0;
 
+      // number of items contributing to getMuLambda for column d of mode
+      // (cost estimate used to schedule and split columns)
+      virtual std::uint64_t col_nnz(uint32_t mode, int d) const;
+
+      // getMuLambda restricted to items [from, to) of column d;
+      // the part with from == 0 also adds the terms that do not depend
+      // on the items (e.g. VV for fully known matrices)
+      virtual void getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const;
+
    public:
       virtual double sumsq(const SubModel& model) const = 0;
       virtual double var_total() const = 0;
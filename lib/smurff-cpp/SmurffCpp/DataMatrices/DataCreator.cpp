@@ -3,6 +3,7 @@
 #include "DataCreatorBase.h"
 
 #include <SmurffCpp/DataMatrices/MatricesData.h>
+#include <SmurffCpp/DataTensors/CSFTensorData.h>
 
 //noise classes
 #include <SmurffCpp/Configs/NoiseConfig.h>
@@ -48,6 +49,14 @@ std::shared_ptr<Data> DataCreator::create(std::shared_ptr<const TensorConfig> tc
       THROWERROR("Tensor config does not support aux data");
    }
 
+   //compressed sparse fiber trees instead of one SparseMode per mode
+   if (m_session->getConfig().getCSFTensor())
+   {
+      std::shared_ptr<CSFTensorData> tensorData = std::make_shared<CSFTensorData>(*tc);
+      tensorData->setNoiseModel(NoiseFactory::create_noise_model(tc->getNoiseConfig()));
+      return tensorData;
+   }
+
    //create creator
    std::shared_ptr<DataCreatorBase> creatorBase = std::make_shared<DataCreatorBase>();
 
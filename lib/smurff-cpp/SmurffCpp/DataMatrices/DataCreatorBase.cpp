@@ -5,6 +5,8 @@
 //matrix classes
 #include <SmurffCpp/DataMatrices/SparseMatrixData.h>
 #include <SmurffCpp/DataMatrices/ScarceMatrixData.h>
+#include <SmurffCpp/DataMatrices/SparseBinaryMatrixData.h>
+#include <SmurffCpp/DataMatrices/ScarceBinaryMatrixData.h>
 #include <SmurffCpp/DataMatrices/DenseMatrixData.h>
 
 //tensor classes
@@ -23,25 +25,30 @@ std::shared_ptr<Data> DataCreatorBase::create(std::shared_ptr<const MatrixConfig
    if (mc->isDense())
    {
       Eigen::MatrixXd Ytrain = matrix_utils::dense_to_eigen(*mc);
-      std::shared_ptr<MatrixData> local_data_ptr(new DenseMatrixData(Ytrain));
+      std::shared_ptr<MatrixData> local_data_ptr(new DenseMatrixData(std::move(Ytrain)));
       local_data_ptr->setNoiseModel(noise);
       return local_data_ptr;
    }
    else
    {
-      Eigen::SparseMatrix<double> Ytrain = matrix_utils::sparse_to_eigen(*mc);
+      SparseStorage Ytrain(*mc);
+      std::shared_ptr<MatrixData> local_data_ptr;
       if (!mc->isScarce())
       {
-         std::shared_ptr<MatrixData> local_data_ptr(new SparseMatrixData(Ytrain));
-         local_data_ptr->setNoiseModel(noise);
-         return local_data_ptr;
+         if (Ytrain.isBinary())
+            local_data_ptr = std::make_shared<SparseBinaryMatrixData>(std::move(Ytrain));
+         else
+            local_data_ptr = std::make_shared<SparseMatrixData>(std::move(Ytrain));
       }
       else
       {
-         std::shared_ptr<MatrixData> local_data_ptr(new ScarceMatrixData(Ytrain));
-         local_data_ptr->setNoiseModel(noise);
-         return local_data_ptr;
+         if (Ytrain.isBinary())
+            local_data_ptr = std::make_shared<ScarceBinaryMatrixData>(std::move(Ytrain));
+         else
+            local_data_ptr = std::make_shared<ScarceMatrixData>(std::move(Ytrain));
       }
+      local_data_ptr->setNoiseModel(noise);
+      return local_data_ptr;
    }
 }
 
@@ -1,22 +1,53 @@
 #include "DenseMatrixData.h"
 
+#include <algorithm>
+
 using namespace smurff;
 using namespace Eigen;
 
 DenseMatrixData::DenseMatrixData(MatrixXd Y)
-   : FullMatrixData<MatrixXd>(Y)
+   : FullMatrixData<MatrixXd>(std::move(Y))
 {
     this->name = "DenseMatrixData [fully known]";
 }
 
+void DenseMatrixData::update_pnm(const SubModel& model, uint32_t mode)
+{
+    FullMatrixData<MatrixXd>::update_pnm(model, mode);
+
+    auto &ns = noise();
+    if (ns.isGaussian())
+        RR[mode].noalias() = ns.getAlpha() * (*model.CVbegin(mode) * this->Y(mode));
+    else
+        RR[mode].resize(0, 0);
+}
+
 //d is an index of column in U matrix
 void DenseMatrixData::getMuLambda(const SubModel& model, uint32_t mode, int d, VectorXd& rr, MatrixXd& MM) const
 {
+    getMuLambdaRange(model, mode, d, 0, col_nnz(mode, d), rr, MM);
+}
+
+//only rows [from, to) of column d
+void DenseMatrixData::getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM) const
+{
+    auto &ns = noise();
+
+    if (RR[mode].size())
+    {
+        // precomputed in update_pnm, the whole column goes with the first range
+        if (from == 0)
+        {
+            rr.noalias() += RR[mode].col(d);
+            MM.noalias() += ns.getAlpha() * VV[mode]; // MM = MM + VV[m]
+        }
+        return;
+    }
+
     auto &Y = this->Y(mode).col(d);
     auto Vf = *model.CVbegin(mode);
-    auto &ns = noise();
 
-    for(int r = 0; r<Y.rows(); ++r) 
+    for(int r = from; r < (int)to; ++r) 
     {
         const auto &col = Vf.col(r);
         PVec<> pos = this->pos(mode, d, r);
@@ -24,7 +55,13 @@ void DenseMatrixData::getMuLambda(const SubModel& model, uint32_t mode, int d, V
         rr.noalias() += col * noisy_val; // rr = rr + (V[m] * noisy_y[d]) 
     }
 
-    MM.noalias() += ns.getAlpha() * VV[mode]; // MM = MM + VV[m]
+    if (from == 0)
+        MM.noalias() += ns.getAlpha() * VV[mode]; // MM = MM + VV[m]
+}
+
+std::uint64_t DenseMatrixData::col_nnz(uint32_t mode, int d) const
+{
+    return this->Y(mode).rows();
 }
 
 double DenseMatrixData::train_rmse(const SubModel& model) const
@@ -48,18 +85,14 @@ double DenseMatrixData::var_total() const
 }
 
 // for the adaptive gaussian noise
+//
+// sum (pred - y)^2 = sum pred^2 - 2 * sum y .* pred + sum y^2
+// where sum y .* pred = sum (U * Y) .* V is one GEMM
 double DenseMatrixData::sumsq(const SubModel& model) const
 {
-   double sumsq = 0.0;
-
-   #pragma omp parallel for schedule(guided) reduction(+:sumsq)
-   for (int j = 0; j < this->ncol(); j++) 
-   {
-      for (int i = 0; i < this->nrow(); i++) 
-      {
-         sumsq += std::pow(model.predict({i,j}) - this->Y()(i,j), 2);
-      }
-   }
+   const double sum_y_pred = (model.U(0) * Y()).cwiseProduct(model.U(1)).sum();
+   const double sumsq = sum_predictions_squared(model) - 2.0 * sum_y_pred + Y().squaredNorm();
 
-   return sumsq;
+   // rounding can make a tiny sum negative
+   return std::max(sumsq, 0.0);
 }
@@ -6,9 +6,17 @@ namespace smurff
 {
    class DenseMatrixData : public FullMatrixData<Eigen::MatrixXd>
    {
+   private:
+      // alpha * V * Y(mode): rr of all columns of a mode with Gaussian noise,
+      // computed with one GEMM in update_pnm, empty for other noise
+      Eigen::MatrixXd RR[2];
+
    public:
       DenseMatrixData(Eigen::MatrixXd Y);
+      void update_pnm(const SubModel& model, std::uint32_t mode) override;
       void getMuLambda(const SubModel& model, std::uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
+      std::uint64_t col_nnz(std::uint32_t mode, int d) const override;
+      void getMuLambdaRange(const SubModel& model, std::uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
 
    public:
       double train_rmse(const SubModel& model) const override;
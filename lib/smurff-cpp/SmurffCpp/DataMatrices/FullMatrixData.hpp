@@ -17,7 +17,7 @@ namespace smurff
 
    public:
       FullMatrixData(YType Y) 
-         : MatrixDataTempl<YType>(Y)
+         : MatrixDataTempl<YType>(std::move(Y))
       {
          this->name = "MatrixData [fully known]";
       }
@@ -45,5 +45,17 @@ namespace smurff
       {
          return 0;
       }
+
+   protected:
+      // sum of the squared predictions of all cells, without predicting each cell:
+      // sum_ij (u_i' v_j)^2 = trace((U U') (V V'))
+      //
+      // VV is not used here: VV[0] is stale once mode 1 has been sampled
+      static double sum_predictions_squared(const SubModel& model)
+      {
+         const Eigen::MatrixXd UU = model.U(0) * model.U(0).transpose();
+         const Eigen::MatrixXd VV = model.U(1) * model.U(1).transpose();
+         return UU.cwiseProduct(VV).sum();
+      }
    };
 }
@@ -1,5 +1,7 @@
 #include "MatricesData.h"
 
+#include <algorithm>
+
 #include <SmurffCpp/Utils/Error.h>
 
 using namespace smurff;
@@ -120,6 +122,41 @@ void MatricesData::getMuLambda(const SubModel& model, uint32_t mode, int pos, Ei
    THROWERROR_ASSERT(count > 0);
 }
 
+std::uint64_t MatricesData::col_nnz(uint32_t mode, int pos) const
+{
+   std::uint64_t nnz = 0;
+   apply(mode, pos, [mode, pos, &nnz](const Block &b) {
+       nnz += b.data()->col_nnz(mode, pos - b.start(mode));
+   });
+   return nnz;
+}
+
+//items are numbered block after block, in the order of apply
+//each block gets the part of [from, to) that overlaps with its own items
+void MatricesData::getMuLambdaRange(const SubModel& model, uint32_t mode, int pos, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const
+{
+   const std::uint64_t total = col_nnz(mode, pos);
+   std::uint64_t off = 0;
+   int count = 0;
+   apply(mode, pos, [&](const Block &b) {
+       const int d = pos - b.start(mode);
+       const std::uint64_t n = b.data()->col_nnz(mode, d);
+       const std::uint64_t b_from = std::min(std::max(from, off), off + n) - off;
+       const std::uint64_t b_to = std::max(std::min(to, off + n), off) - off;
+
+       // the part that starts at (or before) this block also adds its
+       // item-independent terms, even if the block has no items
+       const bool first = from <= off && (off < to || to == total);
+       if (b_from < b_to || first)
+          b.data()->getMuLambdaRange(b.submodel(model), mode, d, b_from, b_to, rr, MM);
+
+       off += n;
+       count++;
+   });
+
+   THROWERROR_ASSERT(count > 0);
+}
+
 void MatricesData::update_pnm(const SubModel& model, uint32_t mode)
 {
    for(auto &b : blocks) {
@@ -25,6 +25,8 @@ namespace smurff
       // update noise and precision/mean
       void update(const SubModel& model) override;
       void getMuLambda(const SubModel& model, uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
+      std::uint64_t col_nnz(uint32_t mode, int d) const override;
+      void getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
       void update_pnm(const SubModel& model, uint32_t mode) override;
 
       //-- print info
@@ -8,6 +8,8 @@
 //matrix classes
 #include <SmurffCpp/DataMatrices/SparseMatrixData.h>
 #include <SmurffCpp/DataMatrices/ScarceMatrixData.h>
+#include <SmurffCpp/DataMatrices/SparseBinaryMatrixData.h>
+#include <SmurffCpp/DataMatrices/ScarceBinaryMatrixData.h>
 #include <SmurffCpp/DataMatrices/DenseMatrixData.h>
 #include <SmurffCpp/DataMatrices/MatricesData.h>
 
@@ -24,25 +26,30 @@ std::shared_ptr<MatrixData> create_matrix_data(std::shared_ptr<const MatrixConfi
    if (matrixConfig->isDense())
    {
       Eigen::MatrixXd Ytrain = matrix_utils::dense_to_eigen(*matrixConfig);
-      std::shared_ptr<MatrixData> local_data_ptr(new DenseMatrixData(Ytrain));
+      std::shared_ptr<MatrixData> local_data_ptr(new DenseMatrixData(std::move(Ytrain)));
       local_data_ptr->setNoiseModel(noise);
       return local_data_ptr;
    }
    else
    {
-      Eigen::SparseMatrix<double> Ytrain = matrix_utils::sparse_to_eigen(*matrixConfig);
+      SparseStorage Ytrain(*matrixConfig);
+      std::shared_ptr<MatrixData> local_data_ptr;
       if (!matrixConfig->isScarce())
       {
-         std::shared_ptr<MatrixData> local_data_ptr(new SparseMatrixData(Ytrain));
-         local_data_ptr->setNoiseModel(noise);
-         return local_data_ptr;
+         if (Ytrain.isBinary())
+            local_data_ptr = std::make_shared<SparseBinaryMatrixData>(std::move(Ytrain));
+         else
+            local_data_ptr = std::make_shared<SparseMatrixData>(std::move(Ytrain));
       }
       else
       {
-         std::shared_ptr<MatrixData> local_data_ptr(new ScarceMatrixData(Ytrain));
-         local_data_ptr->setNoiseModel(noise);
-         return local_data_ptr;
+         if (Ytrain.isBinary())
+            local_data_ptr = std::make_shared<ScarceBinaryMatrixData>(std::move(Ytrain));
+         else
+            local_data_ptr = std::make_shared<ScarceMatrixData>(std::move(Ytrain));
       }
+      local_data_ptr->setNoiseModel(noise);
+      return local_data_ptr;
    }
 }
 
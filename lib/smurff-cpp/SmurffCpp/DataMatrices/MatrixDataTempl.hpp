@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "MatrixData.h"
+#include "SparseStorage.h"
 
 #include <SmurffCpp/Utils/Error.h>
 
@@ -20,7 +21,7 @@ namespace smurff
       {
          m_Yv = std::shared_ptr<std::vector<YType> >(new std::vector<YType>());
          m_Yv->push_back(Y.transpose());
-         m_Yv->push_back(Y);
+         m_Yv->push_back(std::move(Y));
       }
 
       void init_pre() override
@@ -49,4 +50,45 @@ namespace smurff
          return m_Yv->operator[](mode);
       }
    };
+
+   // sparse data: one SparseStorage serves both modes, instead of a copy
+   // of Y and of Y transposed
+   template<>
+   class MatrixDataTempl<SparseStorage> : public MatrixData
+   {
+   private:
+      SparseStorage m_Y;
+
+   public:
+      MatrixDataTempl(SparseStorage Y)
+         : m_Y(std::move(Y))
+      {
+      }
+
+      void init_pre() override
+      {
+         THROWERROR_ASSERT(nrow() > 0 && ncol() > 0);
+      }
+
+      PVec<> dim() const override
+      {
+         return PVec<>({ static_cast<int>(m_Y.rows()), static_cast<int>(m_Y.cols()) });
+      }
+
+      std::uint64_t nnz() const override
+      {
+         return m_Y.nonZeros();
+      }
+
+      double sum() const override
+      {
+         return m_Y.sum();
+      }
+
+   public:
+      const SparseStorage& Y() const
+      {
+         return m_Y;
+      }
+   };
 }
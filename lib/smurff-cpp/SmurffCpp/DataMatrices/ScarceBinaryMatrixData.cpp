@@ -0,0 +1,42 @@
+#include "ScarceBinaryMatrixData.h"
+
+#include <SmurffCpp/VMatrixExprIterator.hpp>
+#include <SmurffCpp/ConstVMatrixExprIterator.hpp>
+
+using namespace smurff;
+using namespace Eigen;
+
+ScarceBinaryMatrixData::ScarceBinaryMatrixData(SparseStorage Y)
+   : ScarceMatrixData(std::move(Y))
+{
+   THROWERROR_ASSERT_MSG(this->Y().isBinary(), "ScarceBinaryMatrixData needs binary data");
+   name = "ScarceBinaryMatrixData [with NAs]";
+}
+
+void ScarceBinaryMatrixData::getMuLambdaRange(const SubModel& model, std::uint32_t mode, int n, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM) const
+{
+   getMuLambdaRangeOf<UnitValue>(model, mode, n, from, to, rr, MM);
+}
+
+// all known values are 1: the variance is 0, which ScarceMatrixData
+// replaces by 1.0 as well
+double ScarceBinaryMatrixData::var_total() const
+{
+   return 1.0;
+}
+
+double ScarceBinaryMatrixData::sumsq(const SubModel& model) const
+{
+   double sumsq = 0.0;
+
+   #pragma omp parallel for schedule(guided) reduction(+:sumsq)
+   for (std::uint64_t r = 0; r < Y().rows(); r++)
+   {
+      for (std::uint64_t i = Y().begin(0, r); i < Y().end(0, r); ++i)
+      {
+         sumsq += std::pow(model.predict({static_cast<int>(r), static_cast<int>(Y().index(0, i))}) - 1.0, 2);
+      }
+   }
+
+   return sumsq;
+}
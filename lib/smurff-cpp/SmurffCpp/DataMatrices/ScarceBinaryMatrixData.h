@@ -0,0 +1,22 @@
+#pragma once
+
+#include "ScarceMatrixData.h"
+
+namespace smurff
+{
+   // scarce matrix where every known value is 1, stored as a binary
+   // SparseStorage without values
+   class ScarceBinaryMatrixData : public ScarceMatrixData
+   {
+   public:
+      ScarceBinaryMatrixData(SparseStorage Y);
+
+   public:
+      void getMuLambdaRange(const SubModel& model, std::uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
+
+   public:
+      double var_total() const override;
+
+      double sumsq(const SubModel& model) const override;
+   };
+}
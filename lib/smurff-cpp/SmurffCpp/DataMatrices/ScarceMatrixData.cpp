@@ -3,29 +3,34 @@
 #include <SmurffCpp/VMatrixExprIterator.hpp>
 #include <SmurffCpp/ConstVMatrixExprIterator.hpp>
 
-#include <SmurffCpp/Utils/ThreadVector.hpp>
+#include <SmurffCpp/Utils/NumLatent.hpp>
+#include <SmurffCpp/Utils/Panel.hpp>
 
 using namespace smurff;
 using namespace Eigen;
 
-ScarceMatrixData::ScarceMatrixData(SparseMatrix<double> Y)
-   : MatrixDataTempl<SparseMatrix<double> >(Y)
+ScarceMatrixData::ScarceMatrixData(SparseStorage Y)
+   : MatrixDataTempl<SparseStorage>(std::move(Y))
 {
    name = "ScarceMatrixData [with NAs]";
 }
 
+ScarceMatrixData::ScarceMatrixData(const SparseMatrix<double>& Y)
+   : ScarceMatrixData(SparseStorage(Y))
+{
+}
+
 void ScarceMatrixData::init_pre()
 {
-   MatrixDataTempl<SparseMatrix<double> >::init_pre();
+   MatrixDataTempl<SparseStorage>::init_pre();
 
    // check no rows, nor cols withouth data
    for(std::uint64_t mode = 0; mode < nmode(); ++mode)
    {
-      auto& m = this->Y(mode);
       auto& count = num_empty[mode];
-      for (int j = 0; j < m.cols(); j++)
+      for (std::uint64_t j = 0; j < Y().dim(mode); j++)
       {
-         if (m.col(j).nonZeros() == 0) 
+         if (Y().nnz(mode, j) == 0) 
             count++;
       }
    }
@@ -38,73 +43,122 @@ double ScarceMatrixData::train_rmse(const SubModel& model) const
 
 std::ostream& ScarceMatrixData::info(std::ostream& os, std::string indent)
 {
-    MatrixDataTempl<SparseMatrix<double> >::info(os, indent);
+    MatrixDataTempl<SparseStorage>::info(os, indent);
     if (num_empty[0]) os << indent << "  Warning: " << num_empty[0] << " empty rows\n";
     if (num_empty[1]) os << indent << "  Warning: " << num_empty[1] << " empty cols\n";
     return os;
 }
 
-void ScarceMatrixData::getMuLambda(const SubModel& model, std::uint32_t mode, int n, VectorXd& rr, MatrixXd& MM) const
+template<typename Value>
+struct ScarceMatrixData::GetMuLambdaKernel
 {
-   auto &Y = this->Y(mode);
-   const int num_latent = model.nlatent();
-   const std::int64_t local_nnz = Y.col(n).nonZeros();
-   const std::int64_t total_nnz = Y.nonZeros();
-   auto from = Y.outerIndexPtr()[n];
-   auto to = Y.outerIndexPtr()[n+1];
-
-   auto getMuLambdaBasic = [&model, this, mode, n](int from, int to, VectorXd& rr, MatrixXd& MM) -> void
-   {
-       auto &Y = this->Y(mode);
-       auto Vf = *model.CVbegin(mode);
-       auto &ns = noise();
-
-       for(int i = from; i < to; ++i)
-       {
-           auto val = Y.valuePtr()[i];
-           auto idx = Y.innerIndexPtr()[i];
-           const auto &col = Vf.col(idx);
-           auto pos = this->pos(mode, n, idx);
-           double noisy_val = ns.sample(model, pos, val);
-           rr.noalias() += col * noisy_val;
-           MM.triangularView<Lower>() +=  ns.getAlpha() * col * col.transpose();
-       }
-
-       // make MM complete
-       MM.triangularView<Upper>() = MM.transpose();
-    };
-
-   
-
-   bool in_parallel = (local_nnz >10000) || ((double)local_nnz > (double)total_nnz / 100.);
-   if (in_parallel) 
-   {
-       const int task_size = ceil(local_nnz / 100.0);
-       thread_vector<VectorXd> rrs(VectorXd::Zero(num_latent));
-       thread_vector<MatrixXd> MMs(MatrixXd::Zero(num_latent, num_latent));
-
-       for(int j = from; j < to; j += task_size) 
-       {
-           #pragma omp task shared(rrs, MMs)
-           getMuLambdaBasic(j, std::min(j + task_size, to), rrs.local(), MMs.local());
-       }
-       #pragma omp taskwait
-       
-       // accumulate 
-       MM += MMs.combine();
-       rr += rrs.combine();
-   } 
-   else 
+   template<int K>
+   struct type
    {
-      VectorXd my_rr = VectorXd::Zero(num_latent);
-      MatrixXd my_MM = MatrixXd::Zero(num_latent, num_latent);
+      typedef Eigen::Matrix<double, K, 1> Vector;
+      typedef Eigen::Matrix<double, K, K> Matrix;
+
+      // on the stack for fixed K
+      enum { MaxPanelCols = panel_max_cols(K) };
+      typedef Eigen::Matrix<double, K, Eigen::Dynamic, Eigen::ColMajor, K, MaxPanelCols> Panel;
+
+      //accumulates items [from, to) of column n into rr and MM
+      //
+      //the columns of V of the items are gathered in a panel, which updates
+      //MM with one rank-b update (syrk) and rr with one matrix-vector product,
+      //or with the sum of the columns if every value is 1 and the noise Gaussian
+      static void run(const ScarceMatrixData& data, const SubModel& model, std::uint32_t mode, int n, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM)
+      {
+         const Value value{};
+         const int num_latent = model.nlatent();
+         auto &Y = data.Y();
+         auto Vf = *model.CVbegin(mode);
+         auto &ns = data.noise();
+         const bool gaussian = ns.isGaussian();
+         const double alpha = ns.getAlpha();
+         const std::uint64_t offset = Y.begin(mode, n);
+
+         // fixed size: on the stack
+         Vector my_rr = Vector::Zero(num_latent);
+         Matrix my_MM = Matrix::Zero(num_latent, num_latent);
+
+         if (to - from < PANEL_MIN_ITEMS)
+         {
+            // too few items for a panel: one at a time
+            for(std::uint64_t i = offset + from; i < offset + to; ++i)
+            {
+               auto val = value(Y, mode, i);
+               auto idx = Y.index(mode, i);
+               Map<const Vector> col(Vf.col(idx).data(), num_latent);
+               double noisy_val = gaussian ? alpha * val : ns.sample(model, data.pos(mode, n, idx), val);
+               my_rr.noalias() += col * noisy_val;
+               my_MM.template triangularView<Lower>() += alpha * col * col.transpose();
+            }
+         }
+         else
+         {
+            const std::uint64_t width = std::min<std::uint64_t>(panel_width(num_latent), to - from);
+            Panel panel(num_latent, width);
+            Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, MaxPanelCols, 1> vals(width);
+
+            for(std::uint64_t i = offset + from; i < offset + to; i += width)
+            {
+               const int w = std::min(width, offset + to - i);
+               for(int j = 0; j < w; ++j)
+               {
+                  auto val = value(Y, mode, i + j);
+                  auto idx = Y.index(mode, i + j);
+                  panel.col(j) = Map<const Vector>(Vf.col(idx).data(), num_latent);
+
+                  // gaussian: alpha * val, the alpha is applied to rr below
+                  if (!gaussian)
+                     vals(j) = ns.sample(model, data.pos(mode, n, idx), val);
+                  else if (!Value::unit)
+                     vals(j) = val;
+               }
+
+               my_MM.template selfadjointView<Lower>().rankUpdate(panel.leftCols(w), alpha);
+               if (gaussian && Value::unit)
+                  my_rr.noalias() += alpha * panel.leftCols(w).rowwise().sum();
+               else if (gaussian)
+                  my_rr.noalias() += alpha * (panel.leftCols(w) * vals.head(w));
+               else
+                  my_rr.noalias() += panel.leftCols(w) * vals.head(w);
+            }
+         }
+
+         // make MM complete
+         my_MM.template triangularView<Upper>() = my_MM.transpose();
+
+         // add to global
+         rr += my_rr;
+         MM += my_MM;
+      }
+   };
+};
 
-      getMuLambdaBasic(from, to, my_rr, my_MM);
+template<typename Value>
+void ScarceMatrixData::getMuLambdaRangeOf(const SubModel& model, std::uint32_t mode, int n, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM) const
+{
+   dispatch_num_latent<GetMuLambdaKernel<Value>::template type>(model.nlatent(), *this, model, mode, n, from, to, rr, MM);
+}
 
-      // add to global
-      rr += my_rr;
-      MM += my_MM;
-   }
+template void ScarceMatrixData::getMuLambdaRangeOf<ScarceMatrixData::StoredValue>(const SubModel&, std::uint32_t, int, std::uint64_t, std::uint64_t, VectorXd&, MatrixXd&) const;
+template void ScarceMatrixData::getMuLambdaRangeOf<ScarceMatrixData::UnitValue>(const SubModel&, std::uint32_t, int, std::uint64_t, std::uint64_t, VectorXd&, MatrixXd&) const;
+
+void ScarceMatrixData::getMuLambda(const SubModel& model, std::uint32_t mode, int n, VectorXd& rr, MatrixXd& MM) const
+{
+   getMuLambdaRange(model, mode, n, 0, col_nnz(mode, n), rr, MM);
+}
+
+void ScarceMatrixData::getMuLambdaRange(const SubModel& model, std::uint32_t mode, int n, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM) const
+{
+   getMuLambdaRangeOf<StoredValue>(model, mode, n, from, to, rr, MM);
+}
+
+std::uint64_t ScarceMatrixData::col_nnz(std::uint32_t mode, int n) const
+{
+   return Y().nnz(mode, n);
 }
 
 void ScarceMatrixData::update_pnm(const SubModel &, std::uint32_t mode)
@@ -122,13 +176,10 @@ double ScarceMatrixData::var_total() const
    double cwise_mean = this->sum() / this->nnz();
    double se = 0.0;
 
-   #pragma omp parallel for schedule(guided) reduction(+:se)
-   for (int k = 0; k < Y().outerSize(); ++k)
+   #pragma omp parallel for schedule(static) reduction(+:se)
+   for (std::uint64_t i = 0; i < Y().nonZeros(); ++i)
    {
-      for (SparseMatrix<double>::InnerIterator it(Y(), k); it; ++it)
-      {
-         se += std::pow(it.value() - cwise_mean, 2);
-      }
+      se += std::pow(Y().value(0, i) - cwise_mean, 2);
    }
 
    double var = se / this->nnz();
@@ -146,11 +197,11 @@ double ScarceMatrixData::sumsq(const SubModel& model) const
    double sumsq = 0.0;
 
    #pragma omp parallel for schedule(guided) reduction(+:sumsq)
-   for (int j = 0; j < Y().outerSize(); j++) 
+   for (std::uint64_t r = 0; r < Y().rows(); r++) 
    {
-      for (SparseMatrix<double>::InnerIterator it(Y(), j); it; ++it) 
+      for (std::uint64_t i = Y().begin(0, r); i < Y().end(0, r); ++i) 
       {
-         sumsq += std::pow(model.predict({static_cast<int>(it.row()), static_cast<int>(it.col())})- it.value(), 2);
+         sumsq += std::pow(model.predict({static_cast<int>(r), static_cast<int>(Y().index(0, i))})- Y().value(0, i), 2);
       }
    }
 
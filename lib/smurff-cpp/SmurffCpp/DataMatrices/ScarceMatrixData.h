@@ -4,13 +4,36 @@
 
 namespace smurff
 {
-   class ScarceMatrixData : public MatrixDataTempl<Eigen::SparseMatrix<double> >
+   class ScarceMatrixData : public MatrixDataTempl<SparseStorage>
    {
+   protected:
+      // value of item i of mode for getMuLambda: the stored one, or 1 for
+      // binary storage, which has no values
+      struct StoredValue
+      {
+         static constexpr bool unit = false;
+         double operator()(const SparseStorage& Y, std::uint32_t mode, std::uint64_t i) const { return Y.value(mode, i); }
+      };
+
+      struct UnitValue
+      {
+         static constexpr bool unit = true;
+         double operator()(const SparseStorage&, std::uint32_t, std::uint64_t) const { return 1.0; }
+      };
+
+      // getMuLambdaRange with the values of the items from Value
+      template<typename Value>
+      void getMuLambdaRangeOf(const SubModel& model, std::uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const;
+
    private:
       int num_empty[2] = {0,0};
 
+      // getMuLambda specialized on the values and num_latent
+      template<typename Value> struct GetMuLambdaKernel;
+
    public:
-      ScarceMatrixData(Eigen::SparseMatrix<double> Y);
+      ScarceMatrixData(SparseStorage Y);
+      ScarceMatrixData(const Eigen::SparseMatrix<double>& Y);
 
    public:
       void init_pre() override;
@@ -20,6 +43,8 @@ namespace smurff
       std::ostream& info(std::ostream& os, std::string indent) override;
 
       void getMuLambda(const SubModel& model, std::uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
+      std::uint64_t col_nnz(std::uint32_t mode, int d) const override;
+      void getMuLambdaRange(const SubModel& model, std::uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
       void update_pnm(const SubModel& model, std::uint32_t mode) override;
 
       std::uint64_t nna() const override;
@@ -0,0 +1,91 @@
+#include "SparseBinaryMatrixData.h"
+
+#include <algorithm>
+
+#include <SmurffCpp/Utils/NumLatent.hpp>
+
+using namespace smurff;
+using namespace Eigen;
+
+SparseBinaryMatrixData::SparseBinaryMatrixData(SparseStorage Y)
+   : SparseMatrixData(std::move(Y))
+{
+   THROWERROR_ASSERT_MSG(this->Y().isBinary(), "SparseBinaryMatrixData needs binary data");
+   this->name = "SparseBinaryMatrixData [fully known]";
+}
+
+template<int K>
+struct SparseBinaryMatrixData::GetMuLambdaKernel
+{
+   typedef Eigen::Matrix<double, K, 1> Vector;
+
+   //accumulates items [from, to) of column d into rr and MM
+   //
+   //every stored value is 1: with Gaussian noise rr is alpha times the
+   //sum of the columns of V
+   static void run(const SparseBinaryMatrixData& data, const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM)
+   {
+      const int num_latent = model.nlatent();
+      const auto& Y = data.Y();
+      auto Vf = *model.CVbegin(mode);
+      auto &ns = data.noise();
+      const bool gaussian = ns.isGaussian();
+      const double alpha = ns.getAlpha();
+      auto offset = Y.begin(mode, d);
+
+      Vector my_rr = Vector::Zero(num_latent);
+      for (std::uint64_t i = offset + from; i < offset + to; ++i)
+      {
+         auto row = Y.index(mode, i);
+         Map<const Vector> col(Vf.col(row).data(), num_latent);
+         if (gaussian)
+            my_rr.noalias() += col;
+         else
+            my_rr.noalias() += col * ns.sample(model, data.pos(mode, d, row), 1.0);
+      }
+
+      if (gaussian)
+         rr.noalias() += alpha * my_rr; // rr = rr + (V[m] * y[d]) * alpha
+      else
+         rr.noalias() += my_rr;
+
+      if (from == 0)
+         MM.noalias() += alpha * data.VV[mode]; // MM = MM + VV[m]
+   }
+};
+
+void SparseBinaryMatrixData::getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM) const
+{
+   dispatch_num_latent<GetMuLambdaKernel>(model.nlatent(), *this, model, mode, d, from, to, rr, MM);
+}
+
+// fraction p of 1s: nnz cells at (1 - p)^2 and the others at p^2
+double SparseBinaryMatrixData::var_total() const
+{
+   const double p = (double)this->nnz() / this->size();
+   double var = p * (1.0 - p);
+   if (var <= 0.0 || std::isnan(var))
+   {
+      // if var cannot be computed using 1.0
+      var = 1.0;
+   }
+
+   return var;
+}
+
+// all cells as if Y was zero, then correct the 1s:
+// (pred - 1)^2 = pred^2 + 1 - 2 * pred
+double SparseBinaryMatrixData::sumsq(const SubModel& model) const
+{
+   double sumsq = sum_predictions_squared(model);
+
+   #pragma omp parallel for schedule(guided) reduction(+:sumsq)
+   for(std::uint64_t r = 0; r < Y().rows(); ++r)
+   {
+      for (std::uint64_t i = Y().begin(0, r); i < Y().end(0, r); ++i)
+         sumsq += 1.0 - 2.0 * model.predict({(int)r, (int)Y().index(0, i)});
+   }
+
+   // rounding can make a tiny sum negative
+   return std::max(sumsq, 0.0);
+}
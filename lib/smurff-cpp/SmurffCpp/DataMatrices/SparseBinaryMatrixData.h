@@ -0,0 +1,26 @@
+#pragma once
+
+#include "SparseMatrixData.h"
+
+namespace smurff
+{
+   // fully known matrix of 0s and 1s, where the 1s are stored as a binary
+   // SparseStorage without values
+   class SparseBinaryMatrixData : public SparseMatrixData
+   {
+   private:
+      // getMuLambda specialized on num_latent
+      template<int K> struct GetMuLambdaKernel;
+
+   public:
+      SparseBinaryMatrixData(SparseStorage Y);
+
+   public:
+      void getMuLambdaRange(const SubModel& model, std::uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
+
+   public:
+      double var_total() const override;
+
+      double sumsq(const SubModel& model) const override;
+   };
+}
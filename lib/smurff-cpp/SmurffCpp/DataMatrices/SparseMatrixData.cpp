@@ -1,29 +1,65 @@
 #include "SparseMatrixData.h"
 
+#include <algorithm>
+
+#include <SmurffCpp/Utils/NumLatent.hpp>
+
 using namespace smurff;
 using namespace Eigen;
 
-SparseMatrixData::SparseMatrixData(SparseMatrix<double> Y)
-   : FullMatrixData<SparseMatrix<double>>(Y)
+SparseMatrixData::SparseMatrixData(SparseStorage Y)
+   : FullMatrixData<SparseStorage>(std::move(Y))
 {
    this->name = "SparseMatrixData [fully known]";
 }
 
+SparseMatrixData::SparseMatrixData(const SparseMatrix<double>& Y)
+   : SparseMatrixData(SparseStorage(Y))
+{
+}
+
+template<int K>
+struct SparseMatrixData::GetMuLambdaKernel
+{
+   typedef Eigen::Matrix<double, K, 1> Vector;
+
+   //accumulates items [from, to) of column d into rr and MM
+   static void run(const SparseMatrixData& data, const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM)
+   {
+      const int num_latent = model.nlatent();
+      const auto& Y = data.Y();
+      auto Vf = *model.CVbegin(mode);
+      auto &ns = data.noise();
+      auto offset = Y.begin(mode, d);
+
+      Map<Vector> rr_k(rr.data(), num_latent);
+      for (std::uint64_t i = offset + from; i < offset + to; ++i)
+      {
+         auto row = Y.index(mode, i);
+         Map<const Vector> col(Vf.col(row).data(), num_latent);
+         auto p = data.pos(mode, d, row);
+         double noisy_val = ns.sample(model, p, Y.value(mode, i));
+         rr_k.noalias() += col * noisy_val; // rr = rr + (V[m] * y[d]) * alpha
+      }
+
+      if (from == 0)
+         MM.noalias() += ns.getAlpha() * data.VV[mode]; // MM = MM + VV[m]
+   }
+};
+
 void SparseMatrixData::getMuLambda(const SubModel& model, uint32_t mode, int d, VectorXd& rr, MatrixXd& MM) const
 {
-    const auto& Y = this->Y(mode);
-    auto Vf = *model.CVbegin(mode);
-    auto &ns = noise();
-
-    for (SparseMatrix<double>::InnerIterator it(Y, d); it; ++it) 
-    {
-        const auto &col = Vf.col(it.row());
-        auto p = pos(mode, d, it.row());
-        double noisy_val = ns.sample(model, p, it.value());
-        rr.noalias() += col * noisy_val; // rr = rr + (V[m] * y[d]) * alpha
-    }
-
-    MM.noalias() += ns.getAlpha() * VV[mode]; // MM = MM + VV[m]
+   getMuLambdaRange(model, mode, d, 0, col_nnz(mode, d), rr, MM);
+}
+
+void SparseMatrixData::getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM) const
+{
+   dispatch_num_latent<GetMuLambdaKernel>(model.nlatent(), *this, model, mode, d, from, to, rr, MM);
+}
+
+std::uint64_t SparseMatrixData::col_nnz(uint32_t mode, int d) const
+{
+   return Y().nnz(mode, d);
 }
 
 double SparseMatrixData::train_rmse(const SubModel& model) const
@@ -38,17 +74,17 @@ double SparseMatrixData::var_total() const
    double se = 0.0;
 
    #pragma omp parallel for schedule(guided) reduction(+:se)
-   for(int c = 0; c < Y().cols(); ++c)
+   for(std::uint64_t r = 0; r < Y().rows(); ++r)
    {
-      int r = 0;
-      for (SparseMatrix<double>::InnerIterator it(Y(), c); it; ++it)
+      std::int64_t c = 0;
+      for (std::uint64_t i = Y().begin(0, r); i < Y().end(0, r); ++i)
       {
-         se += (r - it.row()) * cwise_mean_squared; // handle implicit zeroes
-         se += std::pow(it.value() - cwise_mean, 2);
-         r = it.row() + 1;
+         se += (c - Y().index(0, i)) * cwise_mean_squared; // handle implicit zeroes
+         se += std::pow(Y().value(0, i) - cwise_mean, 2);
+         c = Y().index(0, i) + 1;
       }
 
-      se += (r - Y().rows()) * cwise_mean_squared; // handle implicit zeroes
+      se += (c - (std::int64_t)Y().cols()) * cwise_mean_squared; // handle implicit zeroes
    }
 
    double var = se / this->size();
@@ -61,26 +97,19 @@ double SparseMatrixData::var_total() const
    return var;
 }
 
+// all cells as if Y was zero, then correct the non-zeros:
+// (pred - y)^2 = pred^2 + y * (y - 2 * pred)
 double SparseMatrixData::sumsq(const SubModel& model) const
 {
-   double sumsq = 0.0;
-   
+   double sumsq = sum_predictions_squared(model);
+
    #pragma omp parallel for schedule(guided) reduction(+:sumsq)
-   for(int c = 0; c < Y().cols(); ++c)
+   for(std::uint64_t r = 0; r < Y().rows(); ++r)
    {
-      int r = 0;
-      for (SparseMatrix<double>::InnerIterator it(Y(), c); it; ++it)
-      {
-         for(; r < it.row(); r++) //handle implicit zeroes
-            sumsq += std::pow(model.predict({r, c}), 2);
-
-         sumsq += std::pow(model.predict({r, c}) - it.value(), 2);
-         r++;
-      }
-
-      for(; r < Y().rows(); r++) //handle implicit zeroes
-         sumsq += std::pow(model.predict({r, c}), 2);
+      for (std::uint64_t i = Y().begin(0, r); i < Y().end(0, r); ++i)
+         sumsq += Y().value(0, i) * (Y().value(0, i) - 2.0 * model.predict({(int)r, (int)Y().index(0, i)}));
    }
 
-   return sumsq;
+   // rounding can make a tiny sum negative
+   return std::max(sumsq, 0.0);
 }
@@ -4,12 +4,19 @@
 
 namespace smurff
 {
-   class SparseMatrixData : public FullMatrixData<Eigen::SparseMatrix<double> >
+   class SparseMatrixData : public FullMatrixData<SparseStorage>
    {
+   private:
+      // getMuLambda specialized on num_latent
+      template<int K> struct GetMuLambdaKernel;
+
    public:
-      SparseMatrixData(Eigen::SparseMatrix<double> Y);
+      SparseMatrixData(SparseStorage Y);
+      SparseMatrixData(const Eigen::SparseMatrix<double>& Y);
 
       void getMuLambda(const SubModel& model, std::uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
+      std::uint64_t col_nnz(std::uint32_t mode, int d) const override;
+      void getMuLambdaRange(const SubModel& model, std::uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
 
    public:
       double train_rmse(const SubModel& model) const override;
@@ -0,0 +1,177 @@
+#include "SparseStorage.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <SmurffCpp/Utils/Error.h>
+#include <SmurffCpp/Utils/omp_util.h>
+
+using namespace smurff;
+
+SparseStorage::SparseStorage(const TensorConfig& tc)
+{
+   THROWERROR_ASSERT_MSG(!tc.isDense() && tc.getNModes() == 2, "SparseStorage needs a sparse matrix");
+
+   const std::uint64_t nnz = tc.getNNZ();
+   const auto& columns = tc.getColumns();
+   const auto& values = tc.getValues();
+
+   THROWERROR_ASSERT_MSG(columns.size() == 2 * nnz && (tc.isBinary() || values.size() == nnz), "No data in " + tc.info() + ", it was released after loading");
+
+   build(tc.getDims()[0], tc.getDims()[1], nnz, columns.data(), columns.data() + nnz, values.data(), tc.isBinary(), tc.getFilename());
+}
+
+SparseStorage::SparseStorage(const Eigen::SparseMatrix<double>& Y)
+{
+   std::vector<std::uint32_t> rows, cols;
+   std::vector<double> values;
+
+   for (int k = 0; k < Y.outerSize(); ++k)
+   {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(Y, k); it; ++it)
+      {
+         rows.push_back(it.row());
+         cols.push_back(it.col());
+         values.push_back(it.value());
+      }
+   }
+
+   build(Y.rows(), Y.cols(), values.size(), rows.data(), cols.data(), values.data(), false, "");
+}
+
+// stable counting sort of items order(0) .. order(nnz - 1) by keys[item]:
+// sorted gets the items, ptr[k] the position of the first item of key k
+//
+// the items are split in chunks that are counted and scattered in parallel,
+// at most one per thread and no more than the counts of all chunks fit in
+// the memory of the items
+template<typename Order>
+static void counting_sort(std::uint64_t nnz, const Order& order, const std::uint32_t* keys, std::uint64_t nkeys,
+                          std::vector<std::uint64_t>& ptr, std::vector<std::uint32_t>& sorted)
+{
+   const std::uint64_t nchunks = std::max<std::uint64_t>(1, std::min<std::uint64_t>(threads::get_max_threads(), nnz / (nkeys + 1)));
+   std::vector<std::uint64_t> counts(nchunks * nkeys, 0); // items of key k in chunk c at counts[c * nkeys + k]
+
+   auto chunk_begin = [nnz, nchunks](std::uint64_t c) { return c * nnz / nchunks; };
+
+   #pragma omp parallel for schedule(static)
+   for (std::uint64_t c = 0; c < nchunks; c++)
+   {
+      std::uint64_t* my_counts = counts.data() + c * nkeys;
+      for (std::uint64_t s = chunk_begin(c); s < chunk_begin(c + 1); s++)
+         my_counts[keys[order(s)]]++;
+   }
+
+   //first position of key k in chunk c: the items of smaller keys and
+   //the items of key k in the chunks before c
+   ptr.resize(nkeys + 1);
+   std::uint64_t total = 0;
+   for (std::uint64_t k = 0; k < nkeys; k++)
+   {
+      ptr[k] = total;
+      for (std::uint64_t c = 0; c < nchunks; c++)
+      {
+         const std::uint64_t n = counts[c * nkeys + k];
+         counts[c * nkeys + k] = total;
+         total += n;
+      }
+   }
+   ptr[nkeys] = total;
+
+   sorted.resize(nnz);
+
+   #pragma omp parallel for schedule(static)
+   for (std::uint64_t c = 0; c < nchunks; c++)
+   {
+      std::uint64_t* my_pos = counts.data() + c * nkeys;
+      for (std::uint64_t s = chunk_begin(c); s < chunk_begin(c + 1); s++)
+      {
+         const std::uint32_t i = order(s);
+         sorted[my_pos[keys[i]]++] = i;
+      }
+   }
+}
+
+void SparseStorage::build(std::uint64_t nrow, std::uint64_t ncol, std::uint64_t nnz, const std::uint32_t* rows, const std::uint32_t* cols, const double* values, bool binary, const std::string& name)
+{
+   THROWERROR_ASSERT_MSG(nnz < std::numeric_limits<std::uint32_t>::max(), "Too many items for SparseStorage: " + std::to_string(nnz));
+
+   m_dims[0] = nrow;
+   m_dims[1] = ncol;
+   m_isBinary = binary;
+
+   std::uint64_t out_of_range = 0;
+
+   #pragma omp parallel for schedule(static) reduction(+:out_of_range)
+   for (std::uint64_t i = 0; i < nnz; i++)
+      out_of_range += rows[i] >= nrow || cols[i] >= ncol;
+
+   THROWERROR_ASSERT_MSG(out_of_range == 0, "Coordinate is larger than the dimension in " + name);
+
+   //by column, then stable by row: the items of a row are sorted by column
+   std::vector<std::uint64_t> col_ptr;
+   std::vector<std::uint32_t> by_col, by_row;
+   counting_sort(nnz, [](std::uint64_t s) { return (std::uint32_t)s; }, cols, ncol, col_ptr, by_col);
+   counting_sort(nnz, [&by_col](std::uint64_t s) { return by_col[s]; }, rows, nrow, m_ptr[0], by_row);
+   std::vector<std::uint32_t>().swap(by_col);
+
+   m_values.resize(binary ? 0 : nnz);
+   m_idx[0].resize(nnz);
+   double sum = 0.0;
+
+   #pragma omp parallel for schedule(static) reduction(+:sum)
+   for (std::uint64_t s = 0; s < nnz; s++)
+   {
+      m_idx[0][s] = cols[by_row[s]];
+      if (!binary)
+      {
+         m_values[s] = values[by_row[s]];
+         sum += m_values[s];
+      }
+   }
+   m_sum = binary ? nnz : sum;
+
+   //duplicates are next to each other in a row
+   std::uint64_t duplicates = 0;
+
+   #pragma omp parallel for schedule(guided) reduction(+:duplicates)
+   for (std::uint64_t r = 0; r < nrow; r++)
+      for (std::uint64_t s = m_ptr[0][r] + 1; s < m_ptr[0][r + 1]; s++)
+         duplicates += m_idx[0][s] == m_idx[0][s - 1];
+
+   THROWERROR_ASSERT_MSG(duplicates == 0, "probable presence of duplicate records in " + name);
+
+   //positions of the rows by column, stable: the items of a column are sorted by row
+   counting_sort(nnz, [](std::uint64_t s) { return (std::uint32_t)s; }, m_idx[0].data(), ncol, m_ptr[1], m_perm);
+
+   m_idx[1].resize(nnz);
+
+   #pragma omp parallel for schedule(static)
+   for (std::uint64_t s = 0; s < nnz; s++)
+      m_idx[1][s] = rows[by_row[m_perm[s]]];
+
+   //binary: no values to permute
+   if (binary)
+      std::vector<std::uint32_t>().swap(m_perm);
+}
+
+std::uint64_t SparseStorage::bytes() const
+{
+   return m_values.size() * sizeof(double)
+        + (m_ptr[0].size() + m_ptr[1].size()) * sizeof(std::uint64_t)
+        + (m_idx[0].size() + m_idx[1].size() + m_perm.size()) * sizeof(std::uint32_t);
+}
+
+Eigen::SparseMatrix<double> SparseStorage::to_eigen() const
+{
+   std::vector<Eigen::Triplet<double> > triplets;
+   triplets.reserve(nonZeros());
+
+   for (std::uint64_t r = 0; r < rows(); r++)
+      for (std::uint64_t i = begin(0, r); i < end(0, r); i++)
+         triplets.emplace_back(r, index(0, i), m_isBinary ? 1.0 : value(0, i));
+
+   Eigen::SparseMatrix<double> out(rows(), cols());
+   out.setFromTriplets(triplets.begin(), triplets.end());
+   return out;
+}
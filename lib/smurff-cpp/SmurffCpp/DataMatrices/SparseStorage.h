@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <Eigen/Sparse>
+
+#include <SmurffCpp/Configs/TensorConfig.h>
+
+namespace smurff
+{
+   //sparse matrix with one array of values and the indices of both modes
+   //
+   //mode 0 is the rows (CSR): the items of row d are [begin(0, d), end(0, d)),
+   //sorted by column, their values are stored in this order.
+   //mode 1 is the columns (CSC): the items of column d are [begin(1, d), end(1, d)),
+   //sorted by row, their values are read through a permutation into the
+   //values of mode 0.
+   //
+   //binary storage keeps only the indices, every value is 1.
+   class SparseStorage
+   {
+   private:
+      std::uint64_t m_dims[2];
+      double m_sum;
+      bool m_isBinary;
+
+      std::vector<double> m_values; // values by row, empty if binary
+      std::vector<std::uint64_t> m_ptr[2]; // items of hyperplane d of mode m are [m_ptr[m][d], m_ptr[m][d + 1])
+      std::vector<std::uint32_t> m_idx[2]; // coordinate in the other mode of every item of mode m
+      std::vector<std::uint32_t> m_perm; // position in m_values of every item of mode 1, empty if binary
+
+   public:
+      // from the coordinates and values of a sparse 2-mode config,
+      // binary if the config is binary
+      explicit SparseStorage(const TensorConfig& tc);
+
+      explicit SparseStorage(const Eigen::SparseMatrix<double>& Y);
+
+   private:
+      // values is not read if binary
+      void build(std::uint64_t nrow, std::uint64_t ncol, std::uint64_t nnz, const std::uint32_t* rows, const std::uint32_t* cols, const double* values, bool binary, const std::string& name);
+
+   public:
+      std::uint64_t rows() const { return m_dims[0]; }
+      std::uint64_t cols() const { return m_dims[1]; }
+      std::uint64_t dim(int mode) const { return m_dims[mode]; }
+      std::uint64_t nonZeros() const { return m_idx[0].size(); }
+      bool isBinary() const { return m_isBinary; }
+      double sum() const { return m_sum; }
+
+      // items of hyperplane d of mode
+      std::uint64_t begin(int mode, std::uint64_t d) const { return m_ptr[mode][d]; }
+      std::uint64_t end(int mode, std::uint64_t d) const { return m_ptr[mode][d + 1]; }
+      std::uint64_t nnz(int mode, std::uint64_t d) const { return end(mode, d) - begin(mode, d); }
+
+      // coordinate in the other mode and value of item i of mode,
+      // binary storage has no values: every value is 1
+      std::uint32_t index(int mode, std::uint64_t i) const { return m_idx[mode][i]; }
+      double value(int mode, std::uint64_t i) const { return m_values[mode == 0 ? i : m_perm[i]]; }
+
+      // bytes used by the values and indices
+      std::uint64_t bytes() const;
+
+      Eigen::SparseMatrix<double> to_eigen() const;
+   };
+}
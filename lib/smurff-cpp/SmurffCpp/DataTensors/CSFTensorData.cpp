@@ -0,0 +1,376 @@
+#include "CSFTensorData.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <type_traits>
+
+#include <SmurffCpp/IO/TensorIO.h>
+#include <SmurffCpp/Utils/NumModes.hpp>
+#include <SmurffCpp/Utils/Panel.hpp>
+
+using namespace Eigen;
+using namespace smurff;
+
+CSFTensorData::CSFTensorData(const smurff::TensorConfig& tc)
+   : m_dims(tc.getDims())
+{
+   // only the header of the file was read (see tensor_io::read_tensor_header)
+   std::shared_ptr<TensorConfig> fromFile;
+   if (!tc.hasData())
+      fromFile = tensor_io::read_tensor(tc.getFilename(), tc.isScarce());
+
+   auto items = std::make_shared<CSFItems>(fromFile ? *fromFile : tc);
+   fromFile.reset();
+
+   // items in the order of the leaves of the tree of mode 0, which then reads them sequentially
+   items->permute(CSFTree(items, m_dims, 0).getPerm());
+   m_items = items;
+
+   for (std::uint32_t mode = 0; mode < m_dims.size(); mode++)
+      m_trees.emplace_back(m_items, m_dims, mode);
+
+   const auto& values = m_items->values;
+   m_sum = std::accumulate(values.begin(), values.end(), 0.0);
+
+   std::uint64_t totalSize = std::accumulate(m_dims.begin(), m_dims.end(), (std::uint64_t)1, std::multiplies<std::uint64_t>());
+   this->name = totalSize == nnz() ? "CSFTensorData [fully known]" : "CSFTensorData [with NAs]";
+}
+
+const CSFTree& CSFTensorData::tree(std::uint64_t mode) const
+{
+   return m_trees.at(mode);
+}
+
+std::uint64_t CSFTensorData::bytes() const
+{
+   std::uint64_t ret = m_items->bytes();
+   for (const auto& t : m_trees)
+      ret += t.bytes();
+   return ret;
+}
+
+std::uint64_t CSFTensorData::coo_bytes() const
+{
+   // one SparseMode per mode: the other coordinates and the value of every item, and the plane pointers
+   std::uint64_t ret = 0;
+   for (auto d : m_dims)
+      ret += nnz() * (sizeof(std::uint32_t) * (nmode() - 1) + sizeof(double)) + sizeof(std::uint64_t) * (d + 1);
+   return ret;
+}
+
+void CSFTensorData::init_pre()
+{
+   //the number of threads is set by now
+   m_panels.init(Eigen::MatrixXd());
+}
+
+double CSFTensorData::sum() const
+{
+   return m_sum;
+}
+
+std::uint64_t CSFTensorData::nmode() const
+{
+   return m_dims.size();
+}
+
+std::uint64_t CSFTensorData::nnz() const
+{
+   return m_items->nnz;
+}
+
+std::uint64_t CSFTensorData::nna() const
+{
+   return size() - nnz();
+}
+
+PVec<> CSFTensorData::dim() const
+{
+   std::vector<int> pvec_dims;
+   for (auto& d : m_dims)
+      pvec_dims.push_back(static_cast<int>(d));
+   return PVec<>(pvec_dims);
+}
+
+double CSFTensorData::train_rmse(const SubModel& model) const
+{
+   return std::sqrt(sumsq(model) / this->nnz());
+}
+
+//walks the subtree of hyperplane d in the tree of mode
+//
+//the Hadamard product of the V columns of levels 1..l is kept in P[l], so it is
+//computed once for all leaves below a node. Long fibers of leaves are gathered
+//in a panel: sum_j (p .* v_j)(p .* v_j)' = (p p') .* (sum_j v_j v_j'), where the
+//sum is one rank-b update for fibers of at least PANEL_MIN_ITEMS leaves.
+template<int K, int N>
+struct CSFTensorData::GetMuLambdaKernel
+{
+   typedef Eigen::Matrix<double, K, 1> Vector;
+   typedef Eigen::Matrix<double, K, K> Matrix;
+   typedef Eigen::Matrix<double, K, Eigen::Dynamic> Panel;
+   typedef Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, PANEL_MAX_WIDTH, 1> PanelValues;
+
+   struct Walk
+   {
+      const CSFTree& tree;
+      const SubModel& model;
+      INoiseModel& ns;
+      const bool gaussian;
+      const double alpha;
+      const int num_latent;
+      const int width; // of the panel
+
+      //leaves [lo, hi) of the hyperplane, clip if not all of them
+      std::uint64_t lo, hi;
+      bool clip;
+
+      const std::uint32_t* perm; // item of every leaf
+      const double* values; // of the items
+      const std::uint32_t* coords; // of the items
+      std::uint32_t modes[N]; // mode of every level
+
+      const double* V[N]; // first column of U of the mode of every level > 0
+      Index stride[N];
+      Vector P[N]; // Hadamard product of the columns of levels 1..l
+      PVec<> pos; // coordinates of the current node, for non-Gaussian noise
+
+      Vector col;
+      Map<Panel> panel; // in m_panels of the thread, allocated on the first call
+      PanelValues y;
+      Matrix S;
+      Vector r;
+
+      Map<Vector> rr;
+      Map<Matrix> MM;
+
+      Walk(const CSFTensorData& data, const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, VectorXd& rr_, MatrixXd& MM_)
+         : tree(data.tree(mode)), model(model), ns(data.noise()),
+           gaussian(ns.isGaussian()), alpha(ns.getAlpha()), num_latent(model.nlatent()), width(panel_width(num_latent)),
+           pos(N), col(num_latent), panel(thread_panel(data, num_latent, width)), y(width), S(num_latent, num_latent), r(num_latent),
+           rr(rr_.data(), num_latent), MM(MM_.data(), num_latent, num_latent)
+      {
+         const std::uint64_t begin = tree.leafBegin(0, d);
+         lo = begin + from;
+         hi = begin + to;
+         clip = from > 0 || hi < tree.leafBegin(0, d + 1);
+
+         const CSFItems& items = tree.getItems();
+         perm = tree.getPerm().data();
+         values = items.values.data();
+         coords = items.coords.data();
+
+         pos[mode] = d;
+         for (int l = 1; l < N; l++)
+         {
+            modes[l] = tree.getMode(l);
+            auto U = model.U(tree.getMode(l));
+            V[l] = U.data();
+            stride[l] = U.outerStride();
+            P[l].resize(num_latent);
+         }
+      }
+
+      static Map<Panel> thread_panel(const CSFTensorData& data, int num_latent, int width)
+      {
+         MatrixXd& buf = data.m_panels.local();
+         if (buf.rows() != num_latent || buf.cols() != width)
+            buf.resize(num_latent, width);
+         return Map<Panel>(buf.data(), num_latent, width);
+      }
+
+      // coordinate of item i in the mode of level
+      std::uint32_t id(int level, std::uint32_t i) const
+      {
+         return coords[i * N + modes[level]];
+      }
+
+      Map<const Vector> column(int level, std::uint32_t id) const
+      {
+         return Map<const Vector>(V[level] + id * stride[level], num_latent);
+      }
+   };
+
+   //internal level L: update the partial product and go down
+   template<int L>
+   static void visit(Walk& w, std::integral_constant<int, L>, std::uint64_t begin, std::uint64_t end)
+   {
+      const auto& ptr = w.tree.getPtr(L);
+
+      for (std::uint64_t n = begin; n < end; n++)
+      {
+         if (w.clip)
+         {
+            if (w.tree.leafBegin(L, n + 1) <= w.lo)
+               continue;
+            if (w.tree.leafBegin(L, n) >= w.hi)
+               break;
+         }
+
+         //coordinate of the node is that of its first leaf
+         const std::uint32_t id = w.id(L, w.perm[w.tree.leafBegin(L, n)]);
+         w.pos[w.modes[L]] = id;
+         if (L == 1)
+            w.P[L] = w.column(L, id);
+         else
+            w.P[L] = w.P[L - 1].cwiseProduct(w.column(L, id));
+
+         visit(w, std::integral_constant<int, L + 1>(), ptr[n], ptr[n + 1]);
+      }
+   }
+
+   //leaves: one fiber with the partial product P[N - 2]
+   static void visit(Walk& w, std::integral_constant<int, N - 1>, std::uint64_t begin, std::uint64_t end)
+   {
+      const double* values = w.values;
+      const std::uint32_t* perm = w.perm;
+      begin = std::max(begin, w.lo);
+      end = std::min(end, w.hi);
+
+      if (w.gaussian && end >= begin + PANEL_MIN_ITEMS)
+      {
+         for (std::uint64_t b = begin; b < end; b += w.width)
+         {
+            const int nb = std::min(std::uint64_t(w.width), end - b);
+            for (int j = 0; j < nb; j++)
+            {
+               const std::uint32_t i = perm[b + j];
+               w.panel.col(j) = w.column(N - 1, w.id(N - 1, i));
+               w.y(j) = values[i];
+            }
+
+            auto panel = w.panel.leftCols(nb);
+            w.S.setZero();
+            w.S.template selfadjointView<Eigen::Lower>().rankUpdate(panel);
+            w.r.noalias() = panel * w.y.head(nb);
+
+            if (N == 2)
+            {
+               w.MM.template triangularView<Eigen::Lower>() += w.alpha * w.S;
+               w.rr.noalias() += w.alpha * w.r;
+            }
+            else
+            {
+               const auto& p = w.P[N - 2];
+               w.MM.template triangularView<Eigen::Lower>() += w.alpha * w.S.cwiseProduct(p * p.transpose());
+               w.rr.noalias() += w.alpha * p.cwiseProduct(w.r);
+            }
+         }
+
+         return;
+      }
+
+      for (std::uint64_t j = begin; j < end; j++)
+      {
+         const std::uint32_t i = perm[j];
+         if (N == 2)
+            w.col = w.column(N - 1, w.id(N - 1, i));
+         else
+            w.col = w.P[N - 2].cwiseProduct(w.column(N - 1, w.id(N - 1, i)));
+
+         w.MM.template triangularView<Eigen::Lower>() += w.alpha * w.col * w.col.transpose(); // MM = MM + (col * colT) * alpha
+
+         double noisy_val;
+         if (w.gaussian)
+         {
+            noisy_val = w.alpha * values[i];
+         }
+         else
+         {
+            w.pos[w.modes[N - 1]] = w.id(N - 1, i);
+            noisy_val = w.ns.sample(w.model, w.pos, values[i]);
+         }
+         w.rr.noalias() += w.col * noisy_val; // rr = rr + (col * value) * alpha
+      }
+   }
+
+   //accumulates items [from, to) of hyperplane d into rr and MM
+   static void run(const CSFTensorData& data, const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, VectorXd& rr, MatrixXd& MM)
+   {
+      Walk w(data, model, mode, d, from, to, rr, MM);
+
+      const auto& ptr = w.tree.getPtr(0);
+      visit(w, std::integral_constant<int, 1>(), ptr[d], ptr[d + 1]);
+
+      w.MM.template triangularView<Upper>() = w.MM.transpose();
+   }
+};
+
+void CSFTensorData::getMuLambda(const SubModel& model, uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const
+{
+   getMuLambdaRange(model, mode, d, 0, col_nnz(mode, d), rr, MM);
+}
+
+void CSFTensorData::getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const
+{
+   dispatch_num_latent_modes<GetMuLambdaKernel>(model.nlatent(), nmode(), *this, model, mode, d, from, to, rr, MM);
+}
+
+std::uint64_t CSFTensorData::col_nnz(uint32_t mode, int d) const
+{
+   return tree(mode).nItemsOnPlane(d);
+}
+
+void CSFTensorData::update_pnm(const SubModel& model, uint32_t mode)
+{
+   //do not need to cache VV here
+}
+
+double CSFTensorData::sumsq(const SubModel& model) const
+{
+   double sumsq = 0.0;
+   const CSFItems& items = *m_items;
+
+   #pragma omp parallel for schedule(guided) reduction(+:sumsq)
+   for(std::uint64_t i = 0; i < items.nnz; i++) //go through each item
+   {
+      PVec<> pos(nmode());
+      for (std::uint32_t m = 0; m < nmode(); m++)
+         pos[m] = items.coord(m, i);
+      sumsq += std::pow(model.predict(pos) - items.values[i], 2);
+   }
+
+   return sumsq;
+}
+
+double CSFTensorData::var_total() const
+{
+   double cwise_mean = this->sum() / this->nnz();
+   const auto& values = m_items->values;
+   double se = 0.0;
+
+   #pragma omp parallel for schedule(guided) reduction(+:se)
+   for(std::uint64_t i = 0; i < values.size(); i++)
+   {
+      se += std::pow(values[i] - cwise_mean, 2);
+   }
+
+   double var = se / this->nnz();
+   if (var <= 0.0 || std::isnan(var))
+   {
+      // if var cannot be computed using 1.0
+      var = 1.0;
+   }
+
+   return var;
+}
+
+std::ostream& CSFTensorData::info(std::ostream& os, std::string indent)
+{
+   Data::info(os, indent);
+   double train_fill_rate = 100. * nnz() / size();
+
+   os << indent << "Size: " << nnz() << " [";
+
+   for (std::size_t i = 0; i < m_dims.size() - 1; i++)
+   {
+      os << m_dims[i] << " x ";
+   }
+
+   os << m_dims.back() << "] (" << std::fixed << std::setprecision(2) << train_fill_rate << "%)\n";
+   os << indent << "Storage: " << m_trees.size() << " CSF trees, " << bytes() / 1024 / 1024 << " MB ("
+      << coo_bytes() / 1024 / 1024 << " MB as TensorData)\n";
+
+   return os;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include <Eigen/Dense>
+
+#include "CSFTree.h"
+#include <SmurffCpp/Configs/TensorConfig.h>
+#include <SmurffCpp/DataMatrices/Data.h>
+#include <SmurffCpp/Utils/PVec.hpp>
+#include <SmurffCpp/Utils/ThreadVector.hpp>
+
+namespace smurff {
+
+//sparse tensor stored as one compressed sparse fiber tree per mode
+//
+//compared to TensorData the coordinates shared by the items of a fiber are
+//stored once, and getMuLambda computes the Hadamard product of the V columns
+//of a shared prefix once per fiber
+//
+//getMuLambda needs the items of one hyperplane of any mode, which are a
+//subtree only of the tree rooted at that mode, so every mode has its own tree.
+//The coordinates and values of the items are stored once (CSFItems) and the
+//trees keep only their node pointers and the item of every leaf. With n_l
+//nodes on level l of a tree this takes
+//
+//   (4 * N + 8) * nnz + sum over modes of 4 * nnz + 4 * sum_{0 < l < N-1} (n_l + 1) + 4 * (dim_root + 1) bytes
+//
+//against N * (nnz * (4 * (N - 1) + 8) + 8 * (dim + 1)) for TensorData. As
+//n_l <= nnz the trees take at most (4 * N^2 + 8) * nnz bytes for the items,
+//which is no more than the 4 * N * (N + 1) * nnz of TensorData for N >= 2, even
+//if no fibers are shared. info() prints both sizes.
+class CSFTensorData : public Data
+{
+private:
+   std::vector<std::uint64_t> m_dims; //vector of dimention sizes
+   std::shared_ptr<const CSFItems> m_items;
+   std::vector<CSFTree> m_trees; // tree rooted at every mode
+   double m_sum;
+
+   // num_latent x panel_width(num_latent) panel of every thread for getMuLambda
+   mutable thread_vector<Eigen::MatrixXd> m_panels;
+
+   // getMuLambda specialized on num_latent and the number of modes
+   template<int K, int N> struct GetMuLambdaKernel;
+
+public:
+   CSFTensorData(const smurff::TensorConfig& tc);
+
+   const CSFTree& tree(std::uint64_t mode) const;
+
+   // bytes used by the items and the trees
+   std::uint64_t bytes() const;
+
+   // bytes the same tensor takes as TensorData
+   std::uint64_t coo_bytes() const;
+
+protected:
+   void init_pre() override;
+
+public:
+   double sum() const override;
+
+public:
+   std::uint64_t nmode() const override;
+   std::uint64_t nnz() const override;
+   std::uint64_t nna() const override;
+   PVec<> dim() const override;
+
+public:
+   double train_rmse(const SubModel& model) const override;
+   void getMuLambda(const SubModel& model, uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
+   std::uint64_t col_nnz(uint32_t mode, int d) const override;
+   void getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
+   void update_pnm(const SubModel& model, uint32_t mode) override;
+
+public:
+   double sumsq(const SubModel& model) const override;
+   double var_total() const override;
+
+public:
+   std::ostream& info(std::ostream& os, std::string indent) override;
+};
+
+}
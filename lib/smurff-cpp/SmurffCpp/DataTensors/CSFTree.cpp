@@ -0,0 +1,129 @@
+#include "CSFTree.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include <SmurffCpp/Utils/Error.h>
+
+using namespace smurff;
+
+CSFItems::CSFItems(const TensorConfig& tc)
+   : nnz(tc.getNNZ()), nmodes(tc.getNModes()), coords(nnz * nmodes), values(tc.getValues())
+{
+   // items and nodes are indexed with 32 bits
+   THROWERROR_ASSERT_MSG(nnz <= std::numeric_limits<std::uint32_t>::max(), "Too many non-zeros for a CSF tensor");
+
+   const auto& dims = tc.getDims();
+   const auto& columns = tc.getColumns();
+   for (std::uint64_t m = 0; m < nmodes; m++)
+   {
+      for (std::uint64_t i = 0; i < nnz; i++)
+      {
+         THROWERROR_ASSERT_MSG(columns[m * nnz + i] < dims[m], "Coordinate is larger than the dimension");
+         coords[i * nmodes + m] = columns[m * nnz + i];
+      }
+   }
+}
+
+void CSFItems::permute(const std::vector<std::uint32_t>& perm)
+{
+   std::vector<std::uint32_t> new_coords(coords.size());
+   std::vector<double> new_values(values.size());
+   for (std::uint64_t i = 0; i < nnz; i++)
+   {
+      std::copy_n(coords.begin() + perm[i] * nmodes, nmodes, new_coords.begin() + i * nmodes);
+      new_values[i] = values[perm[i]];
+   }
+   coords.swap(new_coords);
+   values.swap(new_values);
+}
+
+std::uint64_t CSFItems::bytes() const
+{
+   return coords.size() * sizeof(std::uint32_t) + values.size() * sizeof(double);
+}
+
+CSFTree::CSFTree(std::shared_ptr<const CSFItems> items, const std::vector<std::uint64_t>& dims, std::uint32_t root)
+   : m_items(items)
+{
+   const std::uint64_t nmodes = dims.size();
+   const std::uint64_t nnz = items->nnz;
+
+   THROWERROR_ASSERT(root < nmodes);
+
+   //root first, the other modes from the smallest to the largest dimension
+   m_modes.push_back(root);
+   for (std::uint32_t m = 0; m < nmodes; m++)
+      if (m != root)
+         m_modes.push_back(m);
+   std::stable_sort(m_modes.begin() + 1, m_modes.end(), [&dims](std::uint32_t a, std::uint32_t b) { return dims[a] < dims[b]; });
+
+   auto coord = [&](std::uint64_t l, std::uint32_t i) { return items->coord(m_modes[l], i); };
+
+   //sort items by the coordinates of the levels: stable counting sorts
+   //from the last level to the root
+   m_perm.resize(nnz);
+   std::iota(m_perm.begin(), m_perm.end(), 0);
+   {
+      std::vector<std::uint32_t> tmp(nnz);
+      for (std::uint64_t l = nmodes; l-- > 0; )
+      {
+         std::vector<std::uint64_t> count(dims[m_modes[l]] + 1, 0);
+         for (std::uint64_t i = 0; i < nnz; i++)
+            count[coord(l, i) + 1]++;
+         std::partial_sum(count.begin(), count.end(), count.begin());
+         for (std::uint64_t i = 0; i < nnz; i++)
+            tmp[count[coord(l, m_perm[i])]++] = m_perm[i];
+         m_perm.swap(tmp);
+      }
+   }
+
+   //one node per distinct prefix of coordinates
+   m_ptr.resize(nmodes - 1);
+   m_ptr[0].assign(dims[root] + 1, 0);
+   std::vector<std::uint32_t> nnodes(nmodes, 0);
+
+   for (std::uint64_t s = 0; s < nnz; s++)
+   {
+      const std::uint32_t i = m_perm[s];
+
+      //first level where the item differs from the previous one
+      std::uint64_t first = 1;
+      if (s > 0)
+      {
+         const std::uint32_t prev = m_perm[s - 1];
+         first = 0;
+         while (first < nmodes - 1 && coord(first, i) == coord(first, prev))
+            first++;
+         first = std::max(first, (std::uint64_t)1);
+      }
+
+      for (std::uint64_t l = first; l < nmodes; l++)
+      {
+         if (l == 1)
+            m_ptr[0][coord(0, i) + 1]++; //count the children of the hyperplane
+
+         if (l + 1 < nmodes) //children of the new node start here
+            m_ptr[l].push_back(nnodes[l + 1]);
+
+         nnodes[l]++;
+      }
+   }
+
+   //pointers of a level are the starts of the children, add the ends
+   std::partial_sum(m_ptr[0].begin(), m_ptr[0].end(), m_ptr[0].begin());
+   for (std::uint64_t l = 1; l + 1 < nmodes; l++)
+   {
+      m_ptr[l].push_back(nnodes[l + 1]);
+      m_ptr[l].shrink_to_fit();
+   }
+}
+
+std::uint64_t CSFTree::bytes() const
+{
+   std::uint64_t ret = m_perm.size() * sizeof(std::uint32_t);
+   for (const auto& p : m_ptr)
+      ret += p.size() * sizeof(std::uint32_t);
+   return ret;
+}
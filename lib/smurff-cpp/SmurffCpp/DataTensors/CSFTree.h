@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <SmurffCpp/Configs/TensorConfig.h>
+
+namespace smurff {
+
+//coordinates and values of the items of a tensor, stored once and shared by
+//the CSF trees of all modes
+struct CSFItems
+{
+   CSFItems(const TensorConfig& tc);
+
+   std::uint64_t nnz;
+   std::uint64_t nmodes;
+   std::vector<std::uint32_t> coords; // coordinates of item i are coords[i * nmodes .. (i + 1) * nmodes)
+   std::vector<double> values;
+
+   std::uint32_t coord(std::uint32_t mode, std::uint32_t item) const
+   {
+      return coords[item * nmodes + mode];
+   }
+
+   // reorders the items, item i is the previous item perm[i]
+   void permute(const std::vector<std::uint32_t>& perm);
+
+   std::uint64_t bytes() const;
+};
+
+//compressed sparse fiber (CSF) tree of a tensor rooted at one mode
+//
+//level 0 has a node for every hyperplane of the root mode, a node of level l > 0
+//is a distinct prefix of coordinates in the modes of levels 0..l, and the leaves
+//(last level) are the items. The modes after the root are ordered from the
+//smallest to the largest dimension, so that the upper levels share the most.
+//
+//the tree stores only the structure: the children of every node and the item
+//of every leaf. The coordinate of a node is that of the first item below it,
+//and is read from the shared CSFItems.
+class CSFTree
+{
+private:
+   std::shared_ptr<const CSFItems> m_items;
+   std::vector<std::uint32_t> m_modes; // mode of each level, m_modes[0] is the root mode
+   std::vector<std::vector<std::uint32_t> > m_ptr; // children of node n of level l are [m_ptr[l][n], m_ptr[l][n + 1]) in level l + 1
+   std::vector<std::uint32_t> m_perm; // item of every leaf
+
+public:
+   // tree of items rooted at mode root
+   CSFTree(std::shared_ptr<const CSFItems> items, const std::vector<std::uint64_t>& dims, std::uint32_t root);
+
+public:
+   const CSFItems& getItems() const
+   {
+      return *m_items;
+   }
+
+   std::uint64_t getNLevels() const
+   {
+      return m_modes.size();
+   }
+
+   std::uint32_t getMode(std::uint64_t level) const
+   {
+      return m_modes[level];
+   }
+
+   std::uint64_t getNNodes(std::uint64_t level) const
+   {
+      return level + 1 == m_modes.size() ? m_perm.size() : m_ptr[level].size() - 1;
+   }
+
+   const std::vector<std::uint32_t>& getPtr(std::uint64_t level) const
+   {
+      return m_ptr[level];
+   }
+
+   const std::vector<std::uint32_t>& getPerm() const
+   {
+      return m_perm;
+   }
+
+   std::uint64_t getNNZ() const
+   {
+      return m_perm.size();
+   }
+
+   std::uint64_t getNPlanes() const
+   {
+      return getNNodes(0);
+   }
+
+   // index of the first leaf below node n of level
+   std::uint64_t leafBegin(std::uint64_t level, std::uint64_t n) const
+   {
+      for (std::uint64_t l = level; l + 1 < m_modes.size(); l++)
+         n = m_ptr[l][n];
+      return n;
+   }
+
+   // coordinate of node n of level > 0 in mode getMode(level)
+   std::uint32_t id(std::uint64_t level, std::uint64_t n) const
+   {
+      return m_items->coord(m_modes[level], m_perm[leafBegin(level, n)]);
+   }
+
+   std::uint64_t nItemsOnPlane(std::uint64_t hyperplane) const
+   {
+      return leafBegin(0, hyperplane + 1) - leafBegin(0, hyperplane);
+   }
+
+   // bytes used by the tree, without the shared items
+   std::uint64_t bytes() const;
+};
+
+}
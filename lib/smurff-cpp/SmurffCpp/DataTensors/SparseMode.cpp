@@ -1,6 +1,8 @@
 #include "SparseMode.h"
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 
 #include <SmurffCpp/Utils/Error.h>
@@ -18,46 +20,53 @@ SparseMode::SparseMode()
 // m - index of dimention to fix
 // mode_size - size of dimention to fix
 SparseMode::SparseMode(const MatrixXui32& idx, const std::vector<double>& vals, std::uint64_t mode, std::uint64_t mode_size) 
+   : SparseMode(idx, vals, mode, mode_size, 0, mode_size)
+{
+}
+
+// plane_begin, plane_end - range of hyperplanes to keep
+SparseMode::SparseMode(const MatrixXui32& idx, const std::vector<double>& vals, std::uint64_t mode, std::uint64_t mode_size,
+                       std::uint64_t plane_begin, std::uint64_t plane_end)
 {
    if ((size_t)idx.rows() != vals.size())
    {
       THROWERROR("Number of rows in 'idx' should equal number of values in 'vals'");
    }
 
-   m_row_ptr.resize(mode_size + 1); // mode_size + 1 because this vector will hold commulative sum of number of elements
-   m_values.resize(vals.size()); // resize values vector
-   m_indices.resize(idx.rows(), idx.cols() - 1); // reduce number of columns by 1 (exclude fixed dimension)
+   if (plane_begin > plane_end || plane_end > mode_size)
+   {
+      THROWERROR("Invalid range of hyperplanes");
+   }
 
    m_mode = mode; // save dimension index that is fixed
-   std::uint64_t nnz  = idx.rows(); // get nnz from index matrix
 
    auto rows = idx.col(m_mode); // get column with coordinates for fixed dimension
    
    // compute number of non-zero entries per each element for the mode
    // (compute number of non-zero elements for each coordinate in specific dimension)
-   for (std::uint64_t i = 0; i < nnz; i++) 
+   std::vector<std::uint64_t> plane_nnz(mode_size, 0);
+   for (std::uint64_t i = 0; i < (std::uint64_t)idx.rows(); i++) 
    {
       if (rows(i) >= mode_size) //index in column should be within dimension size
       {
          THROWERROR("'idx' value is larger than 'mode_size'");
       }
 
-      m_row_ptr[rows(i)]++; //count item with specific index
-   }
+      if (rows(i) < plane_begin || rows(i) >= plane_end)
+         continue;
 
-   // compute commulative sum of number of elements for each coordinate in specific dimension
-   for (std::uint64_t row = 0, cumsum = 0; row < mode_size; row++)
-   {
-      std::uint64_t temp = m_row_ptr[row];
-      m_row_ptr[row] = cumsum;
-      cumsum += temp;
+      plane_nnz[rows(i)]++; //count item with specific index
    }
-   m_row_ptr[mode_size] = nnz; //last element should be equal to nnz
+
+   allocate(plane_nnz, idx.cols() - 1); // reduce number of columns by 1 (exclude fixed dimension)
 
    // transform index matrix into index matrix with one reduced/fixed dimension
-   for (std::uint64_t i = 0; i < nnz; i++) 
+   for (std::uint64_t i = 0; i < (std::uint64_t)idx.rows(); i++) 
    {
       std::uint32_t row  = rows(i); // coordinate in fixed dimension
+      if (row < plane_begin || row >= plane_end)
+         continue;
+
       std::uint64_t dest = m_row_ptr[row]; // commulative number of elements for this index
 
       for (std::uint64_t j = 0, nj = 0; j < (std::uint64_t)idx.cols(); j++) //go through each column in index matrix
@@ -80,6 +89,75 @@ SparseMode::SparseMode(const MatrixXui32& idx, const std::vector<double>& vals,
       m_row_ptr[row] = prev;
       prev = temp;
    }
+
+   sortPlanes();
+}
+
+SparseMode::SparseMode(std::uint64_t mode, const std::vector<std::uint64_t>& plane_nnz, std::uint64_t nmodes)
+   : m_mode(mode)
+{
+   if (mode >= nmodes)
+   {
+      THROWERROR("Invalid mode");
+   }
+
+   allocate(plane_nnz, nmodes - 1);
+}
+
+void SparseMode::allocate(const std::vector<std::uint64_t>& plane_nnz, std::uint64_t ncoords)
+{
+   const std::uint64_t mode_size = plane_nnz.size();
+
+   m_row_ptr.resize(mode_size + 1); // mode_size + 1 because this vector will hold commulative sum of number of elements
+
+   // compute commulative sum of number of elements for each coordinate in specific dimension
+   std::uint64_t nnz = 0;
+   for (std::uint64_t row = 0; row < mode_size; row++)
+   {
+      m_row_ptr[row] = nnz;
+      nnz += plane_nnz[row];
+   }
+   m_row_ptr[mode_size] = nnz; //last element should be equal to nnz
+
+   m_values.resize(nnz);
+   m_indices.resize(nnz, ncoords);
+}
+
+void SparseMode::sortPlanes()
+{
+   const std::uint64_t mode_size = getNPlanes();
+
+   // sort the items of every hyperplane by their coordinates, so that
+   // adjacent items share leading coordinates (see TensorData::getMuLambda)
+   #pragma omp parallel for schedule(dynamic, 64)
+   for (std::uint64_t h = 0; h < mode_size; h++)
+   {
+      const std::uint64_t begin = m_row_ptr[h];
+      const std::uint64_t n = m_row_ptr[h + 1] - begin;
+      if (n < 2)
+         continue;
+
+      std::vector<std::uint64_t> perm(n);
+      std::iota(perm.begin(), perm.end(), begin);
+      std::sort(perm.begin(), perm.end(), [this](std::uint64_t a, std::uint64_t b)
+         {
+            for (Eigen::Index c = 0; c < m_indices.cols(); c++)
+               if (m_indices(a, c) != m_indices(b, c))
+                  return m_indices(a, c) < m_indices(b, c);
+            return a < b;
+         });
+
+      MatrixXui32 indices(n, m_indices.cols());
+      std::vector<double> values(n);
+      for (std::uint64_t i = 0; i < n; i++)
+      {
+         indices.row(i) = m_indices.row(perm[i]);
+         values[i] = m_values[perm[i]];
+      }
+
+      m_indices.middleRows(begin, n) = indices;
+      std::copy(values.begin(), values.end(), m_values.begin() + begin);
+   }
 }
 
 std::uint64_t SparseMode::getNNZ() const
@@ -129,7 +207,7 @@ const MatrixXui32& SparseMode::getIndices() const
 
 std::pair<PVec<>, double> SparseMode::item(std::uint64_t hyperplane, std::uint64_t item) const
 {
-   std::vector<int> coords(this->getNCoords() + 1); //number of coordinates in sview + 1 dimension that is fixed
+   PVec<> coords(this->getNCoords() + 1); //number of coordinates in sview + 1 dimension that is fixed, on the stack
 
    coords[m_mode] = hyperplane; //fixed mode coordinate of current sview is initialized with index of hyperplane
 
@@ -155,7 +233,7 @@ std::pair<PVec<>, double> SparseMode::item(std::uint64_t hyperplane, std::uint64
 
 PVec<> SparseMode::pos(std::uint64_t hyperplane, std::uint64_t item) const
 {
-   std::vector<int> coords(this->getNCoords() + 1); //number of coordinates in sview + 1 dimension that is fixed
+   PVec<> coords(this->getNCoords() + 1); //number of coordinates in sview + 1 dimension that is fixed, on the stack
 
    coords[m_mode] = hyperplane; //fixed mode coordinate of current sview is initialized with index of hyperplane
 
@@ -14,6 +14,7 @@ namespace smurff {
 typedef Eigen::Matrix<std::uint32_t, Eigen::Dynamic, Eigen::Dynamic > MatrixXui32;
 
 //this is a tensor rotation where one dimention is fixed (excluded)
+//the items of a hyperplane are sorted by their coordinates
 class SparseMode
 {
 private:
@@ -32,6 +33,35 @@ public:
    // mode_size - size of dimension to fix
    SparseMode(const MatrixXui32& idx, const std::vector<double>& vals, std::uint64_t mode, std::uint64_t mode_size);
 
+   // only the items on hyperplanes [plane_begin, plane_end) are kept,
+   // the other hyperplanes are empty
+   SparseMode(const MatrixXui32& idx, const std::vector<double>& vals, std::uint64_t mode, std::uint64_t mode_size,
+              std::uint64_t plane_begin, std::uint64_t plane_end);
+
+   // empty hyperplanes with room for plane_nnz[h] items on hyperplane h,
+   // the items are put in place with put, followed by sortPlanes
+   SparseMode(std::uint64_t mode, const std::vector<std::uint64_t>& plane_nnz, std::uint64_t nmodes);
+
+private:
+   // row_ptr set to the beginning of every hyperplane
+   void allocate(const std::vector<std::uint64_t>& plane_nnz, std::uint64_t ncoords);
+
+public:
+   // item i to position dest, columns[m][i] is coordinate m of item i
+   void put(std::uint64_t dest, const std::uint32_t* const* columns, const double* values, std::uint64_t i)
+   {
+      for (std::uint64_t j = 0, nj = 0; nj < (std::uint64_t)m_indices.cols(); j++)
+      {
+         if (j != m_mode)
+            m_indices(dest, nj++) = columns[j][i];
+      }
+
+      m_values[dest] = values[i];
+   }
+
+   // sorts the items of every hyperplane by their coordinates, once all are in place
+   void sortPlanes();
+
    std::uint64_t getNNZ() const;
 
    std::uint64_t getNPlanes() const;
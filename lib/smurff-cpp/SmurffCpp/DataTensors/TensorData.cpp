@@ -1,41 +1,241 @@
 #include "TensorData.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 
 #include <SmurffCpp/ConstVMatrixExprIterator.hpp>
+#include <SmurffCpp/IO/ChunkedTensor.h>
+#include <SmurffCpp/Utils/NumModes.hpp>
+#include <SmurffCpp/Utils/Panel.hpp>
+#include <SmurffCpp/Utils/omp_util.h>
 
 using namespace Eigen;
 using namespace smurff;
 
-//convert array of coordinates to [nnz x nmodes] matrix
-MatrixXui32 toMatrixNew(const std::vector<std::uint32_t>& columns, std::uint64_t nnz, std::uint64_t nmodes) 
+static void check_plane_ranges(const std::vector<std::uint64_t>& dims, const std::vector<std::uint64_t>& plane_begin, const std::vector<std::uint64_t>& plane_end)
 {
-   MatrixXui32 idx(nnz, nmodes);
-   for (std::uint64_t row = 0; row < nnz; row++) 
+   THROWERROR_ASSERT(plane_begin.size() == dims.size() && plane_end.size() == dims.size());
+
+   for (std::uint64_t m = 0; m < dims.size(); m++)
    {
-      for (std::uint64_t col = 0; col < nmodes; col++) 
+      if (plane_begin[m] > plane_end[m] || plane_end[m] > dims[m])
       {
-         idx(row, col) = columns[col * nnz + row];
+         THROWERROR("Invalid range of hyperplanes");
       }
    }
-   return idx;
+}
+
+// items [0, n) of columns to the hyperplanes of mode, items with a
+// coordinate outside [plane_begin, plane_end) are left out
+//
+// the items are split in parts that are counted and put in place in
+// parallel: every part has its own count of items per hyperplane, which
+// after a prefix sum over the parts is the position of its first item on
+// every hyperplane, so that the items of a hyperplane keep their order
+// whatever the number of threads
+static std::shared_ptr<SparseMode> build_mode(const std::vector<const std::uint32_t*>& columns, const double* values, std::uint64_t n,
+                                              std::uint64_t mode, std::uint64_t mode_size, std::uint64_t plane_begin, std::uint64_t plane_end)
+{
+   // as many parts as threads, as long as the counts are not larger than the items
+   const std::int64_t nparts = std::max<std::uint64_t>(1, std::min<std::uint64_t>(threads::get_max_threads(), n / std::max<std::uint64_t>(mode_size, 1)));
+   auto part_begin = [n, nparts](std::int64_t p) { return p * n / nparts; };
+
+   const std::uint32_t* rows = columns[mode];
+   std::vector<std::vector<std::uint64_t> > next(nparts);
+   std::vector<char> ok(nparts, 1); // exceptions cannot leave the parallel loop
+
+   #pragma omp parallel for schedule(static)
+   for (std::int64_t p = 0; p < nparts; p++)
+   {
+      std::vector<std::uint64_t>& count = next[p];
+      count.resize(mode_size, 0);
+
+      for (std::uint64_t i = part_begin(p); i < part_begin(p + 1); i++)
+      {
+         const std::uint32_t row = rows[i];
+         if (row >= mode_size)
+         {
+            ok[p] = 0;
+            break;
+         }
+
+         if (row >= plane_begin && row < plane_end)
+            count[row]++;
+      }
+   }
+
+   if (std::find(ok.begin(), ok.end(), 0) != ok.end())
+   {
+      THROWERROR("Coordinate larger than the dimension of mode " + std::to_string(mode));
+   }
+
+   // items per hyperplane, next[p][row] becomes the offset of the first
+   // item of part p among the items of hyperplane row
+   std::vector<std::uint64_t> plane_nnz(mode_size);
+
+   #pragma omp parallel for schedule(static)
+   for (std::int64_t row = 0; row < (std::int64_t)mode_size; row++)
+   {
+      std::uint64_t sum = 0;
+      for (std::int64_t p = 0; p < nparts; p++)
+      {
+         const std::uint64_t c = next[p][row];
+         next[p][row] = sum;
+         sum += c;
+      }
+      plane_nnz[row] = sum;
+   }
+
+   auto sview = std::make_shared<SparseMode>(mode, plane_nnz, columns.size());
+
+   #pragma omp parallel for schedule(static)
+   for (std::int64_t p = 0; p < nparts; p++)
+   {
+      std::vector<std::uint64_t>& dest = next[p];
+      for (std::uint64_t row = plane_begin; row < plane_end; row++)
+         dest[row] += sview->beginPlane(row);
+
+      for (std::uint64_t i = part_begin(p); i < part_begin(p + 1); i++)
+      {
+         const std::uint32_t row = rows[i];
+         if (row >= plane_begin && row < plane_end)
+            sview->put(dest[row]++, columns.data(), values, i);
+      }
+
+      std::vector<std::uint64_t>().swap(dest);
+   }
+
+   sview->sortPlanes();
+   return sview;
 }
 
 TensorData::TensorData(const smurff::TensorConfig& tc) 
+   : TensorData(tc, std::vector<std::uint64_t>(tc.getNModes(), 0), tc.getDims())
+{
+}
+
+TensorData::TensorData(const smurff::TensorConfig& tc, const std::vector<std::uint64_t>& plane_begin, const std::vector<std::uint64_t>& plane_end)
    : m_dims(tc.getDims()),
-     m_nnz(tc.getNNZ()),
      m_Y(std::make_shared<std::vector<std::shared_ptr<SparseMode> > >())
 {
-   //combine coordinates into [nnz x nmodes] matrix
-   MatrixXui32 idx = toMatrixNew(tc.getColumns(), tc.getNNZ(), tc.getNModes());
+   check_plane_ranges(m_dims, plane_begin, plane_end);
 
-   for (std::uint64_t mode = 0; mode < tc.getNModes(); mode++) 
+   if (!tc.hasData())
+   {
+      // only the header of the file was read (see tensor_io::read_tensor_header)
+      THROWERROR_ASSERT_MSG(!tc.getFilename().empty(), "Tensor data is neither in memory nor in a file");
+      readModes(tensor_io::ChunkedTensorReader(tc.getFilename()), plane_begin, plane_end);
+   }
+   else
    {
-      m_Y->push_back(std::make_shared<SparseMode>(idx, tc.getValues(), mode, m_dims[mode]));
+      // every mode straight from the column-major coordinates of the config,
+      // without an [nnz x nmodes] copy of them
+      const std::uint64_t nnz = tc.getNNZ();
+      std::vector<const std::uint32_t*> columns(m_dims.size());
+      for (std::uint64_t m = 0; m < m_dims.size(); m++)
+         columns[m] = tc.getColumns().data() + m * nnz;
+
+      for (std::uint64_t m = 0; m < m_dims.size(); m++)
+         m_Y->push_back(build_mode(columns, tc.getValues().data(), nnz, m, m_dims[m], plane_begin[m], plane_end[m]));
    }
 
+   initNNZ();
+}
+
+TensorData::TensorData(const tensor_io::ChunkedTensorReader& reader)
+   : TensorData(reader, std::vector<std::uint64_t>(reader.getNModes(), 0), reader.getDims())
+{
+}
+
+TensorData::TensorData(const tensor_io::ChunkedTensorReader& reader, const std::vector<std::uint64_t>& plane_begin, const std::vector<std::uint64_t>& plane_end)
+   : m_dims(reader.getDims()),
+     m_Y(std::make_shared<std::vector<std::shared_ptr<SparseMode> > >())
+{
+   readModes(reader, plane_begin, plane_end);
+   initNNZ();
+}
+
+void TensorData::readModes(const tensor_io::ChunkedTensorReader& reader, const std::vector<std::uint64_t>& plane_begin, const std::vector<std::uint64_t>& plane_end)
+{
+   const std::uint64_t nmodes = reader.getNModes();
+   check_plane_ranges(m_dims, plane_begin, plane_end);
+
+   std::vector<std::vector<std::uint32_t> > columns(nmodes);
+   std::vector<const std::uint32_t*> column_ptrs(nmodes);
+   std::vector<double> values;
+
+   // first pass: number of items on every hyperplane
+   std::vector<std::vector<std::uint64_t> > plane_nnz(nmodes);
+   for (std::uint64_t m = 0; m < nmodes; m++)
+      plane_nnz[m].resize(m_dims[m], 0);
+
+   for (std::uint64_t c = 0; c < reader.getNChunks(); c++)
+   {
+      for (std::uint64_t m = 0; m < nmodes; m++)
+      {
+         columns[m].resize(reader.chunkSize(c));
+         reader.readColumn(c, m, columns[m].data());
+
+         for (auto row : columns[m])
+         {
+            if (row >= m_dims[m])
+            {
+               THROWERROR("Coordinate larger than the dimension in " + reader.getName());
+            }
+
+            if (row >= plane_begin[m] && row < plane_end[m])
+               plane_nnz[m][row]++;
+         }
+      }
+   }
+
+   // plane_nnz[m][h] becomes the position of the next item on hyperplane h
+   for (std::uint64_t m = 0; m < nmodes; m++)
+   {
+      m_Y->push_back(std::make_shared<SparseMode>(m, plane_nnz[m], nmodes));
+      for (std::uint64_t h = 0; h < m_dims[m]; h++)
+         plane_nnz[m][h] = Y(m)->beginPlane(h);
+   }
+
+   // second pass: every item to its place on its hyperplane of every mode
+   for (std::uint64_t c = 0; c < reader.getNChunks(); c++)
+   {
+      const std::uint64_t n = reader.chunkSize(c);
+      for (std::uint64_t m = 0; m < nmodes; m++)
+      {
+         columns[m].resize(n);
+         reader.readColumn(c, m, columns[m].data());
+         column_ptrs[m] = columns[m].data();
+      }
+
+      values.resize(n);
+      reader.readValues(c, values.data());
+
+      #pragma omp parallel for schedule(static)
+      for (std::int64_t m = 0; m < (std::int64_t)nmodes; m++)
+      {
+         std::shared_ptr<SparseMode> sview = Y(m);
+         std::vector<std::uint64_t>& next = plane_nnz[m];
+
+         for (std::uint64_t i = 0; i < n; i++)
+         {
+            const std::uint32_t row = column_ptrs[m][i];
+            if (row >= plane_begin[m] && row < plane_end[m])
+               sview->put(next[row]++, column_ptrs.data(), values.data(), i);
+         }
+      }
+   }
+
+   for (auto& sview : *m_Y)
+      sview->sortPlanes();
+}
+
+void TensorData::initNNZ()
+{
+   m_nnz = Y(0)->getNNZ();
+
    std::uint64_t totalSize = std::accumulate(m_dims.begin(), m_dims.end(), (std::uint64_t)1, std::multiplies<std::uint64_t>());
    this->name = totalSize == m_nnz ? "TensorData [fully known]" : "TensorData [with NAs]";
 }
@@ -99,30 +299,130 @@ double TensorData::train_rmse(const SubModel& model) const
 
 //d is an index of column in U matrix
 //this function selects d'th hyperplane from mode`th SparseMode
-//it does j multiplications
-//where each multiplication is a cwiseProduct of columns from each V matrix
-void TensorData::getMuLambda(const SubModel& model, uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const
+//for every item it computes col, the cwiseProduct of the columns from each V matrix
+//
+//the items of a hyperplane are sorted by their coordinates (see SparseMode), so
+//adjacent items share the product of the first N - 2 columns, which is computed
+//once per prefix. The cols are gathered in a panel, which updates MM with one
+//rank-b update (syrk) and rr with one matrix-vector product.
+//
+//N is the number of modes, the loops over the N - 1 other modes are unrolled
+template<int K, int N>
+struct TensorData::GetMuLambdaKernel
 {
-   std::shared_ptr<SparseMode> sview = Y(mode); //get tensor rotation for mode
-   
-   auto V0 = model.CVbegin(mode); //get first V matrix
-   for (std::uint64_t j = sview->beginPlane(d); j < sview->endPlane(d); j++) //go through hyperplane in tensor rotation
+   typedef Eigen::Matrix<double, K, 1> Vector;
+   typedef Eigen::Array<double, K, 1> Array;
+   typedef Eigen::Matrix<double, K, K> Matrix;
+
+   // on the stack for fixed K
+   enum { MaxPanelCols = panel_max_cols(K) };
+   typedef Eigen::Matrix<double, K, Eigen::Dynamic, Eigen::ColMajor, K, MaxPanelCols> Panel;
+
+   //accumulates items [from, to) of hyperplane d into rr and MM
+   static void run(const TensorData& data, const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM)
    {
-      VectorXd col = (*V0).col(sview->getIndices()(j, 0)); //create a copy of m'th column from V (m = 0)
-      auto V = model.CVbegin(mode); //get V matrices for mode      
-      for (std::uint64_t m = 1; m < sview->getNCoords(); m++) //go through each coordinate of value
+      const int num_latent = model.nlatent();
+      std::shared_ptr<SparseMode> sview = data.Y(mode); //get tensor rotation for mode
+      const MatrixXui32& indices = sview->getIndices();
+      const std::vector<double>& values = sview->getValues();
+      auto &ns = data.noise();
+      const bool gaussian = ns.isGaussian();
+      const double alpha = ns.getAlpha();
+
+      //first column and column stride of the V matrices of the other modes
+      const double* V[N - 1];
+      Eigen::Index stride[N - 1];
+      auto Vit = model.CVbegin(mode);
+      for (int m = 0; m < N - 1; m++, ++Vit)
+      {
+         V[m] = (*Vit).data();
+         stride[m] = (*Vit).outerStride();
+      }
+
+      auto column = [&](int m, std::uint64_t j) { return Map<const Vector>(V[m] + indices(j, m) * stride[m], num_latent); };
+
+      const std::uint64_t begin = sview->beginPlane(d) + from;
+      const std::uint64_t end = sview->beginPlane(d) + to;
+
+      //product of the columns of the first N - 2 other modes of the last item
+      Vector prefix(num_latent);
+      auto item_column = [&](std::uint64_t j, double* col)
+      {
+         bool same_prefix = j > begin;
+         for (int m = 0; m < N - 2 && same_prefix; m++)
+            same_prefix = indices(j, m) == indices(j - 1, m);
+
+         if (N > 2 && !same_prefix)
+         {
+            prefix = column(0, j);
+            for (int m = 1; m < N - 2; m++)
+               prefix.array() *= column(m, j).array();
+         }
+
+         if (N > 2)
+            Map<Vector>(col, num_latent) = prefix.cwiseProduct(column(N - 2, j));
+         else
+            Map<Vector>(col, num_latent) = column(0, j);
+      };
+
+      Map<Vector> rr_k(rr.data(), num_latent);
+      Map<Matrix> MM_k(MM.data(), num_latent, num_latent);
+
+      if (end - begin < PANEL_MIN_ITEMS)
       {
-         ++V; //inc iterator prior to access since we are starting from m = 1
-         col.noalias() = col.cwiseProduct((*V).col(sview->getIndices()(j, m))); //multiply by m'th column from V
+         // too few items for a panel: one at a time
+         Vector col(num_latent);
+         for (std::uint64_t j = begin; j < end; j++) //go through hyperplane in tensor rotation
+         {
+            item_column(j, col.data());
+            MM_k.template triangularView<Eigen::Lower>() += alpha * col * col.transpose(); // MM = MM + (col * colT) * alpha
+
+            double noisy_val = gaussian ? alpha * values[j] : ns.sample(model, sview->pos(d, j), values[j]);
+            rr_k.noalias() += col * noisy_val; // rr = rr + (col * value) * alpha
+         }
       }
-      MM.triangularView<Eigen::Lower>() += noise().getAlpha() * col * col.transpose(); // MM = MM + (col * colT) * alpha (where col = product of columns in each V)
-      
-      auto pos = sview->pos(d, j);
-      double noisy_val = noise().sample(model, pos, sview->getValues()[j]);
-      rr.noalias() += col * noisy_val; // rr = rr + (col * value) * alpha (where value = j'th value of Y)
+      else
+      {
+         const std::uint64_t width = std::min<std::uint64_t>(panel_width(num_latent), end - begin);
+         Panel panel(num_latent, width);
+         Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, MaxPanelCols, 1> vals(width);
+
+         for (std::uint64_t i = begin; i < end; i += width)
+         {
+            const int w = std::min(width, end - i);
+            for (int j = 0; j < w; ++j)
+            {
+               item_column(i + j, panel.col(j).data());
+
+               // gaussian: alpha * val, the alpha is applied to rr below
+               vals(j) = gaussian ? values[i + j] : ns.sample(model, sview->pos(d, i + j), values[i + j]);
+            }
+
+            MM_k.template selfadjointView<Eigen::Lower>().rankUpdate(panel.leftCols(w), alpha);
+            if (gaussian)
+               rr_k.noalias() += alpha * (panel.leftCols(w) * vals.head(w));
+            else
+               rr_k.noalias() += panel.leftCols(w) * vals.head(w);
+         }
+      }
+
+      MM_k.template triangularView<Upper>() = MM_k.transpose();
    }
+};
 
-   MM.triangularView<Upper>() = MM.transpose();
+void TensorData::getMuLambda(const SubModel& model, uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const
+{
+   getMuLambdaRange(model, mode, d, 0, col_nnz(mode, d), rr, MM);
+}
+
+void TensorData::getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const
+{
+   dispatch_num_latent_modes<GetMuLambdaKernel>(model.nlatent(), nmode(), *this, model, mode, d, from, to, rr, MM);
+}
+
+std::uint64_t TensorData::col_nnz(uint32_t mode, int d) const
+{
+   return Y(mode)->nItemsOnPlane(d);
 }
 
 void TensorData::update_pnm(const SubModel& model, uint32_t mode)
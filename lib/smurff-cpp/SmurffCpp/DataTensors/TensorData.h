@@ -15,6 +15,8 @@
 
 namespace smurff {
 
+namespace tensor_io { class ChunkedTensorReader; }
+
 class TensorData : public Data
 {
 private:
@@ -22,9 +24,32 @@ private:
    std::uint64_t m_nnz;
    std::shared_ptr<std::vector<std::shared_ptr<SparseMode> > > m_Y; // this is a vector of tensor rotations
 
+   // getMuLambda specialized on num_latent and the number of modes
+   template<int K, int N> struct GetMuLambdaKernel;
+
+   // builds the modes from the file chunk by chunk, without the coordinates
+   // of all items in memory: one pass counts the items on every hyperplane,
+   // a second pass puts them in place
+   void readModes(const tensor_io::ChunkedTensorReader& reader, const std::vector<std::uint64_t>& plane_begin, const std::vector<std::uint64_t>& plane_end);
+
+   // nnz and name, once the modes are built
+   void initNNZ();
+
 public:
    TensorData(const smurff::TensorConfig& tc);
 
+   // keeps only the hyperplanes [plane_begin[m], plane_end[m]) of every mode m,
+   // enough to compute getMuLambda for these columns of U(m) (see MPIDistSession)
+   //
+   // nnz, sum and sumsq are over the entries on the kept hyperplanes of mode 0
+   //
+   // a config without data (see TensorConfig::hasData) is read from its file
+   TensorData(const smurff::TensorConfig& tc, const std::vector<std::uint64_t>& plane_begin, const std::vector<std::uint64_t>& plane_end);
+
+   // straight from a .sct file
+   TensorData(const tensor_io::ChunkedTensorReader& reader);
+   TensorData(const tensor_io::ChunkedTensorReader& reader, const std::vector<std::uint64_t>& plane_begin, const std::vector<std::uint64_t>& plane_end);
+
    std::shared_ptr<SparseMode> Y(std::uint64_t mode) const;
 
 protected:
@@ -42,6 +67,8 @@ public:
 public:
    double train_rmse(const SubModel& model) const override;
    void getMuLambda(const SubModel& model, uint32_t mode, int d, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
+   std::uint64_t col_nnz(uint32_t mode, int d) const override;
+   void getMuLambdaRange(const SubModel& model, uint32_t mode, int d, std::uint64_t from, std::uint64_t to, Eigen::VectorXd& rr, Eigen::MatrixXd& MM) const override;
    void update_pnm(const SubModel& model, uint32_t mode) override;
 
 public:
@@ -0,0 +1,395 @@
+#include "ChunkedTensor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <SmurffCpp/IO/TensorIO.h>
+#include <SmurffCpp/IO/TextIO.h>
+#include <SmurffCpp/Utils/Error.h>
+
+using namespace smurff;
+
+const char tensor_io::ChunkedTensorReader::MAGIC[8] = { 'S', 'M', 'U', 'R', 'F', 'S', 'C', 'T' };
+constexpr std::uint64_t tensor_io::ChunkedTensorReader::VERSION;
+constexpr std::uint64_t tensor_io::ChunkedTensorReader::FLAG_BINARY;
+constexpr std::uint64_t tensor_io::ChunkedTensorReader::CHUNK_SIZE_DEFAULT_VALUE;
+
+// encoding and nbytes in front of every column
+#define COLUMN_HEADER_SIZE (2 * sizeof(std::uint64_t))
+
+static std::uint64_t padded(std::uint64_t nbytes)
+{
+   return (nbytes + 7) & ~(std::uint64_t)7;
+}
+
+// small differences of either sign give small numbers
+static std::uint64_t zigzag(std::int64_t v)
+{
+   return ((std::uint64_t)v << 1) ^ (std::uint64_t)(v >> 63);
+}
+
+static std::int64_t unzigzag(std::uint64_t v)
+{
+   return (std::int64_t)(v >> 1) ^ -(std::int64_t)(v & 1);
+}
+
+static std::uint64_t varint_size(std::uint64_t v)
+{
+   std::uint64_t n = 1;
+   for (; v >= 0x80; v >>= 7)
+      n++;
+   return n;
+}
+
+static std::uint64_t delta_varint_size(const std::uint32_t* begin, const std::uint32_t* end)
+{
+   std::uint64_t nbytes = 0;
+   std::int64_t prev = 0;
+   for (const std::uint32_t* p = begin; p < end; ++p)
+   {
+      nbytes += varint_size(zigzag((std::int64_t)*p - prev));
+      prev = *p;
+   }
+   return nbytes;
+}
+
+static void write_delta_varint(std::vector<char>& out, const std::uint32_t* begin, const std::uint32_t* end)
+{
+   std::int64_t prev = 0;
+   for (const std::uint32_t* p = begin; p < end; ++p)
+   {
+      std::uint64_t v = zigzag((std::int64_t)*p - prev);
+      for (; v >= 0x80; v >>= 7)
+         out.push_back((char)(v | 0x80));
+      out.push_back((char)v);
+      prev = *p;
+   }
+}
+
+// false if [p, end) does not hold exactly n coordinates
+static bool read_delta_varint(const char* p, const char* end, std::uint32_t* out, std::uint64_t n)
+{
+   std::int64_t prev = 0;
+   for (std::uint64_t i = 0; i < n; i++)
+   {
+      std::uint64_t v = 0;
+      for (int shift = 0; ; shift += 7)
+      {
+         if (p == end || shift >= 64)
+            return false;
+
+         unsigned char b = *p++;
+         v |= (std::uint64_t)(b & 0x7f) << shift;
+         if (!(b & 0x80))
+            break;
+      }
+
+      prev += unzigzag(v);
+      if (prev < 0 || prev > std::numeric_limits<std::uint32_t>::max())
+         return false;
+
+      out[i] = (std::uint32_t)prev;
+   }
+
+   return p == end;
+}
+
+// numbers are read and written in host byte order, the format is little endian
+static void check_little_endian()
+{
+   const std::uint32_t one = 1;
+   unsigned char first;
+   std::memcpy(&first, &one, 1);
+   THROWERROR_ASSERT_MSG(first == 1, "Chunked sparse tensors (.sct) are little endian, they can not be read or written on this host");
+}
+
+static void write_uint64(std::ostream& out, std::uint64_t value)
+{
+   out.write(reinterpret_cast<const char*>(&value), sizeof(std::uint64_t));
+}
+
+// ======================================================================================================
+
+tensor_io::ChunkedTensorReader::ChunkedTensorReader(const std::string& filename)
+   : m_file(std::make_shared<MappedFile>(filename)), m_name(filename)
+{
+   m_data = m_file->data<char>(0, m_file->size());
+   m_size = m_file->size();
+   readHeader();
+}
+
+tensor_io::ChunkedTensorReader::ChunkedTensorReader(const char* begin, const char* end)
+   : m_name("memory"), m_data(begin), m_size(end - begin)
+{
+   readHeader();
+}
+
+const char* tensor_io::ChunkedTensorReader::at(std::uint64_t offset, std::uint64_t nbytes) const
+{
+   THROWERROR_ASSERT_MSG(offset <= m_size && nbytes <= m_size - offset, "Unexpected end of file: " + m_name);
+   return m_data + offset;
+}
+
+void tensor_io::ChunkedTensorReader::readHeader()
+{
+   check_little_endian();
+   THROWERROR_ASSERT_MSG(std::memcmp(at(0, sizeof(MAGIC)), MAGIC, sizeof(MAGIC)) == 0, "Not a chunked sparse tensor: " + m_name);
+
+   std::uint64_t offset = sizeof(MAGIC);
+   auto next = [this, &offset]()
+   {
+      std::uint64_t value;
+      std::memcpy(&value, at(offset, sizeof(std::uint64_t)), sizeof(std::uint64_t));
+      offset += sizeof(std::uint64_t);
+      return value;
+   };
+
+   std::uint64_t version = next();
+   THROWERROR_ASSERT_MSG(version == VERSION, "Unsupported version " + std::to_string(version) + " of " + m_name);
+
+   m_flags = next();
+
+   std::uint64_t nmodes = next();
+   THROWERROR_ASSERT_MSG(nmodes > 0 && nmodes <= m_size / sizeof(std::uint64_t), "Invalid number of modes in " + m_name);
+
+   m_dims.resize(nmodes);
+   for (auto& d : m_dims)
+      d = next();
+
+   m_nnz = next();
+   m_chunkSize = next();
+   std::uint64_t nchunks = next();
+
+   bool chunks_ok = m_nnz == 0 ? nchunks == 0 : m_chunkSize > 0 && nchunks == (m_nnz - 1) / m_chunkSize + 1;
+   THROWERROR_ASSERT_MSG(chunks_ok && nchunks < m_size / sizeof(std::uint64_t), "Invalid number of chunks in " + m_name);
+
+   // the index is at the end of the file
+   std::uint64_t index_offset = m_size - (nchunks + 1) * sizeof(std::uint64_t);
+   m_index.resize(nchunks + 1);
+   std::memcpy(m_index.data(), at(index_offset, m_index.size() * sizeof(std::uint64_t)), m_index.size() * sizeof(std::uint64_t));
+
+   THROWERROR_ASSERT_MSG(m_index.front() == offset && m_index.back() == index_offset && std::is_sorted(m_index.begin(), m_index.end()),
+                         "Invalid chunk index in " + m_name);
+}
+
+const char* tensor_io::ChunkedTensorReader::column(std::uint64_t chunk, std::uint64_t mode, ColumnEncoding& encoding, std::uint64_t& nbytes) const
+{
+   THROWERROR_ASSERT(chunk < getNChunks() && mode < getNModes());
+
+   const std::uint64_t chunk_end = m_index[chunk + 1];
+   std::uint64_t offset = m_index[chunk];
+   for (std::uint64_t m = 0; ; m++)
+   {
+      THROWERROR_ASSERT_MSG(COLUMN_HEADER_SIZE <= chunk_end - offset, "Invalid chunk in " + m_name);
+
+      std::uint64_t header[2];
+      std::memcpy(header, at(offset, COLUMN_HEADER_SIZE), COLUMN_HEADER_SIZE);
+      offset += COLUMN_HEADER_SIZE;
+
+      THROWERROR_ASSERT_MSG(header[1] <= chunk_end - offset && padded(header[1]) <= chunk_end - offset, "Invalid chunk in " + m_name);
+
+      if (m == mode)
+      {
+         encoding = static_cast<ColumnEncoding>(header[0]);
+         nbytes = header[1];
+         return m_data + offset;
+      }
+
+      offset += padded(header[1]);
+   }
+}
+
+const std::string& tensor_io::ChunkedTensorReader::getName() const
+{
+   return m_name;
+}
+
+const std::vector<std::uint64_t>& tensor_io::ChunkedTensorReader::getDims() const
+{
+   return m_dims;
+}
+
+std::uint64_t tensor_io::ChunkedTensorReader::getNModes() const
+{
+   return m_dims.size();
+}
+
+std::uint64_t tensor_io::ChunkedTensorReader::getNNZ() const
+{
+   return m_nnz;
+}
+
+bool tensor_io::ChunkedTensorReader::isBinary() const
+{
+   return (m_flags & FLAG_BINARY) != 0;
+}
+
+std::uint64_t tensor_io::ChunkedTensorReader::getNChunks() const
+{
+   return m_index.size() - 1;
+}
+
+std::uint64_t tensor_io::ChunkedTensorReader::chunkBegin(std::uint64_t chunk) const
+{
+   return chunk * m_chunkSize;
+}
+
+std::uint64_t tensor_io::ChunkedTensorReader::chunkSize(std::uint64_t chunk) const
+{
+   return std::min(m_chunkSize, m_nnz - chunkBegin(chunk));
+}
+
+void tensor_io::ChunkedTensorReader::readColumn(std::uint64_t chunk, std::uint64_t mode, std::uint32_t* out) const
+{
+   ColumnEncoding encoding;
+   std::uint64_t nbytes;
+   const char* data = column(chunk, mode, encoding, nbytes);
+   const std::uint64_t n = chunkSize(chunk);
+
+   switch (encoding)
+   {
+   case ColumnEncoding::raw:
+      {
+         THROWERROR_ASSERT_MSG(nbytes == n * sizeof(std::uint32_t), "Invalid column in " + m_name);
+         std::memcpy(out, data, nbytes);
+         break;
+      }
+   case ColumnEncoding::delta_varint:
+      {
+         THROWERROR_ASSERT_MSG(read_delta_varint(data, data + nbytes, out, n), "Invalid column in " + m_name);
+         break;
+      }
+   default:
+      {
+         THROWERROR("Unknown column encoding in " + m_name);
+      }
+   }
+}
+
+void tensor_io::ChunkedTensorReader::readValues(std::uint64_t chunk, double* out) const
+{
+   const std::uint64_t n = chunkSize(chunk);
+   if (isBinary())
+   {
+      std::fill(out, out + n, 1.0);
+      return;
+   }
+
+   // the values follow the column of the last mode
+   ColumnEncoding encoding;
+   std::uint64_t nbytes;
+   const char* last = column(chunk, getNModes() - 1, encoding, nbytes);
+   const std::uint64_t offset = (last - m_data) + padded(nbytes);
+
+   THROWERROR_ASSERT_MSG(m_index[chunk + 1] - offset == n * sizeof(double), "Invalid chunk in " + m_name);
+   std::memcpy(out, at(offset, n * sizeof(double)), n * sizeof(double));
+}
+
+std::shared_ptr<TensorConfig> tensor_io::ChunkedTensorReader::readAll(bool isScarce) const
+{
+   std::vector<std::uint64_t> dims = m_dims;
+   std::vector<std::uint32_t> columns(getNModes() * m_nnz);
+   std::vector<double> values(m_nnz);
+
+   for (std::uint64_t c = 0; c < getNChunks(); c++)
+   {
+      for (std::uint64_t m = 0; m < getNModes(); m++)
+         readColumn(c, m, columns.data() + m * m_nnz + chunkBegin(c));
+
+      if (!isBinary())
+         readValues(c, values.data() + chunkBegin(c));
+   }
+
+   if (isBinary())
+      return std::make_shared<TensorConfig>(std::move(dims), std::move(columns), NoiseConfig(), isScarce);
+   else
+      return std::make_shared<TensorConfig>(std::move(dims), std::move(columns), std::move(values), NoiseConfig(), isScarce);
+}
+
+// ======================================================================================================
+
+std::shared_ptr<TensorConfig> tensor_io::read_sparse_chunked(std::istream& in, bool isScarce)
+{
+   std::string data = text_io::read_all(in);
+   return ChunkedTensorReader(data.data(), data.data() + data.size()).readAll(isScarce);
+}
+
+void tensor_io::write_sparse_chunked(std::ostream& out, std::shared_ptr<const TensorConfig> tensorConfig)
+{
+   tensor_io::write_sparse_chunked(out, tensorConfig, ChunkedTensorReader::CHUNK_SIZE_DEFAULT_VALUE, true);
+}
+
+void tensor_io::write_sparse_chunked(std::ostream& out, std::shared_ptr<const TensorConfig> tensorConfig, std::uint64_t chunk_size, bool delta)
+{
+   THROWERROR_ASSERT_MSG(chunk_size > 0, "Chunk size should be positive");
+   check_little_endian();
+
+   const std::uint64_t nmodes = tensorConfig->getNModes();
+   const std::uint64_t nnz = tensorConfig->getNNZ();
+   const std::vector<std::uint64_t>& dims = tensorConfig->getDims();
+   const std::vector<std::uint32_t>& columns = tensorConfig->getColumns();
+   const std::vector<double>& values = tensorConfig->getValues();
+   const bool isBinary = tensorConfig->isBinary();
+
+   THROWERROR_ASSERT_MSG(columns.size() == nmodes * nnz, "Tensor data is not in memory");
+
+   const std::uint64_t nchunks = nnz == 0 ? 0 : (nnz - 1) / chunk_size + 1;
+
+   out.write(ChunkedTensorReader::MAGIC, sizeof(ChunkedTensorReader::MAGIC));
+   write_uint64(out, ChunkedTensorReader::VERSION);
+   write_uint64(out, isBinary ? ChunkedTensorReader::FLAG_BINARY : 0);
+   write_uint64(out, nmodes);
+   for (auto d : dims)
+      write_uint64(out, d);
+   write_uint64(out, nnz);
+   write_uint64(out, chunk_size);
+   write_uint64(out, nchunks);
+
+   std::uint64_t offset = sizeof(ChunkedTensorReader::MAGIC) + (6 + nmodes) * sizeof(std::uint64_t);
+   std::vector<std::uint64_t> index;
+   std::vector<char> encoded;
+   const char padding[8] = { 0 };
+
+   for (std::uint64_t c = 0; c < nchunks; c++)
+   {
+      index.push_back(offset);
+
+      const std::uint64_t begin = c * chunk_size;
+      const std::uint64_t n = std::min(chunk_size, nnz - begin);
+
+      for (std::uint64_t m = 0; m < nmodes; m++)
+      {
+         const std::uint32_t* col = columns.data() + m * nnz + begin;
+
+         ColumnEncoding encoding = ColumnEncoding::raw;
+         std::uint64_t nbytes = n * sizeof(std::uint32_t);
+         const char* data = reinterpret_cast<const char*>(col);
+
+         if (delta && delta_varint_size(col, col + n) < nbytes)
+         {
+            encoded.clear();
+            write_delta_varint(encoded, col, col + n);
+            encoding = ColumnEncoding::delta_varint;
+            nbytes = encoded.size();
+            data = encoded.data();
+         }
+
+         write_uint64(out, static_cast<std::uint64_t>(encoding));
+         write_uint64(out, nbytes);
+         out.write(data, nbytes);
+         out.write(padding, padded(nbytes) - nbytes);
+
+         offset += COLUMN_HEADER_SIZE + padded(nbytes);
+      }
+
+      if (!isBinary)
+      {
+         out.write(reinterpret_cast<const char*>(values.data() + begin), n * sizeof(double));
+         offset += n * sizeof(double);
+      }
+   }
+
+   index.push_back(offset);
+   out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(std::uint64_t));
+}
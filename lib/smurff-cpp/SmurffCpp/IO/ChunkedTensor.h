@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Configs/TensorConfig.h>
+#include <SmurffCpp/IO/MappedFile.h>
+
+//
+// chunked sparse tensor (.sct): the items are stored in chunks of at most
+// chunk_size items, every chunk holds one column of coordinates per mode
+// and a column of values, so that a tensor can be read chunk by chunk
+// without keeping all its coordinates in memory
+//
+// all numbers are little endian, coordinates are 0-based. The reader and
+// the writer use the host byte order and throw on big endian hosts.
+//
+//    char[8]     magic "SMURFSCT"
+//    uint64      version
+//    uint64      flags (FLAG_BINARY: no values, all are 1)
+//    uint64      nmodes
+//    uint64      dims[nmodes]
+//    uint64      nnz
+//    uint64      chunk_size
+//    uint64      nchunks
+//
+//    chunk c, for every mode m:
+//       uint64   encoding of the column
+//       uint64   nbytes
+//       char     column[nbytes], zero padded to a multiple of 8 bytes
+//    followed by
+//       double   values[n] unless FLAG_BINARY
+//
+//    uint64      index[nchunks + 1], byte offsets of the chunks, the
+//                last one is the offset of the index itself
+//
+
+namespace smurff { namespace tensor_io
+{
+   enum class ColumnEncoding : std::uint64_t
+   {
+      raw = 0,          // uint32 per coordinate
+      delta_varint = 1  // difference with the previous coordinate in the chunk,
+                        // zigzag encoded in LEB128 varints
+   };
+
+   // reads a .sct tensor from a file, or from memory, chunk by chunk
+   // (see tensor_io::write_sparse_chunked for writing)
+   class ChunkedTensorReader
+   {
+   public:
+      static const char MAGIC[8];
+      static constexpr std::uint64_t VERSION = 1;
+      static constexpr std::uint64_t FLAG_BINARY = 1;
+
+      // items per chunk written by write_tensor
+      static constexpr std::uint64_t CHUNK_SIZE_DEFAULT_VALUE = 1 << 20;
+
+   private:
+      std::shared_ptr<MappedFile> m_file; // null when reading from memory
+      std::string m_name;
+      const char* m_data;
+      std::uint64_t m_size;
+
+      std::uint64_t m_flags;
+      std::vector<std::uint64_t> m_dims;
+      std::uint64_t m_nnz;
+      std::uint64_t m_chunkSize;
+      std::vector<std::uint64_t> m_index;
+
+   public:
+      explicit ChunkedTensorReader(const std::string& filename);
+
+      // [begin, end) has to stay valid as long as this object
+      ChunkedTensorReader(const char* begin, const char* end);
+
+   private:
+      void readHeader();
+
+      // nbytes at offset, after checking they are in the file
+      const char* at(std::uint64_t offset, std::uint64_t nbytes) const;
+
+      // encoded column of mode in chunk, sets encoding and nbytes
+      const char* column(std::uint64_t chunk, std::uint64_t mode, ColumnEncoding& encoding, std::uint64_t& nbytes) const;
+
+   public:
+      const std::string& getName() const;
+
+      const std::vector<std::uint64_t>& getDims() const;
+      std::uint64_t getNModes() const;
+      std::uint64_t getNNZ() const;
+      bool isBinary() const;
+
+      std::uint64_t getNChunks() const;
+
+      // first item of chunk
+      std::uint64_t chunkBegin(std::uint64_t chunk) const;
+
+      // number of items in chunk
+      std::uint64_t chunkSize(std::uint64_t chunk) const;
+
+      // coordinates of mode in chunk, into out[0, chunkSize(chunk))
+      void readColumn(std::uint64_t chunk, std::uint64_t mode, std::uint32_t* out) const;
+
+      // values in chunk, into out[0, chunkSize(chunk))
+      void readValues(std::uint64_t chunk, double* out) const;
+
+      // whole tensor in memory
+      std::shared_ptr<TensorConfig> readAll(bool isScarce) const;
+   };
+}}
@@ -0,0 +1,63 @@
+#include "MappedFile.h"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <SmurffCpp/IO/GenericIO.h>
+
+using namespace smurff;
+
+MappedFile::MappedFile(const std::string& filename)
+   : m_filename(filename), m_data(nullptr), m_size(0), m_isMapped(false)
+{
+   THROWERROR_FILE_NOT_EXIST(filename);
+
+#ifndef _WIN32
+   int fd = ::open(filename.c_str(), O_RDONLY);
+   THROWERROR_ASSERT_MSG(fd >= 0, "Error opening file: " + filename);
+
+   struct stat st;
+   if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+   {
+      void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED)
+      {
+         m_data = static_cast<const char*>(addr);
+         m_size = st.st_size;
+         m_isMapped = true;
+      }
+   }
+
+   // the mapping stays valid after closing
+   ::close(fd);
+
+   if (m_isMapped)
+      return;
+#endif
+
+   // no mapping: read the whole file
+   std::ifstream fileStream(filename, std::ios_base::binary | std::ios_base::ate);
+   THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
+
+   m_buffer.resize(fileStream.tellg());
+   fileStream.seekg(0);
+   fileStream.read(m_buffer.data(), m_buffer.size());
+   THROWERROR_ASSERT_MSG(fileStream.good(), "Error reading file: " + filename);
+
+   m_data = m_buffer.data();
+   m_size = m_buffer.size();
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+   if (m_isMapped)
+      ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Utils/Error.h>
+
+namespace smurff
+{
+   // read-only contents of a file
+   //
+   // the file is memory mapped where the platform allows it, so that only
+   // the pages that are accessed are read from disk; otherwise it is read
+   // into a buffer owned by this object
+   class MappedFile
+   {
+   private:
+      std::string m_filename;
+      const char* m_data;
+      std::uint64_t m_size;
+      bool m_isMapped;
+      std::vector<char> m_buffer;
+
+   public:
+      explicit MappedFile(const std::string& filename);
+      ~MappedFile();
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+   public:
+      const std::string& getFilename() const
+      {
+         return m_filename;
+      }
+
+      std::uint64_t size() const
+      {
+         return m_size;
+      }
+
+      bool isMapped() const
+      {
+         return m_isMapped;
+      }
+
+      // count elements of type T at byte offset, valid as long as this object
+      template<typename T>
+      const T* data(std::uint64_t offset, std::uint64_t count) const
+      {
+         THROWERROR_ASSERT_MSG(offset <= m_size && count <= (m_size - offset) / sizeof(T), "Unexpected end of file: " + m_filename);
+
+         const char* ptr = m_data + offset;
+         THROWERROR_ASSERT_MSG(reinterpret_cast<std::uintptr_t>(ptr) % alignof(T) == 0, "Misaligned data in " + m_filename);
+
+         return reinterpret_cast<const T*>(ptr);
+      }
+
+      // single element of type T at byte offset
+      template<typename T>
+      T get(std::uint64_t offset) const
+      {
+         return *data<T>(offset, 1);
+      }
+   };
+}
@@ -12,6 +12,7 @@
 #include <SmurffCpp/Utils/Error.h>
 
 #include <SmurffCpp/IO/GenericIO.h>
+#include <SmurffCpp/IO/TextIO.h>
 
 using namespace smurff;
 
@@ -92,6 +93,195 @@ std::string MatrixTypeToExtension(matrix_io::MatrixType matrixType)
    return std::string();
 }
 
+// ======================================================================================================
+// text formats: the whole text is parsed in parallel by text_io
+
+// nrow and ncol on the first two lines, p is moved to the values
+static void read_csv_header(const char*& p, const char* end, std::uint64_t& nrow, std::uint64_t& ncol)
+{
+   if (!text_io::parse_line(p, end, nrow) || !text_io::parse_line(p, end, ncol))
+   {
+      THROWERROR("Could not get 'rows', 'cols' values for csv matrix format");
+   }
+}
+
+// one line with ncol comma separated values per row, values in column major order
+static void read_csv_values(const char* begin, const char* end, std::uint64_t nrow, std::uint64_t ncol, double* values)
+{
+   std::uint64_t nlines = text_io::for_each_record(begin, end, '\n', 0, [=](const char* p, const char* last, std::uint64_t row)
+   {
+      if (row >= nrow)
+         return true;
+
+      for (std::uint64_t col = 0; col < ncol; col++)
+      {
+         if (!text_io::parse(p, last, values[nrow * col + row]))
+            return false;
+      }
+
+      return text_io::at_end(p, last);
+   }, "invalid number of columns");
+
+   if (nlines < nrow)
+   {
+      THROWERROR("invalid number of rows");
+   }
+}
+
+namespace {
+   struct MatrixMarketHeader
+   {
+      std::string format;
+      std::string field;
+      std::uint64_t nrows;
+      std::uint64_t ncols;
+      std::uint64_t nnz;
+   };
+}
+
+// MatrixMarket format specification
+// https://github.com/ExaScience/smurff/files/1398286/MMformat.pdf
+//
+// banner and size line, p is moved to the first entry
+static MatrixMarketHeader read_matrix_market_header(const char*& p, const char* end)
+{
+   // Check that text has MatrixMarket format data
+   const std::string banner = "%%MatrixMarket";
+   if ((std::uint64_t)(end - p) <= banner.size() || !std::equal(banner.begin(), banner.end(), p) || !std::isblank(p[banner.size()]))
+   {
+      std::stringstream ss;
+      ss << "Cannot read MatrixMarket from input stream: ";
+      ss << "the first 15 characters must be '%%MatrixMarket' followed by at least one blank";
+      THROWERROR(ss.str());
+   }
+
+   // Parse MatrixMarket header
+   const char* header_end = text_io::line_end(p, end);
+   std::stringstream headerStream(std::string(p + banner.size(), header_end));
+   p = header_end;
+
+   MatrixMarketHeader header;
+
+   std::string object;
+   headerStream >> object;
+   std::transform(object.begin(), object.end(), object.begin(), ::toupper);
+
+   headerStream >> header.format;
+   std::transform(header.format.begin(), header.format.end(), header.format.begin(), ::toupper);
+
+   headerStream >> header.field;
+   std::transform(header.field.begin(), header.field.end(), header.field.begin(), ::toupper);
+
+   std::string symmetry;
+   headerStream >> symmetry;
+   std::transform(symmetry.begin(), symmetry.end(), symmetry.begin(), ::toupper);
+
+   // Check object type
+   if (object != MM_OBJ_MATRIX)
+   {
+      std::stringstream ss;
+      ss << "Invalid MartrixMarket object type: expected 'matrix' but got '" << object << "'";
+      THROWERROR(ss.str());
+   }
+
+   // Check format type
+   if (header.format != MM_FMT_COORD && header.format != MM_FMT_ARRAY)
+   {
+      std::stringstream ss;
+      ss << "Invalid MatrixMarket format type: expected 'coordinate' or 'array' but got '" << header.format << "'";
+      THROWERROR(ss.str());
+   }
+
+   // Check field type
+   if (header.field != MM_FLD_REAL && header.field != MM_FLD_PATTERN)
+   {
+      THROWERROR("Invalid MatrixMarket field type: only 'real' and 'pattern' field types are supported");
+   }
+
+   if (header.format == MM_FMT_ARRAY && header.field != MM_FLD_REAL)
+   {
+      THROWERROR("Invalid MatrixMarket field type: array format supports only 'real' field type");
+   }
+
+   // Check symmetry type
+   if (symmetry != MM_SYM_GENERAL)
+   {
+      THROWERROR("Invalid MatrixMarket symmetry type: only 'general' symmetry type is supported");
+   }
+
+   // Skip comments and empty lines
+   p = text_io::skip_lines(p, end, '%');
+
+   // Read size
+   const char* size_end = text_io::line_end(p, end);
+   if (header.format == MM_FMT_COORD)
+   {
+      if (!text_io::parse(p, size_end, header.nrows) || !text_io::parse(p, size_end, header.ncols) || !text_io::parse(p, size_end, header.nnz))
+      {
+         THROWERROR("Could not get 'rows', 'cols', 'nnz' values for coordinate matrix format");
+      }
+   }
+   else
+   {
+      if (!text_io::parse(p, size_end, header.nrows) || !text_io::parse(p, size_end, header.ncols))
+      {
+         THROWERROR("Could not get 'rows', 'cols' values for array matrix format");
+      }
+      header.nnz = header.nrows * header.ncols;
+   }
+   p = size_end;
+
+   return header;
+}
+
+// f(i, row, col, val) for every entry i of a coordinate text, with 0-based row and col
+template<typename F>
+static void read_matrix_market_coordinates(const char* begin, const char* end, const MatrixMarketHeader& header, F f)
+{
+   const bool pattern = header.field == MM_FLD_PATTERN;
+
+   std::uint64_t nentries = text_io::for_each_record(begin, end, '\n', '%', [&](const char* p, const char* last, std::uint64_t i)
+   {
+      if (i >= header.nnz)
+         return true;
+
+      std::uint32_t row;
+      std::uint32_t col;
+      double val = 1.0;
+
+      if (!text_io::parse(p, last, row) || !text_io::parse(p, last, col))
+         return false;
+
+      if (!pattern && !text_io::parse(p, last, val))
+         return false;
+
+      if (row < 1 || row > header.nrows || col < 1 || col > header.ncols)
+         return false;
+
+      f(i, row - 1, col - 1, val);
+      return true;
+   }, "Could not parse an entry line for coordinate matrix format");
+
+   if (nentries < header.nnz)
+   {
+      THROWERROR("Could not parse an entry line for coordinate matrix format");
+   }
+}
+
+// the values of an array text, one per line in column major order
+static void read_matrix_market_array(const char* begin, const char* end, const MatrixMarketHeader& header, double* values)
+{
+   std::uint64_t nvalues = text_io::for_each_record(begin, end, '\n', '%', [&](const char* p, const char* last, std::uint64_t i)
+   {
+      return i >= header.nnz || text_io::parse(p, last, values[i]);
+   }, "Could not parse an entry line for array matrix format");
+
+   if (nvalues < header.nnz)
+   {
+      THROWERROR("Could not parse an entry line for array matrix format");
+   }
+}
+
 std::shared_ptr<MatrixConfig> matrix_io::read_matrix(const std::string& filename, bool isScarce)
 {
    std::shared_ptr<MatrixConfig> ret;
@@ -104,37 +294,34 @@ std::shared_ptr<MatrixConfig> matrix_io::read_matrix(const std::string& filename
    {
    case matrix_io::MatrixType::sdm:
       {
-         std::ifstream fileStream(filename, std::ios_base::binary);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         ret = matrix_io::read_sparse_float64_bin(fileStream, isScarce);
+         MappedFile file(filename);
+         ret = matrix_io::read_sparse_float64_bin(file, isScarce);
          break;
       }
    case matrix_io::MatrixType::sbm:
       {
-         std::ifstream fileStream(filename, std::ios_base::binary);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         ret = matrix_io::read_sparse_binary_bin(fileStream, isScarce);
+         MappedFile file(filename);
+         ret = matrix_io::read_sparse_binary_bin(file, isScarce);
          break;
       }
    case matrix_io::MatrixType::mtx:
       {
-         std::ifstream fileStream(filename);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         ret = matrix_io::read_matrix_market(fileStream, isScarce);
+         MappedFile file(filename);
+         const char* text = file.data<char>(0, file.size());
+         ret = matrix_io::read_matrix_market(text, text + file.size(), isScarce);
          break;
       }
    case matrix_io::MatrixType::csv:
       {
-         std::ifstream fileStream(filename);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         ret = matrix_io::read_dense_float64_csv(fileStream);
+         MappedFile file(filename);
+         const char* text = file.data<char>(0, file.size());
+         ret = matrix_io::read_dense_float64_csv(text, text + file.size());
          break;
       }
    case matrix_io::MatrixType::ddm:
       {
-         std::ifstream fileStream(filename, std::ios_base::binary);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         ret = matrix_io::read_dense_float64_bin(fileStream);
+         MappedFile file(filename);
+         ret = matrix_io::read_dense_float64_bin(file);
          break;
       }
    case matrix_io::MatrixType::none:
@@ -168,54 +355,17 @@ std::shared_ptr<MatrixConfig> matrix_io::read_dense_float64_bin(std::istream& in
 
 std::shared_ptr<MatrixConfig> matrix_io::read_dense_float64_csv(std::istream& in)
 {
-   std::stringstream ss;
-   std::string line;
-
-   // rows and cols
-   getline(in, line);
-   ss.clear();
-   ss << line;
-   std::uint64_t nrow;
-   ss >> nrow;
-
-   getline(in, line);
-   ss.clear();
-   ss << line;
-   std::uint64_t ncol;
-   ss >> ncol;
-
-   std::uint64_t nnz = nrow * ncol;
-
-   std::vector<double> values;
-   values.resize(nnz);
-
-   std::uint64_t row = 0;
-   std::uint64_t col = 0;
-
-   while(getline(in, line) && row < nrow)
-   {
-      col = 0;
-
-      std::stringstream lineStream(line);
-      std::string cell;
-
-      while (std::getline(lineStream, cell, ',') && col < ncol)
-      {
-         values[(nrow * col++) + row] = stod(cell);
-      }
-
-      row++;
-   }
+   std::string text = text_io::read_all(in);
+   return matrix_io::read_dense_float64_csv(text.data(), text.data() + text.size());
+}
 
-   if(row != nrow)
-   {
-      THROWERROR("invalid number of rows");
-   }
+std::shared_ptr<MatrixConfig> matrix_io::read_dense_float64_csv(const char* begin, const char* end)
+{
+   std::uint64_t nrow, ncol;
+   read_csv_header(begin, end, nrow, ncol);
 
-   if(col != ncol)
-   {
-      THROWERROR("invalid number of columns");
-   }
+   std::vector<double> values(nrow * ncol);
+   read_csv_values(begin, end, nrow, ncol, values.data());
 
    return std::make_shared<smurff::MatrixConfig>(nrow, ncol, std::move(values), smurff::NoiseConfig());
 }
@@ -280,155 +430,95 @@ std::shared_ptr<MatrixConfig> matrix_io::read_sparse_binary_bin(std::istream& in
    return std::make_shared<smurff::MatrixConfig>(nrow, ncol, std::move(rows), std::move(cols), smurff::NoiseConfig(), isScarce);
 }
 
-// MatrixMarket format specification
-// https://github.com/ExaScience/smurff/files/1398286/MMformat.pdf
-std::shared_ptr<MatrixConfig> matrix_io::read_matrix_market(std::istream& in, bool isScarce)
-{
-   // Check that stream has MatrixMarket format data
-   std::array<char, 15> matrixMarketArr;
-   in.read(matrixMarketArr.data(), 14);
-   std::string matrixMarketStr(matrixMarketArr.begin(), matrixMarketArr.end());
-   if (matrixMarketStr != "%%MatrixMarket" && !std::isblank(in.get()))
-   {
-      std::stringstream ss;
-      ss << "Cannot read MatrixMarket from input stream: ";
-      ss << "the first 15 characters must be '%%MatrixMarket' followed by at least one blank";
-      THROWERROR(ss.str());
-   }
-
-   // Parse MatrixMarket header
-   std::string headerStr;
-   std::getline(in, headerStr);
-   std::stringstream headerStream(headerStr);
+// layout of .sdm and .sbm: nrow, ncol, nnz, then nnz 1-based rows, nnz 1-based cols (and nnz values)
+#define SPARSE_HEADER_SIZE (3 * sizeof(std::uint64_t))
 
-   std::string object;
-   headerStream >> object;
-   std::transform(object.begin(), object.end(), object.begin(), ::toupper);
+static void read_sparse_header(const MappedFile& file, std::uint64_t& nrow, std::uint64_t& ncol, std::uint64_t& nnz)
+{
+   nrow = file.get<std::uint64_t>(0);
+   ncol = file.get<std::uint64_t>(sizeof(std::uint64_t));
+   nnz = file.get<std::uint64_t>(2 * sizeof(std::uint64_t));
+}
 
-   std::string format;
-   headerStream >> format;
-   std::transform(format.begin(), format.end(), format.begin(), ::toupper);
+// 1-based indices in the file, 0-based in memory: a copy is needed anyway
+static std::vector<std::uint32_t> read_sparse_indices(const MappedFile& file, std::uint64_t offset, std::uint64_t nnz)
+{
+   const std::uint32_t* idx = file.data<std::uint32_t>(offset, nnz);
 
-   std::string field;
-   headerStream >> field;
-   std::transform(field.begin(), field.end(), field.begin(), ::toupper);
+   std::vector<std::uint32_t> ret(nnz);
+   std::transform(idx, idx + nnz, ret.begin(), [](std::uint32_t i){ return i - 1; });
+   return ret;
+}
 
-   std::string symmetry;
-   headerStream >> symmetry;
-   std::transform(symmetry.begin(), symmetry.end(), symmetry.begin(), ::toupper);
+std::shared_ptr<MatrixConfig> matrix_io::read_dense_float64_bin(const MappedFile& file)
+{
+   std::uint64_t nrow = file.get<std::uint64_t>(0);
+   std::uint64_t ncol = file.get<std::uint64_t>(sizeof(std::uint64_t));
 
-   // Check object type
-   if (object != MM_OBJ_MATRIX)
-   {
-      std::stringstream ss;
-      ss << "Invalid MartrixMarket object type: expected 'matrix' but got '" << object << "'";
-      THROWERROR(ss.str());
-   }
+   const double* data = file.data<double>(2 * sizeof(std::uint64_t), nrow * ncol);
+   std::vector<double> values(data, data + nrow * ncol);
 
-   // Check field type
-   if (field != MM_FLD_REAL && field != MM_FLD_PATTERN)
-   {
-      THROWERROR("Invalid MatrixMarket field type: only 'real' and 'pattern' field types are supported");
-   }
+   return std::make_shared<smurff::MatrixConfig>(nrow, ncol, std::move(values), smurff::NoiseConfig());
+}
 
-   // Check symmetry type
-   if (symmetry != MM_SYM_GENERAL)
-   {
-      THROWERROR("Invalid MatrixMarket symmetry type: only 'general' symmetry type is supported");
-   }
+std::shared_ptr<MatrixConfig> matrix_io::read_sparse_float64_bin(const MappedFile& file, bool isScarce)
+{
+   std::uint64_t nrow, ncol, nnz;
+   read_sparse_header(file, nrow, ncol, nnz);
 
-   // Skip comments and empty lines
-   while (in.peek() == '%' || in.peek() == '\n')
-      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+   std::vector<std::uint32_t> rows = read_sparse_indices(file, SPARSE_HEADER_SIZE, nnz);
+   std::vector<std::uint32_t> cols = read_sparse_indices(file, SPARSE_HEADER_SIZE + nnz * sizeof(std::uint32_t), nnz);
 
-   // Read data
-   if (format == MM_FMT_COORD)
-   {
-      std::uint64_t nrows;
-      std::uint64_t ncols;
-      std::uint64_t nnz;
-      in >> nrows >> ncols >> nnz;
+   const double* data = file.data<double>(SPARSE_HEADER_SIZE + 2 * nnz * sizeof(std::uint32_t), nnz);
+   std::vector<double> values(data, data + nnz);
 
-      if (in.fail())
-      {
-         THROWERROR("Could not get 'rows', 'cols', 'nnz' values for coordinate matrix format");
-      }
-
-      std::vector<std::uint32_t> rows(nnz);
-      std::vector<std::uint32_t> cols(nnz);
-      std::vector<double> vals(nnz);
+   return std::make_shared<smurff::MatrixConfig>(nrow, ncol, std::move(rows), std::move(cols), std::move(values), smurff::NoiseConfig(), isScarce);
+}
 
-      for (std::uint64_t i = 0; i < nnz; i++)
-      {
-         while (in.peek() == '%' || in.peek() == '\n')
-            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+std::shared_ptr<MatrixConfig> matrix_io::read_sparse_binary_bin(const MappedFile& file, bool isScarce)
+{
+   std::uint64_t nrow, ncol, nnz;
+   read_sparse_header(file, nrow, ncol, nnz);
 
-         std::uint32_t row;
-         std::uint32_t col;
-         double val;
+   std::vector<std::uint32_t> rows = read_sparse_indices(file, SPARSE_HEADER_SIZE, nnz);
+   std::vector<std::uint32_t> cols = read_sparse_indices(file, SPARSE_HEADER_SIZE + nnz * sizeof(std::uint32_t), nnz);
 
-         if (field == MM_FLD_REAL)
-         {
-            in >> row >> col >> val;
-         }
-         else if (field == MM_FLD_PATTERN)
-         {
-            in >> row >> col;
-            val = 1.0;
-         }
-         else
-         {
-            THROWERROR("Invalid MatrixMarket field type: coord format supports only 'real' and 'pattern' field types");
-         }
+   return std::make_shared<smurff::MatrixConfig>(nrow, ncol, std::move(rows), std::move(cols), smurff::NoiseConfig(), isScarce);
+}
 
-         if (in.fail())
-         {
-            THROWERROR("Could not parse an entry line for coordinate matrix format");
-         }
+// MatrixMarket format specification
+// https://github.com/ExaScience/smurff/files/1398286/MMformat.pdf
+std::shared_ptr<MatrixConfig> matrix_io::read_matrix_market(std::istream& in, bool isScarce)
+{
+   std::string text = text_io::read_all(in);
+   return matrix_io::read_matrix_market(text.data(), text.data() + text.size(), isScarce);
+}
 
-         rows[i] = row - 1;
-         cols[i] = col - 1;
-         vals[i] = val;
-      }
+std::shared_ptr<MatrixConfig> matrix_io::read_matrix_market(const char* begin, const char* end, bool isScarce)
+{
+   MatrixMarketHeader header = read_matrix_market_header(begin, end);
 
-      return std::make_shared<smurff::MatrixConfig>(nrows, ncols, std::move(rows), std::move(cols), std::move(vals), NoiseConfig(), isScarce);
-   }
-   else if (format == MM_FMT_ARRAY)
+   if (header.format == MM_FMT_COORD)
    {
-      if (field != MM_FLD_REAL)
-      {
-         THROWERROR("Invalid MatrixMarket field type: array format supports only 'real' field type");
-      }
-
-      std::uint64_t nrows;
-      std::uint64_t ncols;
-      in >> nrows >> ncols;
-
-      if (in.fail())
-      {
-         THROWERROR("Could not get 'rows', 'cols' values for array matrix format");
-      }
+      std::vector<std::uint32_t> rows(header.nnz);
+      std::vector<std::uint32_t> cols(header.nnz);
+      std::vector<double> vals(header.nnz);
 
-      std::vector<double> vals(nrows * ncols);
-      for (double& val : vals)
+      read_matrix_market_coordinates(begin, end, header, [&](std::uint64_t i, std::uint32_t row, std::uint32_t col, double val)
       {
-         while (in.peek() == '%' || in.peek() == '\n')
-            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-         in >> val;
-         if (in.fail())
-         {
-            THROWERROR("Could not parse an entry line for array matrix format");
-         }
-      }
+         rows[i] = row;
+         cols[i] = col;
+         vals[i] = val;
+      });
 
-      return std::make_shared<smurff::MatrixConfig>(nrows, ncols, std::move(vals), NoiseConfig());
+      return std::make_shared<smurff::MatrixConfig>(header.nrows, header.ncols, std::move(rows), std::move(cols), std::move(vals), NoiseConfig(), isScarce);
    }
    else
    {
-      std::stringstream ss;
-      ss << "Invalid MatrixMarket format type: expected 'coordinate' or 'array' but got '" << format << "'";
-      THROWERROR(ss.str());
+      std::vector<double> vals(header.nrows * header.ncols);
+      read_matrix_market_array(begin, end, header, vals.data());
+
+      return std::make_shared<smurff::MatrixConfig>(header.nrows, header.ncols, std::move(vals), NoiseConfig());
    }
 }
 
@@ -650,9 +740,8 @@ void matrix_io::eigen::read_matrix(const std::string& filename, Eigen::MatrixXd&
       break;
    case matrix_io::MatrixType::ddm:
       {
-         std::ifstream fileStream(filename, std::ios_base::binary);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         matrix_io::eigen::read_dense_float64_bin(fileStream, X);
+         MappedFile file(filename);
+         matrix_io::eigen::read_dense_float64_bin(file, X);
       }
       break;
    case matrix_io::MatrixType::none:
@@ -676,16 +765,14 @@ void matrix_io::eigen::read_matrix(const std::string& filename, Eigen::SparseMat
    {
    case matrix_io::MatrixType::sdm:
       {
-         std::ifstream fileStream(filename, std::ios_base::binary);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         matrix_io::eigen::read_sparse_float64_bin(fileStream, X);
+         MappedFile file(filename);
+         matrix_io::eigen::read_sparse_float64_bin(file, X);
       }
       break;
    case matrix_io::MatrixType::sbm:
       {
-         std::ifstream fileStream(filename, std::ios_base::binary);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         matrix_io::eigen::read_sparse_binary_bin(fileStream, X);
+         MappedFile file(filename);
+         matrix_io::eigen::read_sparse_binary_bin(file, X);
       }
       break;
    case matrix_io::MatrixType::mtx:
@@ -728,51 +815,15 @@ void matrix_io::eigen::read_dense_float64_bin(std::istream& in, Eigen::MatrixXd&
 
 void matrix_io::eigen::read_dense_float64_csv(std::istream& in, Eigen::MatrixXd& X)
 {
-   std::stringstream ss;
-   std::string line;
-
-   // rows and cols
-   getline(in, line);
-   ss.clear();
-   ss << line;
-   std::uint64_t nrow;
-   ss >> nrow;
+   std::string text = text_io::read_all(in);
+   const char* begin = text.data();
+   const char* end = text.data() + text.size();
 
-   getline(in, line);
-   ss.clear();
-   ss << line;
-   std::uint64_t ncol;
-   ss >> ncol;
+   std::uint64_t nrow, ncol;
+   read_csv_header(begin, end, nrow, ncol);
 
    X.resize(nrow, ncol);
-
-   std::uint64_t row = 0;
-   std::uint64_t col = 0;
-
-   while(getline(in, line) && row < nrow)
-   {
-      col = 0;
-
-      std::stringstream lineStream(line);
-      std::string cell;
-
-      while (std::getline(lineStream, cell, ',') && col < ncol)
-      {
-         X(row, col++) = stod(cell);
-      }
-
-      row++;
-   }
-
-   if(row != nrow)
-   {
-      THROWERROR("invalid number of rows");
-   }
-
-   if(col != ncol)
-   {
-      THROWERROR("invalid number of columns");
-   }
+   read_csv_values(begin, end, nrow, ncol, X.data());
 }
 
 void matrix_io::eigen::read_sparse_float64_bin(std::istream& in, Eigen::SparseMatrix<double>& X)
@@ -835,210 +886,101 @@ void matrix_io::eigen::read_sparse_binary_bin(std::istream& in, Eigen::SparseMat
    X.setFromTriplets(triplets.begin(), triplets.end());
 }
 
-// MatrixMarket format specification
-// https://github.com/ExaScience/smurff/files/1398286/MMformat.pdf
-void matrix_io::eigen::read_matrix_market(std::istream& in, Eigen::MatrixXd& X)
+void matrix_io::eigen::read_dense_float64_bin(const MappedFile& file, Eigen::MatrixXd& X)
 {
-   // Check that stream has MatrixMarket format data
-   std::array<char, 15> matrixMarketArr;
-   in.read(matrixMarketArr.data(), 14);
-   std::string matrixMarketStr(matrixMarketArr.begin(), matrixMarketArr.end());
-   if (matrixMarketStr != "%%MatrixMarket" && !std::isblank(in.get()))
-   {
-      std::stringstream ss;
-      ss << "Cannot read MatrixMarket from input stream: ";
-      ss << "the first 15 characters must be '%%MatrixMarket' followed by at least one blank";
-      THROWERROR(ss.str());
-   }
-
-   // Parse MatrixMarket header
-   std::string headerStr;
-   std::getline(in, headerStr);
-   std::stringstream headerStream(headerStr);
-
-   std::string object;
-   headerStream >> object;
-   std::transform(object.begin(), object.end(), object.begin(), ::toupper);
-
-   std::string format;
-   headerStream >> format;
-   std::transform(format.begin(), format.end(), format.begin(), ::toupper);
-
-   std::string field;
-   headerStream >> field;
-   std::transform(field.begin(), field.end(), field.begin(), ::toupper);
-
-   std::string symmetry;
-   headerStream >> symmetry;
-   std::transform(symmetry.begin(), symmetry.end(), symmetry.begin(), ::toupper);
+   X = matrix_io::eigen::map_dense_float64_bin(file);
+}
 
-   // Check object type
-   if (object != MM_OBJ_MATRIX)
-   {
-      std::stringstream ss;
-      ss << "Invalid MartrixMarket object type: expected 'matrix' but got '" << object << "'";
-      THROWERROR(ss.str());
-   }
+void matrix_io::eigen::read_sparse_float64_bin(const MappedFile& file, Eigen::SparseMatrix<double>& X)
+{
+   std::uint64_t nrow, ncol, nnz;
+   read_sparse_header(file, nrow, ncol, nnz);
 
-   // Check field type
-   if (field != MM_FLD_REAL)
-   {
-      THROWERROR("Invalid MatrixMarket field type: only 'real' field type is supported");
-   }
+   const std::uint32_t* rows = file.data<std::uint32_t>(SPARSE_HEADER_SIZE, nnz);
+   const std::uint32_t* cols = file.data<std::uint32_t>(SPARSE_HEADER_SIZE + nnz * sizeof(std::uint32_t), nnz);
+   const double* values = file.data<double>(SPARSE_HEADER_SIZE + 2 * nnz * sizeof(std::uint32_t), nnz);
 
-   // Check symmetry type
-   if (symmetry != MM_SYM_GENERAL)
-   {
-      THROWERROR("Invalid MatrixMarket symmetry type: only 'general' symmetry type is supported");
-   }
+   std::vector<Eigen::Triplet<double> > triplets;
+   triplets.reserve(nnz);
+   for(uint64_t i = 0; i < nnz; i++)
+      triplets.push_back(Eigen::Triplet<double>(rows[i] - 1, cols[i] - 1, values[i]));
 
-   // Skip comments and empty lines
-   while (in.peek() == '%' || in.peek() == '\n')
-      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+   X.resize(nrow, ncol);
+   X.setFromTriplets(triplets.begin(), triplets.end());
 
-   if (format != MM_FMT_ARRAY)
+   if(X.nonZeros() != (int)nnz)
    {
-      THROWERROR("Cannot read a sparse matrix as Eigen::MatrixXd");
+      THROWERROR("Invalid number of values");
    }
+}
 
-   std::uint64_t nrows;
-   std::uint64_t ncols;
-   in >> nrows >> ncols;
+void matrix_io::eigen::read_sparse_binary_bin(const MappedFile& file, Eigen::SparseMatrix<double>& X)
+{
+   std::uint64_t nrow, ncol, nnz;
+   read_sparse_header(file, nrow, ncol, nnz);
 
-   if (in.fail())
-   {
-      THROWERROR("Could not get 'rows', 'cols' values for array matrix format");
-   }
+   const std::uint32_t* rows = file.data<std::uint32_t>(SPARSE_HEADER_SIZE, nnz);
+   const std::uint32_t* cols = file.data<std::uint32_t>(SPARSE_HEADER_SIZE + nnz * sizeof(std::uint32_t), nnz);
 
-   X.resize(nrows, ncols);
+   std::vector<Eigen::Triplet<double> > triplets;
+   triplets.reserve(nnz);
+   for(uint64_t i = 0; i < nnz; i++)
+      triplets.push_back(Eigen::Triplet<double>(rows[i] - 1, cols[i] - 1, 1));
 
-   for (std::uint64_t col = 0; col < ncols; col++)
-   {
-      for (std::uint64_t row = 0; row < nrows; row++)
-      {
-         while (in.peek() == '%' || in.peek() == '\n')
-            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+   X.resize(nrow, ncol);
+   X.setFromTriplets(triplets.begin(), triplets.end());
+}
 
-         double val;
-         in >> val;
-         if (in.fail())
-         {
-            THROWERROR("Could not parse an entry line for array matrix format");
-         }
+Eigen::Map<const Eigen::MatrixXd> matrix_io::eigen::map_dense_float64_bin(const MappedFile& file)
+{
+   std::uint64_t nrow = file.get<std::uint64_t>(0);
+   std::uint64_t ncol = file.get<std::uint64_t>(sizeof(std::uint64_t));
 
-         X(row, col) = val;
-      }
-   }
+   const double* data = file.data<double>(2 * sizeof(std::uint64_t), nrow * ncol);
+   return Eigen::Map<const Eigen::MatrixXd>(data, nrow, ncol);
 }
 
 // MatrixMarket format specification
 // https://github.com/ExaScience/smurff/files/1398286/MMformat.pdf
-void matrix_io::eigen::read_matrix_market(std::istream& in, Eigen::SparseMatrix<double>& X)
+void matrix_io::eigen::read_matrix_market(std::istream& in, Eigen::MatrixXd& X)
 {
-   // Check that stream has MatrixMarket format data
-   std::array<char, 15> matrixMarketArr;
-   in.read(matrixMarketArr.data(), 14);
-   std::string matrixMarketStr(matrixMarketArr.begin(), matrixMarketArr.end());
-   if (matrixMarketStr != "%%MatrixMarket" && !std::isblank(in.get()))
-   {
-      std::stringstream ss;
-      ss << "Cannot read MatrixMarket from input stream: ";
-      ss << "the first 15 characters must be '%%MatrixMarket' followed by at least one blank";
-      THROWERROR(ss.str());
-   }
-
-   // Parse MatrixMarket header
-   std::string headerStr;
-   std::getline(in, headerStr);
-   std::stringstream headerStream(headerStr);
-
-   std::string object;
-   headerStream >> object;
-   std::transform(object.begin(), object.end(), object.begin(), ::toupper);
+   std::string text = text_io::read_all(in);
+   const char* begin = text.data();
+   const char* end = text.data() + text.size();
 
-   std::string format;
-   headerStream >> format;
-   std::transform(format.begin(), format.end(), format.begin(), ::toupper);
+   MatrixMarketHeader header = read_matrix_market_header(begin, end);
 
-   std::string field;
-   headerStream >> field;
-   std::transform(field.begin(), field.end(), field.begin(), ::toupper);
-
-   std::string symmetry;
-   headerStream >> symmetry;
-   std::transform(symmetry.begin(), symmetry.end(), symmetry.begin(), ::toupper);
-
-   // Check object type
-   if (object != MM_OBJ_MATRIX)
+   if (header.format != MM_FMT_ARRAY)
    {
-      std::stringstream ss;
-      ss << "Invalid MartrixMarket object type: expected 'matrix' but got '" << object << "'";
-      THROWERROR(ss.str());
+      THROWERROR("Cannot read a sparse matrix as Eigen::MatrixXd");
    }
 
-   // Check field type
-   if (field != MM_FLD_REAL && field != MM_FLD_PATTERN)
-   {
-      THROWERROR("Invalid MatrixMarket field type: only 'real' and 'pattern' field types are supported");
-   }
+   X.resize(header.nrows, header.ncols);
+   read_matrix_market_array(begin, end, header, X.data());
+}
 
-   // Check symmetry type
-   if (symmetry != MM_SYM_GENERAL)
-   {
-      THROWERROR("Invalid MatrixMarket symmetry type: only 'general' symmetry type is supported");
-   }
+// MatrixMarket format specification
+// https://github.com/ExaScience/smurff/files/1398286/MMformat.pdf
+void matrix_io::eigen::read_matrix_market(std::istream& in, Eigen::SparseMatrix<double>& X)
+{
+   std::string text = text_io::read_all(in);
+   const char* begin = text.data();
+   const char* end = text.data() + text.size();
 
-   // Skip comments and empty lines
-   while (in.peek() == '%' || in.peek() == '\n')
-      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+   MatrixMarketHeader header = read_matrix_market_header(begin, end);
 
-   if (format != MM_FMT_COORD)
+   if (header.format != MM_FMT_COORD)
    {
       THROWERROR("Cannot read a dense matrix as Eigen::SparseMatrix<double>");
    }
 
-   std::uint64_t nrows;
-   std::uint64_t ncols;
-   std::uint64_t nnz;
-   in >> nrows >> ncols >> nnz;
-
-   if (in.fail())
-   {
-      THROWERROR("Could not get 'rows', 'cols', 'nnz' values for coordinate matrix format");
-   }
-
-   X.resize(nrows, ncols);
-
-   std::vector<Eigen::Triplet<double> > triplets;
-   triplets.reserve(nnz);
-
-   for (std::uint64_t i = 0; i < nnz; i++)
+   std::vector<Eigen::Triplet<double> > triplets(header.nnz);
+   read_matrix_market_coordinates(begin, end, header, [&](std::uint64_t i, std::uint32_t row, std::uint32_t col, double val)
    {
-      while (in.peek() == '%' || in.peek() == '\n')
-         in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-      std::uint32_t row;
-      std::uint32_t col;
-      double val;
-
-      if (field == MM_FLD_REAL)
-      {
-         in >> row >> col >> val;
-      }
-      else if (field == MM_FLD_PATTERN)
-      {
-         in >> row >> col;
-         val = 1.0;
-      }
-
-      if (in.fail())
-      {
-         THROWERROR("Could not parse an entry line for coordinate matrix format");
-      }
-
-      triplets.push_back(Eigen::Triplet<double>(row - 1, col - 1, val));
-   }
+      triplets[i] = Eigen::Triplet<double>(row, col, val);
+   });
 
+   X.resize(header.nrows, header.ncols);
    X.setFromTriplets(triplets.begin(), triplets.end());
 }
 
@@ -10,6 +10,7 @@
 #include <memory>
 
 #include <SmurffCpp/Configs/MatrixConfig.h>
+#include <SmurffCpp/IO/MappedFile.h>
 
 #include <Eigen/Sparse>
 #include <Eigen/Dense>
@@ -50,6 +51,18 @@ namespace smurff { namespace matrix_io
 
    std::shared_ptr<MatrixConfig> read_matrix_market(std::istream& in, bool isScarce);
 
+   // text formats from [begin, end) in memory, parsed in parallel
+   std::shared_ptr<MatrixConfig> read_dense_float64_csv(const char* begin, const char* end);
+
+   std::shared_ptr<MatrixConfig> read_matrix_market(const char* begin, const char* end, bool isScarce);
+
+   // binary formats straight from the (mapped) file, without a stream
+   std::shared_ptr<MatrixConfig> read_dense_float64_bin(const MappedFile& file);
+
+   std::shared_ptr<MatrixConfig> read_sparse_float64_bin(const MappedFile& file, bool isScarce);
+
+   std::shared_ptr<MatrixConfig> read_sparse_binary_bin(const MappedFile& file, bool isScarce);
+
    // ===
 
    void write_matrix(const std::string& filename, std::shared_ptr<const MatrixConfig> matrixConfig);
@@ -80,6 +93,15 @@ namespace smurff { namespace matrix_io
       void read_matrix_market(std::istream& in, Eigen::MatrixXd& X);
       void read_matrix_market(std::istream& in, Eigen::SparseMatrix<double>& X);
 
+      void read_dense_float64_bin(const MappedFile& file, Eigen::MatrixXd& X);
+
+      void read_sparse_float64_bin(const MappedFile& file, Eigen::SparseMatrix<double>& X);
+
+      void read_sparse_binary_bin(const MappedFile& file, Eigen::SparseMatrix<double>& X);
+
+      // view of a .ddm file without copying, valid as long as file
+      Eigen::Map<const Eigen::MatrixXd> map_dense_float64_bin(const MappedFile& file);
+
       // ===
 
       void write_matrix(const std::string& filename, const Eigen::MatrixXd& X);
@@ -6,13 +6,17 @@
 
 #include <SmurffCpp/Utils/Error.h>
 
+#include <SmurffCpp/IO/ChunkedTensor.h>
 #include <SmurffCpp/IO/GenericIO.h>
+#include <SmurffCpp/IO/MappedFile.h>
+#include <SmurffCpp/IO/TextIO.h>
 
 using namespace smurff;
 
 #define EXTENSION_SDT ".sdt" //sparse double tensor (binary file)
 #define EXTENSION_SBT ".sbt" //sparse binary tensor (binary file)
 #define EXTENSION_TNS ".tns" //sparse tensor (txt file)
+#define EXTENSION_SCT ".sct" //sparse chunked tensor (binary file)
 #define EXTENSION_CSV ".csv" //dense tensor (txt file)
 #define EXTENSION_DDT ".ddt" //dense double tensor (binary file)
 
@@ -38,6 +42,10 @@ tensor_io::TensorType tensor_io::ExtensionToTensorType(const std::string& fname)
    {
       return tensor_io::TensorType::tns;
    }
+   else if (extension == EXTENSION_SCT)
+   {
+      return tensor_io::TensorType::sct;
+   }
    else if (extension == EXTENSION_CSV)
    {
       return tensor_io::TensorType::csv;
@@ -63,6 +71,8 @@ std::string TensorTypeToExtension(tensor_io::TensorType tensorType)
       return EXTENSION_SBT;
    case tensor_io::TensorType::tns:
       return EXTENSION_TNS;
+   case tensor_io::TensorType::sct:
+      return EXTENSION_SCT;
    case tensor_io::TensorType::csv:
        return EXTENSION_CSV;
    case tensor_io::TensorType::ddt:
@@ -79,6 +89,28 @@ std::string TensorTypeToExtension(tensor_io::TensorType tensorType)
    return std::string();
 }
 
+// ======================================================================================================
+// text formats: long lines of values are parsed in parallel by text_io
+
+// the n values on the line at p, separated by delim, p is moved to the next line
+template<typename T>
+static void read_line_values(const char*& p, const char* end, char delim, T* values, std::uint64_t n, const std::string& error)
+{
+   const char* last = text_io::line_end(p, end);
+
+   std::uint64_t count = text_io::for_each_record(p, last, delim, 0, [=](const char* first, const char* record_end, std::uint64_t i)
+   {
+      return i >= n || (text_io::parse(first, record_end, values[i]) && text_io::at_end(first, record_end));
+   }, error);
+
+   if (count < n)
+   {
+      THROWERROR(error);
+   }
+
+   p = last < end ? last + 1 : end;
+}
+
 std::shared_ptr<TensorConfig> tensor_io::read_tensor(const std::string& filename, bool isScarce)
 {
    std::shared_ptr<TensorConfig> ret;
@@ -105,16 +137,21 @@ std::shared_ptr<TensorConfig> tensor_io::read_tensor(const std::string& filename
       }
    case tensor_io::TensorType::tns:
       {
-         std::ifstream fileStream(filename);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         ret = tensor_io::read_sparse_float64_tns(fileStream, isScarce);
+         MappedFile file(filename);
+         const char* text = file.data<char>(0, file.size());
+         ret = tensor_io::read_sparse_float64_tns(text, text + file.size(), isScarce);
+         break;
+      }
+   case tensor_io::TensorType::sct:
+      {
+         ret = tensor_io::ChunkedTensorReader(filename).readAll(isScarce);
          break;
       }
    case tensor_io::TensorType::csv:
       {
-         std::ifstream fileStream(filename);
-         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
-         ret = tensor_io::read_dense_float64_csv(fileStream);
+         MappedFile file(filename);
+         const char* text = file.data<char>(0, file.size());
+         ret = tensor_io::read_dense_float64_csv(text, text + file.size());
          break;
       }
    case tensor_io::TensorType::ddt:
@@ -156,66 +193,30 @@ std::shared_ptr<TensorConfig> tensor_io::read_dense_float64_bin(std::istream& in
 
 std::shared_ptr<TensorConfig> tensor_io::read_dense_float64_csv(std::istream& in)
 {
-   std::stringstream ss;
-   std::string line;
-   std::string cell;
+   std::string text = text_io::read_all(in);
+   return tensor_io::read_dense_float64_csv(text.data(), text.data() + text.size());
+}
 
+std::shared_ptr<TensorConfig> tensor_io::read_dense_float64_csv(const char* begin, const char* end)
+{
    // nmodes
 
-   getline(in, line); 
-   ss.clear();
-   ss << line;
    std::uint64_t nmodes;
-   ss >> nmodes;
+   if (!text_io::parse_line(begin, end, nmodes))
+   {
+      THROWERROR("invalid number of modes");
+   }
 
    //dimentions
 
-   getline(in, line);
-   std::stringstream lineStream0(line);
-   
    std::vector<uint64_t> dims(nmodes);
-
-   std::uint64_t dim = 0;
-
-   while (std::getline(lineStream0, cell, ',') && dim < nmodes)
-   {
-      ss.clear();
-      ss << cell;
-      std::uint64_t mode;
-      ss >> mode;
-
-      dims[dim++] = mode;
-   }
-
-   if(dim != nmodes)
-   {
-      THROWERROR("invalid number of dimensions");
-   }
+   read_line_values(begin, end, ',', dims.data(), nmodes, "invalid number of dimensions");
 
    //values
 
-   std::getline(in, line);
-   std::stringstream lineStream1(line);
-
    std::uint64_t nnz = std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<std::uint64_t>());
    std::vector<double> values(nnz);
-
-   std::uint64_t nval = 0;
-
-   while (std::getline(lineStream1, cell, ',') && nval < nnz)
-   {
-      ss.clear();
-      ss << cell;
-      std::uint64_t value;
-      ss >> value;
-
-      values[nval++] = value;
-   }
-
-   if(nval != nnz)
-   {
-      THROWERROR("invalid number of values");
-   }
+   read_line_values(begin, end, ',', values.data(), nnz, "invalid number of values");
 
    return std::make_shared<TensorConfig>(std::move(dims), std::move(values), NoiseConfig());
 }
@@ -249,99 +250,44 @@ std::shared_ptr<TensorConfig> tensor_io::read_sparse_float64_bin(std::istream& i
 
 std::shared_ptr<TensorConfig> tensor_io::read_sparse_float64_tns(std::istream& in, bool isScarce)
 {
-   std::stringstream ss;
-   std::string line;
-   std::string cell;
+   std::string text = text_io::read_all(in);
+   return tensor_io::read_sparse_float64_tns(text.data(), text.data() + text.size(), isScarce);
+}
 
+std::shared_ptr<TensorConfig> tensor_io::read_sparse_float64_tns(const char* begin, const char* end, bool isScarce)
+{
    // nmodes
 
-   getline(in, line); 
-   ss.clear();
-   ss << line;
    std::uint64_t nmodes;
-   ss >> nmodes;
+   if (!text_io::parse_line(begin, end, nmodes))
+   {
+      THROWERROR("invalid number of modes");
+   }
 
    //dimentions
 
-   getline(in, line);
-   std::stringstream lineStream0(line);
-   
    std::vector<uint64_t> dims(nmodes);
+   read_line_values(begin, end, '\t', dims.data(), nmodes, "invalid number of dimensions");
 
-   std::uint64_t dim = 0;
+   // nnz
 
-   while (std::getline(lineStream0, cell, '\t') && dim < nmodes)
-   {
-      ss.clear();
-      ss << cell;
-      std::uint64_t mode;
-      ss >> mode;
-
-      dims[dim++] = mode;
-   }
-
-   if(dim != nmodes)
+   std::uint64_t nnz;
+   if (!text_io::parse_line(begin, end, nnz))
    {
-      THROWERROR("invalid number of dimensions");
+      THROWERROR("invalid number of non zeros");
    }
 
-   // nmodes
-
-   getline(in, line); 
-   ss.clear();
-   ss << line;
-   std::uint64_t nnz;
-   ss >> nnz;
-
    //columns
 
-   getline(in, line);
-   std::stringstream lineStream1(line);
-
    std::vector<std::uint32_t> columns(nmodes * nnz);
+   read_line_values(begin, end, '\t', columns.data(), nmodes * nnz, "invalid number of coordinates");
 
-   std::uint64_t col = 0;
-
-   while (std::getline(lineStream1, cell, '\t') && col < (nmodes * nnz))
-   {
-      ss.clear();
-      ss << cell;
-      std::uint64_t column;
-      ss >> column;
-
-      columns[col++] = column;
-   }
-
-   if(col != nmodes * nnz)
-   {
-      THROWERROR("invalid number of coordinates");
-   }
-   
    std::for_each(columns.begin(), columns.end(), [](std::uint32_t& col){ col--; });
 
    //values
 
-   getline(in, line);
-   std::stringstream lineStream2(line);
-
    std::vector<double> values(nnz);
-
-   std::uint64_t nval = 0;
-
-   while (std::getline(lineStream2, cell, '\t') && nval < nnz)
-   {
-      ss.clear();
-      ss << cell;
-      std::uint64_t value;
-      ss >> value;
-
-      values[nval++] = value;
-   }
-
-   if(nval != nnz)
-   {
-      THROWERROR("invalid number of values");
-   }
+   read_line_values(begin, end, '\t', values.data(), nnz, "invalid number of values");
 
    return std::make_shared<TensorConfig>(std::move(dims), std::move(columns), std::move(values), NoiseConfig(), isScarce);
 }
@@ -370,6 +316,26 @@ std::shared_ptr<TensorConfig> tensor_io::read_sparse_binary_bin(std::istream& in
    return std::make_shared<TensorConfig>(std::move(dims), std::move(columns), NoiseConfig(), isScarce);
 }
 
+bool tensor_io::is_chunked(const std::string& filename)
+{
+   std::size_t dotIndex = filename.find_last_of(".");
+   return dotIndex != std::string::npos && filename.substr(dotIndex) == EXTENSION_SCT;
+}
+
+std::shared_ptr<TensorConfig> tensor_io::read_tensor_header(const std::string& filename, bool isScarce)
+{
+   if (!is_chunked(filename))
+   {
+      THROWERROR("Only the header of " EXTENSION_SCT " files can be read: " + filename);
+   }
+
+   tensor_io::ChunkedTensorReader reader(filename);
+
+   auto ret = std::make_shared<TensorConfig>(reader.getDims(), reader.getNNZ(), reader.isBinary(), NoiseConfig(), isScarce);
+   ret->setFilename(filename);
+   return ret;
+}
+
 // ======================================================================================================
 
 void tensor_io::write_tensor(const std::string& filename, std::shared_ptr<const TensorConfig> tensorConfig)
@@ -398,6 +364,13 @@ void tensor_io::write_tensor(const std::string& filename, std::shared_ptr<const
          tensor_io::write_sparse_float64_tns(fileStream, tensorConfig);
       }
       break;
+   case tensor_io::TensorType::sct:
+      {
+         std::ofstream fileStream(filename, std::ios_base::binary);
+         THROWERROR_ASSERT_MSG(fileStream.is_open(), "Error opening file: " + filename);
+         tensor_io::write_sparse_chunked(fileStream, tensorConfig);
+      }
+      break;
    case tensor_io::TensorType::csv:
       {
          std::ofstream fileStream(filename);
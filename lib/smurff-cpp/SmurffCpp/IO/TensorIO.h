@@ -1,3 +1,5 @@
+#pragma once
+
 #include <string>
 #include <iostream>
 #include <memory>
@@ -13,6 +15,7 @@ namespace smurff { namespace tensor_io
       sdt,
       sbt,
       tns,
+      sct,
 
       //dense types
       csv,
@@ -31,6 +34,20 @@ namespace smurff { namespace tensor_io
 
    std::shared_ptr<TensorConfig> read_sparse_binary_bin(std::istream& in, bool isScarce);
 
+   std::shared_ptr<TensorConfig> read_sparse_chunked(std::istream& in, bool isScarce);
+
+   // true if filename is a .sct file
+   bool is_chunked(const std::string& filename);
+
+   // dims and nnz of a .sct file without its columns and values, these are
+   // read from the file when the data is created (see TensorData)
+   std::shared_ptr<TensorConfig> read_tensor_header(const std::string& filename, bool isScarce);
+
+   // text formats from [begin, end) in memory, parsed in parallel
+   std::shared_ptr<TensorConfig> read_dense_float64_csv(const char* begin, const char* end);
+
+   std::shared_ptr<TensorConfig> read_sparse_float64_tns(const char* begin, const char* end, bool isScarce);
+
    // ===
 
    void write_tensor(const std::string& filename, std::shared_ptr<const TensorConfig> tensorConfig);
@@ -42,4 +59,10 @@ namespace smurff { namespace tensor_io
    void write_sparse_float64_tns(std::ostream& out, std::shared_ptr<const TensorConfig> tensorConfig);
 
    void write_sparse_binary_bin(std::ostream& out, std::shared_ptr<const TensorConfig> tensorConfig);
+
+   void write_sparse_chunked(std::ostream& out, std::shared_ptr<const TensorConfig> tensorConfig);
+
+   // chunk_size items per chunk, with delta every column is delta_varint
+   // encoded when that makes it smaller (see ChunkedTensor.h)
+   void write_sparse_chunked(std::ostream& out, std::shared_ptr<const TensorConfig> tensorConfig, std::uint64_t chunk_size, bool delta);
 }}
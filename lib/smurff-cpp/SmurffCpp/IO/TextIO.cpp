@@ -0,0 +1,228 @@
+#include "TextIO.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+
+#include <SmurffCpp/Utils/omp_util.h>
+
+using namespace smurff;
+
+// no parallel parsing of texts smaller than this
+#define MIN_CHUNK_BYTES (1 << 20)
+
+static bool is_digit(char c)
+{
+   return c >= '0' && c <= '9';
+}
+
+// end of the number at p
+static bool is_separator(char c)
+{
+   return text_io::is_blank(c) || c == '\n';
+}
+
+bool text_io::parse(const char*& p, const char* end, std::uint64_t& value)
+{
+   skip_blanks(p, end);
+
+   const char* q = p;
+   if (q < end && *q == '+')
+      ++q;
+
+   const char* digits = q;
+   std::uint64_t v = 0;
+   for (; q < end && is_digit(*q); ++q)
+   {
+      std::uint64_t d = *q - '0';
+      if (v > (std::numeric_limits<std::uint64_t>::max() - d) / 10)
+         return false;
+      v = v * 10 + d;
+   }
+
+   if (q == digits || (q < end && !is_separator(*q)))
+      return false;
+
+   value = v;
+   p = q;
+   return true;
+}
+
+bool text_io::parse(const char*& p, const char* end, std::uint32_t& value)
+{
+   const char* q = p;
+   std::uint64_t v;
+   if (!parse(q, end, v) || v > std::numeric_limits<std::uint32_t>::max())
+      return false;
+
+   value = v;
+   p = q;
+   return true;
+}
+
+// exact powers of ten in double precision
+static const double powers_of_ten[] = {
+   1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// strtod for everything that is not plain decimal or does not fit the
+// fast path: the token is copied so that strtod does not read past end
+static bool parse_strtod(const char*& p, const char* end, double& value)
+{
+   const char* q = p;
+   while (q < end && !is_separator(*q))
+      ++q;
+
+   char buf[128];
+   std::size_t len = q - p;
+   if (len == 0 || len >= sizeof(buf))
+      return false;
+
+   std::copy(p, q, buf);
+   buf[len] = 0;
+
+   char* last;
+   double v = std::strtod(buf, &last);
+   if (last != buf + len)
+      return false;
+
+   value = v;
+   p = q;
+   return true;
+}
+
+// the decimal digits as an integer mantissa and a power of ten: when both
+// are exact doubles, one multiplication or division gives the correctly
+// rounded result
+bool text_io::parse(const char*& p, const char* end, double& value)
+{
+   skip_blanks(p, end);
+
+   const char* q = p;
+   bool negative = false;
+   if (q < end && (*q == '-' || *q == '+'))
+      negative = *q++ == '-';
+
+   std::uint64_t mantissa = 0;
+   int exponent = 0;
+   int ndigits = 0;
+   bool exact = true;
+
+   auto add_digit = [&](char c)
+   {
+      ndigits++;
+      if (mantissa < 100000000000000000ull)
+         mantissa = mantissa * 10 + (c - '0');
+      else
+         exact = false;
+   };
+
+   for (; q < end && is_digit(*q); ++q)
+      add_digit(*q);
+
+   if (q < end && *q == '.')
+   {
+      for (++q; q < end && is_digit(*q); ++q)
+      {
+         add_digit(*q);
+         exponent--;
+      }
+   }
+
+   if (ndigits == 0)
+      return parse_strtod(p, end, value); // inf, nan
+
+   if (q < end && (*q == 'e' || *q == 'E'))
+   {
+      ++q;
+      bool negative_exp = false;
+      if (q < end && (*q == '-' || *q == '+'))
+         negative_exp = *q++ == '-';
+
+      if (q == end || !is_digit(*q))
+         return false;
+
+      int e = 0;
+      for (; q < end && is_digit(*q); ++q)
+         e = std::min(e * 10 + (*q - '0'), 100000);
+
+      exponent += negative_exp ? -e : e;
+   }
+
+   if (q < end && !is_separator(*q))
+      return false;
+
+   if (!exact || mantissa > (1ull << 53) || exponent < -22 || exponent > 22)
+      return parse_strtod(p, end, value);
+
+   double v = (double)mantissa;
+   v = exponent < 0 ? v / powers_of_ten[-exponent] : v * powers_of_ten[exponent];
+
+   value = negative ? -v : v;
+   p = q;
+   return true;
+}
+
+bool text_io::parse_line(const char*& p, const char* end, std::uint64_t& value)
+{
+   const char* last = line_end(p, end);
+   bool ok = parse(p, last, value) && at_end(p, last);
+   p = last < end ? last + 1 : end;
+   return ok;
+}
+
+const char* text_io::line_end(const char* p, const char* end)
+{
+   const char* q = static_cast<const char*>(std::memchr(p, '\n', end - p));
+   return q ? q : end;
+}
+
+const char* text_io::skip_lines(const char* p, const char* end, char comment)
+{
+   while (p < end)
+   {
+      const char* first = p;
+      const char* last = line_end(p, end);
+      skip_blanks(first, last);
+      if (first < last && *first != comment)
+         break;
+
+      p = last < end ? last + 1 : end;
+   }
+
+   return p;
+}
+
+std::string text_io::read_all(std::istream& in)
+{
+   return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+std::vector<const char*> text_io::split(const char* begin, const char* end, char delim, std::uint64_t nchunks)
+{
+   std::vector<const char*> bounds(1, begin);
+   const std::uint64_t size = end - begin;
+
+   for (std::uint64_t c = 1; c < nchunks; c++)
+   {
+      const char* p = std::max(bounds.back(), begin + c * size / nchunks);
+      if (p == end)
+         break;
+
+      const char* q = static_cast<const char*>(std::memchr(p, delim, end - p));
+      if (!q)
+         break;
+
+      bounds.push_back(q + 1);
+   }
+
+   bounds.push_back(end);
+   return bounds;
+}
+
+std::uint64_t text_io::num_chunks(std::uint64_t size)
+{
+   return std::max<std::uint64_t>(1, std::min<std::uint64_t>(threads::get_max_threads(), size / MIN_CHUNK_BYTES));
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Utils/Error.h>
+
+//
+// shared by the text readers of matrix_io and tensor_io (.mtx, .csv, .tns):
+// the whole text is in memory and split in records that are parsed in
+// parallel, straight into their place in the output arrays
+//
+
+namespace smurff { namespace text_io
+{
+   // blanks around numbers, commas separate the values in .csv files
+   inline bool is_blank(char c)
+   {
+      return c == ' ' || c == '\t' || c == '\r' || c == ',';
+   }
+
+   inline void skip_blanks(const char*& p, const char* end)
+   {
+      while (p < end && is_blank(*p))
+         ++p;
+   }
+
+   // only blanks left in [p, end)
+   inline bool at_end(const char* p, const char* end)
+   {
+      skip_blanks(p, end);
+      return p == end;
+   }
+
+   // parse the number at p, after blanks, without allocating
+   // on success p is moved past the number
+   bool parse(const char*& p, const char* end, std::uint64_t& value);
+   bool parse(const char*& p, const char* end, std::uint32_t& value);
+   bool parse(const char*& p, const char* end, double& value);
+
+   // the single number on the line at p, p is moved to the next line
+   bool parse_line(const char*& p, const char* end, std::uint64_t& value);
+
+   // end of the line at p, without the newline
+   const char* line_end(const char* p, const char* end);
+
+   // start of the next line that is not blank and does not start with comment
+   const char* skip_lines(const char* p, const char* end, char comment);
+
+   // whole stream in memory
+   std::string read_all(std::istream& in);
+
+   // at most nchunks + 1 boundaries that split [begin, end) in chunks,
+   // every chunk but the last ends just after a delim
+   std::vector<const char*> split(const char* begin, const char* end, char delim, std::uint64_t nchunks);
+
+   // number of chunks for a text of size bytes
+   std::uint64_t num_chunks(std::uint64_t size);
+
+   // next record in [p, end) separated by delim, skipping blank records
+   // and records that start with comment (0 for none)
+   //
+   // returns false if there is none, else [first, last) is the record
+   // and p is moved past it
+   inline bool next_record(const char*& p, const char* end, char delim, char comment, const char*& first, const char*& last)
+   {
+      while (p < end)
+      {
+         first = p;
+         last = static_cast<const char*>(std::memchr(p, delim, end - p));
+         if (!last)
+            last = end;
+
+         p = last < end ? last + 1 : end;
+
+         skip_blanks(first, last);
+         if (first < last && *first != comment)
+            return true;
+      }
+
+      return false;
+   }
+
+   // calls f(first, last, i) for every record [first, last) in [begin, end),
+   // i numbers the records from 0
+   //
+   // the text is split in chunks at delim: the records of all chunks are
+   // counted in parallel, after which every chunk knows the number of its
+   // first record and all chunks are parsed in parallel. f returns false
+   // when a record cannot be parsed, then error is thrown
+   //
+   // returns the number of records
+   template<typename F>
+   std::uint64_t for_each_record(const char* begin, const char* end, char delim, char comment, F f, const std::string& error)
+   {
+      std::vector<const char*> bounds = split(begin, end, delim, num_chunks(end - begin));
+      const std::int64_t nchunks = bounds.size() - 1;
+
+      std::vector<std::uint64_t> offsets(nchunks + 1, 0);
+
+      #pragma omp parallel for schedule(static)
+      for (std::int64_t c = 0; c < nchunks; c++)
+      {
+         const char* p = bounds[c];
+         const char *first, *last;
+         while (next_record(p, bounds[c + 1], delim, comment, first, last))
+            offsets[c + 1]++;
+      }
+
+      for (std::int64_t c = 0; c < nchunks; c++)
+         offsets[c + 1] += offsets[c];
+
+      // exceptions cannot leave the parallel loop
+      std::vector<char> ok(nchunks, 1);
+
+      #pragma omp parallel for schedule(static)
+      for (std::int64_t c = 0; c < nchunks; c++)
+      {
+         const char* p = bounds[c];
+         const char *first, *last;
+         std::uint64_t i = offsets[c];
+         while (ok[c] && next_record(p, bounds[c + 1], delim, comment, first, last))
+            ok[c] = f(first, last, i++);
+      }
+
+      for (std::int64_t c = 0; c < nchunks; c++)
+      {
+         if (!ok[c])
+         {
+            THROWERROR(error);
+         }
+      }
+
+      return offsets[nchunks];
+   }
+}}
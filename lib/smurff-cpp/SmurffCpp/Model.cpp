@@ -13,6 +13,8 @@
 #include <SmurffCpp/DataMatrices/Data.h>
 #include <SmurffCpp/IO/MatrixIO.h>
 #include <SmurffCpp/Utils/Distribution.h>
+#include <SmurffCpp/Utils/NumModes.hpp>
+#include <SmurffCpp/Utils/Reordering.h>
 
 #include <SmurffCpp/Model.h>
 
@@ -31,8 +33,33 @@ using namespace Eigen;
 using namespace smurff;
 
 
+template<int K, int N>
+struct Model::PredictKernel
+{
+   typedef Eigen::Matrix<double, K, 1> Vector;
+   typedef Eigen::Array<double, K, 1> Array;
+
+   static double run(const Model &m, const PVec<> &pos)
+   {
+      const int nl = m.nlatent();
+
+      if (N == 2)
+      {
+         return Map<const Vector>(m.col(0, pos[0]).data(), nl).dot(Map<const Vector>(m.col(1, pos[1]).data(), nl));
+      }
+
+      // Hadamard product of the columns of the first N - 1 modes,
+      // the loop is unrolled for the fixed N
+      Map<Array> P(m.Pcache.local().data(), nl);
+      P = Map<const Array>(m.col(0, pos[0]).data(), nl);
+      for(int d = 1; d < N - 1; ++d)
+         P *= Map<const Array>(m.col(d, pos[d]).data(), nl);
+      return (P * Map<const Array>(m.col(N - 1, pos[N - 1]).data(), nl)).sum();
+   }
+};
+
 Model::Model()
-   : m_num_latent(-1), m_dims(0)
+   : m_num_latent(-1), m_dims(0), m_predict(nullptr)
 {
 }
 
@@ -65,21 +92,18 @@ void Model::init(int num_latent, const PVec<>& dims, ModelInitTypes model_init_t
       m_samples.push_back(sample);
    }
 
+   init_kernels();
+}
+
+void Model::init_kernels()
+{
    Pcache.init(ArrayXd::Ones(m_num_latent));
+   m_predict = select_num_latent_modes<PredictKernel>(m_num_latent, m_dims.size());
 }
 
 double Model::predict(const PVec<> &pos) const
 {
-   if (nmodes() == 2)
-   {
-      return col(0, pos[0]).dot(col(1, pos[1]));
-   }
-
-   auto &P = Pcache.local();
-   P.setOnes();
-   for(uint32_t d = 0; d < nmodes(); ++d)
-      P *= col(d, pos.at(d)).array();
-   return P.sum();
+   return m_predict(*this, pos);
 }
 
 const Eigen::MatrixXd &Model::U(uint32_t f) const
@@ -143,13 +167,31 @@ SubModel Model::full()
    return SubModel(*this);
 }
 
+void Model::setReordering(std::shared_ptr<const Reordering> reordering)
+{
+   m_reordering = reordering;
+}
+
 void Model::save(std::shared_ptr<const StepFile> sf) const
 {
+   Eigen::MatrixXd original;
+
    std::uint64_t i = 0;
    for (auto U : m_samples)
    {
-      std::string path = sf->getModelFileName(i++);
-      smurff::matrix_io::eigen::write_matrix(path, *U);
+      std::string path = sf->getModelFileName(i);
+
+      if (m_reordering)
+      {
+         m_reordering->unpermuteColumns(*U, i, original);
+         smurff::matrix_io::eigen::write_matrix(path, original);
+      }
+      else
+      {
+         smurff::matrix_io::eigen::write_matrix(path, *U);
+      }
+
+      i++;
    }
 }
 
@@ -165,11 +207,20 @@ void Model::restore(std::shared_ptr<const StepFile> sf)
       std::string path = sf->getModelFileName(i);
       THROWERROR_FILE_NOT_EXIST(path);
       smurff::matrix_io::eigen::read_matrix(path, *U);
+
+      if (m_reordering)
+      {
+         Eigen::MatrixXd original;
+         original.swap(*U);
+         m_reordering->permuteColumns(original, i, *U);
+      }
+
       m_dims.at(i) = U->cols();
       m_num_latent = U->rows();
       m_samples.push_back(U);
    }
-   Pcache.init(ArrayXd::Ones(m_num_latent));
+
+   init_kernels();
 }
 
 std::ostream& Model::info(std::ostream &os, std::string indent) const
@@ -18,6 +18,8 @@ class Data;
 
 class SubModel;
 
+class Reordering;
+
 template<class T>
 class VMatrixExprIterator;
 
@@ -40,9 +42,22 @@ private:
    // to make predictions faster
    mutable thread_vector<Eigen::ArrayXd> Pcache;
 
+   // predict specialized on num_latent and the number of modes, selected in init and restore
+   template<int K, int N> struct PredictKernel;
+   double (*m_predict)(const Model &, const PVec<> &);
+
+   void init_kernels();
+
+   // new ids of the entities of the session, null when not reordered,
+   // saved and restored samples are in the original ids
+   std::shared_ptr<const Reordering> m_reordering;
+
 public:
    Model();
 
+public:
+   void setReordering(std::shared_ptr<const Reordering> reordering);
+
 public:
    //initialize U matrices in the model (random/zero)
    void init(int num_latent, const PVec<>& dims, ModelInitTypes model_init_type);
@@ -9,3 +9,8 @@ double GaussianNoise::getAlpha() const
 {
     return alpha;
 }
+
+bool GaussianNoise::isGaussian() const
+{
+    return true;
+}
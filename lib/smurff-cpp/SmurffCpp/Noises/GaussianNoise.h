@@ -15,6 +15,8 @@ namespace smurff {
 
    public:
       double getAlpha() const override;
+
+      bool isGaussian() const override;
    };
 
 }
@@ -13,3 +13,8 @@ double INoiseModel::sample(const SubModel& model, const PVec<> &pos, double val)
 {
     return getAlpha() * val;
 }
+
+bool INoiseModel::isGaussian() const
+{
+    return false;
+}
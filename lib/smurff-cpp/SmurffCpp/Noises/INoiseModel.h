@@ -41,5 +41,9 @@ namespace smurff {
 
       virtual double getAlpha() const;
       virtual double sample(const SubModel& model, const PVec<> &pos, double val);
+
+      // true if sample(model, pos, val) is getAlpha() * val,
+      // so that it does not have to be called for every item
+      virtual bool isGaussian() const;
    };
 }
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <unordered_map>
 
 #include <Eigen/Sparse>
 #include <Eigen/Core>
@@ -9,18 +12,25 @@
 #include <SmurffCpp/ResultItem.h>
 
 #include <SmurffCpp/Model.h>
+#include <SmurffCpp/IO/MatrixIO.h>
 
 #include <SmurffCpp/Predict/PredictSession.h>
+#include <SmurffCpp/Predict/SampleCache.h>
+#include <SmurffCpp/Predict/StackedSamples.h>
 
 namespace smurff
 {
 
+std::uint64_t PredictSession::CACHE_BUDGET_DEFAULT_VALUE = 1ULL << 30; // 1 GiB
+bool PredictSession::CACHE_MAPPED_DEFAULT_VALUE = true;
+
 PredictSession::PredictSession(std::shared_ptr<RootFile> rf)
     : m_model_rootfile(rf), m_pred_rootfile(0),
       m_has_config(false), m_num_latent(-1),
       m_dims(PVec<>(0)), m_is_init(false)
 {
     m_stepfiles = m_model_rootfile->openSampleStepFiles();
+    m_cache = std::make_shared<SampleCache>(m_stepfiles, CACHE_BUDGET_DEFAULT_VALUE, CACHE_MAPPED_DEFAULT_VALUE);
 }
 
 PredictSession::PredictSession(std::shared_ptr<RootFile> rf, const Config &config)
@@ -29,6 +39,7 @@ PredictSession::PredictSession(std::shared_ptr<RootFile> rf, const Config &confi
       m_dims(PVec<>(0)), m_is_init(false)
 {
     m_stepfiles = m_model_rootfile->openSampleStepFiles();
+    m_cache = std::make_shared<SampleCache>(m_stepfiles, CACHE_BUDGET_DEFAULT_VALUE, CACHE_MAPPED_DEFAULT_VALUE);
 }
 PredictSession::PredictSession(const Config &config)
     : m_pred_rootfile(0), m_config(config), m_has_config(true),
@@ -37,6 +48,7 @@ PredictSession::PredictSession(const Config &config)
     THROWERROR_ASSERT(config.getRootName().size())
     m_model_rootfile = std::make_shared<RootFile>(config.getRootName());
     m_stepfiles = m_model_rootfile->openSampleStepFiles();
+    m_cache = std::make_shared<SampleCache>(m_stepfiles, CACHE_BUDGET_DEFAULT_VALUE, CACHE_MAPPED_DEFAULT_VALUE);
 }
 
 void PredictSession::run()
@@ -77,8 +89,8 @@ bool PredictSession::step()
     THROWERROR_ASSERT(m_pos != m_stepfiles.rend());
 
     double start = tick();
-    auto model = restoreModel(*m_pos);
-    m_result->update(model, false);
+    auto sample = getSample(std::distance(m_pos, m_stepfiles.rend()) - 1);
+    m_result->update(*sample);
     double stop = tick();
     m_secs_per_iter = stop - start;
     m_secs_total += m_secs_per_iter;
@@ -177,21 +189,63 @@ std::ostream &PredictSession::info(std::ostream &os, std::string indent) const
     return os;
 }
 
-std::shared_ptr<Model> PredictSession::restoreModel(const std::shared_ptr<StepFile> &sf)
+void PredictSession::setCacheBudget(std::uint64_t budget)
+{
+    m_stacked.reset();
+    m_cache = std::make_shared<SampleCache>(m_stepfiles, budget, m_cache->isMapped());
+}
+
+void PredictSession::setCacheMapped(bool mapped)
+{
+    m_stacked.reset();
+    m_cache = std::make_shared<SampleCache>(m_stepfiles, m_cache->getBudget(), mapped);
+}
+
+void PredictSession::preload()
+{
+    m_cache->preload();
+}
+
+std::shared_ptr<const SampleCache> PredictSession::getCache() const
 {
-    auto model = sf->restoreModel();
+    return m_cache;
+}
+
+std::shared_ptr<const ModelSample> PredictSession::getSample(std::size_t i)
+{
+    auto sample = m_cache->get(i);
     if (m_num_latent <= 0)
     {
-        m_num_latent = model->nlatent();
-        m_dims = model->getDims();
+        m_num_latent = sample->nlatent();
+        m_dims = sample->getDims();
     }
     else
     {
-        THROWERROR_ASSERT(m_num_latent == model->nlatent());
-        THROWERROR_ASSERT(m_dims == model->getDims());
+        THROWERROR_ASSERT(m_num_latent == sample->nlatent());
+        THROWERROR_ASSERT(m_dims == sample->getDims());
     }
 
-    return model;
+    return sample;
+}
+
+bool PredictSession::fitsStacked()
+{
+    return m_stacked || m_stepfiles.size() * getSample(0)->bytes() <= m_cache->getBudget();
+}
+
+std::shared_ptr<const StackedSamples> PredictSession::getStackedSamples()
+{
+    if (!m_stacked)
+    {
+        // the panels count against the cache budget: make room for them
+        // before stacking, the samples are not needed after
+        m_cache->reserve(m_stepfiles.size() * getSample(0)->bytes());
+        m_stacked = std::make_shared<StackedSamples>(*m_cache);
+        m_cache->clear();
+        m_cache->reserve(m_stacked->bytes());
+    }
+
+    return m_stacked;
 }
 
 // predict one element
@@ -203,20 +257,261 @@ ResultItem PredictSession::predict(PVec<> pos, const StepFile &sf)
 }
 
 // predict one element
+//
+// only one column of each latent matrix is needed: binary model files
+// are mapped instead of restoring the full model
 void PredictSession::predict(ResultItem &res, const StepFile &sf)
 {
-    auto model = sf.restoreModel();
-    auto pred = model->predict(res.coords);
-    res.update(pred);
+    if (!sf.isBinary())
+    {
+        auto model = sf.restoreModel();
+        auto pred = model->predict(res.coords);
+        res.update(pred);
+        return;
+    }
+
+    const std::uint64_t nmodes = sf.getNSamples();
+    THROWERROR_ASSERT_MSG(res.coords.size() == nmodes, "Wrong number of coordinates for model in " + sf.getStepFileName());
+
+    Eigen::ArrayXd P;
+    for (std::uint64_t m = 0; m < nmodes; ++m)
+    {
+        MappedFile file(sf.getModelFileName(m));
+        auto U = matrix_io::eigen::map_dense_float64_bin(file);
+        THROWERROR_ASSERT_MSG(res.coords[m] >= 0 && res.coords[m] < U.cols(), "Coordinate out of range for " + file.getFilename());
+
+        if (m == 0)
+            P = U.col(res.coords[m]);
+        else
+            P *= U.col(res.coords[m]).array();
+    }
+
+    res.update(P.sum());
+}
+
+static void check_coords(const PVec<> &coords, const PVec<> &dims)
+{
+    THROWERROR_ASSERT_MSG(coords.size() == dims.size(), "Wrong number of coordinates for model");
+    THROWERROR_ASSERT_MSG(coords.in(PVec<>(dims.size()), dims), "Coordinate out of range for model");
 }
 
 // predict one element
+//
+// from the stacked samples when they exist, they are not built for one
+// element
 void PredictSession::predict(ResultItem &res)
 {
-    auto stepfiles = getModelRoot()->openSampleStepFiles();
+    if (m_stacked)
+    {
+        check_coords(res.coords, m_dims);
+
+        Eigen::MatrixXd work;
+        Eigen::VectorXd preds;
+        m_stacked->predict(res.coords, work, preds);
+        for (Eigen::Index i = 0; i < preds.size(); ++i)
+            res.update(preds(i));
+        return;
+    }
+
+    for (std::size_t i = 0; i < m_stepfiles.size(); ++i)
+    {
+        auto sample = getSample(i);
+        check_coords(res.coords, m_dims);
+        res.update(sample->predict(res.coords));
+    }
+}
+
+// predict many elements
+//
+// with the stacked samples when they fit, otherwise every sample is
+// fetched from the cache once for all elements
+void PredictSession::predict(std::vector<ResultItem> &res)
+{
+    if (fitsStacked())
+    {
+        getStackedSamples()->predict(res);
+        return;
+    }
 
-    for (const auto &sf : stepfiles)
-        predict(res, *sf);
+    for (std::size_t i = 0; i < m_stepfiles.size(); ++i)
+    {
+        auto sample = getSample(i);
+
+        if (i == 0)
+        {
+            for (const auto &r : res)
+                check_coords(r.coords, m_dims);
+        }
+
+        #pragma omp parallel for schedule(guided)
+        for (std::size_t k = 0; k < res.size(); ++k)
+            res[k].update(sample->predict(res[k].coords));
+    }
+}
+
+void PredictSession::predict(const std::vector<PVec<>> &coords, const std::vector<double> &probs,
+                             Eigen::VectorXd &mean, Eigen::VectorXd &var, Eigen::MatrixXd &quantiles)
+{
+    if (fitsStacked())
+    {
+        getStackedSamples()->predict(coords, probs, mean, var, quantiles);
+        return;
+    }
+
+    // one sample at a time: running mean and variance, and the predictions
+    // of every sample only when the quantiles need them
+    StackedSamples::check_probs(probs);
+
+    const int nsamples = m_stepfiles.size();
+    Eigen::MatrixXd preds(probs.empty() ? 0 : coords.size(), nsamples);
+    mean.setZero(coords.size());
+    var.setZero(coords.size());
+    quantiles.resize(coords.size(), probs.size());
+
+    for (int i = 0; i < nsamples; ++i)
+    {
+        auto sample = getSample(i);
+
+        if (i == 0)
+        {
+            for (const auto &c : coords)
+                check_coords(c, m_dims);
+        }
+
+        #pragma omp parallel for schedule(guided)
+        for (std::size_t k = 0; k < coords.size(); ++k)
+        {
+            const double pred = sample->predict(coords[k]);
+            const double delta = pred - mean(k);
+            mean(k) += delta / (i + 1);
+            var(k) += delta * (pred - mean(k));
+
+            if (!probs.empty())
+                preds(k, i) = pred;
+        }
+    }
+
+    if (probs.empty())
+        return;
+
+    #pragma omp parallel
+    {
+        Eigen::VectorXd p(nsamples);
+
+        #pragma omp for schedule(guided)
+        for (std::size_t k = 0; k < coords.size(); ++k)
+        {
+            p = preds.row(k).transpose();
+            StackedSamples::quantiles(p, probs, quantiles, k);
+        }
+    }
+}
+
+// size of the mean, variance and prediction of one batch of top-N rows
+static const std::uint64_t TOPN_BATCH_BYTES = 64 << 20;
+
+std::vector<std::vector<TopNItem>> PredictSession::topN(const std::vector<int> &rows, int n, double ucb,
+                                                        std::shared_ptr<const MatrixConfig> exclude)
+{
+    getSample(0); // model dimensions
+    THROWERROR_ASSERT_MSG(m_dims.size() == 2, "Top-N queries need a model with two modes");
+    THROWERROR_ASSERT_MSG(n >= 0, "Number of top-N items should be positive");
+
+    const int nrows = m_dims[0];
+    const std::uint32_t ncols = m_dims[1];
+    for (int row : rows)
+        THROWERROR_ASSERT_MSG(row >= 0 && row < nrows, "Row out of range for model");
+
+    // sorted excluded columns of every row of rows
+    std::unordered_map<int, std::vector<std::uint32_t>> excluded;
+    if (exclude)
+    {
+        THROWERROR_ASSERT_MSG(!exclude->isDense(), "Excluded entries should be sparse");
+        THROWERROR_ASSERT_MSG(exclude->getNRow() == (std::uint64_t)nrows && exclude->getNCol() == ncols,
+                              "Excluded entries should have the dimensions of the model");
+
+        for (int row : rows)
+            excluded[row];
+
+        const std::uint64_t nnz = exclude->getNNZ();
+        const std::vector<std::uint32_t> &columns = exclude->getColumns();
+        for (std::uint64_t i = 0; i < nnz; ++i)
+        {
+            auto it = excluded.find(columns[i]);
+            if (it != excluded.end())
+                it->second.push_back(columns[nnz + i]);
+        }
+
+        for (auto &e : excluded)
+        {
+            std::sort(e.second.begin(), e.second.end());
+            e.second.erase(std::unique(e.second.begin(), e.second.end()), e.second.end());
+        }
+    }
+
+    const std::size_t nsamples = m_stepfiles.size();
+    const std::size_t batch = std::max<std::size_t>(1, TOPN_BATCH_BYTES / (3 * ncols * sizeof(double)));
+
+    std::vector<std::vector<TopNItem>> ret(rows.size());
+    Eigen::MatrixXd Uq, P, mean, M2;
+
+    for (std::size_t start = 0; start < rows.size(); start += batch)
+    {
+        const std::size_t b = std::min(batch, rows.size() - start);
+
+        // ncols x b predictions of every sample, mean and variance
+        // accumulated as in ResultItem::update
+        mean.setZero(ncols, b);
+        M2.setZero(ncols, b);
+        for (std::size_t s = 0; s < nsamples; ++s)
+        {
+            auto sample = getSample(s);
+            const auto &U = sample->U(0);
+
+            Uq.resize(U.rows(), b);
+            for (std::size_t q = 0; q < b; ++q)
+                Uq.col(q) = U.col(rows[start + q]);
+
+            P.noalias() = sample->U(1).transpose() * Uq;
+
+            const double w = 1.0 / (s + 1);
+            const double *p = P.data();
+            double *mu = mean.data();
+            double *m2 = M2.data();
+            for (Eigen::Index i = 0; i < P.size(); ++i)
+            {
+                const double delta = p[i] - mu[i];
+                mu[i] += delta * w;
+                m2[i] += delta * delta * (s * w);
+            }
+        }
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (std::size_t q = 0; q < b; ++q)
+        {
+            const int row = rows[start + q];
+            const std::vector<std::uint32_t> *skip = exclude ? &excluded.find(row)->second : nullptr;
+            std::size_t next = 0;
+
+            TopN top(n);
+            for (std::uint32_t col = 0; col < ncols; ++col)
+            {
+                if (skip && next < skip->size() && (*skip)[next] == col)
+                {
+                    ++next;
+                    continue;
+                }
+
+                const double m = mean(col, q);
+                const double sd = nsamples > 1 ? std::sqrt(M2(col, q) / (nsamples - 1)) : 0.0;
+                top.offer({col, m, sd, m + ucb * sd});
+            }
+
+            ret[start + q] = top.sorted();
+        }
+    }
+
+    return ret;
 }
 
 ResultItem PredictSession::predict(PVec<> pos)
@@ -231,12 +526,15 @@ std::shared_ptr<Result> PredictSession::predict(std::shared_ptr<TensorConfig> Y)
 {
     auto res = std::make_shared<Result>(Y);
 
-    for (const auto s : m_stepfiles)
+    if (fitsStacked())
     {
-        auto model = restoreModel(s);
-        res->update(model, false);
+        res->update(*getStackedSamples());
+        return res;
     }
 
+    for (std::size_t i = 0; i < m_stepfiles.size(); ++i)
+        res->update(*getSample(i));
+
     return res;
 }
 
@@ -1,18 +1,25 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <Eigen/Sparse>
 #include <Eigen/Core>
 
 #include <SmurffCpp/Utils/PVec.hpp>
 #include <SmurffCpp/Sessions/ISession.h>
+#include <SmurffCpp/Predict/TopN.h>
 
 namespace smurff {
 
 class RootFile;
+class StepFile;
 class Result;
 struct ResultItem;
+class ModelSample;
+class SampleCache;
+class StackedSamples;
 
 class PredictSession : public ISession
 {
@@ -29,12 +36,23 @@ private:
     double m_secs_total;
 
     std::vector<std::shared_ptr<StepFile>> m_stepfiles;
+    std::shared_ptr<SampleCache> m_cache;
+    std::shared_ptr<StackedSamples> m_stacked;
 
     int m_num_latent;
     PVec<> m_dims;
     bool m_is_init;
 
-    std::shared_ptr<Model> restoreModel(const std::shared_ptr<StepFile> &);
+    std::shared_ptr<const ModelSample> getSample(std::size_t i);
+
+    // the stacked samples are used for many predictions when they fit in
+    // the cache budget, which they take from the cached samples
+    bool fitsStacked();
+
+public:
+    // bytes of latent matrices kept in memory between predictions
+    static std::uint64_t CACHE_BUDGET_DEFAULT_VALUE;
+    static bool CACHE_MAPPED_DEFAULT_VALUE;
 
 public:
     int getNumSteps() const
@@ -71,6 +89,21 @@ public:
         return m_model_rootfile;
     }
 
+    // samples are kept in a cache of at most budget bytes, and mapped from
+    // binary model files instead of read when mapped is set; both empty the
+    // cache and drop the stacked samples
+    void setCacheBudget(std::uint64_t budget);
+    void setCacheMapped(bool mapped);
+
+    // loads as many samples as fit in the cache budget
+    void preload();
+
+    std::shared_ptr<const SampleCache> getCache() const;
+
+    // all samples stacked per mode, built on first use; the panels are
+    // reserved in the cache budget and the cached samples dropped
+    std::shared_ptr<const StackedSamples> getStackedSamples();
+
   public:
     PredictSession(const Config &config);
     PredictSession(std::shared_ptr<RootFile> rf, const Config &config);
@@ -87,10 +120,26 @@ public:
     void predict(ResultItem &);
     void predict(ResultItem &, const StepFile &sf);
 
+    // predict many elements with one pass over the samples
+    void predict(std::vector<ResultItem> &);
+
+    // mean, variance and quantiles at probs over the samples of the
+    // predictions for every element, see StackedSamples::predict
+    void predict(const std::vector<PVec<>> &coords, const std::vector<double> &probs,
+                 Eigen::VectorXd &mean, Eigen::VectorXd &var, Eigen::MatrixXd &quantiles);
+
     // predict all elements in Ytest
     std::shared_ptr<Result> predict(std::shared_ptr<TensorConfig> Y);
     void predict(Result &, const StepFile &);
 
+    // the n columns with the highest score for every row of rows, best
+    // first: score is mean + ucb * std of the predictions of all samples,
+    // ucb = 0 ranks by posterior mean. Entries of exclude, e.g. the train
+    // data, are skipped. Rows are answered in batches, with one pass over
+    // the samples per batch.
+    std::vector<std::vector<TopNItem>> topN(const std::vector<int> &rows, int n, double ucb = 0.0,
+                                           std::shared_ptr<const MatrixConfig> exclude = std::shared_ptr<const MatrixConfig>());
+
     // predict element or elements based on sideinfo
     template<class Feat>
     std::shared_ptr<Result> predict(std::vector<std::shared_ptr<Feat>>);
@@ -0,0 +1,190 @@
+#include "SampleCache.h"
+
+#include <SmurffCpp/Model.h>
+#include <SmurffCpp/IO/MatrixIO.h>
+#include <SmurffCpp/Utils/Error.h>
+#include <SmurffCpp/Utils/StepFile.h>
+
+namespace smurff {
+
+ModelSample::ModelSample(const StepFile& sf, bool mapped)
+{
+   if (mapped && sf.isBinary())
+   {
+      for (std::int32_t m = 0; m < sf.getNSamples(); ++m)
+      {
+         auto file = std::make_shared<MappedFile>(sf.getModelFileName(m));
+         m_U.push_back(matrix_io::eigen::map_dense_float64_bin(*file));
+         m_files.push_back(file);
+      }
+   }
+   else
+   {
+      m_model = sf.restoreModel();
+      for (std::uint64_t m = 0; m < m_model->nmodes(); ++m)
+      {
+         const Eigen::MatrixXd& U = m_model->U(m);
+         m_U.push_back(Eigen::Map<const Eigen::MatrixXd>(U.data(), U.rows(), U.cols()));
+      }
+   }
+
+   THROWERROR_ASSERT_MSG(m_U.size() >= 2, "Model in " + sf.getStepFileName() + " should have at least two modes");
+
+   for (std::uint64_t m = 1; m < m_U.size(); ++m)
+   {
+      THROWERROR_ASSERT_MSG(m_U[m].rows() == m_U[0].rows(), "Number of latents differs between the modes of " + sf.getStepFileName());
+   }
+}
+
+std::uint64_t ModelSample::nmodes() const
+{
+   return m_U.size();
+}
+
+int ModelSample::nlatent() const
+{
+   return m_U[0].rows();
+}
+
+PVec<> ModelSample::getDims() const
+{
+   PVec<> dims(m_U.size());
+   for (std::uint64_t m = 0; m < m_U.size(); ++m)
+      dims[m] = m_U[m].cols();
+   return dims;
+}
+
+std::uint64_t ModelSample::bytes() const
+{
+   std::uint64_t ret = 0;
+   for (const auto& U : m_U)
+      ret += U.size() * sizeof(double);
+   return ret;
+}
+
+SampleCache::SampleCache(const std::vector<std::shared_ptr<StepFile> >& stepfiles, std::uint64_t budget, bool mapped)
+   : m_stepfiles(stepfiles), m_budget(budget), m_mapped(mapped),
+     m_samples(stepfiles.size()), m_mru_pos(stepfiles.size()), m_bytes(0), m_reserved(0),
+     m_hits(0), m_misses(0)
+{
+}
+
+void SampleCache::insert(std::size_t i, std::shared_ptr<const ModelSample> sample)
+{
+   const std::uint64_t bytes = sample->bytes();
+   if (m_reserved + bytes > m_budget)
+      return;
+
+   while (m_reserved + m_bytes + bytes > m_budget)
+      evict(m_mru.front());
+
+   m_samples[i] = sample;
+   m_mru.push_front(i);
+   m_mru_pos[i] = m_mru.begin();
+   m_bytes += bytes;
+}
+
+void SampleCache::touch(std::size_t i)
+{
+   m_mru.splice(m_mru.begin(), m_mru, m_mru_pos[i]);
+}
+
+void SampleCache::evict(std::size_t i)
+{
+   m_bytes -= m_samples[i]->bytes();
+   m_samples[i].reset();
+   m_mru.erase(m_mru_pos[i]);
+}
+
+std::size_t SampleCache::size() const
+{
+   return m_stepfiles.size();
+}
+
+const StepFile& SampleCache::getStepFile(std::size_t i) const
+{
+   return *m_stepfiles.at(i);
+}
+
+std::shared_ptr<const ModelSample> SampleCache::get(std::size_t i)
+{
+   THROWERROR_ASSERT(i < size());
+
+   if (m_samples[i])
+   {
+      m_hits++;
+      touch(i);
+      return m_samples[i];
+   }
+
+   m_misses++;
+   auto sample = std::make_shared<const ModelSample>(*m_stepfiles[i], m_mapped);
+   insert(i, sample);
+   return sample;
+}
+
+void SampleCache::preload()
+{
+   for (std::size_t i = 0; i < size(); ++i)
+   {
+      if (m_samples[i])
+         continue;
+
+      auto sample = std::make_shared<const ModelSample>(*m_stepfiles[i], m_mapped);
+      if (m_reserved + m_bytes + sample->bytes() > m_budget)
+         break;
+
+      insert(i, sample);
+   }
+}
+
+void SampleCache::clear()
+{
+   while (!m_mru.empty())
+      evict(m_mru.back());
+   m_reserved = 0;
+}
+
+void SampleCache::reserve(std::uint64_t bytes)
+{
+   m_reserved = bytes;
+   while (!m_mru.empty() && m_reserved + m_bytes > m_budget)
+      evict(m_mru.front());
+}
+
+std::uint64_t SampleCache::getBudget() const
+{
+   return m_budget;
+}
+
+bool SampleCache::isMapped() const
+{
+   return m_mapped;
+}
+
+std::uint64_t SampleCache::bytes() const
+{
+   return m_bytes;
+}
+
+std::uint64_t SampleCache::getReserved() const
+{
+   return m_reserved;
+}
+
+std::size_t SampleCache::numCached() const
+{
+   return m_mru.size();
+}
+
+std::uint64_t SampleCache::getHits() const
+{
+   return m_hits;
+}
+
+std::uint64_t SampleCache::getMisses() const
+{
+   return m_misses;
+}
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <SmurffCpp/Utils/PVec.hpp>
+#include <SmurffCpp/IO/MappedFile.h>
+
+namespace smurff {
+
+class Model;
+class StepFile;
+
+// latent matrices of one posterior sample, restored in memory or mapped
+// from the binary model files of its step file
+class ModelSample
+{
+private:
+   std::shared_ptr<Model> m_model;                   // when restored
+   std::vector<std::shared_ptr<MappedFile> > m_files; // when mapped
+   std::vector<Eigen::Map<const Eigen::MatrixXd> > m_U;
+
+public:
+   // mapped is ignored for text model files
+   ModelSample(const StepFile& sf, bool mapped);
+
+public:
+   std::uint64_t nmodes() const;
+   int nlatent() const;
+   PVec<> getDims() const;
+
+   const Eigen::Map<const Eigen::MatrixXd>& U(std::uint64_t mode) const
+   {
+      return m_U[mode];
+   }
+
+   bool isMapped() const
+   {
+      return !m_files.empty();
+   }
+
+   // size of the latent matrices
+   std::uint64_t bytes() const;
+
+   // dot product of the columns pos[m] of every U(m), pos has to be in range
+   double predict(const PVec<>& pos) const
+   {
+      const int nl = nlatent();
+
+      if (m_U.size() == 2)
+         return m_U[0].col(pos[0]).dot(m_U[1].col(pos[1]));
+
+      double sum = 0.0;
+      for (int k = 0; k < nl; ++k)
+      {
+         double p = m_U[0](k, pos[0]);
+         for (std::uint64_t m = 1; m < m_U.size(); ++m)
+            p *= m_U[m](k, pos[m]);
+         sum += p;
+      }
+      return sum;
+   }
+};
+
+// posterior samples of a PredictSession, loaded once and kept as long as
+// they fit in a memory budget
+//
+// the most recently used sample is dropped first: the predictions go over
+// the samples in order, again and again, so the sample used last is the one
+// needed again latest, and the least recently used one the next. With a
+// budget of B < S samples every pass then reads about S - B of them instead
+// of all S.
+class SampleCache
+{
+private:
+   std::vector<std::shared_ptr<StepFile> > m_stepfiles;
+   std::uint64_t m_budget;
+   bool m_mapped;
+
+   std::vector<std::shared_ptr<const ModelSample> > m_samples; // null when not cached
+   std::list<std::size_t> m_mru;                              // cached samples, most recently used first
+   std::vector<std::list<std::size_t>::iterator> m_mru_pos;
+   std::uint64_t m_bytes;
+   std::uint64_t m_reserved;
+
+   std::uint64_t m_hits;
+   std::uint64_t m_misses;
+
+public:
+   // budget - bytes of latent matrices to keep, mapped - map binary model
+   // files instead of reading them
+   SampleCache(const std::vector<std::shared_ptr<StepFile> >& stepfiles, std::uint64_t budget, bool mapped);
+
+private:
+   void insert(std::size_t i, std::shared_ptr<const ModelSample> sample);
+   void touch(std::size_t i);
+   void evict(std::size_t i);
+
+public:
+   // number of samples
+   std::size_t size() const;
+
+   const StepFile& getStepFile(std::size_t i) const;
+
+   // sample i, loaded when it is not cached
+   std::shared_ptr<const ModelSample> get(std::size_t i);
+
+   // loads the samples in order, as long as they fit in the budget
+   void preload();
+
+   // drops all samples and releases the reserved bytes
+   void clear();
+
+   // bytes kept outside of the cache that count against its budget, samples
+   // are dropped until the rest fits
+   void reserve(std::uint64_t bytes);
+
+   std::uint64_t getBudget() const;
+   bool isMapped() const;
+
+   std::uint64_t bytes() const;
+   std::uint64_t getReserved() const;
+   std::size_t numCached() const;
+   std::uint64_t getHits() const;
+   std::uint64_t getMisses() const;
+};
+
+}
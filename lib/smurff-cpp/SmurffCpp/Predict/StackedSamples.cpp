@@ -0,0 +1,145 @@
+#include "StackedSamples.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <SmurffCpp/Predict/SampleCache.h>
+#include <SmurffCpp/Utils/Error.h>
+
+namespace smurff {
+
+StackedSamples::StackedSamples(SampleCache& cache)
+   : m_nsamples(cache.size()), m_nlatent(0)
+{
+   THROWERROR_ASSERT_MSG(m_nsamples > 0, "No samples to stack");
+
+   for (int s = 0; s < m_nsamples; ++s)
+   {
+      auto sample = cache.get(s);
+      if (s == 0)
+      {
+         m_nlatent = sample->nlatent();
+         for (std::uint64_t m = 0; m < sample->nmodes(); ++m)
+            m_panels.push_back(Eigen::MatrixXd(m_nsamples * m_nlatent, sample->U(m).cols()));
+      }
+
+      THROWERROR_ASSERT(sample->nlatent() == m_nlatent);
+      THROWERROR_ASSERT(sample->getDims() == getDims());
+
+      for (std::uint64_t m = 0; m < nmodes(); ++m)
+         m_panels[m].middleRows(s * m_nlatent, m_nlatent) = sample->U(m);
+   }
+}
+
+PVec<> StackedSamples::getDims() const
+{
+   PVec<> dims(m_panels.size());
+   for (std::uint64_t m = 0; m < m_panels.size(); ++m)
+      dims[m] = m_panels[m].cols();
+   return dims;
+}
+
+std::uint64_t StackedSamples::bytes() const
+{
+   std::uint64_t ret = 0;
+   for (const auto& P : m_panels)
+      ret += P.size() * sizeof(double);
+   return ret;
+}
+
+void StackedSamples::check_probs(const std::vector<double>& probs)
+{
+   for (double p : probs)
+   {
+      THROWERROR_ASSERT_MSG(p >= 0.0 && p <= 1.0, "Quantile probabilities should be in [0, 1]");
+   }
+}
+
+// coordinates sorted by their entity of the first mode: the latents of that
+// entity are read once and stay in cache for all coordinates that share it
+template<typename Coords>
+static std::vector<std::size_t> row_order(std::size_t n, const Coords& coords, const PVec<>& dims)
+{
+   for (std::size_t k = 0; k < n; ++k)
+   {
+      const PVec<>& pos = coords(k);
+      THROWERROR_ASSERT_MSG(pos.size() == dims.size(), "Wrong number of coordinates for model");
+      THROWERROR_ASSERT_MSG(pos.in(PVec<>(dims.size()), dims), "Coordinate out of range for model");
+   }
+
+   std::vector<std::size_t> order(n);
+   std::iota(order.begin(), order.end(), 0);
+   std::stable_sort(order.begin(), order.end(),
+      [&coords](std::size_t a, std::size_t b) { return coords(a)[0] < coords(b)[0]; });
+   return order;
+}
+
+void StackedSamples::predict(std::vector<ResultItem>& items) const
+{
+   auto coords = [&items](std::size_t k) -> const PVec<>& { return items[k].coords; };
+   const std::vector<std::size_t> order = row_order(items.size(), coords, getDims());
+
+   #pragma omp parallel
+   {
+      Eigen::MatrixXd work;
+      Eigen::VectorXd preds(m_nsamples);
+
+      #pragma omp for schedule(dynamic, 256)
+      for (std::size_t j = 0; j < order.size(); ++j)
+      {
+         ResultItem& item = items[order[j]];
+         predict(item.coords, work, preds);
+
+         item.pred_all.reserve(item.pred_all.size() + m_nsamples);
+         for (int s = 0; s < m_nsamples; ++s)
+            item.update(preds(s));
+      }
+   }
+}
+
+void StackedSamples::predict(const std::vector<PVec<> >& coords, const std::vector<double>& probs,
+                             Eigen::VectorXd& mean, Eigen::VectorXd& var, Eigen::MatrixXd& quantiles) const
+{
+   check_probs(probs);
+
+   const std::vector<std::size_t> order = row_order(coords.size(), [&coords](std::size_t k) -> const PVec<>& { return coords[k]; }, getDims());
+
+   mean.resize(coords.size());
+   var.resize(coords.size());
+   quantiles.resize(coords.size(), probs.size());
+
+   #pragma omp parallel
+   {
+      Eigen::MatrixXd work;
+      Eigen::VectorXd preds(m_nsamples);
+
+      #pragma omp for schedule(dynamic, 256)
+      for (std::size_t j = 0; j < order.size(); ++j)
+      {
+         const std::size_t k = order[j];
+         predict(coords[k], work, preds);
+
+         mean(k) = preds.mean();
+         var(k) = (preds.array() - mean(k)).square().sum();
+
+         if (!probs.empty())
+            StackedSamples::quantiles(preds, probs, quantiles, k);
+      }
+   }
+}
+
+void StackedSamples::quantiles(Eigen::VectorXd& preds, const std::vector<double>& probs, Eigen::MatrixXd& quantiles, std::size_t k)
+{
+   const int n = preds.size();
+   std::sort(preds.data(), preds.data() + n);
+   for (std::size_t q = 0; q < probs.size(); ++q)
+   {
+      const double h = (n - 1) * probs[q];
+      const int lo = std::min((int)std::floor(h), n - 1);
+      const int hi = std::min(lo + 1, n - 1);
+      quantiles(k, q) = preds(lo) + (h - lo) * (preds(hi) - preds(lo));
+   }
+}
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <SmurffCpp/Utils/PVec.hpp>
+#include <SmurffCpp/ResultItem.h>
+
+namespace smurff {
+
+class SampleCache;
+
+// latent matrices of all S samples of a PredictSession, stacked per mode
+// into one (S * K) x N panel: column i holds the K latents of entity i of
+// every sample, so that the predictions of all samples for one coordinate
+// are a batch of S dot products over nmodes contiguous columns
+class StackedSamples
+{
+private:
+   std::vector<Eigen::MatrixXd> m_panels;
+   int m_nsamples;
+   int m_nlatent;
+
+public:
+   // every sample of cache, in order
+   StackedSamples(SampleCache& cache);
+
+public:
+   int nsamples() const
+   {
+      return m_nsamples;
+   }
+
+   int nlatent() const
+   {
+      return m_nlatent;
+   }
+
+   std::uint64_t nmodes() const
+   {
+      return m_panels.size();
+   }
+
+   PVec<> getDims() const;
+
+   // size of the panels
+   std::uint64_t bytes() const;
+
+   // K x S latents of entity i of mode
+   Eigen::Map<const Eigen::MatrixXd> latents(std::uint64_t mode, int i) const
+   {
+      return Eigen::Map<const Eigen::MatrixXd>(m_panels[mode].col(i).data(), m_nlatent, m_nsamples);
+   }
+
+   // predictions of every sample for pos, pos has to be in range
+   //
+   // work - buffer for tensors of more than two modes
+   void predict(const PVec<>& pos, Eigen::MatrixXd& work, Eigen::VectorXd& preds) const
+   {
+      if (m_panels.size() == 2)
+      {
+         preds = (latents(0, pos[0]).array() * latents(1, pos[1]).array()).colwise().sum().transpose().matrix();
+         return;
+      }
+
+      work = latents(0, pos[0]);
+      for (std::uint64_t m = 1; m < m_panels.size(); ++m)
+         work.array() *= latents(m, pos[m]).array();
+      preds = work.colwise().sum().transpose();
+   }
+
+public:
+   // every item updated with the prediction of every sample, in order
+   void predict(std::vector<ResultItem>& items) const;
+
+   // mean, variance and quantiles of the predictions for every coordinate
+   //
+   // var - sum of squared deviations from the mean, as ResultItem::var
+   // quantiles - coords.size() x probs.size(), linear interpolation between
+   //             the sorted predictions
+   void predict(const std::vector<PVec<> >& coords, const std::vector<double>& probs,
+                Eigen::VectorXd& mean, Eigen::VectorXd& var, Eigen::MatrixXd& quantiles) const;
+
+   // row k of quantiles from the predictions of every sample, which are
+   // sorted in place, as predict above
+   static void quantiles(Eigen::VectorXd& preds, const std::vector<double>& probs, Eigen::MatrixXd& quantiles, std::size_t k);
+
+   // throws unless every probability is in [0, 1]
+   static void check_probs(const std::vector<double>& probs);
+};
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace smurff {
+
+// one entity of the answer to a top-N query
+struct TopNItem
+{
+   std::uint32_t col;
+   double mean;  // mean of the predictions of all samples
+   double std;   // standard deviation of the predictions of all samples
+   double score; // mean + ucb * std
+};
+
+// the n items with the highest score of those offered, kept in a min-heap
+// on the score so that an item worse than all kept ones costs one compare
+class TopN
+{
+private:
+   std::size_t m_n;
+   std::vector<TopNItem> m_heap;
+
+   // a is better than b: higher score, lower col on ties
+   static bool better(const TopNItem& a, const TopNItem& b)
+   {
+      return a.score > b.score || (a.score == b.score && a.col < b.col);
+   }
+
+public:
+   TopN(std::size_t n)
+      : m_n(n)
+   {
+      m_heap.reserve(n);
+   }
+
+   void offer(const TopNItem& item)
+   {
+      if (m_heap.size() < m_n)
+      {
+         m_heap.push_back(item);
+         std::push_heap(m_heap.begin(), m_heap.end(), better);
+      }
+      else if (m_n > 0 && better(item, m_heap.front()))
+      {
+         std::pop_heap(m_heap.begin(), m_heap.end(), better);
+         m_heap.back() = item;
+         std::push_heap(m_heap.begin(), m_heap.end(), better);
+      }
+   }
+
+   // best first
+   std::vector<TopNItem> sorted() const
+   {
+      std::vector<TopNItem> ret(m_heap);
+      std::sort(ret.begin(), ret.end(), better);
+      return ret;
+   }
+};
+
+}
@@ -1,5 +1,8 @@
 #include "ILatentPrior.h"
 #include <SmurffCpp/Utils/counters.h>
+#include <SmurffCpp/Utils/Error.h>
+
+#include <algorithm>
 
 using namespace smurff;
 using namespace Eigen;
@@ -17,6 +20,11 @@ void ILatentPrior::init()
 
    //this is some new initialization
    init_Usum();
+
+   std::vector<std::uint64_t> nnz(col_end() - col_begin());
+   for(int n = col_begin(); n < col_end(); n++)
+      nnz[n - col_begin()] = data().col_nnz(m_mode, n);
+   m_scheduler.init(nnz, LatentScheduler::sample_cost(num_latent()), threads::get_max_threads(), can_split_latent(), col_begin());
 }
 
 const Model& ILatentPrior::model() const
@@ -85,6 +93,13 @@ int ILatentPrior::num_cols() const
    return model().U(m_mode).cols();
 }
 
+void ILatentPrior::setColumnRange(int begin, int end)
+{
+   THROWERROR_ASSERT(0 <= begin && begin <= end);
+   m_col_begin = begin;
+   m_col_end = end;
+}
+
 std::ostream &ILatentPrior::info(std::ostream &os, std::string indent)
 {
    os << indent << m_mode << ": " << m_name << std::endl;
@@ -99,28 +114,122 @@ bool ILatentPrior::run_slave()
 void ILatentPrior::sample_latents()
 {
    COUNTER("sample_latents");
+   sample_latent_vectors();
+   update_prior();
+}
+
+void ILatentPrior::sample_latent_vectors(const std::function<void()> &overlap)
+{
+   COUNTER("sample_latent_vectors");
    data().update_pnm(model(), m_mode);
 
+   const int K = num_latent();
+
    // for effiency, we keep + update Ucol and UUcol by every thread
-   thread_vector<VectorXd> Ucol(VectorXd::Zero(num_latent()));
-   thread_vector<MatrixXd> UUcol(MatrixXd::Zero(num_latent(), num_latent()));
+   thread_vector<VectorXd> Ucol(VectorXd::Zero(K));
+   thread_vector<MatrixXd> UUcol(MatrixXd::Zero(K, K));
+
+   const auto &chunks = m_scheduler.chunks();
+   const auto &heavy = m_scheduler.heavy();
+   const auto &parts = m_scheduler.parts();
+   const int nparts = parts.size();
+   const int ntasks = nparts + chunks.size();
+   const int block_size = std::max(1, latent_block_size());
+
+   // partial pnm of every part of the split columns
+   std::vector<VectorXd> part_rr(nparts, VectorXd::Zero(K));
+   std::vector<MatrixXd> part_MM(nparts, MatrixXd::Zero(K, K));
 
-   #pragma omp parallel for schedule(guided)
-   for(int n = 0; n < U().cols(); n++)
+   m_scheduler.start();
+
+   #pragma omp parallel
    {
-       #pragma omp task
-       {
-           sample_latent(n);
-           const auto& col = U().col(n);
-           Ucol.local().noalias() += col;
-           UUcol.local().noalias() += col * col.transpose();
-       }
+      double busy = 0.0;
+
+      // the other threads do not wait for this
+      #pragma omp master
+      if (overlap)
+      {
+         double start = tick();
+         overlap();
+         busy += tick() - start;
+      }
+
+      // parts first, so that the split columns are ready early
+      #pragma omp for schedule(dynamic, 1) nowait
+      for(int t = 0; t < ntasks; t++)
+      {
+         double start = tick();
+         if (t < nparts)
+         {
+            const auto &p = parts[t];
+            data().getMuLambdaRange(model(), m_mode, heavy[p.heavy], p.from, p.to, part_rr[t], part_MM[t]);
+         }
+         else
+         {
+            const auto &c = chunks[t - nparts];
+            for(int from = c.from; from < c.to; from += block_size)
+            {
+               const int to = std::min(from + block_size, c.to);
+               sample_latent_block(from, to);
+               for(int n = from; n < to; n++)
+               {
+                  const auto& col = U().col(n);
+                  Ucol.local().noalias() += col;
+                  UUcol.local().noalias() += col * col.transpose();
+               }
+            }
+         }
+         busy += tick() - start;
+      }
+
+      // all parts have to be done before sampling the split columns
+      #pragma omp barrier
+
+      #pragma omp for schedule(dynamic, 1)
+      for(int h = 0; h < (int)heavy.size(); h++)
+      {
+         double start = tick();
+         const int first = m_scheduler.heavy_begin(h);
+         const int last = m_scheduler.heavy_begin(h + 1);
+         for(int i = first + 1; i < last; i++)
+         {
+            part_rr[first] += part_rr[i];
+            part_MM[first] += part_MM[i];
+         }
+
+         const int n = heavy[h];
+         sample_latent_from(n, part_rr[first], part_MM[first]);
+         const auto& col = U().col(n);
+         Ucol.local().noalias() += col;
+         UUcol.local().noalias() += col * col.transpose();
+         busy += tick() - start;
+      }
+
+      m_scheduler.add_busy(busy);
    }
 
+   m_scheduler.stop();
+
    Usum  = Ucol.combine();
    UUsum = UUcol.combine();
+}
 
-   update_prior();
+void ILatentPrior::sample_latent_block(int from, int to)
+{
+   for(int n = from; n < to; n++)
+      sample_latent(n);
+}
+
+void ILatentPrior::sample_latent_from(int n, const VectorXd& rr, const MatrixXd& MM)
+{
+   THROWERROR_NOTIMPL();
+}
+
+std::ostream &ILatentPrior::scheduler_status(std::ostream &os, std::string indent) const
+{
+   os << indent << m_name << " scheduler:" << std::endl;
+   return m_scheduler.status(os, indent + "  ");
 }
 
 void ILatentPrior::save(std::shared_ptr<const StepFile> sf) const
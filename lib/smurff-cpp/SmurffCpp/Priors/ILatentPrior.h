@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <functional>
 
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
@@ -10,6 +11,7 @@
 #include <SmurffCpp/DataMatrices/Data.h>
 #include <SmurffCpp/Utils/Distribution.h>
 #include <SmurffCpp/Utils/ThreadVector.hpp>
+#include <SmurffCpp/Utils/LatentScheduler.h>
 
 #include <SmurffCpp/Model.h>
 
@@ -62,6 +64,12 @@ public:
    int num_latent() const;
    int num_cols() const;
 
+   // columns [col_begin, col_end) of U are sampled by sample_latents,
+   // all columns unless restricted with setColumnRange (see MPIDistSession)
+   int col_begin() const { return m_col_begin; }
+   int col_end() const { return m_col_end < 0 ? num_cols() : m_col_end; }
+   void setColumnRange(int begin, int end);
+
    const Eigen::VectorXd& getUsum() { return Usum; } 
    const Eigen::MatrixXd& getUUsum()  { return UUsum; }
 
@@ -76,13 +84,41 @@ public:
    virtual void sample_latents();
    virtual void sample_latent(int n) = 0;
 
+   // samples all columns of U (sample_latents without update_prior);
+   // if given, overlap is run by the master thread while the other
+   // threads start sampling
+   void sample_latent_vectors(const std::function<void()> &overlap = nullptr);
+
+   // samples columns [from, to) of U; by default one column at a time
+   virtual void sample_latent_block(int from, int to);
+
+   // number of columns handed to sample_latent_block at once
+   virtual int latent_block_size() const { return 1; }
+
+   // samples column n given its pnm (Data::getMuLambda) in rr and MM;
+   // only called when can_split_latent() returns true, for columns
+   // whose getMuLambda is split over several threads
+   virtual void sample_latent_from(int n, const Eigen::VectorXd& rr, const Eigen::MatrixXd& MM);
+   virtual bool can_split_latent() const { return false; }
+
+   // how the columns were distributed in the last sample_latents
+   std::ostream &scheduler_status(std::ostream &os, std::string indent) const;
+
    virtual void update_prior() = 0;
 
-private:
-   void init_Usum();
+protected:
+   // sum of the sampled columns of U and of their outer products
    Eigen::VectorXd Usum;
    Eigen::MatrixXd UUsum;
 
+private:
+   void init_Usum();
+
+   LatentScheduler m_scheduler;
+
+   int m_col_begin = 0;
+   int m_col_end = -1;
+
 public:
    void setMode(std::uint32_t value)
    {
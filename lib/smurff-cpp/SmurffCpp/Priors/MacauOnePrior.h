@@ -56,7 +56,9 @@ public:
    //FIXME: tolerance_a and direct_a are not really used. 
    //should remove later after PriorFactory is properly implemented. 
    //No reason generalizing addSideInfo between priors
-   void addSideInfo(const std::shared_ptr<ISideInfo>& side_info_a, double beta_precision_a, double tolerance_a, bool direct_a, bool enable_beta_precision_sampling_a, bool throw_on_cholesky_error_a);
+   void addSideInfo(const std::shared_ptr<ISideInfo>& side_info_a, double beta_precision_a, double tolerance_a, bool direct_a, bool enable_beta_precision_sampling_a, bool throw_on_cholesky_error_a,
+                    int max_iter_a = SideInfoConfig::MAX_ITER_DEFAULT_VALUE, bool warm_start_a = SideInfoConfig::WARM_START_DEFAULT_VALUE,
+                    PreconditionerTypes preconditioner_a = SideInfoConfig::PRECONDITIONER_DEFAULT_VALUE, bool parallel_blocks_a = SideInfoConfig::PARALLEL_BLOCKS_DEFAULT_VALUE);
 
 public:
 
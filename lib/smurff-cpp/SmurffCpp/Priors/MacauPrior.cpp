@@ -39,10 +39,11 @@ void MacauPrior::init()
 
    if (use_FtF)
    {
-      std::uint64_t dim = Features->cols();
-      FtF_plus_beta.resize(dim, dim);
-      Features->At_mul_A(FtF_plus_beta);
-      FtF_plus_beta.diagonal().array() += beta_precision;
+      decompose_FtF();
+   }
+   else
+   {
+      blockcg_params.preconditioner = Features->create_preconditioner(preconditioner_type);
    }
 
    Uhat.resize(this->num_latent(), Features->rows());
@@ -66,10 +67,9 @@ void MacauPrior::update_prior()
 
     if (enable_beta_precision_sampling)
     {
-        double old_beta = beta_precision;
+        // no refactorization needed, the new shift is applied in sample_beta_direct
         beta_precision = sample_beta_precision(beta, this->Lambda, beta_precision_nu0, beta_precision_mu0);
-        FtF_plus_beta.diagonal().array() += beta_precision - old_beta;
-   }
+    }
 }
 
 const Eigen::VectorXd MacauPrior::getMu(int n) const
@@ -98,6 +98,34 @@ void MacauPrior::compute_Ft_y_omp(Eigen::MatrixXd& Ft_y)
    }
 }
 
+void MacauPrior::decompose_FtF()
+{
+   COUNTER("decompose_FtF");
+   std::uint64_t dim = Features->cols();
+   Eigen::MatrixXd FtF(dim, dim);
+   Features->At_mul_A(FtF); // only the lower triangle is used
+
+   Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eig(FtF);
+   THROWERROR_ASSERT_MSG(eig.info() == Eigen::Success, "Eigendecomposition of F'F failed");
+
+   FtF_eigenvalues = eig.eigenvalues();
+   FtF_eigenvectors = eig.eigenvectors();
+}
+
+std::uint64_t MacauPrior::direct_memory(bool peak) const
+{
+   const std::uint64_t F = Features->cols();
+   const std::uint64_t K = num_latent();
+
+   // eigenvectors, plus Ft_y and two temporaries of the same size in sample_beta_direct
+   std::uint64_t bytes = (F * F + F + 3 * K * F) * sizeof(double);
+
+   // F'F and the work matrix of the eigensolver, freed after decompose_FtF
+   if (peak) bytes += 2 * F * F * sizeof(double);
+
+   return bytes;
+}
+
 void MacauPrior::sample_beta()
 {
    COUNTER("sample_beta");
@@ -107,7 +135,8 @@ void MacauPrior::sample_beta()
       sample_beta_cg();
 }
 
-void MacauPrior::addSideInfo(const std::shared_ptr<ISideInfo>& side_info_a, double beta_precision_a, double tolerance_a, bool direct_a, bool enable_beta_precision_sampling_a, bool throw_on_cholesky_error_a)
+void MacauPrior::addSideInfo(const std::shared_ptr<ISideInfo>& side_info_a, double beta_precision_a, double tolerance_a, bool direct_a, bool enable_beta_precision_sampling_a, bool throw_on_cholesky_error_a,
+                             int max_iter_a, bool warm_start_a, PreconditionerTypes preconditioner_a, bool parallel_blocks_a)
 {
    //FIXME: remove old code
 
@@ -120,6 +149,12 @@ void MacauPrior::addSideInfo(const std::shared_ptr<ISideInfo>& side_info_a, doub
    use_FtF = direct_a;
    enable_beta_precision_sampling = enable_beta_precision_sampling_a;
    throw_on_cholesky_error = throw_on_cholesky_error_a;
+   preconditioner_type = preconditioner_a;
+
+   blockcg_params.max_iter = max_iter_a;
+   blockcg_params.warm_start = warm_start_a;
+   blockcg_params.throw_on_cholesky_error = throw_on_cholesky_error_a;
+   blockcg_params.parallel_blocks = parallel_blocks_a;
 
    // new code
 
@@ -165,13 +200,19 @@ std::ostream& MacauPrior::info(std::ostream &os, std::string indent)
    os << indent << " Method: ";
    if (use_FtF)
    {
-      os << "Cholesky Decomposition";
-      double needs_gb = (double)Features->cols() / 1024. * (double)Features->cols() / 1024. / 1024.;
+      os << "Eigendecomposition of F'F";
+      double needs_gb = (double)direct_memory(false) / 1024. / 1024. / 1024.;
+      double peak_gb = (double)direct_memory(true) / 1024. / 1024. / 1024.;
       if (needs_gb > 1.0) os << " (needing " << needs_gb << " GB of memory)";
       os << std::endl;
+      os << indent << "  with memory estimate: " << needs_gb << " GB, " << peak_gb << " GB during init" << std::endl;
    } else {
       os << "CG Solver" << std::endl;
       os << indent << "  with tolerance: " << std::scientific << tol << std::fixed << std::endl;
+      os << indent << "  with max iterations: " << blockcg_params.max_iter << std::endl;
+      os << indent << "  with preconditioner: " << preconditionerTypeToString(preconditioner_type) << std::endl;
+      os << indent << "  with warm start: " << (blockcg_params.warm_start ? "yes" : "no") << std::endl;
+      os << indent << "  with parallel blocks: " << (blockcg_params.parallel_blocks ? "yes" : "no") << std::endl;
    }
    os << indent << " BetaPrecision: " << beta_precision << std::endl;
    return os;
@@ -181,8 +222,9 @@ std::ostream& MacauPrior::status(std::ostream &os, std::string indent) const
 {
    os << indent << m_name << ": " << std::endl;
    indent += "  ";
-   os << indent << "blockcg iter = " << blockcg_iter << std::endl;
-   os << indent << "FtF_plus_beta= " << FtF_plus_beta.norm() << std::endl;
+   os << indent << "blockcg iter = " << blockcg_iter << ", residual = " << std::scientific << blockcg_residual << std::fixed << std::endl;
+   if (use_FtF)
+      os << indent << "FtF_plus_beta= " << (FtF_eigenvalues.array() + beta_precision).matrix().norm() << std::endl;
    os << indent << "HyperU       = " << HyperU.norm() << std::endl;
    os << indent << "HyperU2      = " << HyperU2.norm() << std::endl;
    os << indent << "Beta         = " << beta.norm() << std::endl;
@@ -195,7 +237,11 @@ std::ostream& MacauPrior::status(std::ostream &os, std::string indent) const
 void MacauPrior::sample_beta_direct()
 {
     this->compute_Ft_y_omp(Ft_y);
-    beta = FtF_plus_beta.llt().solve(Ft_y.transpose()).transpose();
+
+    // beta = Ft_y * (F'F + beta_precision * I)^-1 = Ft_y * V * diag(1 / (lambda + beta_precision)) * V'
+    Eigen::MatrixXd FtyV = Ft_y * FtF_eigenvectors;
+    FtyV.array().rowwise() /= (FtF_eigenvalues.array() + beta_precision).transpose();
+    beta.noalias() = FtyV * FtF_eigenvectors.transpose();
 }
 
 std::pair<double, double> MacauPrior::posterior_beta_precision(Eigen::MatrixXd & beta, Eigen::MatrixXd & Lambda_u, double nu, double mu)
@@ -221,5 +267,6 @@ void MacauPrior::sample_beta_cg()
     Eigen::MatrixXd Ft_y;
     this->compute_Ft_y_omp(Ft_y);
 
-    blockcg_iter = Features->solve_blockcg(beta, beta_precision, Ft_y, tol, 32, 8, throw_on_cholesky_error);
+    // with warm start the previous beta is the initial guess
+    blockcg_iter = Features->solve_blockcg(beta, beta_precision, Ft_y, tol, 32, 8, blockcg_params, blockcg_residual);
 }
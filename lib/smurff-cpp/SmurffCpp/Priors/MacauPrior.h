@@ -8,6 +8,7 @@
 #include <SmurffCpp/Priors/NormalPrior.h>
 
 #include <SmurffCpp/SideInfo/ISideInfo.h>
+#include <SmurffCpp/Configs/SideInfoConfig.h>
 
 namespace smurff {
 
@@ -20,12 +21,14 @@ class MacauPrior : public NormalPrior
 {
 public:
    Eigen::MatrixXd Uhat;
-   Eigen::MatrixXd FtF_plus_beta;       // F'F
+   Eigen::MatrixXd FtF_eigenvectors;    // F'F = V * diag(lambda) * V'
+   Eigen::VectorXd FtF_eigenvalues;     // lambda
    Eigen::MatrixXd beta;      // link matrix
    Eigen::MatrixXd HyperU, HyperU2;
    Eigen::MatrixXd Ft_y;
 
-   int blockcg_iter;
+   int blockcg_iter = 0;
+   double blockcg_residual = 0.0;
    
    double beta_precision_mu0; // Hyper-prior for beta_precision
    double beta_precision_nu0; // Hyper-prior for beta_precision
@@ -51,6 +54,8 @@ public:
    bool use_FtF;
    bool enable_beta_precision_sampling;
    bool throw_on_cholesky_error;
+   PreconditionerTypes preconditioner_type;
+   linop::BlockCGParams blockcg_params;
 
 private:
    MacauPrior();
@@ -68,12 +73,22 @@ public:
 
    void compute_Ft_y_omp(Eigen::MatrixXd& Ft_y);
 
+   // eigendecomposition of F'F for the direct method, computed once,
+   // so that F'F + beta_precision * I can be solved for any beta_precision
+   void decompose_FtF();
+
+   // estimated memory in bytes needed by the direct method,
+   // peak is during decompose_FtF()
+   std::uint64_t direct_memory(bool peak) const;
+
    // Update beta and Uhat
    virtual void sample_beta();
 
 public:
 
-   void addSideInfo(const std::shared_ptr<ISideInfo>& side_info_a, double beta_precision_a, double tolerance_a, bool direct_a, bool enable_beta_precision_sampling_a, bool throw_on_cholesky_error_a);
+   void addSideInfo(const std::shared_ptr<ISideInfo>& side_info_a, double beta_precision_a, double tolerance_a, bool direct_a, bool enable_beta_precision_sampling_a, bool throw_on_cholesky_error_a,
+                    int max_iter_a = SideInfoConfig::MAX_ITER_DEFAULT_VALUE, bool warm_start_a = SideInfoConfig::WARM_START_DEFAULT_VALUE,
+                    PreconditionerTypes preconditioner_a = SideInfoConfig::PRECONDITIONER_DEFAULT_VALUE, bool parallel_blocks_a = SideInfoConfig::PARALLEL_BLOCKS_DEFAULT_VALUE);
 
 public:
 
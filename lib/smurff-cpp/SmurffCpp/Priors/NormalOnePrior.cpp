@@ -44,18 +44,29 @@ void NormalOnePrior::update_prior()
 
 void NormalOnePrior::sample_latent(int d)
 {
-   const int K = num_latent();
+   VectorXd &rr = rrs.local();
+   MatrixXd &MM = MMs.local();
+
+   rr.setZero();
+   MM.setZero();
 
-   MatrixXd XX = MatrixXd::Zero(K, K);
-   VectorXd yX = VectorXd::Zero(K);
+   data().getMuLambda(model(), m_mode, d, rr, MM);
 
-   data().getMuLambda(model(), m_mode, d, yX, XX);
+   sample_latent_from(d, rr, MM);
+}
+
+void NormalOnePrior::sample_latent_from(int d, const VectorXd& rr, const MatrixXd& MM)
+{
+   // add hyperparams, in the buffers of the thread: rr and MM may be them
+   VectorXd &yX = rrs.local();
+   MatrixXd &XX = MMs.local();
 
-   // add hyperparams
+   yX = rr;
    yX.noalias() += Lambda * mu;
-   XX.noalias() += Lambda;
+   XX = MM;
+   XX += Lambda;
 
-   for(int k=0;k<K;++k) sample_latent(d, k, XX, yX);
+   for(int k=0;k<num_latent();++k) sample_latent(d, k, XX, yX);
 }
  
 std::pair<double,double> NormalOnePrior::sample_latent(int d, int k, const MatrixXd& XX, const VectorXd& yX)
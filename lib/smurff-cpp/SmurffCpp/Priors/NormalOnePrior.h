@@ -40,6 +40,8 @@ public:
    virtual const Eigen::VectorXd getMu(int n) const;
 
    void sample_latent(int n) override;
+   void sample_latent_from(int n, const Eigen::VectorXd& rr, const Eigen::MatrixXd& MM) override;
+   bool can_split_latent() const override { return true; }
    virtual std::pair<double,double> sample_latent(int d, int k, const Eigen::MatrixXd& XX, const Eigen::VectorXd& yX);
 
    void update_prior() override;
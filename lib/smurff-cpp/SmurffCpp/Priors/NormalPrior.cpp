@@ -1,11 +1,13 @@
 #include "NormalPrior.h"
 
 #include <iomanip>
+#include <algorithm>
 
 #include <SmurffCpp/Utils/chol.h>
 #include <SmurffCpp/Utils/linop.h>
 #include <SmurffCpp/IO/MatrixIO.h>
 #include <SmurffCpp/Utils/counters.h>
+#include <SmurffCpp/Utils/NumLatent.hpp>
 
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
@@ -24,6 +26,44 @@ NormalPrior::NormalPrior(std::shared_ptr<BaseSession> session, uint32_t mode, st
 
 }
 
+template<int K>
+struct NormalPrior::SampleLatentKernel
+{
+   typedef Eigen::Matrix<double, K, 1> Vector;
+   typedef Eigen::Matrix<double, K, K> Matrix;
+
+   //rr and MM already contain the pnm of column n
+   static void run(NormalPrior &p, int n, const VectorXd &rr, const MatrixXd &MM)
+   {
+      const int nl = p.num_latent();
+      const auto &mu_u = p.getMu(n);
+
+      // add hyperparams
+      Map<const Matrix> Lambda(p.Lambda.data(), nl, nl);
+      Vector rr_k = Map<const Vector>(rr.data(), nl);
+      rr_k.noalias() += Lambda * Map<const Vector>(mu_u.data(), nl);
+      Matrix MM_k = Map<const Matrix>(MM.data(), nl, nl) + Lambda;
+
+      //Solve system of linear equations for x: MM * x = rr - not exactly correct  because we have random part
+      //Sample from multivariate normal distribution with mean rr and precision matrix MM
+
+      Eigen::LLT<Matrix> chol;
+      {
+         chol = MM_k.llt(); // compute the Cholesky decomposition X = L * U
+         if(chol.info() != Eigen::Success)
+         {
+            THROWERROR("Cholesky Decomposition failed!");
+         }
+      }
+
+      chol.matrixL().solveInPlace(rr_k); // solve for y: y = L^-1 * b
+      rr_k.noalias() += nrandn(nl);
+      chol.matrixU().solveInPlace(rr_k); // solve for x: x = U^-1 * y
+
+      p.U().col(n).noalias() = rr_k; // rr is equal to x
+   }
+};
+
 void NormalPrior::init()
 {
    //does not look that there was such init previously
@@ -44,6 +84,12 @@ void NormalPrior::init()
    mu0.setZero();
    b0 = 2;
    df = K;
+
+   m_sample_latent = select_num_latent<SampleLatentKernel>(K);
+
+   // per-thread block buffers are sized on first use
+   MMbs.init(VectorXd());
+   rrbs.init(VectorXd());
 }
 
 const Eigen::VectorXd NormalPrior::getMu(int n) const
@@ -57,10 +103,8 @@ void NormalPrior::update_prior()
 }
 
 //n is an index of column in U matrix
-void  NormalPrior::sample_latent(int n)
+void NormalPrior::sample_latent(int n)
 {
-   const auto &mu_u = getMu(n);
-
    VectorXd &rr = rrs.local();
    MatrixXd &MM = MMs.local();
 
@@ -70,27 +114,76 @@ void  NormalPrior::sample_latent(int n)
    // add pnm
    data().getMuLambda(model(), m_mode, n, rr, MM);
 
-   // add hyperparams
-   rr.noalias() += Lambda * mu_u;
-   MM.noalias() += Lambda;
+   m_sample_latent(*this, n, rr, MM);
+}
+
+void NormalPrior::sample_latent_from(int n, const VectorXd &rr, const MatrixXd &MM)
+{
+   m_sample_latent(*this, n, rr, MM);
+}
 
-   //Solve system of linear equations for x: MM * x = rr - not exactly correct  because we have random part
-   //Sample from multivariate normal distribution with mean rr and precision matrix MM
+int NormalPrior::latent_block_size() const
+{
+   return std::max(1, batch_size);
+}
 
-   Eigen::LLT<MatrixXd> chol;
+//samples columns [from, to) of U together
+//same as sample_latent for each column, but the Cholesky decomposition,
+//triangular solves and noise are done on an interleaved tile of columns
+void NormalPrior::sample_latent_block(int from, int to)
+{
+   if (latent_block_size() == 1)
    {
-      chol = MM.llt(); // compute the Cholesky decomposition X = L * U
-      if(chol.info() != Eigen::Success)
-      {
-         THROWERROR("Cholesky Decomposition failed!");
-      }
+      ILatentPrior::sample_latent_block(from, to);
+      return;
+   }
+
+   const int K = num_latent();
+   const int w = to - from;
+
+   THROWERROR_ASSERT(w <= batch_size);
+
+   VectorXd &rr = rrs.local();
+   MatrixXd &MM = MMs.local();
+
+   VectorXd &MMbuf = MMbs.local();
+   VectorXd &rrbuf = rrbs.local();
+   if (MMbuf.size() < w * K * K) MMbuf.resize(batch_size * K * K);
+   if (rrbuf.size() < w * K) rrbuf.resize(batch_size * K);
+
+   // lane l of element (i,j) is at (j*K + i)*w + l
+   Map<MatrixXd> MMb(MMbuf.data(), w, K * K);
+   Map<MatrixXd> rrb(rrbuf.data(), w, K);
+
+   for (int l = 0; l < w; l++)
+   {
+      const int n = from + l;
+
+      rr.setZero();
+      MM.setZero();
+
+      // add pnm
+      data().getMuLambda(model(), m_mode, n, rr, MM);
+
+      // add hyperparams
+      rr.noalias() += Lambda * getMu(n);
+      MM.noalias() += Lambda;
+
+      // scatter into lane l (lower triangle only)
+      for (int j = 0; j < K; j++)
+         for (int i = j; i < K; i++)
+            MMb(l, j * K + i) = MM(i, j);
+
+      rrb.row(l) = rr.transpose();
    }
 
-   chol.matrixL().solveInPlace(rr); // solve for y: y = L^-1 * b
-   rr.noalias() += nrandn(num_latent());
-   chol.matrixU().solveInPlace(rr); // solve for x: x = U^-1 * y
-   
-   U().col(n).noalias() = rr; // rr is equal to x
+   chol_decomp_batch(MMb.data(), K, w); // MM = L * L'
+   chol_solve_L_batch(MMb.data(), rrb.data(), K, w); // y = L^-1 * rr
+   rrb.array() += nrandn(w, K);
+   chol_solve_Lt_batch(MMb.data(), rrb.data(), K, w); // x = L'^-1 * y
+
+   for (int l = 0; l < w; l++)
+      U().col(from + l).noalias() = rrb.row(l).transpose();
 }
 
 std::ostream &NormalPrior::status(std::ostream &os, std::string indent) const
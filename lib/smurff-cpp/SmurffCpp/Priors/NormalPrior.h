@@ -26,6 +26,20 @@ public:
   int b0;
   int df;
 
+  // number of columns sampled together by sample_latent_block
+  // (0 or 1 = one column at a time)
+  int batch_size = 0;
+
+private:
+  // interleaved (one lane per column) precision matrices and rhs
+  // of the columns in a block, see chol_decomp_batch
+  smurff::thread_vector<Eigen::VectorXd> MMbs;
+  smurff::thread_vector<Eigen::VectorXd> rrbs;
+
+  // sample_latent specialized on num_latent, selected in init
+  template<int K> struct SampleLatentKernel;
+  void (*m_sample_latent)(NormalPrior &, int, const Eigen::VectorXd &, const Eigen::MatrixXd &) = nullptr;
+
 protected:
    NormalPrior()
       : ILatentPrior(){}
@@ -41,6 +55,13 @@ public:
   virtual const Eigen::VectorXd getMu(int n) const;
   
   void sample_latent(int n) override;
+  void sample_latent_from(int n, const Eigen::VectorXd &rr, const Eigen::MatrixXd &MM) override;
+  bool can_split_latent() const override { return true; }
+  void sample_latent_block(int from, int to) override;
+  int latent_block_size() const override;
+
+  void setBatchSize(int value) { batch_size = value; }
+  int getBatchSize() const { return batch_size; }
 
   void update_prior() override;
   std::ostream &status(std::ostream &os, std::string indent) const override;
@@ -78,7 +78,11 @@ std::shared_ptr<ILatentPrior> PriorFactory::create_prior(std::shared_ptr<Session
    {
    case PriorTypes::normal:
    case PriorTypes::default_prior:
-      return std::shared_ptr<NormalPrior>(new NormalPrior(session, -1));
+      {
+         std::shared_ptr<NormalPrior> prior(new NormalPrior(session, -1));
+         prior->setBatchSize(session->getConfig().getSampleBatch());
+         return prior;
+      }
    case PriorTypes::spikeandslab:
       return std::shared_ptr<SpikeAndSlabPrior>(new SpikeAndSlabPrior(session, -1));
    case PriorTypes::normalone:
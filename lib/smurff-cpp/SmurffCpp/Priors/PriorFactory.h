@@ -59,12 +59,16 @@ std::shared_ptr<ILatentPrior> PriorFactory::create_macau_prior(std::shared_ptr<S
       {
       case NoiseTypes::fixed:
          {
-            prior->addSideInfo(side_info, noise_config.getPrecision(), config_item->getTol(), config_item->getDirect(), false, config_item->getThrowOnCholeskyError());
+            prior->addSideInfo(side_info, noise_config.getPrecision(), config_item->getTol(), config_item->getDirect(), false, config_item->getThrowOnCholeskyError(),
+                               config_item->getMaxIter(), config_item->getWarmStart(), config_item->getPreconditioner(),
+                               config_item->getParallelBlocks());
          }
          break;
       case NoiseTypes::adaptive:
          {
-            prior->addSideInfo(side_info, noise_config.getPrecision(), config_item->getTol(), config_item->getDirect(), true, config_item->getThrowOnCholeskyError());
+            prior->addSideInfo(side_info, noise_config.getPrecision(), config_item->getTol(), config_item->getDirect(), true, config_item->getThrowOnCholeskyError(),
+                               config_item->getMaxIter(), config_item->getWarmStart(), config_item->getPreconditioner(),
+                               config_item->getParallelBlocks());
          }
          break;
       default:
@@ -89,7 +93,10 @@ std::shared_ptr<ILatentPrior> PriorFactory::create_macau_prior(std::shared_ptr<S
 
    for (auto& item : config_items)
    {
-      const auto &sideinfoConfig = item->getSideInfo();
+      // rows in the new ids when the session reorders the entities
+      std::shared_ptr<MatrixConfig> sideinfoConfig = item->getSideInfo();
+      if (session->getReordering())
+         sideinfoConfig = session->getReordering()->permuteRows(*sideinfoConfig, mode);
 
       if (sideinfoConfig->isBinary())
       {
@@ -24,8 +24,27 @@ void BaseSession::addPrior(std::shared_ptr<ILatentPrior> prior)
 
 bool BaseSession::step()
 {
-   for(auto &p : m_priors)
-      p->sample_latents();
+   if (m_pipeline_step)
+   {
+      // sampling the latents of a mode needs the U of all other modes,
+      // but not their hyper-parameters: run update_prior of the previous
+      // mode while sampling the current one
+      std::shared_ptr<ILatentPrior> prev;
+      for(auto &p : m_priors)
+      {
+         if (prev)
+            p->sample_latent_vectors([prev]() { prev->update_prior(); });
+         else
+            p->sample_latent_vectors();
+         prev = p;
+      }
+      prev->update_prior();
+   }
+   else
+   {
+      for(auto &p : m_priors)
+         p->sample_latents();
+   }
    data().update(model());
    return true;
 }
@@ -32,6 +32,9 @@ protected:
 protected:
    bool is_init = false;
 
+   // overlap update_prior of a mode with the sampling of the next mode
+   bool m_pipeline_step = false;
+
    //train data
    std::shared_ptr<Data> data_ptr;
 
@@ -15,6 +15,7 @@
 #include <SmurffCpp/Version.h>
 #include <SmurffCpp/IO/GenericIO.h>
 #include <SmurffCpp/IO/MatrixIO.h>
+#include <SmurffCpp/IO/TensorIO.h>
 
 #include <SmurffCpp/Utils/RootFile.h>
 #include <SmurffCpp/Utils/StringUtils.h>
@@ -28,6 +29,10 @@ static const char *BURNIN_NAME = "burnin";
 static const char *NSAMPLES_NAME = "nsamples";
 static const char *NUM_LATENT_NAME = "num-latent";
 static const char *NUM_THREADS_NAME = "num-threads";
+static const char *SAMPLE_BATCH_NAME = "sample-batch";
+static const char *PIPELINE_STEP_NAME = "pipeline-step";
+static const char *CSF_TENSOR_NAME = "csf-tensor";
+static const char *REORDER_NAME = "reorder";
 static const char *SAVE_PREFIX_NAME = "save-prefix";
 static const char *SAVE_EXTENSION_NAME = "save-extension";
 static const char *SAVE_FREQ_NAME = "save-freq";
@@ -64,6 +69,10 @@ po::options_description get_desc()
 	(BURNIN_NAME, po::value<int>()->default_value(Config::BURNIN_DEFAULT_VALUE), "number of samples to discard")
 	(NSAMPLES_NAME, po::value<int>()->default_value(Config::NSAMPLES_DEFAULT_VALUE), "number of samples to collect")
 	(NUM_LATENT_NAME, po::value<int>()->default_value(Config::NUM_LATENT_DEFAULT_VALUE), "number of latent dimensions")
+	(SAMPLE_BATCH_NAME, po::value<int>()->default_value(Config::SAMPLE_BATCH_DEFAULT_VALUE), "number of latent vectors sampled together by normal priors (0 = one at a time)")
+	(PIPELINE_STEP_NAME, po::value<bool>()->default_value(Config::PIPELINE_STEP_DEFAULT_VALUE), "update the hyper-parameters of a mode while sampling the next mode")
+	(CSF_TENSOR_NAME, po::value<bool>()->default_value(Config::CSF_TENSOR_DEFAULT_VALUE), "store train tensors as compressed sparse fiber trees")
+	(REORDER_NAME, po::value<std::string>()->default_value(reorderTypeToString(Config::REORDER_DEFAULT_VALUE)), "renumber the rows, columns, ... of the train data for memory locality; reorder-types: <none|degree|rcm>")
 	(THRESHOLD_NAME, po::value<double>()->default_value(Config::THRESHOLD_DEFAULT_VALUE), "threshold for binary classification and AUC calculation");
 
     po::options_description predict_desc("Used during prediction");
@@ -106,7 +115,16 @@ struct ConfigFiller
     {
         if (vm.count(name) && !vm[name].defaulted())
         {
-            auto tensor_config = generic_io::read_data_config(vm[name].as<std::string>(), true);
+            std::string filename = vm[name].as<std::string>();
+
+            // train data in a .sct file is read chunk by chunk when the
+            // data is created, without keeping all of it in the config
+            std::shared_ptr<TensorConfig> tensor_config;
+            if (name == TRAIN_NAME && tensor_io::is_chunked(filename))
+                tensor_config = tensor_io::read_tensor_header(filename, true);
+            else
+                tensor_config = generic_io::read_data_config(filename, true);
+
             tensor_config->setNoiseConfig(NoiseConfig(NoiseConfig::NOISE_TYPE_DEFAULT_VALUE));
             (this->config.*Func)(tensor_config); 
         }
@@ -158,6 +176,10 @@ fill_config(const po::variables_map &vm)
     filler.set<int,         &Config::setNSamples>(NSAMPLES_NAME);
     filler.set<int,         &Config::setNumLatent>(NUM_LATENT_NAME);
     filler.set<int,         &Config::setNumThreads>(NUM_THREADS_NAME);
+    filler.set<int,         &Config::setSampleBatch>(SAMPLE_BATCH_NAME);
+    filler.set<bool,        &Config::setPipelineStep>(PIPELINE_STEP_NAME);
+    filler.set<bool,        &Config::setCSFTensor>(CSF_TENSOR_NAME);
+    filler.set<std::string, &Config::setReorderType>(REORDER_NAME);
     filler.set<std::string, &Config::setSavePrefix>(SAVE_PREFIX_NAME);
     filler.set<std::string, &Config::setSaveExtension>(SAVE_EXTENSION_NAME);
     filler.set<int,         &Config::setSaveFreq>(SAVE_FREQ_NAME);
@@ -218,7 +240,7 @@ Config smurff::parse_options(int argc, char *argv[])
     }
 
     const std::vector<std::string> train_only_options = {
-        TRAIN_NAME, TEST_NAME, PRIOR_NAME, BURNIN_NAME, NSAMPLES_NAME, NUM_LATENT_NAME};
+        TRAIN_NAME, TEST_NAME, PRIOR_NAME, BURNIN_NAME, NSAMPLES_NAME, NUM_LATENT_NAME, SAMPLE_BATCH_NAME, PIPELINE_STEP_NAME, CSF_TENSOR_NAME, REORDER_NAME};
 
     //-- prediction only
     if (vm.count(PREDICT_NAME))
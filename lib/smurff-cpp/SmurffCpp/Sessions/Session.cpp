@@ -13,6 +13,7 @@
 #include <SmurffCpp/Utils/counters.h>
 #include <SmurffCpp/Utils/Error.h>
 #include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/IO/TensorIO.h>
 
 #include <SmurffCpp/DataMatrices/DataCreator.h>
 #include <SmurffCpp/Priors/PriorFactory.h>
@@ -82,15 +83,46 @@ void Session::setFromBase()
         m_pred->set(m_config.getTest(), m_config.getNSamples());
     }
 
+    // renumber the entities of every mode before anything is created
+    // from the train data and the side info
+
+    std::shared_ptr<TensorConfig> train = m_config.getTrain();
+
+    if (m_config.getReorderType() != ReorderTypes::none)
+    {
+        if (!train->hasData())
+        {
+            // only the header of the file was read (see tensor_io::read_tensor_header)
+            std::shared_ptr<TensorConfig> header = train;
+            train = tensor_io::read_tensor(header->getFilename(), header->isScarce());
+            train->setNoiseConfig(header->getNoiseConfig());
+            train->setPos(header->getPos());
+        }
+
+        m_reordering = std::make_shared<Reordering>(*train, m_config.getReorderType());
+        train = m_reordering->permute(*train);
+
+        m_model->setReordering(m_reordering);
+        m_pred->setReordering(m_reordering);
+    }
+
     // initialize data
 
-    data_ptr = m_config.getTrain()->create(std::make_shared<DataCreator>(this_session));
+    data_ptr = train->create(this->create_data_creator());
+    train.reset();
+
+    // the data has its own copy of the train values, keep the ones of the
+    // config only if they can not be read again from the file
+    if (!m_config.getTrain()->getFilename().empty())
+        m_config.getTrain()->releaseData();
 
     // initialize priors
 
     std::shared_ptr<IPriorFactory> priorFactory = this->create_prior_factory();
     for (std::size_t i = 0; i < m_config.getPriorTypes().size(); i++)
         this->addPrior(priorFactory->create_prior(this_session, i));
+
+    m_pipeline_step = m_config.getPipelineStep();
 }
 
 void Session::init()
@@ -124,6 +156,12 @@ void Session::init()
         printStatus(std::cout, resume);
     }
 
+    //memory once the data is loaded
+    if (m_config.getVerbose())
+    {
+        std::cout << "Memory: peak " << peak_rss() / 1024 / 1024 << " MB, resident " << current_rss() / 1024 / 1024 << " MB" << std::endl;
+    }
+
     is_init = true;
 }
 
@@ -396,6 +434,9 @@ void Session::printStatus(std::ostream &output, bool resume)
             model().status(output, "    ");
             output << "  Noise:" << std::endl;
             data().status(output, "    ");
+            output << "  Threads:" << std::endl;
+            for (const auto &p : m_priors)
+                p->scheduler_status(output, "     ");
         }
 
         if (m_config.getVerbose() > 2)
@@ -433,3 +474,8 @@ std::shared_ptr<IPriorFactory> Session::create_prior_factory() const
 {
     return std::make_shared<PriorFactory>();
 }
+
+std::shared_ptr<IDataCreator> Session::create_data_creator()
+{
+    return std::make_shared<DataCreator>(shared_from_this());
+}
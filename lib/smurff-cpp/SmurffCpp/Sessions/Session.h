@@ -7,7 +7,9 @@
 #include <SmurffCpp/Utils/Error.h>
 #include <SmurffCpp/Configs/Config.h>
 #include <SmurffCpp/Priors/IPriorFactory.h>
+#include <SmurffCpp/DataMatrices/IDataCreator.h>
 #include <SmurffCpp/Utils/RootFile.h>
+#include <SmurffCpp/Utils/Reordering.h>
 #include <SmurffCpp/StatusItem.h>
 
 namespace smurff {
@@ -25,6 +27,9 @@ private:
 protected:
    Config m_config;
 
+   // new ids of the entities of every mode, null when not reordered
+   std::shared_ptr<const Reordering> m_reordering;
+
 private:
    int m_iter = -1; //index of step iteration
    double m_secs_per_iter = .0; //time in seconds for last_iter
@@ -79,6 +84,8 @@ private:
 public:
    virtual std::shared_ptr<IPriorFactory> create_prior_factory() const;
 
+   virtual std::shared_ptr<IDataCreator> create_data_creator();
+
    std::shared_ptr<RootFile> getRootFile() const override
    {
        THROWERROR_ASSERT_MSG(m_rootFile, "No root file found. Did you save any models?");
@@ -90,6 +97,11 @@ public:
    {
       return m_config;
    }
+
+   std::shared_ptr<const Reordering> getReordering() const
+   {
+      return m_reordering;
+   }
 };
 
 }
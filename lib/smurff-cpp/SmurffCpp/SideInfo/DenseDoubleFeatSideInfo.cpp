@@ -50,6 +50,16 @@ int DenseDoubleFeatSideInfo::solve_blockcg(Eigen::MatrixXd& X, double reg, Eigen
    return smurff::linop::solve_blockcg(X, *m_side_info, reg, B, tol, blocksize, excess, throw_on_cholesky_error);
 }
 
+int DenseDoubleFeatSideInfo::solve_blockcg(Eigen::MatrixXd& X, double reg, Eigen::MatrixXd& B, double tol, const int blocksize, const int excess, const linop::BlockCGParams& params, double& residual)
+{
+   return smurff::linop::solve_blockcg(X, *m_side_info, reg, B, tol, blocksize, excess, params, residual);
+}
+
+std::shared_ptr<Preconditioner> DenseDoubleFeatSideInfo::create_preconditioner(PreconditionerTypes type)
+{
+   return Preconditioner::create(type, col_square_sum(), *m_side_info);
+}
+
 Eigen::VectorXd DenseDoubleFeatSideInfo::col_square_sum()
 {
    return smurff::linop::col_square_sum(*m_side_info);
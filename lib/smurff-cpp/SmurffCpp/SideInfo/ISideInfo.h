@@ -1,9 +1,12 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 
 #include <Eigen/Dense>
 
+#include <SmurffCpp/Utils/Preconditioner.h>
+
 namespace smurff {
 
    class ISideInfo
@@ -30,6 +33,11 @@ namespace smurff {
 
       virtual int solve_blockcg(Eigen::MatrixXd& X, double reg, Eigen::MatrixXd& B, double tol, const int blocksize, const int excess, bool throw_on_cholesky_error = false) = 0;
 
+      virtual int solve_blockcg(Eigen::MatrixXd& X, double reg, Eigen::MatrixXd& B, double tol, const int blocksize, const int excess, const linop::BlockCGParams& params, double& residual) = 0;
+
+      // empty for PreconditionerTypes::none
+      virtual std::shared_ptr<Preconditioner> create_preconditioner(PreconditionerTypes type) = 0;
+
       virtual Eigen::VectorXd col_square_sum() = 0;
 
       virtual void At_mul_Bt(Eigen::VectorXd& Y, const int col, Eigen::MatrixXd& B) = 0;
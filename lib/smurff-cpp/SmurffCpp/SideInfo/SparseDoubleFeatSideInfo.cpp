@@ -109,6 +109,17 @@ int SparseDoubleFeatSideInfo::solve_blockcg(Eigen::MatrixXd& X, double reg, Eige
     return smurff::linop::solve_blockcg(X, *this, reg, B, tol, blocksize, excess, throw_on_cholesky_error);
 }
 
+int SparseDoubleFeatSideInfo::solve_blockcg(Eigen::MatrixXd& X, double reg, Eigen::MatrixXd& B, double tol, const int blocksize, const int excess, const linop::BlockCGParams& params, double& residual)
+{
+    COUNTER("solve_blockcg");
+    return smurff::linop::solve_blockcg(X, *this, reg, B, tol, blocksize, excess, params, residual);
+}
+
+std::shared_ptr<Preconditioner> SparseDoubleFeatSideInfo::create_preconditioner(PreconditionerTypes type)
+{
+    return Preconditioner::create(type, col_square_sum(), *matrix_col_major_ptr);
+}
+
 Eigen::VectorXd SparseDoubleFeatSideInfo::col_square_sum()
 {
     COUNTER("col_square_sum");
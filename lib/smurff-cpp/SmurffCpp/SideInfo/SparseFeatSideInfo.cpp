@@ -1,6 +1,7 @@
 #include "SparseFeatSideInfo.h"
 
 #include <SmurffCpp/Utils/linop.h>
+#include <SmurffCpp/Utils/MatrixUtils.h>
 
 using namespace smurff;
 
@@ -52,6 +53,19 @@ int SparseFeatSideInfo::solve_blockcg(Eigen::MatrixXd& X, double reg, Eigen::Mat
    return smurff::linop::solve_blockcg(X, *m_side_info, reg, B, tol, blocksize, excess, throw_on_cholesky_error);
 }
 
+int SparseFeatSideInfo::solve_blockcg(Eigen::MatrixXd& X, double reg, Eigen::MatrixXd& B, double tol, const int blocksize, const int excess, const linop::BlockCGParams& params, double& residual)
+{
+   return smurff::linop::solve_blockcg(X, *m_side_info, reg, B, tol, blocksize, excess, params, residual);
+}
+
+std::shared_ptr<Preconditioner> SparseFeatSideInfo::create_preconditioner(PreconditionerTypes type)
+{
+   if (type == PreconditionerTypes::none)
+      return std::shared_ptr<Preconditioner>();
+
+   return Preconditioner::create(type, col_square_sum(), matrix_utils::bcsr_to_eigen(m_side_info->M));
+}
+
 Eigen::VectorXd SparseFeatSideInfo::col_square_sum()
 {
    return smurff::linop::col_square_sum(*m_side_info);
@@ -37,6 +37,10 @@ public:
 
    int solve_blockcg(Eigen::MatrixXd& X, double reg, Eigen::MatrixXd& B, double tol, const int blocksize, const int excess, bool throw_on_cholesky_error = false) override;
 
+   int solve_blockcg(Eigen::MatrixXd& X, double reg, Eigen::MatrixXd& B, double tol, const int blocksize, const int excess, const linop::BlockCGParams& params, double& residual) override;
+
+   std::shared_ptr<Preconditioner> create_preconditioner(PreconditionerTypes type) override;
+
    Eigen::VectorXd col_square_sum() override;
 
    void At_mul_Bt(Eigen::VectorXd& Y, const int col, Eigen::MatrixXd& B) override;
@@ -0,0 +1,90 @@
+#include "LatentScheduler.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "counters.h"
+#include "omp_util.h"
+
+using namespace smurff;
+
+const int LatentScheduler::CHUNKS_PER_THREAD = 8;
+
+void LatentScheduler::init(const std::vector<std::uint64_t>& nnz, double sample_cost, int nthreads, bool split, int first)
+{
+   m_chunks.clear();
+   m_heavy.clear();
+   m_heavy_begin.clear();
+   m_parts.clear();
+
+   const int ncols = nnz.size();
+   const double total = std::accumulate(nnz.begin(), nnz.end(), 0.0) + sample_cost * ncols;
+   const double target = std::max(sample_cost, total / (std::max(1, nthreads) * CHUNKS_PER_THREAD));
+
+   // only worth splitting when another thread can work on the other parts
+   split = split && nthreads > 1;
+
+   int from = 0;
+   double cost = 0.0;
+   for (int n = 0; n < ncols; ++n)
+   {
+      if (split && nnz[n] > target)
+      {
+         if (from < n)
+            m_chunks.push_back({first + from, first + n});
+
+         m_heavy_begin.push_back(m_parts.size());
+         const std::uint64_t part_size = target;
+         for (std::uint64_t i = 0; i < nnz[n]; i += part_size)
+            m_parts.push_back({(int)m_heavy.size(), i, std::min(i + part_size, nnz[n])});
+         m_heavy.push_back(first + n);
+
+         from = n + 1;
+         cost = 0.0;
+         continue;
+      }
+
+      cost += nnz[n] + sample_cost;
+      if (cost >= target)
+      {
+         m_chunks.push_back({first + from, first + n + 1});
+         from = n + 1;
+         cost = 0.0;
+      }
+   }
+
+   if (from < ncols)
+      m_chunks.push_back({first + from, first + ncols});
+
+   m_heavy_begin.push_back(m_parts.size());
+
+   m_busy.assign(threads::get_max_threads(), 0.0);
+}
+
+void LatentScheduler::start()
+{
+   std::fill(m_busy.begin(), m_busy.end(), 0.0);
+   m_start = tick();
+}
+
+void LatentScheduler::add_busy(double seconds)
+{
+   m_busy.at(threads::get_thread_num()) += seconds;
+}
+
+void LatentScheduler::stop()
+{
+   m_wall = tick() - m_start;
+}
+
+std::ostream& LatentScheduler::status(std::ostream& os, std::string indent) const
+{
+   os << indent << m_chunks.size() << " chunks, " << m_heavy.size() << " split columns in " << m_parts.size() << " parts" << std::endl;
+   os << indent << "Busy/idle per thread:";
+   for (std::size_t t = 0; t < m_busy.size(); ++t)
+   {
+      os << " " << m_busy[t] << "/" << std::max(0.0, m_wall - m_busy[t]);
+   }
+   os << " sec" << std::endl;
+   return os;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace smurff
+{
+   // Distributes the columns of one mode over the threads in
+   // ILatentPrior::sample_latents.
+   //
+   // The cost of a column is the number of items contributing to its rr and MM
+   // (Data::col_nnz) plus a constant for sampling the latent vector itself.
+   // Light columns are grouped into contiguous chunks of roughly equal cost.
+   // Heavy columns (more items than a chunk) are split into parts, each part
+   // computing a partial rr and MM over a range of items. The parts of
+   // a heavy column are summed before the column is sampled.
+   class LatentScheduler
+   {
+   public:
+      // columns [from, to)
+      struct Chunk
+      {
+         int from;
+         int to;
+      };
+
+      // items [from, to) of heavy column heavy()[heavy]
+      struct Part
+      {
+         int heavy;
+         std::uint64_t from;
+         std::uint64_t to;
+      };
+
+   public:
+      // number of chunks per thread: more chunks = better balance, more overhead
+      static const int CHUNKS_PER_THREAD;
+
+      // cost of sampling one latent vector of num_latent, relative to one item
+      static double sample_cost(int num_latent) { return num_latent / 3.0 + 1.0; }
+
+      // nnz[i] is the number of items of column first + i
+      void init(const std::vector<std::uint64_t>& nnz, double sample_cost, int nthreads, bool split, int first = 0);
+
+      const std::vector<Chunk>& chunks() const { return m_chunks; }
+      const std::vector<int>& heavy() const { return m_heavy; }
+      const std::vector<Part>& parts() const { return m_parts; }
+
+      // parts of heavy column h are parts()[heavy_begin(h) .. heavy_begin(h+1))
+      int heavy_begin(int h) const { return m_heavy_begin.at(h); }
+
+   public:
+      // busy time per thread in the last start() .. stop() interval
+      void start();
+      void add_busy(double seconds);
+      void stop();
+
+      std::ostream& status(std::ostream& os, std::string indent) const;
+
+   private:
+      std::vector<Chunk> m_chunks;
+      std::vector<int> m_heavy;
+      std::vector<int> m_heavy_begin;
+      std::vector<Part> m_parts;
+
+      std::vector<double> m_busy;
+      double m_start = 0.0;
+      double m_wall = 0.0;
+   };
+}
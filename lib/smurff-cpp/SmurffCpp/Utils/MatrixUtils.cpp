@@ -106,6 +106,19 @@ smurff::matrix_utils::sparse_eigen_struct smurff::matrix_utils::csr_to_eigen(con
     return {row_major, col_major, transposed_sparse};
 }
 
+Eigen::SparseMatrix<double> smurff::matrix_utils::bcsr_to_eigen(const BinaryCSR& bcsr) {
+    std::vector<Eigen::Triplet<double>> triplet_list;
+    triplet_list.reserve(bcsr.nnz);
+    for (int row = 0; row < bcsr.nrow; row++) {
+        for (int i = bcsr.row_ptr[row]; i < bcsr.row_ptr[row + 1]; i++) {
+            triplet_list.push_back(Eigen::Triplet<double>(row, bcsr.cols[i], 1.0));
+        }
+    }
+    Eigen::SparseMatrix<double> out(bcsr.nrow, bcsr.ncol);
+    out.setFromTriplets(triplet_list.begin(), triplet_list.end());
+    return out;
+}
+
 std::ostream& smurff::matrix_utils::operator << (std::ostream& os, const MatrixConfig& mc)
 {
    const std::vector<std::uint32_t>& rows = mc.getRows();
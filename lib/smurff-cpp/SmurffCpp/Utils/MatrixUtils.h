@@ -36,6 +36,8 @@ namespace smurff { namespace matrix_utils {
 
    sparse_eigen_struct csr_to_eigen(const CSR& csr);
 
+   Eigen::SparseMatrix<double> bcsr_to_eigen(const BinaryCSR& bcsr);
+
    std::ostream& operator << (std::ostream& os, const MatrixConfig& mc);
 
    bool equals(const Eigen::MatrixXd& m1, const Eigen::MatrixXd& m2, double precision = std::numeric_limits<double>::epsilon());
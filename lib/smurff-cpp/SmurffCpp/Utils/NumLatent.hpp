@@ -0,0 +1,65 @@
+#pragma once
+
+#include <utility>
+
+#include <Eigen/Core>
+
+namespace smurff
+{
+   // The Gibbs hot path (sampling a latent vector, accumulating rr and MM,
+   // predicting a single cell) is instantiated with fixed-size Eigen types
+   // for these values of num_latent. Any other num_latent uses the
+   // Eigen::Dynamic instantiation of the same kernel.
+   //
+   // A kernel is a class template over the number of latents with a static
+   // run() function, for example:
+   //
+   //    template<int K> struct Kernel { static double run(const Model &, int); };
+   //
+   // Inside run() the latent vectors are accessed through
+   // Eigen::Map<Eigen::Matrix<double, K, 1> >(ptr, num_latent), which is
+   // valid for both the fixed and the dynamic instantiation.
+
+   inline bool is_fixed_num_latent(int num_latent)
+   {
+      switch (num_latent)
+      {
+         case 8:
+         case 16:
+         case 32:
+         case 64:
+            return true;
+         default:
+            return false;
+      }
+   }
+
+   // returns a pointer to the instantiation of Kernel<>::run for num_latent
+   // to be stored at initialization and called in the hot loop
+   template<template<int> class Kernel>
+   auto select_num_latent(int num_latent) -> decltype(&Kernel<Eigen::Dynamic>::run)
+   {
+      switch (num_latent)
+      {
+         case 8:  return &Kernel<8>::run;
+         case 16: return &Kernel<16>::run;
+         case 32: return &Kernel<32>::run;
+         case 64: return &Kernel<64>::run;
+         default: return &Kernel<Eigen::Dynamic>::run;
+      }
+   }
+
+   // calls the instantiation of Kernel<>::run for num_latent
+   template<template<int> class Kernel, typename... Args>
+   auto dispatch_num_latent(int num_latent, Args&&... args) -> decltype(Kernel<Eigen::Dynamic>::run(std::forward<Args>(args)...))
+   {
+      switch (num_latent)
+      {
+         case 8:  return Kernel<8>::run(std::forward<Args>(args)...);
+         case 16: return Kernel<16>::run(std::forward<Args>(args)...);
+         case 32: return Kernel<32>::run(std::forward<Args>(args)...);
+         case 64: return Kernel<64>::run(std::forward<Args>(args)...);
+         default: return Kernel<Eigen::Dynamic>::run(std::forward<Args>(args)...);
+      }
+   }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include <SmurffCpp/Utils/Error.h>
+#include <SmurffCpp/Utils/NumLatent.hpp>
+#include <SmurffCpp/Utils/PVec.hpp>
+
+namespace smurff
+{
+   // The kernels that loop over the modes of one item (predicting a cell,
+   // accumulating rr and MM of a tensor) are instantiated for every tensor
+   // order in [MIN_NUM_MODES, MAX_NUM_MODES], so the loop over the modes is
+   // unrolled and the coordinates of an item fit in a PVec<> on the stack.
+   //
+   // A kernel is a class template over the number of latents and the number
+   // of modes with a static run() function, for example:
+   //
+   //    template<int K, int N> struct Kernel { static double run(const Model &, const PVec<> &); };
+
+   constexpr int MIN_NUM_MODES = 2;
+   constexpr int MAX_NUM_MODES = 6;
+
+   static_assert(PVec<>::max_size() >= MAX_NUM_MODES, "PVec<> cannot hold the coordinates of MAX_NUM_MODES modes");
+
+   inline bool is_supported_num_modes(int nmodes)
+   {
+      return MIN_NUM_MODES <= nmodes && nmodes <= MAX_NUM_MODES;
+   }
+
+   // returns a pointer to the instantiation of Kernel<>::run for nmodes
+   template<template<int> class Kernel>
+   auto select_num_modes(int nmodes) -> decltype(&Kernel<MIN_NUM_MODES>::run)
+   {
+      switch (nmodes)
+      {
+         case 2: return &Kernel<2>::run;
+         case 3: return &Kernel<3>::run;
+         case 4: return &Kernel<4>::run;
+         case 5: return &Kernel<5>::run;
+         case 6: return &Kernel<6>::run;
+         default: THROWERROR("Unsupported number of modes: " + std::to_string(nmodes));
+      }
+   }
+
+   // calls the instantiation of Kernel<>::run for nmodes
+   template<template<int> class Kernel, typename... Args>
+   auto dispatch_num_modes(int nmodes, Args&&... args) -> decltype(Kernel<MIN_NUM_MODES>::run(std::forward<Args>(args)...))
+   {
+      switch (nmodes)
+      {
+         case 2: return Kernel<2>::run(std::forward<Args>(args)...);
+         case 3: return Kernel<3>::run(std::forward<Args>(args)...);
+         case 4: return Kernel<4>::run(std::forward<Args>(args)...);
+         case 5: return Kernel<5>::run(std::forward<Args>(args)...);
+         case 6: return Kernel<6>::run(std::forward<Args>(args)...);
+         default: THROWERROR("Unsupported number of modes: " + std::to_string(nmodes));
+      }
+   }
+
+   namespace detail
+   {
+      // Kernel<K, N> as a template over N only
+      template<template<int, int> class Kernel, int K>
+      struct BindNumLatent
+      {
+         template<int N> using type = Kernel<K, N>;
+      };
+
+      template<template<int, int> class Kernel>
+      struct SelectNumModes
+      {
+         template<int K> struct type
+         {
+            static auto run(int nmodes) -> decltype(&Kernel<K, MIN_NUM_MODES>::run)
+            {
+               return select_num_modes<BindNumLatent<Kernel, K>::template type>(nmodes);
+            }
+         };
+      };
+
+      template<template<int, int> class Kernel>
+      struct DispatchNumModes
+      {
+         template<int K> struct type
+         {
+            template<typename... Args>
+            static auto run(int nmodes, Args&&... args) -> decltype(Kernel<K, MIN_NUM_MODES>::run(std::forward<Args>(args)...))
+            {
+               return dispatch_num_modes<BindNumLatent<Kernel, K>::template type>(nmodes, std::forward<Args>(args)...);
+            }
+         };
+      };
+   }
+
+   // select_num_latent and select_num_modes combined
+   template<template<int, int> class Kernel>
+   auto select_num_latent_modes(int num_latent, int nmodes) -> decltype(&Kernel<Eigen::Dynamic, MIN_NUM_MODES>::run)
+   {
+      return dispatch_num_latent<detail::SelectNumModes<Kernel>::template type>(num_latent, nmodes);
+   }
+
+   // dispatch_num_latent and dispatch_num_modes combined
+   template<template<int, int> class Kernel, typename... Args>
+   auto dispatch_num_latent_modes(int num_latent, int nmodes, Args&&... args) -> decltype(Kernel<Eigen::Dynamic, MIN_NUM_MODES>::run(std::forward<Args>(args)...))
+   {
+      return dispatch_num_latent<detail::DispatchNumModes<Kernel>::template type>(num_latent, nmodes, std::forward<Args>(args)...);
+   }
+}
@@ -12,7 +12,8 @@
 
 namespace smurff
 {
-   template<size_t MaxSize = 3>
+   // the default MaxSize is the highest tensor order (MAX_NUM_MODES in NumModes.hpp)
+   template<size_t MaxSize = 6>
    class PVec
    {
    private:
@@ -73,6 +74,11 @@ namespace smurff
 
    public:
       // meta info
+      static constexpr size_t max_size()
+      {
+         return MaxSize;
+      }
+
       size_t size() const
       {
          return m_size;
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Eigen/Core>
+
+namespace smurff
+{
+   // getMuLambda of the sparse data gathers the columns of V of the items of
+   // a hyperplane in a panel, and updates MM with one rank-b update (syrk)
+   // of the panel instead of one rank-1 update per item
+
+   // size of the panel, about the L1 data cache
+   constexpr int PANEL_BYTES = 32 * 1024;
+
+   // items of a hyperplane below which getMuLambda does not use a panel
+   constexpr int PANEL_MIN_ITEMS = 16;
+
+   // bounds of the panel width
+   constexpr int PANEL_MIN_WIDTH = 8;
+   constexpr int PANEL_MAX_WIDTH = 256;
+
+   // columns of V gathered per rank-b update of MM, so that the panel
+   // (K x b doubles) stays in L1 while MM is updated
+   constexpr int panel_width(int num_latent)
+   {
+      return PANEL_BYTES / (int)sizeof(double) / num_latent < PANEL_MIN_WIDTH ? PANEL_MIN_WIDTH
+           : PANEL_BYTES / (int)sizeof(double) / num_latent > PANEL_MAX_WIDTH ? PANEL_MAX_WIDTH
+           : PANEL_BYTES / (int)sizeof(double) / num_latent;
+   }
+
+   // maximum columns of the panel of a kernel instantiated for K latents,
+   // so that it is on the stack for fixed K
+   constexpr int panel_max_cols(int K)
+   {
+      return K == Eigen::Dynamic ? Eigen::Dynamic : panel_width(K);
+   }
+}
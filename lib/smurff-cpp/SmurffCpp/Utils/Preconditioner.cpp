@@ -0,0 +1,207 @@
+#include "Preconditioner.h"
+
+#include <algorithm>
+#include <exception>
+
+#include <SmurffCpp/Utils/Error.h>
+#include <SmurffCpp/Utils/counters.h>
+
+using namespace smurff;
+
+int Preconditioner::BLOCK_SIZE = 64;
+
+PreconditionerTypes smurff::stringToPreconditionerType(std::string name)
+{
+   if(name == PRECONDITIONER_NAME_NONE)
+      return PreconditionerTypes::none;
+   else if(name == PRECONDITIONER_NAME_JACOBI)
+      return PreconditionerTypes::jacobi;
+   else if(name == PRECONDITIONER_NAME_BLOCK_JACOBI)
+      return PreconditionerTypes::block_jacobi;
+   else if(name == PRECONDITIONER_NAME_ICHOL)
+      return PreconditionerTypes::ichol;
+   else
+   {
+      THROWERROR("Invalid preconditioner type " + name);
+   }
+}
+
+std::string smurff::preconditionerTypeToString(PreconditionerTypes type)
+{
+   switch(type)
+   {
+      case PreconditionerTypes::none:
+         return PRECONDITIONER_NAME_NONE;
+      case PreconditionerTypes::jacobi:
+         return PRECONDITIONER_NAME_JACOBI;
+      case PreconditionerTypes::block_jacobi:
+         return PRECONDITIONER_NAME_BLOCK_JACOBI;
+      case PreconditionerTypes::ichol:
+         return PRECONDITIONER_NAME_ICHOL;
+      default:
+      {
+         THROWERROR("Invalid preconditioner type");
+      }
+   }
+}
+
+template<typename Features>
+static std::shared_ptr<Preconditioner> create_preconditioner(PreconditionerTypes type, const Eigen::VectorXd& col_square_sum, const Features& F)
+{
+   switch(type)
+   {
+      case PreconditionerTypes::none:
+         return std::shared_ptr<Preconditioner>();
+      case PreconditionerTypes::jacobi:
+         return std::make_shared<JacobiPreconditioner>(col_square_sum);
+      case PreconditionerTypes::block_jacobi:
+         return std::make_shared<BlockJacobiPreconditioner>(F);
+      case PreconditionerTypes::ichol:
+         return std::make_shared<ICholPreconditioner>(F);
+      default:
+      {
+         THROWERROR("Invalid preconditioner type");
+      }
+   }
+}
+
+std::shared_ptr<Preconditioner> Preconditioner::create(PreconditionerTypes type, const Eigen::VectorXd& col_square_sum, const Eigen::SparseMatrix<double>& F)
+{
+   return create_preconditioner(type, col_square_sum, F);
+}
+
+std::shared_ptr<Preconditioner> Preconditioner::create(PreconditionerTypes type, const Eigen::VectorXd& col_square_sum, const Eigen::MatrixXd& F)
+{
+   return create_preconditioner(type, col_square_sum, F);
+}
+
+void Preconditioner::update(double reg)
+{
+   if (reg == m_reg)
+      return;
+
+   COUNTER("preconditioner_factorize");
+   factorize(reg);
+   m_reg = reg;
+}
+
+// ------------ Jacobi ------------
+
+JacobiPreconditioner::JacobiPreconditioner(const Eigen::VectorXd& col_square_sum)
+   : m_diag(col_square_sum)
+{
+}
+
+void JacobiPreconditioner::factorize(double reg)
+{
+   m_inv_diag = (m_diag.array() + reg).inverse();
+}
+
+void JacobiPreconditioner::apply(Eigen::MatrixXd& Z, const Eigen::MatrixXd& R) const
+{
+   Z.resize(R.rows(), R.cols());
+
+   #pragma omp parallel for schedule(static)
+   for (int feat = 0; feat < R.cols(); feat++)
+   {
+      Z.col(feat) = R.col(feat) * m_inv_diag(feat);
+   }
+}
+
+// ------------ block-Jacobi ------------
+
+BlockJacobiPreconditioner::BlockJacobiPreconditioner(const Eigen::SparseMatrix<double>& F)
+   : m_blocks((F.cols() + BLOCK_SIZE - 1) / BLOCK_SIZE)
+{
+   #pragma omp parallel for schedule(dynamic, 1)
+   for (int block = 0; block < (int)m_blocks.size(); block++)
+   {
+      const int col = block * BLOCK_SIZE;
+      const int bcols = std::min(BLOCK_SIZE, (int)F.cols() - col);
+      Eigen::SparseMatrix<double> Fb = F.middleCols(col, bcols);
+      m_blocks[block] = Eigen::MatrixXd(Fb.transpose() * Fb);
+   }
+}
+
+BlockJacobiPreconditioner::BlockJacobiPreconditioner(const Eigen::MatrixXd& F)
+   : m_blocks((F.cols() + BLOCK_SIZE - 1) / BLOCK_SIZE)
+{
+   #pragma omp parallel for schedule(dynamic, 1)
+   for (int block = 0; block < (int)m_blocks.size(); block++)
+   {
+      const int col = block * BLOCK_SIZE;
+      const int bcols = std::min(BLOCK_SIZE, (int)F.cols() - col);
+      m_blocks[block].noalias() = F.middleCols(col, bcols).transpose() * F.middleCols(col, bcols);
+   }
+}
+
+void BlockJacobiPreconditioner::factorize(double reg)
+{
+   m_chol.resize(m_blocks.size());
+
+   // an exception must not leave the parallel region, keep the first one
+   std::exception_ptr error;
+
+   #pragma omp parallel for schedule(dynamic, 1)
+   for (int block = 0; block < (int)m_blocks.size(); block++)
+   {
+      try
+      {
+         Eigen::MatrixXd A = m_blocks[block];
+         A.diagonal().array() += reg;
+         m_chol[block].compute(A);
+         THROWERROR_ASSERT_MSG(m_chol[block].info() == Eigen::Success, "Cholesky Decomposition of block-Jacobi preconditioner failed");
+      }
+      catch (...)
+      {
+         #pragma omp critical
+         if (!error)
+            error = std::current_exception();
+      }
+   }
+
+   if (error)
+      std::rethrow_exception(error);
+}
+
+void BlockJacobiPreconditioner::apply(Eigen::MatrixXd& Z, const Eigen::MatrixXd& R) const
+{
+   Z.resize(R.rows(), R.cols());
+
+   #pragma omp parallel for schedule(static)
+   for (int block = 0; block < (int)m_chol.size(); block++)
+   {
+      const int col = block * BLOCK_SIZE;
+      const int bcols = m_blocks[block].cols();
+      Z.middleCols(col, bcols) = m_chol[block].solve(R.middleCols(col, bcols).transpose()).transpose();
+   }
+}
+
+// ------------ incomplete Cholesky ------------
+
+ICholPreconditioner::ICholPreconditioner(const Eigen::SparseMatrix<double>& F)
+{
+   m_FtF = (F.transpose() * F).pruned();
+}
+
+ICholPreconditioner::ICholPreconditioner(const Eigen::MatrixXd& F)
+{
+   Eigen::MatrixXd FtF = F.transpose() * F;
+   m_FtF = FtF.sparseView();
+}
+
+void ICholPreconditioner::factorize(double reg)
+{
+   Eigen::SparseMatrix<double> I(m_FtF.rows(), m_FtF.cols());
+   I.setIdentity();
+   Eigen::SparseMatrix<double> A = m_FtF + reg * I;
+
+   m_ichol.compute(A);
+   THROWERROR_ASSERT_MSG(m_ichol.info() == Eigen::Success, "Incomplete Cholesky factorization of preconditioner failed");
+}
+
+void ICholPreconditioner::apply(Eigen::MatrixXd& Z, const Eigen::MatrixXd& R) const
+{
+   Eigen::MatrixXd Zt = m_ichol.solve(R.transpose());
+   Z = Zt.transpose();
+}
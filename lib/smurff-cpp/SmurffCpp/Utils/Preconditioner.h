@@ -0,0 +1,140 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/IterativeLinearSolvers>
+
+#define PRECONDITIONER_NAME_NONE "none"
+#define PRECONDITIONER_NAME_JACOBI "jacobi"
+#define PRECONDITIONER_NAME_BLOCK_JACOBI "block-jacobi"
+#define PRECONDITIONER_NAME_ICHOL "ichol"
+
+namespace smurff
+{
+   enum class PreconditionerTypes
+   {
+      none,
+      jacobi,
+      block_jacobi,
+      ichol
+   };
+
+   PreconditionerTypes stringToPreconditionerType(std::string name);
+
+   std::string preconditionerTypeToString(PreconditionerTypes type);
+
+   // Approximate inverse M^-1 of F'F + reg * I, where F are the side features,
+   // used by the preconditioned linop::solve_blockcg.
+   //
+   // The part that depends on F is computed once at construction,
+   // the part that depends on reg in update(), which is cheap to call
+   // every iteration because it only refactorizes when reg changed.
+   class Preconditioner
+   {
+   public:
+      // width of the diagonal blocks of the block-Jacobi preconditioner
+      static int BLOCK_SIZE;
+
+      static std::shared_ptr<Preconditioner> create(PreconditionerTypes type, const Eigen::VectorXd& col_square_sum, const Eigen::SparseMatrix<double>& F);
+      static std::shared_ptr<Preconditioner> create(PreconditionerTypes type, const Eigen::VectorXd& col_square_sum, const Eigen::MatrixXd& F);
+
+   public:
+      virtual ~Preconditioner() {}
+
+      void update(double reg);
+
+      // Z = R * M^-1, the rows of R are the residuals of the right-hand sides
+      virtual void apply(Eigen::MatrixXd& Z, const Eigen::MatrixXd& R) const = 0;
+
+      virtual PreconditionerTypes type() const = 0;
+
+   protected:
+      virtual void factorize(double reg) = 0;
+
+   private:
+      double m_reg = std::numeric_limits<double>::quiet_NaN();
+   };
+
+   // M = diag(F'F) + reg * I
+   class JacobiPreconditioner : public Preconditioner
+   {
+   public:
+      JacobiPreconditioner(const Eigen::VectorXd& col_square_sum);
+
+      void apply(Eigen::MatrixXd& Z, const Eigen::MatrixXd& R) const override;
+
+      PreconditionerTypes type() const override { return PreconditionerTypes::jacobi; }
+
+   protected:
+      void factorize(double reg) override;
+
+   private:
+      Eigen::VectorXd m_diag;
+      Eigen::VectorXd m_inv_diag;
+   };
+
+   // M = block diagonal of F'F + reg * I, with blocks of BLOCK_SIZE features
+   class BlockJacobiPreconditioner : public Preconditioner
+   {
+   public:
+      BlockJacobiPreconditioner(const Eigen::SparseMatrix<double>& F);
+      BlockJacobiPreconditioner(const Eigen::MatrixXd& F);
+
+      void apply(Eigen::MatrixXd& Z, const Eigen::MatrixXd& R) const override;
+
+      PreconditionerTypes type() const override { return PreconditionerTypes::block_jacobi; }
+
+   protected:
+      void factorize(double reg) override;
+
+   private:
+      std::vector<Eigen::MatrixXd> m_blocks;
+      std::vector<Eigen::LLT<Eigen::MatrixXd> > m_chol;
+   };
+
+   // M = L * L', the incomplete Cholesky factorization of F'F + reg * I
+   class ICholPreconditioner : public Preconditioner
+   {
+   public:
+      ICholPreconditioner(const Eigen::SparseMatrix<double>& F);
+      ICholPreconditioner(const Eigen::MatrixXd& F);
+
+      void apply(Eigen::MatrixXd& Z, const Eigen::MatrixXd& R) const override;
+
+      PreconditionerTypes type() const override { return PreconditionerTypes::ichol; }
+
+   protected:
+      void factorize(double reg) override;
+
+   private:
+      Eigen::SparseMatrix<double> m_FtF;
+      Eigen::IncompleteCholesky<double, Eigen::Lower, Eigen::AMDOrdering<int> > m_ichol;
+   };
+
+   namespace linop
+   {
+      // optional settings of solve_blockcg
+      struct BlockCGParams
+      {
+         // maximum number of CG iterations
+         int max_iter = 10;
+
+         // start from the X passed in instead of from zero
+         bool warm_start = false;
+
+         // no preconditioning when empty
+         std::shared_ptr<Preconditioner> preconditioner;
+
+         bool throw_on_cholesky_error = false;
+
+         // solve the blocks of right-hand sides in parallel, one block per
+         // thread, instead of one after the other with all threads
+         bool parallel_blocks = false;
+      };
+   }
+}
@@ -0,0 +1,314 @@
+#include "Reordering.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <SmurffCpp/Utils/Error.h>
+
+using namespace smurff;
+
+ReorderTypes smurff::stringToReorderType(std::string name)
+{
+   if(name == REORDER_NAME_NONE)
+      return ReorderTypes::none;
+   else if(name == REORDER_NAME_DEGREE)
+      return ReorderTypes::degree;
+   else if(name == REORDER_NAME_RCM)
+      return ReorderTypes::rcm;
+   else
+   {
+      THROWERROR("Invalid reorder type " + name);
+   }
+}
+
+std::string smurff::reorderTypeToString(ReorderTypes type)
+{
+   switch(type)
+   {
+      case ReorderTypes::none:
+         return REORDER_NAME_NONE;
+      case ReorderTypes::degree:
+         return REORDER_NAME_DEGREE;
+      case ReorderTypes::rcm:
+         return REORDER_NAME_RCM;
+      default:
+      {
+         THROWERROR("Invalid reorder type");
+      }
+   }
+}
+
+// number of items of every entity of mode
+static std::vector<std::uint64_t> degrees(const TensorConfig& train, std::uint64_t mode)
+{
+   const std::uint64_t nnz = train.getNNZ();
+   const std::uint64_t dim = train.getDims()[mode];
+   const std::uint32_t* coords = train.getColumns().data() + mode * nnz;
+
+   std::vector<std::uint64_t> degree(dim, 0);
+   for (std::uint64_t i = 0; i < nnz; i++)
+   {
+      if (coords[i] >= dim)
+      {
+         THROWERROR("Coordinate larger than the dimension of mode " + std::to_string(mode));
+      }
+
+      degree[coords[i]]++;
+   }
+
+   return degree;
+}
+
+Reordering::Reordering(const TensorConfig& train, ReorderTypes type)
+   : m_original(train.getNModes()), m_new(train.getNModes())
+{
+   if (train.isDense())
+   {
+      THROWERROR("Reordering needs sparse train data");
+   }
+
+   THROWERROR_ASSERT_MSG(train.hasData(), "Reordering needs the train data in memory");
+
+   switch (type)
+   {
+   case ReorderTypes::none:
+      for (std::uint64_t m = 0; m < getNModes(); m++)
+      {
+         m_original[m].resize(train.getDims()[m]);
+         std::iota(m_original[m].begin(), m_original[m].end(), 0);
+      }
+      break;
+   case ReorderTypes::degree:
+      degreeOrder(train);
+      break;
+   case ReorderTypes::rcm:
+      rcmOrder(train);
+      break;
+   default:
+      {
+         THROWERROR("Invalid reorder type");
+      }
+   }
+
+   for (std::uint64_t m = 0; m < getNModes(); m++)
+   {
+      m_new[m].resize(m_original[m].size());
+      for (std::uint64_t i = 0; i < m_original[m].size(); i++)
+         m_new[m][m_original[m][i]] = i;
+   }
+}
+
+// entities with the most items first, so that the latent vectors that are
+// read most often share cache lines and pages
+void Reordering::degreeOrder(const TensorConfig& train)
+{
+   for (std::uint64_t m = 0; m < getNModes(); m++)
+   {
+      const std::vector<std::uint64_t> degree = degrees(train, m);
+
+      m_original[m].resize(degree.size());
+      std::iota(m_original[m].begin(), m_original[m].end(), 0);
+      std::stable_sort(m_original[m].begin(), m_original[m].end(),
+         [&degree](std::uint32_t a, std::uint32_t b) { return degree[a] > degree[b]; });
+   }
+}
+
+// reverse Cuthill-McKee on the graph of which the nodes are the entities of
+// all modes, and the entities of an item are each other's neighbours: a
+// breadth-first walk from a node of lowest degree, visiting the neighbours
+// of a node by increasing degree, gives entities that share items nearby
+// ids in every mode
+void Reordering::rcmOrder(const TensorConfig& train)
+{
+   const std::uint64_t nmodes = getNModes();
+   const std::uint64_t nnz = train.getNNZ();
+   const std::vector<std::uint64_t>& dims = train.getDims();
+   const std::uint32_t* columns = train.getColumns().data();
+
+   // node of entity id of mode m is offset[m] + id
+   std::vector<std::uint64_t> offset(nmodes + 1, 0);
+   for (std::uint64_t m = 0; m < nmodes; m++)
+      offset[m + 1] = offset[m] + dims[m];
+
+   // items of node n at items[start[n], start[n + 1])
+   std::vector<std::uint64_t> start(offset[nmodes] + 1, 0);
+   for (std::uint64_t m = 0; m < nmodes; m++)
+   {
+      const std::vector<std::uint64_t> degree = degrees(train, m);
+      for (std::uint64_t id = 0; id < dims[m]; id++)
+         start[offset[m] + id + 1] = degree[id];
+   }
+   std::partial_sum(start.begin(), start.end(), start.begin());
+
+   std::vector<std::uint64_t> items(nmodes * nnz);
+   {
+      std::vector<std::uint64_t> next(start.begin(), start.end() - 1);
+      for (std::uint64_t m = 0; m < nmodes; m++)
+         for (std::uint64_t i = 0; i < nnz; i++)
+            items[next[offset[m] + columns[m * nnz + i]]++] = i;
+   }
+
+   auto by_degree = [&start](std::uint64_t a, std::uint64_t b) { return start[a + 1] - start[a] < start[b + 1] - start[b]; };
+
+   // every connected part starts at its node of lowest degree
+   std::vector<std::uint64_t> roots(offset[nmodes]);
+   std::iota(roots.begin(), roots.end(), 0);
+   std::stable_sort(roots.begin(), roots.end(), by_degree);
+
+   for (std::uint64_t m = 0; m < nmodes; m++)
+      m_original[m].reserve(dims[m]);
+
+   std::vector<char> visited(offset[nmodes], 0);
+   std::vector<std::uint64_t> queue;
+   queue.reserve(offset[nmodes]);
+
+   for (std::uint64_t root : roots)
+   {
+      if (visited[root])
+         continue;
+
+      visited[root] = 1;
+      queue.push_back(root);
+
+      for (std::uint64_t head = queue.size() - 1; head < queue.size(); head++)
+      {
+         const std::uint64_t node = queue[head];
+         const std::uint64_t mode = std::upper_bound(offset.begin(), offset.end(), node) - offset.begin() - 1;
+         m_original[mode].push_back(node - offset[mode]);
+
+         const std::uint64_t first = queue.size();
+         for (std::uint64_t k = start[node]; k < start[node + 1]; k++)
+         {
+            for (std::uint64_t m = 0; m < nmodes; m++)
+            {
+               const std::uint64_t neighbour = offset[m] + columns[m * nnz + items[k]];
+               if (!visited[neighbour])
+               {
+                  visited[neighbour] = 1;
+                  queue.push_back(neighbour);
+               }
+            }
+         }
+
+         std::stable_sort(queue.begin() + first, queue.end(), by_degree);
+      }
+   }
+
+   for (std::uint64_t m = 0; m < nmodes; m++)
+      std::reverse(m_original[m].begin(), m_original[m].end());
+}
+
+std::uint64_t Reordering::getNModes() const
+{
+   return m_original.size();
+}
+
+PVec<> Reordering::toNew(const PVec<>& pos) const
+{
+   PVec<> ret(pos.size());
+   for (std::uint64_t m = 0; m < pos.size(); m++)
+      ret[m] = m_new[m][pos[m]];
+   return ret;
+}
+
+PVec<> Reordering::toOriginal(const PVec<>& pos) const
+{
+   PVec<> ret(pos.size());
+   for (std::uint64_t m = 0; m < pos.size(); m++)
+      ret[m] = m_original[m][pos[m]];
+   return ret;
+}
+
+std::shared_ptr<TensorConfig> Reordering::permute(const TensorConfig& tc) const
+{
+   THROWERROR_ASSERT_MSG(!tc.isDense(), "Only sparse data can be reordered");
+   THROWERROR_ASSERT(tc.getNModes() == getNModes());
+
+   const std::uint64_t nnz = tc.getNNZ();
+   const std::vector<std::uint32_t>& columns = tc.getColumns();
+
+   std::vector<std::uint32_t> new_columns(columns.size());
+   for (std::uint64_t m = 0; m < getNModes(); m++)
+   {
+      const std::vector<std::uint32_t>& new_ids = m_new[m];
+      for (std::uint64_t i = m * nnz; i < (m + 1) * nnz; i++)
+         new_columns[i] = new_ids[columns[i]];
+   }
+
+   std::shared_ptr<TensorConfig> ret;
+   if (dynamic_cast<const MatrixConfig*>(&tc))
+   {
+      if (tc.isBinary())
+         ret = std::make_shared<MatrixConfig>(tc.getDims()[0], tc.getDims()[1], std::move(new_columns), tc.getNoiseConfig(), tc.isScarce());
+      else
+         ret = std::make_shared<MatrixConfig>(tc.getDims()[0], tc.getDims()[1], std::move(new_columns), std::vector<double>(tc.getValues()), tc.getNoiseConfig(), tc.isScarce());
+   }
+   else
+   {
+      if (tc.isBinary())
+         ret = std::make_shared<TensorConfig>(std::vector<std::uint64_t>(tc.getDims()), std::move(new_columns), tc.getNoiseConfig(), tc.isScarce());
+      else
+         ret = std::make_shared<TensorConfig>(std::vector<std::uint64_t>(tc.getDims()), std::move(new_columns), std::vector<double>(tc.getValues()), tc.getNoiseConfig(), tc.isScarce());
+   }
+
+   if (tc.hasPos())
+      ret->setPos(tc.getPos());
+
+   return ret;
+}
+
+std::shared_ptr<MatrixConfig> Reordering::permuteRows(const MatrixConfig& mc, std::uint64_t mode) const
+{
+   const std::vector<std::uint32_t>& new_ids = m_new.at(mode);
+   THROWERROR_ASSERT(mc.getNRow() == new_ids.size());
+
+   const std::uint64_t nrow = mc.getNRow();
+   const std::uint64_t ncol = mc.getNCol();
+
+   std::shared_ptr<MatrixConfig> ret;
+   if (mc.isDense())
+   {
+      // column-major values
+      const std::vector<double>& values = mc.getValues();
+      std::vector<double> new_values(values.size());
+      for (std::uint64_t j = 0; j < ncol; j++)
+         for (std::uint64_t i = 0; i < nrow; i++)
+            new_values[j * nrow + new_ids[i]] = values[j * nrow + i];
+
+      ret = std::make_shared<MatrixConfig>(nrow, ncol, std::move(new_values), mc.getNoiseConfig());
+   }
+   else
+   {
+      // the rows are the first nnz coordinates
+      std::vector<std::uint32_t> new_columns(mc.getColumns());
+      for (std::uint64_t i = 0; i < mc.getNNZ(); i++)
+         new_columns[i] = new_ids[new_columns[i]];
+
+      if (mc.isBinary())
+         ret = std::make_shared<MatrixConfig>(nrow, ncol, std::move(new_columns), mc.getNoiseConfig(), mc.isScarce());
+      else
+         ret = std::make_shared<MatrixConfig>(nrow, ncol, std::move(new_columns), std::vector<double>(mc.getValues()), mc.getNoiseConfig(), mc.isScarce());
+   }
+
+   return ret;
+}
+
+void Reordering::permuteColumns(const Eigen::MatrixXd& U, std::uint64_t mode, Eigen::MatrixXd& out) const
+{
+   const std::vector<std::uint32_t>& original_ids = m_original.at(mode);
+   THROWERROR_ASSERT((std::uint64_t)U.cols() == original_ids.size());
+
+   out.resize(U.rows(), U.cols());
+   for (std::uint64_t i = 0; i < original_ids.size(); i++)
+      out.col(i) = U.col(original_ids[i]);
+}
+
+void Reordering::unpermuteColumns(const Eigen::MatrixXd& U, std::uint64_t mode, Eigen::MatrixXd& out) const
+{
+   const std::vector<std::uint32_t>& original_ids = m_original.at(mode);
+   THROWERROR_ASSERT((std::uint64_t)U.cols() == original_ids.size());
+
+   out.resize(U.rows(), U.cols());
+   for (std::uint64_t i = 0; i < original_ids.size(); i++)
+      out.col(original_ids[i]) = U.col(i);
+}
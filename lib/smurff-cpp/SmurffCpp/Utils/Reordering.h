@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <SmurffCpp/Utils/PVec.hpp>
+#include <SmurffCpp/Configs/TensorConfig.h>
+#include <SmurffCpp/Configs/MatrixConfig.h>
+
+#define REORDER_NAME_NONE "none"
+#define REORDER_NAME_DEGREE "degree"
+#define REORDER_NAME_RCM "rcm"
+
+namespace smurff
+{
+   enum class ReorderTypes
+   {
+      none,
+      degree, // most items first
+      rcm     // reverse Cuthill-McKee over the entities of all modes
+   };
+
+   ReorderTypes stringToReorderType(std::string name);
+
+   std::string reorderTypeToString(ReorderTypes type);
+
+   // Renumbering of the entities (rows, columns, ...) of every mode of the
+   // train data, so that entities that share items get nearby ids and the
+   // latent vectors they read during sampling are nearby in memory.
+   //
+   // The session works in the new ids: the train data and the side info
+   // are permuted once when they are created, the model and the test
+   // coordinates are mapped when saving, restoring and predicting, so that
+   // everything outside the session stays in the original ids.
+   class Reordering
+   {
+   private:
+      std::vector<std::vector<std::uint32_t> > m_original; // m_original[m][new id] = original id
+      std::vector<std::vector<std::uint32_t> > m_new;      // m_new[m][original id] = new id
+
+   public:
+      // train has to have its data in memory (TensorConfig::hasData)
+      Reordering(const TensorConfig& train, ReorderTypes type);
+
+   private:
+      void degreeOrder(const TensorConfig& train);
+      void rcmOrder(const TensorConfig& train);
+
+   public:
+      std::uint64_t getNModes() const;
+
+      std::uint32_t toNew(std::uint64_t mode, std::uint32_t id) const
+      {
+         return m_new[mode][id];
+      }
+
+      std::uint32_t toOriginal(std::uint64_t mode, std::uint32_t id) const
+      {
+         return m_original[mode][id];
+      }
+
+      PVec<> toNew(const PVec<>& pos) const;
+      PVec<> toOriginal(const PVec<>& pos) const;
+
+   public:
+      // sparse tensor or matrix with the coordinates of every mode in the new ids
+      std::shared_ptr<TensorConfig> permute(const TensorConfig& tc) const;
+
+      // side info of mode with its rows in the new ids
+      std::shared_ptr<MatrixConfig> permuteRows(const MatrixConfig& mc, std::uint64_t mode) const;
+
+      // latent vectors of mode from the original to the new ids, and back
+      void permuteColumns(const Eigen::MatrixXd& U, std::uint64_t mode, Eigen::MatrixXd& out) const;
+      void unpermuteColumns(const Eigen::MatrixXd& U, std::uint64_t mode, Eigen::MatrixXd& out) const;
+   };
+}
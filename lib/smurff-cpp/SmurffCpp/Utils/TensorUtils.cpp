@@ -198,3 +198,110 @@ Eigen::MatrixXd smurff::tensor_utils::slice( const TensorConfig& tensorConfig
    }
    return sliceMatrix;
 }
+
+std::vector<std::vector<int> > smurff::tensor_utils::partition(const TensorConfig& train, int nparts, double sample_cost)
+{
+   const auto& dims = train.getDims();
+   const auto& columns = train.getColumns();
+   const std::uint64_t nnz = train.getNNZ();
+
+   std::vector<std::vector<double> > counts(dims.size());
+   for (std::size_t m = 0; m < dims.size(); m++)
+   {
+      counts[m].resize(dims[m], 0.0);
+      for (std::uint64_t i = 0; i < nnz; i++)
+         counts[m][columns[m * nnz + i]] += 1.0;
+   }
+
+   return partition(counts, nparts, sample_cost);
+}
+
+std::vector<std::vector<int> > smurff::tensor_utils::partition(const std::vector<std::vector<double> >& counts, int nparts, double sample_cost)
+{
+   std::vector<std::vector<int> > bounds(counts.size());
+   for (std::size_t m = 0; m < counts.size(); m++)
+   {
+      const int dim = counts[m].size();
+      THROWERROR_ASSERT_MSG(dim >= nparts, "More parts than indices in mode " + std::to_string(m));
+
+      std::vector<double> cost(counts[m]);
+      for (auto& c : cost)
+         c += sample_cost;
+      const double total = std::accumulate(cost.begin(), cost.end(), 0.0);
+
+      bounds[m].push_back(0);
+      double sum = 0.0;
+      for (int n = 0; n < dim - 1; n++)
+      {
+         sum += cost[n];
+         const int r = bounds[m].size();
+         if (r == nparts)
+            break;
+
+         // end the range of part r - 1 when it has its share,
+         // or when there is only one index left for every next part
+         if (sum >= total * r / nparts || dim - (n + 1) == nparts - r)
+            bounds[m].push_back(n + 1);
+      }
+      bounds[m].push_back(dim);
+   }
+
+   return bounds;
+}
+
+std::shared_ptr<smurff::TensorConfig> smurff::tensor_utils::slice_part(const TensorConfig& train, const std::vector<std::vector<int> >& bounds, int part)
+{
+   const auto& dims = train.getDims();
+   const auto& columns = train.getColumns();
+   const auto& values = train.getValues();
+   const std::uint64_t nmodes = train.getNModes();
+   const std::uint64_t nnz = train.getNNZ();
+
+   // entries needed to sample the columns of part in any mode
+   std::vector<std::uint64_t> keep;
+   for (std::uint64_t i = 0; i < nnz; i++)
+   {
+      for (std::uint64_t m = 0; m < nmodes; m++)
+      {
+         const int c = columns[m * nnz + i];
+         if (bounds[m][part] <= c && c < bounds[m][part + 1])
+         {
+            keep.push_back(i);
+            break;
+         }
+      }
+   }
+
+   const std::uint64_t local_nnz = keep.size();
+   std::vector<std::uint32_t> local_columns(nmodes * local_nnz);
+   std::vector<double> local_values(local_nnz);
+   for (std::uint64_t j = 0; j < local_nnz; j++)
+   {
+      for (std::uint64_t m = 0; m < nmodes; m++)
+         local_columns[m * local_nnz + j] = columns[m * nnz + keep[j]];
+      local_values[j] = values[keep[j]];
+   }
+
+   const NoiseConfig& noise = train.getNoiseConfig();
+   std::shared_ptr<TensorConfig> ret;
+   if (dynamic_cast<const MatrixConfig*>(&train))
+   {
+      if (train.isBinary())
+         ret = std::make_shared<MatrixConfig>(dims[0], dims[1], std::move(local_columns), noise, train.isScarce());
+      else
+         ret = std::make_shared<MatrixConfig>(dims[0], dims[1], std::move(local_columns), std::move(local_values), noise, train.isScarce());
+   }
+   else
+   {
+      if (train.isBinary())
+         ret = std::make_shared<TensorConfig>(std::vector<std::uint64_t>(dims), std::move(local_columns), noise, train.isScarce());
+      else
+         ret = std::make_shared<TensorConfig>(std::vector<std::uint64_t>(dims), std::move(local_columns), std::move(local_values), noise, train.isScarce());
+   }
+
+   ret->setFilename(train.getFilename());
+   if (train.hasPos())
+      ret->setPos(train.getPos());
+
+   return ret;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <vector>
 #include <unordered_map>
 
 #include <Eigen/Core>
@@ -41,4 +43,19 @@ Eigen::MatrixXd slice(const TensorConfig& tensorConfig
    , const std::unordered_map<std::uint64_t, std::uint32_t>& dimCoords
     );
 
+// Split the indices of every mode of train into nparts contiguous ranges
+// [bounds[m][p], bounds[m][p + 1]) with about the same number of entries
+// + sample_cost per index, every range has at least one index
+
+std::vector<std::vector<int> > partition(const TensorConfig& train, int nparts, double sample_cost);
+
+// Same, from the number of entries of every index of every mode
+
+std::vector<std::vector<int> > partition(const std::vector<std::vector<double> >& counts, int nparts, double sample_cost);
+
+// The entries of train with at least one coordinate in the ranges of part,
+// with the coordinates and dimensions of train
+
+std::shared_ptr<TensorConfig> slice_part(const TensorConfig& train, const std::vector<std::vector<int> >& bounds, int part);
+
 }}
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdexcept>
 #include <iostream>
+#include <cmath>
 
 #include <Eigen/Dense>
 
@@ -79,3 +80,86 @@ void chol_solve_t(Eigen::MatrixXd & A, Eigen::MatrixXd & B)
    chol_solve(A, B);
    B.transposeInPlace();
 }
+
+/** in-place lower Cholesky decomposition of w interleaved n x n matrices */
+void chol_decomp_batch(double* A, int n, int w)
+{
+   for (int j = 0; j < n; j++)
+   {
+      double* Ajj = A + (j * n + j) * w;
+
+      for (int k = 0; k < j; k++)
+      {
+         const double* Ljk = A + (k * n + j) * w;
+         for (int l = 0; l < w; l++)
+            Ajj[l] -= Ljk[l] * Ljk[l];
+      }
+
+      bool positive = true;
+      for (int l = 0; l < w; l++)
+         positive &= Ajj[l] > 0.0;
+
+      if (!positive)
+      {
+         THROWERROR("c++ error: Cholesky decomp failed (batched)");
+      }
+
+      for (int l = 0; l < w; l++)
+         Ajj[l] = std::sqrt(Ajj[l]);
+
+      for (int i = j + 1; i < n; i++)
+      {
+         double* Aij = A + (j * n + i) * w;
+         for (int k = 0; k < j; k++)
+         {
+            const double* Lik = A + (k * n + i) * w;
+            const double* Ljk = A + (k * n + j) * w;
+            for (int l = 0; l < w; l++)
+               Aij[l] -= Lik[l] * Ljk[l];
+         }
+
+         for (int l = 0; l < w; l++)
+            Aij[l] /= Ajj[l];
+      }
+   }
+}
+
+/** solves L * y = b for y in place, for w interleaved systems */
+void chol_solve_L_batch(const double* L, double* b, int n, int w)
+{
+   for (int i = 0; i < n; i++)
+   {
+      double* bi = b + i * w;
+      for (int k = 0; k < i; k++)
+      {
+         const double* Lik = L + (k * n + i) * w;
+         const double* bk = b + k * w;
+         for (int l = 0; l < w; l++)
+            bi[l] -= Lik[l] * bk[l];
+      }
+
+      const double* Lii = L + (i * n + i) * w;
+      for (int l = 0; l < w; l++)
+         bi[l] /= Lii[l];
+   }
+}
+
+/** solves L' * x = b for x in place, for w interleaved systems */
+void chol_solve_Lt_batch(const double* L, double* b, int n, int w)
+{
+   for (int i = n - 1; i >= 0; i--)
+   {
+      double* bi = b + i * w;
+      for (int k = i + 1; k < n; k++)
+      {
+         const double* Lki = L + (i * n + k) * w;
+         const double* bk = b + k * w;
+         for (int l = 0; l < w; l++)
+            bi[l] -= Lki[l] * bk[l];
+      }
+
+      const double* Lii = L + (i * n + i) * w;
+      for (int l = 0; l < w; l++)
+         bi[l] /= Lii[l];
+   }
+}
@@ -7,3 +7,12 @@ void chol_decomp(double* A, int n);
 void chol_solve(Eigen::MatrixXd & A, Eigen::MatrixXd & B);
 void chol_solve(double* A, int n, double* B, int nrhs);
 void chol_solve_t(Eigen::MatrixXd & A, Eigen::MatrixXd & B);
+
+// Batched kernels for many small SPD systems of the same size n.
+// Matrices and vectors are stored interleaved ("one lane per system"):
+// element (i,j) of matrix l is A[(j*n + i)*w + l] and element i of
+// vector l is b[i*w + l], so that the innermost loops run over the w lanes
+// with unit stride. Only the lower triangle of A is referenced.
+void chol_decomp_batch(double* A, int n, int w);
+void chol_solve_L_batch(const double* L, double* b, int n, int w);
+void chol_solve_Lt_batch(const double* L, double* b, int n, int w);
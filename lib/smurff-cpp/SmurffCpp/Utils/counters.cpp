@@ -4,6 +4,18 @@
  */
 
 #include <chrono>
+#include <fstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "counters.h"
 
 #ifdef PROFILING
 
@@ -72,3 +84,39 @@ double tick()
 {
    return std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
 }
+
+std::uint64_t peak_rss()
+{
+#ifdef _WIN32
+   PROCESS_MEMORY_COUNTERS pmc;
+   if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+      return 0;
+   return pmc.PeakWorkingSetSize;
+#else
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage))
+      return 0;
+#ifdef __APPLE__
+   return usage.ru_maxrss; // bytes on macOS
+#else
+   return usage.ru_maxrss * 1024ull; // kilobytes on Linux
+#endif
+#endif
+}
+
+std::uint64_t current_rss()
+{
+#ifdef _WIN32
+   PROCESS_MEMORY_COUNTERS pmc;
+   if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+      return 0;
+   return pmc.WorkingSetSize;
+#else
+   //resident pages are the second field, only on Linux
+   std::ifstream statm("/proc/self/statm");
+   std::uint64_t size, resident;
+   if (!(statm >> size >> resident))
+      return 0;
+   return resident * sysconf(_SC_PAGESIZE);
+#endif
+}
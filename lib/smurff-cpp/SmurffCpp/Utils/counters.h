@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #ifdef PROFILING
 
 #include <string>
@@ -61,3 +63,7 @@ inline void perf_data_print() {}
 #endif //BPMF_PROFILING
 
 double tick();
+
+// peak and current resident memory of the process in bytes, 0 if unknown
+std::uint64_t peak_rss();
+std::uint64_t current_rss();
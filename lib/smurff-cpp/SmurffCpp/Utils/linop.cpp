@@ -303,52 +303,68 @@ void smurff::linop::A_mul_At_combo(Eigen::MatrixXd & out, Eigen::MatrixXd & A) {
   }
 }
 
+// number of columns of A and B in one tile of A_mul_At_omp and A_mul_Bt_omp_sym
+static const int TILE_COLS = 256;
+
+// lower triangular part of out = sum of Ys[0 .. nthreads), added in thread order
+static void sum_lower(Eigen::MatrixXd & out, const std::vector<MatrixXd> & Ys, int nthreads) {
+  const int n = out.rows();
+  for (int i = 0; i < n; i++) {
+    for (int j = i; j < n; j++) {
+      double tmp = 0;
+      for (int k = 0; k < nthreads; k++) {
+        tmp += Ys[k](j, i);
+      }
+      out(j, i) = tmp;
+    }
+  }
+}
+
+/** A   is [n x k] matrix
+ *  out is [n x n] matrix
+ *  computes out = A * A' (storing only lower triangular part)
+ *  the columns of A are split in tiles, each thread does a SYRK
+ *  update with its tiles
+ */
 void smurff::linop::A_mul_At_omp(Eigen::MatrixXd & out, Eigen::MatrixXd & A) {
   const int n = A.rows();
   const int k = A.cols();
-  double* x = A.data();
   if (A.rows() != out.rows()) {
    THROWERROR("A.rows() must equal out.rows()");
   }
 
-  std::vector<MatrixXd> Ys;
-  Ys.resize(threads::get_max_threads(), MatrixXd(n, n));
+  const int ntiles = (k + TILE_COLS - 1) / TILE_COLS;
+  std::vector<MatrixXd> Ys(threads::get_max_threads());
+  int actual_threads = 1;
 
   #pragma omp parallel
   {
-    const int ithread  = threads::get_thread_num();
-    int rows_per_thread = (int) 8 * ceil(k / 8.0 / threads::get_num_threads());
-    int row_start = rows_per_thread * ithread;
-    int row_end   = rows_per_thread * (ithread + 1);
-    if (row_start >= k) {
-      Ys[ithread].setZero();
-    } else {
-      if (row_end > k) {
-        row_end = k;
-      }
-      double* xi = & x[ row_start * n ];
-      int nrows  = row_end - row_start;
-      MatrixXd X = Map<MatrixXd>(xi, n, nrows);
-      MatrixXd & Y = Ys[ithread];
-      Y.triangularView<Eigen::Lower>() = X * X.transpose();
-    }
-  }
-  for (int i = 0; i < n; i++) {
-    for (int j = i; j < n; j++) {
-      double tmp = 0;
-      for (int k = 0; k < threads::get_max_threads(); k++) {
-        tmp += Ys[k](j, i);
-      }
-      out(j, i) = tmp;
+    #pragma omp single
+    actual_threads = threads::get_num_threads();
+
+    MatrixXd & Y = Ys[threads::get_team_thread_num()];
+    Y.setZero(n, n);
+
+    #pragma omp for schedule(static)
+    for (int tile = 0; tile < ntiles; tile++) {
+      const int col = tile * TILE_COLS;
+      Y.selfadjointView<Eigen::Lower>().rankUpdate(A.middleCols(col, std::min(TILE_COLS, k - col)));
     }
   }
+
+  sum_lower(out, Ys, actual_threads);
 }
 
+/** A and B are [n x k] matrices
+ *  out is [n x n] matrix
+ *  computes out = A * B', assuming it is symmetric
+ *  (storing only lower triangular part)
+ *  the columns of A and B are split in tiles, each thread does a
+ *  triangular GEMM update with its tiles
+ */
 void smurff::linop::A_mul_Bt_omp_sym(Eigen::MatrixXd & out, Eigen::MatrixXd & A, Eigen::MatrixXd & B) {
   const int n = A.rows();
   const int k = A.cols();
-  double* x  = A.data();
-  double* x2 = B.data();
 
   THROWERROR_ASSERT(A.rows() == B.rows());
   THROWERROR_ASSERT(A.cols() == B.cols());
@@ -358,43 +374,27 @@ void smurff::linop::A_mul_Bt_omp_sym(Eigen::MatrixXd & out, Eigen::MatrixXd & A,
    THROWERROR("A.rows() must equal out.rows()");
   }
 
-  std::vector<MatrixXd> Ys;
-  Ys.resize(threads::get_max_threads(), MatrixXd(n, n));
-  int actual_threads = -1;
+  const int ntiles = (k + TILE_COLS - 1) / TILE_COLS;
+  std::vector<MatrixXd> Ys(threads::get_max_threads());
+  int actual_threads = 1;
 
   #pragma omp parallel
   {
     #pragma omp single
     actual_threads = threads::get_num_threads();
-    const int ithread  = threads::get_thread_num();
-    int rows_per_thread = (int) 8 * ceil(k / 8.0 / threads::get_num_threads());
-    int row_start = rows_per_thread * ithread;
-    int row_end   = rows_per_thread * (ithread + 1);
-    if (row_start >= k) {
-      Ys[ithread].setZero();
-    } else {
-      if (row_end > k) {
-        row_end = k;
-      }
-      double* xi  = & x[ row_start * n ];
-      double* x2i = & x2[ row_start * n ];
-      int nrows   = row_end - row_start;
-      MatrixXd X  = Map<MatrixXd>(xi, n, nrows);
-      MatrixXd X2 = Map<MatrixXd>(x2i, n, nrows);
-      MatrixXd & Y = Ys[ithread];
-      Y.triangularView<Eigen::Lower>() = X * X2.transpose();
-    }
-  }
 
-  for (int i = 0; i < n; i++) {
-    for (int j = i; j < n; j++) {
-      double tmp = 0;
-      for (int k = 0; k < actual_threads; k++) {
-        tmp += Ys[k](j, i);
-      }
-      out(j, i) = tmp;
+    MatrixXd & Y = Ys[threads::get_team_thread_num()];
+    Y.setZero(n, n);
+
+    #pragma omp for schedule(static)
+    for (int tile = 0; tile < ntiles; tile++) {
+      const int col = tile * TILE_COLS;
+      const int ncols = std::min(TILE_COLS, k - col);
+      Y.triangularView<Eigen::Lower>() += A.middleCols(col, ncols) * B.middleCols(col, ncols).transpose();
     }
   }
+
+  sum_lower(out, Ys, actual_threads);
 }
 
 Eigen::VectorXd smurff::linop::col_square_sum(SparseFeat & A) 
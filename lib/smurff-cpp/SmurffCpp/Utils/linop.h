@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <exception>
+#include <vector>
+
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
 
@@ -7,6 +11,7 @@
 #include <SmurffCpp/Utils/MatrixUtils.h>
 #include <SmurffCpp/Utils/Error.h>
 #include <SmurffCpp/Utils/counters.h>
+#include <SmurffCpp/Utils/Preconditioner.h>
 
 #include <SmurffCpp/SideInfo/SparseFeat.h>
 #include <SmurffCpp/SideInfo/SparseDoubleFeat.h>
@@ -18,6 +23,10 @@ template<typename T>
 int  solve_blockcg(Eigen::MatrixXd & X, T & t, double reg, Eigen::MatrixXd & B, double tol, const int blocksize, const int excess, bool throw_on_cholesky_error = false);
 template<typename T>
 int  solve_blockcg(Eigen::MatrixXd & X, T & t, double reg, Eigen::MatrixXd & B, double tol, bool throw_on_cholesky_error = false);
+template<typename T>
+int  solve_blockcg(Eigen::MatrixXd & X, T & t, double reg, Eigen::MatrixXd & B, double tol, const int blocksize, const int excess, const BlockCGParams & params, double & residual);
+template<typename T>
+int  solve_blockcg(Eigen::MatrixXd & X, T & t, double reg, Eigen::MatrixXd & B, double tol, const BlockCGParams & params, double & residual);
 
 void At_mul_A(Eigen::MatrixXd & out, SparseFeat & A);
 void At_mul_A(Eigen::MatrixXd & out, SparseDoubleFeat & A);
@@ -211,27 +220,82 @@ template<> inline void compute_uhat(Eigen::MatrixXd & uhat, Eigen::MatrixXd & de
 /** good values for solve_blockcg are blocksize=32 an excess=8 */
 template<typename T>
 inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd & B, double tol, const int blocksize, const int excess, bool throw_on_cholesky_error) {
+  BlockCGParams params;
+  params.throw_on_cholesky_error = throw_on_cholesky_error;
+  double residual;
+  return solve_blockcg(X, K, reg, B, tol, blocksize, excess, params, residual);
+}
+
+template<typename T>
+inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd & B, double tol, bool throw_on_cholesky_error) {
+  BlockCGParams params;
+  params.throw_on_cholesky_error = throw_on_cholesky_error;
+  double residual;
+  return solve_blockcg(X, K, reg, B, tol, params, residual);
+}
+
+template<typename T>
+inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd & B, double tol, const int blocksize, const int excess, const BlockCGParams & params, double & residual) {
   if (B.rows() <= excess + blocksize) {
-    return solve_blockcg(X, K, reg, B, tol, throw_on_cholesky_error);
+    return solve_blockcg(X, K, reg, B, tol, params, residual);
+  }
+  if (params.warm_start) {
+    THROWERROR_ASSERT_MSG(X.rows() == B.rows() && X.cols() == B.cols(), "X must have the size of B for a warm start");
   }
   // split B into blocks of size <blocksize> (+ excess if needed)
-  Eigen::MatrixXd Xblock, Bblock;
-  int max_iter = 0;
+  std::vector<int> block_start;
   for (int i = 0; i < B.rows(); i += blocksize) {
-    int nrows = blocksize;
+    block_start.push_back(i);
     if (i + blocksize + excess >= B.rows()) {
-      nrows = B.rows() - i;
+      break;
     }
-    Bblock.resize(nrows, B.cols());
-    Xblock.resize(nrows, X.cols());
-
-    Bblock = B.block(i, 0, nrows, B.cols());
-    int niter = solve_blockcg(Xblock, K, reg, Bblock, tol, throw_on_cholesky_error);
-    max_iter = std::max(niter, max_iter);
+  }
+  block_start.push_back(B.rows());
+  const int nblocks = block_start.size() - 1;
+
+  std::vector<int> niter(nblocks);
+  std::vector<double> block_residual(nblocks);
+  auto solve_block = [&](int block) {
+    const int i = block_start[block];
+    const int nrows = block_start[block + 1] - i;
+    Eigen::MatrixXd Bblock = B.block(i, 0, nrows, B.cols());
+    Eigen::MatrixXd Xblock(nrows, X.cols());
+    if (params.warm_start) {
+      Xblock = X.block(i, 0, nrows, X.cols());
+    }
+    niter[block] = solve_blockcg(Xblock, K, reg, Bblock, tol, params, block_residual[block]);
     X.block(i, 0, nrows, X.cols()) = Xblock;
+  };
+
+  if (params.parallel_blocks) {
+    // the blocks share the preconditioner, factorize it before
+    if (params.preconditioner) {
+      params.preconditioner->update(reg);
+    }
+
+    // one block per thread, the parallel regions inside
+    // the solver are nested in this one
+    std::exception_ptr error;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int block = 0; block < nblocks; block++) {
+      try {
+        solve_block(block);
+      } catch (...) {
+        #pragma omp critical
+        if (!error) error = std::current_exception();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  } else {
+    for (int block = 0; block < nblocks; block++) {
+      solve_block(block);
+    }
   }
 
-  return max_iter;
+  residual = *std::max_element(block_residual.begin(), block_residual.end());
+  return *std::max_element(niter.begin(), niter.end());
 }
 
 //
@@ -241,12 +305,19 @@ inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd
 //   X = n x m matrix
 //   B = n x m matrix
 //
+//   With params.warm_start the iteration starts from the X passed in,
+//   with params.preconditioner it is the preconditioned block-CG,
+//   using R * M^-1 * R' in place of R * R' for the step sizes.
+//   Converged when all relative residuals ||B - (K' * K + reg * I) * X|| / ||B|| are below tol,
+//   the largest relative residual is returned in residual.
+//
 template<typename T>
-inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd & B, double tol, bool throw_on_cholesky_error) {
+inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd & B, double tol, const BlockCGParams & params, double & residual) {
   // initialize
   const int nfeat = B.cols();
   const int nrhs  = B.rows();
   double tolsq = tol*tol;
+  const bool throw_on_cholesky_error = params.throw_on_cholesky_error;
 
   if (nfeat != K.cols()) {THROWERROR("B.cols() must equal K.cols()");}
 
@@ -267,36 +338,88 @@ inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd
   Eigen::MatrixXd R(nrhs, nfeat);
   Eigen::MatrixXd P(nrhs, nfeat);
   Eigen::MatrixXd Ptmp(nrhs, nfeat);
-  X.setZero();
-  // normalize R and P:
-  #pragma omp parallel for schedule(static) collapse(2)
-  for (int feat = 0; feat < nfeat; feat++) 
-  {
-    for (int rhs = 0; rhs < nrhs; rhs++) 
-    {
-      R(rhs, feat) = B(rhs, feat) * inorms(rhs);
-      P(rhs, feat) = R(rhs, feat);
-    }
-  }
-  Eigen::MatrixXd* RtR = new Eigen::MatrixXd(nrhs, nrhs);
-  Eigen::MatrixXd* RtR2 = new Eigen::MatrixXd(nrhs, nrhs);
 
   Eigen::MatrixXd KP(nrhs, nfeat);
   Eigen::MatrixXd KPtmp(nrhs, K.rows());
   Eigen::MatrixXd PtKP(nrhs, nrhs);
+
+  if (params.warm_start) {
+    THROWERROR_ASSERT_MSG(X.rows() == nrhs && X.cols() == nfeat, "X must have the size of B for a warm start");
+    // normalize X:
+    #pragma omp parallel for schedule(static) collapse(2)
+    for (int feat = 0; feat < nfeat; feat++) 
+    {
+      for (int rhs = 0; rhs < nrhs; rhs++) 
+      {
+        X(rhs, feat) *= inorms(rhs);
+      }
+    }
+    // R = B - X * (K' * K + reg * I), using KP as temporary
+    AtA_mul_B_switch(KP, K, reg, X, KPtmp);
+    #pragma omp parallel for schedule(static) collapse(2)
+    for (int feat = 0; feat < nfeat; feat++) 
+    {
+      for (int rhs = 0; rhs < nrhs; rhs++) 
+      {
+        R(rhs, feat) = B(rhs, feat) * inorms(rhs) - KP(rhs, feat);
+      }
+    }
+  } else {
+    X.setZero();
+    // normalize R:
+    #pragma omp parallel for schedule(static) collapse(2)
+    for (int feat = 0; feat < nfeat; feat++) 
+    {
+      for (int rhs = 0; rhs < nrhs; rhs++) 
+      {
+        R(rhs, feat) = B(rhs, feat) * inorms(rhs);
+      }
+    }
+  }
+
+  // Z = R * M^-1, without preconditioner Z is R itself
+  const bool preconditioned = (bool)params.preconditioner;
+  Eigen::MatrixXd Zbuf;
+  Eigen::MatrixXd & Z = preconditioned ? Zbuf : R;
+  if (preconditioned) {
+    params.preconditioner->update(reg);
+    params.preconditioner->apply(Z, R);
+  }
+  P = Z;
+
+  // RtZ = R * Z' (= R * R' without preconditioner)
+  auto R_mul_Zt = [&](Eigen::MatrixXd & out) {
+    if (preconditioned) {
+      A_mul_Bt_omp_sym(out, R, Z);
+    } else {
+      A_mul_At_combo(out, R);
+    }
+    makeSymmetric(out);
+  };
+
+  // squared norms of the residuals
+  auto residuals = [&]() -> Eigen::VectorXd {
+    return R.rowwise().squaredNorm();
+  };
+
+  Eigen::MatrixXd* RtZ = new Eigen::MatrixXd(nrhs, nrhs);
+  Eigen::MatrixXd* RtZ2 = new Eigen::MatrixXd(nrhs, nrhs);
+
   //Eigen::Matrix<double, N, N> A;
   //Eigen::Matrix<double, N, N> Psi;
   Eigen::MatrixXd A;
   Eigen::MatrixXd Psi;
 
-  A_mul_At_combo(*RtR, R);
-  makeSymmetric(*RtR);
+  R_mul_Zt(*RtZ);
 
   const int nblocks = (int)ceil(nfeat / 64.0);
 
   // CG iteration:
   int iter = 0;
-  for (iter = 0; iter < 10; iter++) {
+  Eigen::VectorXd d = params.warm_start ? residuals() : Eigen::VectorXd::Ones(nrhs);
+  // a warm start can already be converged
+  const bool converged = params.warm_start && (d.array() < tolsq).all();
+  for (iter = 0; !converged && iter < params.max_iter; iter++) {
     // KP = K * P
     ////double t1 = tick();
     AtA_mul_B_switch(KP, K, reg, P, KPtmp);
@@ -308,7 +431,7 @@ inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd
     auto chol_PtKP = PtKP.llt();
     THROWERROR_ASSERT_MSG(!throw_on_cholesky_error || chol_PtKP.info() != Eigen::NumericalIssue, "Cholesky Decomposition failed! (Numerical Issue)");
     THROWERROR_ASSERT_MSG(!throw_on_cholesky_error || chol_PtKP.info() != Eigen::InvalidInput, "Cholesky Decomposition failed! (Invalid Input)");
-    A = chol_PtKP.solve(*RtR);
+    A = chol_PtKP.solve(*RtZ);
 
     A.transposeInPlace();
     ////double t3 = tick();
@@ -327,24 +450,29 @@ inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd
     ////double t4 = tick();
 
     // convergence check:
-    A_mul_At_combo(*RtR2, R);
-    makeSymmetric(*RtR2);
+    if (preconditioned) {
+      params.preconditioner->apply(Z, R);
+      d = residuals();
+    }
+    R_mul_Zt(*RtZ2);
+    if (!preconditioned) {
+      d = RtZ2->diagonal();
+    }
 
-    Eigen::VectorXd d = RtR2->diagonal();
     //std::cout << "[ iter " << iter << "] " << std::scientific << d.transpose() << " (max: " << d.maxCoeff() << " > " << tolsq << ")" << std::endl;
     if ( (d.array() < tolsq).all()) {
       break;
     } 
 
-    // Psi = (R R') \ R2 R2'
-    auto chol_RtR = RtR->llt();
-    THROWERROR_ASSERT_MSG(!throw_on_cholesky_error || chol_RtR.info() != Eigen::NumericalIssue, "Cholesky Decomposition failed! (Numerical Issue)");
-    THROWERROR_ASSERT_MSG(!throw_on_cholesky_error || chol_RtR.info() != Eigen::InvalidInput, "Cholesky Decomposition failed! (Invalid Input)");
-    Psi  = chol_RtR.solve(*RtR2);
+    // Psi = (R Z') \ R2 Z2'
+    auto chol_RtZ = RtZ->llt();
+    THROWERROR_ASSERT_MSG(!throw_on_cholesky_error || chol_RtZ.info() != Eigen::NumericalIssue, "Cholesky Decomposition failed! (Numerical Issue)");
+    THROWERROR_ASSERT_MSG(!throw_on_cholesky_error || chol_RtZ.info() != Eigen::InvalidInput, "Cholesky Decomposition failed! (Invalid Input)");
+    Psi  = chol_RtZ.solve(*RtZ2);
     Psi.transposeInPlace();
     ////double t5 = tick();
 
-    // P = R + Psi' * P (P and R are already transposed)
+    // P = Z + Psi' * P (P and Z are already transposed)
     #pragma omp parallel for schedule(guided)
     for (int block = 0; block < nblocks; block++) 
     {
@@ -352,14 +480,16 @@ inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd
       int bcols = std::min(64, nfeat - col);
       Eigen::MatrixXd xtmp(nrhs, bcols);
       xtmp = Psi *  P.block(0, col, nrhs, bcols);
-      P.block(0, col, nrhs, bcols) = R.block(0, col, nrhs, bcols) + xtmp;
+      P.block(0, col, nrhs, bcols) = Z.block(0, col, nrhs, bcols) + xtmp;
     }
 
-    // R R' = R2 R2'
-    std::swap(RtR, RtR2);
+    // R Z' = R2 Z2'
+    std::swap(RtZ, RtZ2);
     ////double t6 = tick();
     ////printf("t2-t1 = %.3f, t3-t2 = %.3f, t4-t3 = %.3f, t5-t4 = %.3f, t6-t5 = %.3f\n", t2-t1, t3-t2, t4-t3, t5-t4, t6-t5);
   }
+  residual = std::sqrt(d.maxCoeff());
+
   // unnormalizing X:
   #pragma omp parallel for schedule(static) collapse(2)
   for (int feat = 0; feat < nfeat; feat++) 
@@ -369,8 +499,8 @@ inline int solve_blockcg(Eigen::MatrixXd & X, T & K, double reg, Eigen::MatrixXd
       X(rhs, feat) *= norms(rhs);
     }
   }
-  delete RtR;
-  delete RtR2;
+  delete RtZ;
+  delete RtZ2;
   return iter;
 }
 
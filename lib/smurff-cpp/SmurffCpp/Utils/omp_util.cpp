@@ -32,9 +32,26 @@ namespace threads
         return omp_get_max_threads();
     }
 
+    // thread-local state (random generators, thread_vector) is indexed by
+    // the thread number in the active parallel region; a parallel region
+    // nested inside it (e.g. in work overlapped with sampling) runs on one
+    // thread and keeps the number of the thread that entered it
     int get_thread_num()
     {
-        return omp_get_thread_num(); 
+        for (int level = omp_get_level(); level > 0; --level)
+        {
+            if (omp_get_team_size(level) > 1)
+                return omp_get_ancestor_thread_num(level);
+        }
+        return 0;
+    }
+
+    // the thread number in the innermost parallel region, to index partial
+    // results of the threads of one kernel; unlike get_thread_num it is 0
+    // when that region is nested and runs on one thread
+    int get_team_thread_num()
+    {
+        return omp_get_thread_num();
     }
 
 
@@ -101,6 +118,7 @@ namespace threads
     int  get_num_threads() { return 1; }
     int  get_max_threads() { return 1; }
     int  get_thread_num() { return 0; } 
+    int  get_team_thread_num() { return 0; }
 
     #endif // _OPENMP
 }
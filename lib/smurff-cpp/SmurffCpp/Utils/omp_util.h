@@ -11,6 +11,7 @@ namespace smurff
         int  get_num_threads();
         int  get_max_threads();
         int  get_thread_num();
+        int  get_team_thread_num();
 
     }
 }
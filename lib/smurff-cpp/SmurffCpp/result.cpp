@@ -14,9 +14,12 @@
 #include <Eigen/Sparse>
 
 #include <SmurffCpp/Model.h>
+#include <SmurffCpp/Predict/SampleCache.h>
+#include <SmurffCpp/Predict/StackedSamples.h>
 #include <SmurffCpp/result.h>
 
 #include <SmurffCpp/Utils/Error.h>
+#include <SmurffCpp/Utils/Reordering.h>
 #include <SmurffCpp/Utils/StepFile.h>
 #include <SmurffCpp/Utils/StringUtils.h>
 
@@ -253,10 +256,63 @@ void Result::restoreState(std::shared_ptr<const StepFile> sf)
    burnin_iter = stoi(value.c_str());
 }
 
+void Result::setReordering(std::shared_ptr<const Reordering> reordering)
+{
+   m_reordering = reordering;
+}
+
+double Result::predict(const Model& model, const PVec<>& coords) const
+{
+   return m_reordering ? model.predict(m_reordering->toNew(coords)) : model.predict(coords);
+}
+
 //--- update RMSE and AUC
 
 //model - holds samples (U matrices)
 void Result::update(std::shared_ptr<const Model> model, bool burnin)
+{
+   updatePredictions([this, &model](const PVec<>& coords) { return predict(*model, coords); }, burnin);
+}
+
+void Result::update(const ModelSample& sample)
+{
+   updatePredictions([&sample](const PVec<>& coords) { return sample.predict(coords); }, false);
+}
+
+void Result::update(const StackedSamples& samples)
+{
+   if (m_predictions.empty())
+      return;
+
+   samples.predict(m_predictions);
+
+   const size_t NNZ = m_predictions.size();
+   double se_1sample = 0.0;
+   double se_avg = 0.0;
+
+   for(size_t k = 0; k < m_predictions.size(); ++k)
+   {
+      const auto &t = m_predictions.operator[](k);
+      se_1sample += std::pow(t.val - t.pred_1sample, 2);
+      se_avg += std::pow(t.val - t.pred_avg, 2);
+   }
+
+   sample_iter += samples.nsamples();
+   rmse_1sample = std::sqrt(se_1sample / NNZ);
+   rmse_avg = std::sqrt(se_avg / NNZ);
+
+   if (classify)
+   {
+      auc_1sample = calc_auc(m_predictions, threshold,
+            [](const ResultItem &a, const ResultItem &b) { return a.pred_1sample < b.pred_1sample;});
+
+      auc_avg = calc_auc(m_predictions, threshold,
+            [](const ResultItem &a, const ResultItem &b) { return a.pred_avg < b.pred_avg;});
+   }
+}
+
+template<typename Predict>
+void Result::updatePredictions(const Predict& predict, bool burnin)
 {
    if (m_predictions.empty())
       return;
@@ -271,7 +327,7 @@ void Result::update(std::shared_ptr<const Model> model, bool burnin)
       for(size_t k = 0; k < m_predictions.size(); ++k)
       {
          auto &t = m_predictions.operator[](k);
-         t.pred_1sample = model->predict(t.coords); //dot product of i'th columns in each U matrix
+         t.pred_1sample = predict(t.coords); //dot product of i'th columns in each U matrix
          se_1sample += std::pow(t.val - t.pred_1sample, 2);
       }
 
@@ -293,7 +349,7 @@ void Result::update(std::shared_ptr<const Model> model, bool burnin)
       for(size_t k = 0; k < m_predictions.size(); ++k)
       {
          auto &t = m_predictions.operator[](k);
-         const double pred = model->predict(t.coords); //dot product of i'th columns in each U matrix
+         const double pred = predict(t.coords); //dot product of i'th columns in each U matrix
          t.update(pred);
 
          se_1sample += std::pow(t.val - pred, 2);
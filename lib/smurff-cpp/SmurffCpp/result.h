@@ -12,7 +12,10 @@ class StepFile;
 class RootFile;
 
 class Model;
+class ModelSample;
+class StackedSamples;
 class Data;
+class Reordering;
 
 template<typename Item, typename Compare>
 double calc_auc(const std::vector<Item> &predictions,
@@ -68,6 +71,24 @@ public:
    //-- prediction metrics
    void update(std::shared_ptr<const Model> model, bool burnin);
 
+   //-- prediction metrics from a sample of a PredictSession
+   void update(const ModelSample& sample);
+
+   //-- prediction metrics from all samples of a PredictSession at once
+   void update(const StackedSamples& samples);
+
+   //model is in the new ids of reordering, the test items stay in the original ids
+   void setReordering(std::shared_ptr<const Reordering> reordering);
+
+private:
+   std::shared_ptr<const Reordering> m_reordering;
+
+   double predict(const Model& model, const PVec<>& coords) const;
+
+   //predict(coords) of every item
+   template<typename Predict>
+   void updatePredictions(const Predict& predict, bool burnin);
+
 public:
    double rmse_avg = NAN;
    double rmse_1sample = NAN;
@@ -0,0 +1,30 @@
+#include "MPIDistDataCreator.h"
+
+#include <SmurffCpp/DataTensors/TensorData.h>
+#include <SmurffCpp/Noises/NoiseFactory.h>
+#include <SmurffCpp/Utils/Error.h>
+
+using namespace smurff;
+
+MPIDistDataCreator::MPIDistDataCreator(std::shared_ptr<Session> session, const std::vector<std::vector<int> >& bounds, int rank)
+   : DataCreator(session), m_bounds(bounds), m_rank(rank)
+{
+}
+
+std::shared_ptr<Data> MPIDistDataCreator::create(std::shared_ptr<const TensorConfig> tc) const
+{
+   THROWERROR_ASSERT_MSG(!tc->isDense() && tc->isScarce(), "Tensor config should be scarse");
+   THROWERROR_ASSERT(m_bounds.size() == tc->getNModes());
+
+   std::vector<std::uint64_t> plane_begin, plane_end;
+   for (auto& b : m_bounds)
+   {
+      plane_begin.push_back(b.at(m_rank));
+      plane_end.push_back(b.at(m_rank + 1));
+   }
+
+   std::shared_ptr<TensorData> tensorData = std::make_shared<TensorData>(*tc, plane_begin, plane_end);
+   std::shared_ptr<INoiseModel> noise = NoiseFactory::create_noise_model(tc->getNoiseConfig());
+   tensorData->setNoiseModel(noise);
+   return tensorData;
+}
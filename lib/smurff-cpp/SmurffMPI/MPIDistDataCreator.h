@@ -0,0 +1,27 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <SmurffCpp/DataMatrices/DataCreator.h>
+
+namespace smurff {
+
+   // creates a TensorData with only the hyperplanes of the columns
+   // sampled by this rank (see MPIDistSession); matrices are created
+   // as by DataCreator
+   class MPIDistDataCreator : public DataCreator
+   {
+   private:
+      // column ranges of the ranks for every mode, see tensor_utils::partition
+      std::vector<std::vector<int> > m_bounds;
+      int m_rank;
+
+   public:
+      MPIDistDataCreator(std::shared_ptr<Session> session, const std::vector<std::vector<int> >& bounds, int rank);
+
+   public:
+      using DataCreator::create;
+      std::shared_ptr<Data> create(std::shared_ptr<const TensorConfig> tc) const override;
+   };
+}
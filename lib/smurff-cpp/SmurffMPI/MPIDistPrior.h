@@ -0,0 +1,103 @@
+#pragma once
+
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+#include <Eigen/Dense>
+
+#include <SmurffCpp/Priors/ILatentPrior.h>
+#include <SmurffCpp/Utils/counters.h>
+#include <SmurffCpp/Utils/Error.h>
+
+namespace smurff
+{
+
+// Prior of MPIDistSession: every rank samples its own range of columns of U,
+// then the ranks exchange the sampled columns and the sums for update_prior.
+//
+// Prior is a prior with hyper-parameters mu and Lambda
+// (NormalPrior or NormalOnePrior), which are sampled on rank 0
+// and broadcast to the other ranks.
+template<class Prior>
+class MPIDistPrior : public Prior
+{
+public:
+   int world_rank;
+   int world_size;
+
+private:
+   // columns [bounds[r], bounds[r+1]) of U are sampled by rank r
+   std::vector<int> m_bounds;
+
+   // in doubles, for MPI_Allgatherv of U
+   std::vector<int> m_counts;
+   std::vector<int> m_displs;
+
+public:
+   MPIDistPrior(std::shared_ptr<BaseSession> session, uint32_t mode, const std::vector<int>& bounds)
+      : Prior(session, mode), m_bounds(bounds)
+   {
+      MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+      MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+      THROWERROR_ASSERT((int)m_bounds.size() == world_size + 1);
+      this->setColumnRange(m_bounds[world_rank], m_bounds[world_rank + 1]);
+   }
+
+   void init() override
+   {
+      Prior::init();
+
+      THROWERROR_ASSERT(m_bounds.back() == this->num_cols());
+
+      // MPI counts and displacements are int
+      const int K = this->num_latent();
+      THROWERROR_ASSERT_MSG((std::int64_t)K * this->num_cols() <= INT_MAX,
+         "U of mode " + std::to_string(this->getMode()) + " has " + std::to_string(K) + " x " + std::to_string(this->num_cols()) +
+         " doubles, more than MPI_Allgatherv can exchange (" + std::to_string(INT_MAX) + ")");
+
+      m_counts.resize(world_size);
+      m_displs.resize(world_size);
+      for (int r = 0; r < world_size; r++)
+      {
+         m_counts[r] = K * (m_bounds[r + 1] - m_bounds[r]);
+         m_displs[r] = K * m_bounds[r];
+      }
+   }
+
+   void sample_latents() override
+   {
+      COUNTER("sample_latents");
+      this->sample_latent_vectors();
+
+      {
+         COUNTER("mpi_exchange");
+         // U is column major: the columns of every rank are contiguous
+         MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, this->U().data(), m_counts.data(), m_displs.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+         MPI_Allreduce(MPI_IN_PLACE, this->Usum.data(), this->Usum.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+         MPI_Allreduce(MPI_IN_PLACE, this->UUsum.data(), this->UUsum.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+      }
+
+      // one random stream for the hyper-parameters
+      if (world_rank == 0)
+         this->update_prior();
+
+      MPI_Bcast(this->mu.data(), this->mu.size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+      MPI_Bcast(this->Lambda.data(), this->Lambda.size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+   }
+
+   std::ostream &info(std::ostream &os, std::string indent) override
+   {
+      Prior::info(os, indent);
+      os << indent << " MPI version with " << world_size << " ranks, columns ["
+         << this->col_begin() << ", " << this->col_end() << ") on rank " << world_rank << std::endl;
+      return os;
+   }
+};
+
+}
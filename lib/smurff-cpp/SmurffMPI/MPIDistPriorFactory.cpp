@@ -0,0 +1,37 @@
+#include "MPIDistPriorFactory.h"
+
+#include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/Priors/NormalPrior.h>
+#include <SmurffCpp/Priors/NormalOnePrior.h>
+#include <SmurffCpp/Utils/Error.h>
+
+#include <SmurffMPI/MPIDistPrior.h>
+
+using namespace smurff;
+
+MPIDistPriorFactory::MPIDistPriorFactory(const std::vector<std::vector<int> >& bounds)
+   : m_bounds(bounds)
+{
+}
+
+std::shared_ptr<ILatentPrior> MPIDistPriorFactory::create_prior(std::shared_ptr<Session> session, int mode)
+{
+   PriorTypes priorType = session->getConfig().getPriorTypes().at(mode);
+
+   switch(priorType)
+   {
+   case PriorTypes::normal:
+   case PriorTypes::default_prior:
+      {
+         std::shared_ptr<MPIDistPrior<NormalPrior> > prior(new MPIDistPrior<NormalPrior>(session, -1, m_bounds.at(mode)));
+         prior->setBatchSize(session->getConfig().getSampleBatch());
+         return prior;
+      }
+   case PriorTypes::normalone:
+      return std::shared_ptr<MPIDistPrior<NormalOnePrior> >(new MPIDistPrior<NormalOnePrior>(session, -1, m_bounds.at(mode)));
+   default:
+      {
+         THROWERROR("Prior not supported by the distributed MPI session: " + priorTypeToString(priorType));
+      }
+   }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <SmurffCpp/Priors/PriorFactory.h>
+
+namespace smurff {
+
+   class ILatentPrior;
+   class Session;
+
+   class MPIDistPriorFactory : public PriorFactory
+   {
+   private:
+      // column ranges of the ranks for every mode, see tensor_utils::partition
+      std::vector<std::vector<int> > m_bounds;
+
+   public:
+      MPIDistPriorFactory(const std::vector<std::vector<int> >& bounds);
+
+      std::shared_ptr<ILatentPrior> create_prior(std::shared_ptr<Session> session, int mode) override;
+   };
+}
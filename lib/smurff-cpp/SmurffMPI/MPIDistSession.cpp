@@ -0,0 +1,267 @@
+#include <mpi.h>
+
+#include "MPIDistSession.h"
+#include "MPIDistPriorFactory.h"
+#include "MPIDistDataCreator.h"
+#include "MPIDistTensorIO.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+
+#include <SmurffCpp/Configs/MatrixConfig.h>
+#include <SmurffCpp/IO/TensorIO.h>
+#include <SmurffCpp/Utils/TensorUtils.h>
+#include <SmurffCpp/Utils/Distribution.h>
+#include <SmurffCpp/Utils/LatentScheduler.h>
+#include <SmurffCpp/Utils/omp_util.h>
+#include <SmurffCpp/Utils/Error.h>
+
+using namespace smurff;
+
+MPIDistSession::MPIDistSession()
+{
+   name = "MPIDistSession";
+
+   MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+   MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+}
+
+void MPIDistSession::fromConfig(const Config& cfg)
+{
+   auto train = cfg.getTrain();
+   THROWERROR_ASSERT_MSG(train, "MPIDistSession needs train data");
+
+   if (!train->hasData())
+   {
+      // only the header of the file was read (see tensor_io::read_tensor_header)
+      std::shared_ptr<TensorConfig> header = train;
+      train = tensor_io::read_tensor(header->getFilename(), header->isScarce());
+      train->setNoiseConfig(header->getNoiseConfig());
+      train->setPos(header->getPos());
+   }
+
+   THROWERROR_ASSERT_MSG(!train->isDense(), "MPIDistSession does not support dense train data");
+   THROWERROR_ASSERT_MSG(train->getNoiseConfig().getNoiseType() != NoiseTypes::adaptive, "MPIDistSession does not support adaptive noise");
+   checkConfig(cfg);
+
+   m_bounds = tensor_utils::partition(*train, world_size, LatentScheduler::sample_cost(cfg.getNumLatent()));
+   setLocalConfig(cfg, tensor_utils::slice_part(*train, m_bounds, world_rank));
+}
+
+void MPIDistSession::fromConfig(const Config& cfg, const std::string& train_file)
+{
+   THROWERROR_ASSERT_MSG(!cfg.getTrain(), "MPIDistSession reads the train data from " + train_file);
+   checkConfig(cfg);
+
+   auto train = read_shard(train_file, LatentScheduler::sample_cost(cfg.getNumLatent()), m_bounds);
+   train->setNoiseConfig(NoiseConfig(NoiseConfig::NOISE_TYPE_DEFAULT_VALUE));
+   setLocalConfig(cfg, train);
+}
+
+bool MPIDistSession::isSupported(const Config& cfg)
+{
+   for (PriorTypes prior : cfg.getPriorTypes())
+   {
+      if (prior != PriorTypes::normal && prior != PriorTypes::normalone && prior != PriorTypes::default_prior)
+         return false;
+   }
+
+   auto train = cfg.getTrain();
+   if (train && (train->isDense() || train->getNoiseConfig().getNoiseType() == NoiseTypes::adaptive))
+      return false;
+
+   return cfg.getAuxData().empty() &&
+          cfg.getRootName().empty() &&
+          !cfg.getPipelineStep() &&
+          !cfg.getCSFTensor() &&
+          cfg.getReorderType() == ReorderTypes::none;
+}
+
+void MPIDistSession::checkConfig(const Config& cfg) const
+{
+   THROWERROR_ASSERT_MSG(cfg.getAuxData().empty(), "MPIDistSession does not support aux-data");
+   THROWERROR_ASSERT_MSG(cfg.getRootName().empty(), "MPIDistSession cannot resume from a root file");
+   THROWERROR_ASSERT_MSG(!cfg.getPipelineStep(), "MPIDistSession does not support pipeline-step");
+   THROWERROR_ASSERT_MSG(!cfg.getCSFTensor(), "MPIDistSession does not support csf-tensor");
+   THROWERROR_ASSERT_MSG(cfg.getReorderType() == ReorderTypes::none, "MPIDistSession does not support reorder");
+}
+
+void MPIDistSession::setLocalConfig(const Config& cfg, std::shared_ptr<TensorConfig> local_train)
+{
+   Config local_cfg = cfg;
+   local_cfg.setTrain(local_train);
+
+   // only rank 0 prints, predicts and saves
+   if (world_rank != 0)
+   {
+      local_cfg.setVerbose(0);
+      local_cfg.setSaveFreq(0);
+      local_cfg.setCheckpointFreq(0);
+      local_cfg.setTest(std::shared_ptr<TensorConfig>());
+   }
+
+   Session::fromConfig(local_cfg);
+}
+
+void MPIDistSession::init()
+{
+   Session::init();
+
+   // same initial model on all ranks
+   for (std::uint64_t m = 0; m < model().nmodes(); m++)
+      MPI_Bcast(model().U(m).data(), model().U(m).size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+   // different random numbers on every rank: thread t of rank r
+   // gets seed + (r * nthreads + t) * 1999 (see init_bmrng)
+   int seed = m_config.getRandomSeedSet() ? m_config.getRandomSeed() : (int)std::random_device()();
+   MPI_Bcast(&seed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+   init_bmrng(seed + world_rank * threads::get_max_threads() * 1999);
+}
+
+std::shared_ptr<IPriorFactory> MPIDistSession::create_prior_factory() const
+{
+   return std::make_shared<MPIDistPriorFactory>(m_bounds);
+}
+
+std::shared_ptr<IDataCreator> MPIDistSession::create_data_creator()
+{
+   return std::make_shared<MPIDistDataCreator>(shared_from_this(), m_bounds, world_rank);
+}
+
+std::shared_ptr<TensorConfig> MPIDistSession::read_shard(const std::string& filename, double sample_cost, std::vector<std::vector<int> >& bounds)
+{
+   int nranks, rank;
+   MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+   std::vector<std::uint64_t> dims;
+   std::uint64_t nnz;
+   mpi_dist_io::read_sparse_header(filename, dims, nnz);
+   const std::uint64_t nmodes = dims.size();
+
+   // a contiguous range of entries per rank
+   auto chunk = mpi_dist_io::read_sparse_entries(filename, nnz * rank / nranks, nnz * (rank + 1) / nranks);
+   const auto& columns = chunk->getColumns();
+   const auto& values = chunk->getValues();
+   const std::uint64_t chunk_nnz = chunk->getNNZ();
+
+   // number of entries per index, over all ranks
+   std::vector<std::vector<double> > counts(nmodes);
+   for (std::uint64_t m = 0; m < nmodes; m++)
+   {
+      counts[m].resize(dims[m], 0.0);
+      for (std::uint64_t i = 0; i < chunk_nnz; i++)
+         counts[m][columns[m * chunk_nnz + i]] += 1.0;
+      MPI_Allreduce(MPI_IN_PLACE, counts[m].data(), counts[m].size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+   }
+
+   bounds = tensor_utils::partition(counts, nranks, sample_cost);
+
+   // ranks that sample a column of one of the coordinates of entry i
+   std::vector<int> owners(nmodes);
+   auto get_owners = [&](std::uint64_t i) {
+      for (std::uint64_t m = 0; m < nmodes; m++)
+      {
+         const int c = columns[m * chunk_nnz + i];
+         owners[m] = std::upper_bound(bounds[m].begin(), bounds[m].end(), c) - bounds[m].begin() - 1;
+      }
+      std::sort(owners.begin(), owners.end());
+      return std::unique(owners.begin(), owners.end());
+   };
+
+   std::vector<int> send_counts(nranks, 0);
+   for (std::uint64_t i = 0; i < chunk_nnz; i++)
+   {
+      auto owners_end = get_owners(i);
+      for (auto r = owners.begin(); r != owners_end; ++r)
+         send_counts[*r]++;
+   }
+
+   std::vector<int> recv_counts(nranks);
+   MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+   std::vector<int> send_displs(nranks, 0), recv_displs(nranks, 0);
+   for (int r = 1; r < nranks; r++)
+   {
+      send_displs[r] = send_displs[r - 1] + send_counts[r - 1];
+      recv_displs[r] = recv_displs[r - 1] + recv_counts[r - 1];
+   }
+   const std::uint64_t send_nnz = send_displs.back() + send_counts.back();
+   const std::uint64_t local_nnz = recv_displs.back() + recv_counts.back();
+   THROWERROR_ASSERT_MSG(send_nnz * nmodes < (std::uint64_t)std::numeric_limits<int>::max() &&
+                         local_nnz * nmodes < (std::uint64_t)std::numeric_limits<int>::max(), "Too many entries per MPI rank");
+
+   // entry by entry, in the order of the file
+   std::vector<std::uint32_t> send_columns(send_nnz * nmodes);
+   std::vector<double> send_values(send_nnz);
+   std::vector<int> pos(send_displs);
+   for (std::uint64_t i = 0; i < chunk_nnz; i++)
+   {
+      auto owners_end = get_owners(i);
+      for (auto r = owners.begin(); r != owners_end; ++r)
+      {
+         const int j = pos[*r]++;
+         for (std::uint64_t m = 0; m < nmodes; m++)
+            send_columns[j * nmodes + m] = columns[m * chunk_nnz + i];
+         send_values[j] = values[i];
+      }
+   }
+
+   const bool isBinary = chunk->isBinary();
+   chunk.reset();
+
+   std::vector<double> local_values(local_nnz);
+   MPI_Alltoallv(send_values.data(), send_counts.data(), send_displs.data(), MPI_DOUBLE,
+                 local_values.data(), recv_counts.data(), recv_displs.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+   send_values.clear();
+   send_values.shrink_to_fit();
+
+   for (int r = 0; r < nranks; r++)
+   {
+      send_counts[r] *= nmodes; send_displs[r] *= nmodes;
+      recv_counts[r] *= nmodes; recv_displs[r] *= nmodes;
+   }
+
+   std::vector<std::uint32_t> recv_columns(local_nnz * nmodes);
+   MPI_Alltoallv(send_columns.data(), send_counts.data(), send_displs.data(), MPI_UINT32_T,
+                 recv_columns.data(), recv_counts.data(), recv_displs.data(), MPI_UINT32_T, MPI_COMM_WORLD);
+   send_columns.clear();
+   send_columns.shrink_to_fit();
+
+   // mode by mode in TensorConfig
+   std::vector<std::uint32_t> local_columns(nmodes * local_nnz);
+   for (std::uint64_t j = 0; j < local_nnz; j++)
+      for (std::uint64_t m = 0; m < nmodes; m++)
+         local_columns[m * local_nnz + j] = recv_columns[j * nmodes + m];
+   recv_columns.clear();
+   recv_columns.shrink_to_fit();
+
+   std::shared_ptr<TensorConfig> ret;
+   if (isBinary)
+      ret = std::make_shared<TensorConfig>(std::move(dims), std::move(local_columns), NoiseConfig(), true);
+   else
+      ret = std::make_shared<TensorConfig>(std::move(dims), std::move(local_columns), std::move(local_values), NoiseConfig(), true);
+
+   ret->setFilename(filename);
+   return ret;
+}
+
+//create distributed mpi session
+//fromConfig validates the config and slices the train data for this rank
+std::shared_ptr<ISession> smurff::create_mpi_dist_session(const Config& cfg)
+{
+   std::shared_ptr<MPIDistSession> session(new MPIDistSession());
+   session->fromConfig(cfg);
+   return session;
+}
+
+//create distributed mpi session with the train data read in shards from train_file
+std::shared_ptr<ISession> smurff::create_mpi_dist_session(const Config& cfg, const std::string& train_file)
+{
+   std::shared_ptr<MPIDistSession> session(new MPIDistSession());
+   session->fromConfig(cfg, train_file);
+   return session;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Sessions/Session.h>
+#include <SmurffCpp/Priors/IPriorFactory.h>
+
+namespace smurff {
+
+// Data-parallel Gibbs sampler: the columns of every U are partitioned
+// over the MPI ranks and every rank keeps only the entries of the train
+// data it needs to sample its own columns (see MPIDistPrior).
+//
+// Train tensors are stored as a TensorData with, for every mode, only the
+// hyperplanes of the columns of the rank (see MPIDistDataCreator). When
+// constructed from a sparse tensor file, every rank reads only a part of
+// the file and receives the rest of its entries from the other ranks
+// (see read_shard), so no rank ever holds the whole tensor.
+//
+// Rank 0 samples the hyper-parameters, makes the predictions and saves
+// the model; its train RMSE in the status output is over its own slice.
+//
+// Supported are sparse train matrices and tensors with fixed or probit
+// noise, and the normal and normalone priors.
+class MPIDistSession : public Session
+{
+public:
+   int world_rank;
+   int world_size;
+
+private:
+   // columns [m_bounds[m][r], m_bounds[m][r+1]) of mode m are sampled by rank r
+   std::vector<std::vector<int> > m_bounds;
+
+public:
+   MPIDistSession();
+
+   void fromConfig(const Config& cfg);
+
+   // cfg without train data, the train data is read from the sparse tensor train_file
+   void fromConfig(const Config& cfg, const std::string& train_file);
+
+   // cfg can be run by a MPIDistSession, checkConfig and fromConfig
+   // throw for the cases where it can not
+   static bool isSupported(const Config& cfg);
+
+private:
+   void checkConfig(const Config& cfg) const;
+
+   void setLocalConfig(const Config& cfg, std::shared_ptr<TensorConfig> local_train);
+
+protected:
+   void init() override;
+
+public:
+   std::shared_ptr<IPriorFactory> create_prior_factory() const override;
+
+   std::shared_ptr<IDataCreator> create_data_creator() override;
+
+public:
+   // same as tensor_utils::slice_part(read_tensor(filename), tensor_utils::partition(...), rank) on every rank,
+   // but every rank reads only 1/nranks of the entries from filename and
+   // sends them to the ranks that need them (collective on MPI_COMM_WORLD)
+   static std::shared_ptr<TensorConfig> read_shard(const std::string& filename, double sample_cost, std::vector<std::vector<int> >& bounds);
+};
+
+std::shared_ptr<ISession> create_mpi_dist_session(const Config& cfg);
+
+std::shared_ptr<ISession> create_mpi_dist_session(const Config& cfg, const std::string& train_file);
+
+}
@@ -0,0 +1,214 @@
+#include "MPIDistTensorIO.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <SmurffCpp/IO/ChunkedTensor.h>
+#include <SmurffCpp/IO/GenericIO.h>
+#include <SmurffCpp/IO/TensorIO.h>
+#include <SmurffCpp/Utils/Error.h>
+
+using namespace smurff;
+
+bool mpi_dist_io::is_sparse_tensor_file(const std::string& filename)
+{
+   std::size_t dotIndex = filename.find_last_of(".");
+   if (dotIndex == std::string::npos)
+      return false;
+
+   std::string extension = filename.substr(dotIndex);
+   return extension == ".sdt" || extension == ".sbt" || extension == ".tns" || extension == ".sct";
+}
+
+// binary header: nmodes, dims[nmodes], nnz (all uint64)
+static void read_bin_header(std::istream& in, std::vector<std::uint64_t>& dims, std::uint64_t& nnz)
+{
+   std::uint64_t nmodes;
+   in.read(reinterpret_cast<char*>(&nmodes), sizeof(std::uint64_t));
+
+   dims.resize(nmodes);
+   in.read(reinterpret_cast<char*>(dims.data()), dims.size() * sizeof(std::uint64_t));
+
+   in.read(reinterpret_cast<char*>(&nnz), sizeof(std::uint64_t));
+
+   THROWERROR_ASSERT_MSG(in.good(), "Error reading header of sparse tensor");
+}
+
+// text header: nmodes, dims[nmodes] and nnz on the first three lines
+static void read_tns_header(std::istream& in, std::vector<std::uint64_t>& dims, std::uint64_t& nnz)
+{
+   std::uint64_t nmodes;
+   in >> nmodes;
+
+   dims.resize(nmodes);
+   for (auto& d : dims)
+      in >> d;
+
+   in >> nnz;
+
+   THROWERROR_ASSERT_MSG(in.good(), "Error reading header of sparse tensor");
+}
+
+void mpi_dist_io::read_sparse_header(const std::string& filename, std::vector<std::uint64_t>& dims, std::uint64_t& nnz)
+{
+   THROWERROR_FILE_NOT_EXIST(filename);
+
+   if (tensor_io::ExtensionToTensorType(filename) == tensor_io::TensorType::sct)
+   {
+      tensor_io::ChunkedTensorReader reader(filename);
+      dims = reader.getDims();
+      nnz = reader.getNNZ();
+   }
+   else if (tensor_io::ExtensionToTensorType(filename) == tensor_io::TensorType::tns)
+   {
+      std::ifstream in(filename);
+      THROWERROR_ASSERT_MSG(in.is_open(), "Error opening file: " + filename);
+      read_tns_header(in, dims, nnz);
+   }
+   else
+   {
+      std::ifstream in(filename, std::ios_base::binary);
+      THROWERROR_ASSERT_MSG(in.is_open(), "Error opening file: " + filename);
+      read_bin_header(in, dims, nnz);
+   }
+}
+
+// entries [begin, end) of a .sct file, from the chunks that overlap them
+static std::shared_ptr<TensorConfig> read_chunked_entries(const std::string& filename, std::uint64_t begin, std::uint64_t end)
+{
+   tensor_io::ChunkedTensorReader reader(filename);
+   THROWERROR_ASSERT_MSG(begin <= end && end <= reader.getNNZ(), "Invalid range of entries in " + filename);
+
+   const std::uint64_t nmodes = reader.getNModes();
+   const std::uint64_t local_nnz = end - begin;
+   std::vector<std::uint32_t> columns(nmodes * local_nnz);
+   std::vector<double> values(reader.isBinary() ? 0 : local_nnz);
+
+   std::vector<std::uint32_t> chunk_columns;
+   std::vector<double> chunk_values;
+   for (std::uint64_t c = 0; c < reader.getNChunks(); c++)
+   {
+      const std::uint64_t chunk_begin = reader.chunkBegin(c);
+      const std::uint64_t chunk_end = chunk_begin + reader.chunkSize(c);
+      if (chunk_end <= begin)
+         continue;
+      if (chunk_begin >= end)
+         break;
+
+      // overlap [first, last) of the chunk and the range
+      const std::uint64_t first = std::max(begin, chunk_begin);
+      const std::uint64_t last = std::min(end, chunk_end);
+
+      chunk_columns.resize(reader.chunkSize(c));
+      for (std::uint64_t m = 0; m < nmodes; m++)
+      {
+         reader.readColumn(c, m, chunk_columns.data());
+         std::copy(chunk_columns.begin() + (first - chunk_begin), chunk_columns.begin() + (last - chunk_begin),
+                   columns.begin() + m * local_nnz + (first - begin));
+      }
+
+      if (!reader.isBinary())
+      {
+         chunk_values.resize(reader.chunkSize(c));
+         reader.readValues(c, chunk_values.data());
+         std::copy(chunk_values.begin() + (first - chunk_begin), chunk_values.begin() + (last - chunk_begin),
+                   values.begin() + (first - begin));
+      }
+   }
+
+   // zero-based in the file
+   std::vector<std::uint64_t> dims(reader.getDims());
+   std::shared_ptr<TensorConfig> ret;
+   if (reader.isBinary())
+      ret = std::make_shared<TensorConfig>(std::move(dims), std::move(columns), NoiseConfig(), true);
+   else
+      ret = std::make_shared<TensorConfig>(std::move(dims), std::move(columns), std::move(values), NoiseConfig(), true);
+
+   ret->setFilename(filename);
+   return ret;
+}
+
+std::shared_ptr<TensorConfig> mpi_dist_io::read_sparse_entries(const std::string& filename, std::uint64_t begin, std::uint64_t end)
+{
+   THROWERROR_FILE_NOT_EXIST(filename);
+
+   const tensor_io::TensorType type = tensor_io::ExtensionToTensorType(filename);
+   THROWERROR_ASSERT_MSG(is_sparse_tensor_file(filename), "Not a sparse tensor file: " + filename);
+
+   if (type == tensor_io::TensorType::sct)
+      return read_chunked_entries(filename, begin, end);
+
+   std::ifstream in;
+   if (type == tensor_io::TensorType::tns)
+      in.open(filename);
+   else
+      in.open(filename, std::ios_base::binary);
+   THROWERROR_ASSERT_MSG(in.is_open(), "Error opening file: " + filename);
+
+   std::vector<std::uint64_t> dims;
+   std::uint64_t nnz;
+   if (type == tensor_io::TensorType::tns)
+      read_tns_header(in, dims, nnz);
+   else
+      read_bin_header(in, dims, nnz);
+
+   THROWERROR_ASSERT_MSG(begin <= end && end <= nnz, "Invalid range of entries in " + filename);
+
+   const std::uint64_t nmodes = dims.size();
+   const std::uint64_t local_nnz = end - begin;
+   std::vector<std::uint32_t> columns(nmodes * local_nnz);
+   std::vector<double> values(local_nnz, 1.0);
+
+   if (type == tensor_io::TensorType::tns)
+   {
+      // coordinates of all entries mode by mode, then all values
+      std::uint64_t coord;
+      for (std::uint64_t m = 0; m < nmodes; m++)
+      {
+         for (std::uint64_t i = 0; i < nnz; i++)
+         {
+            in >> coord;
+            if (begin <= i && i < end)
+               columns[m * local_nnz + i - begin] = coord;
+         }
+      }
+
+      double value;
+      for (std::uint64_t i = 0; i < end; i++)
+      {
+         in >> value;
+         if (begin <= i)
+            values[i - begin] = value;
+      }
+   }
+   else
+   {
+      const std::streamoff header_size = (2 + nmodes) * sizeof(std::uint64_t);
+      for (std::uint64_t m = 0; m < nmodes; m++)
+      {
+         in.seekg(header_size + (m * nnz + begin) * sizeof(std::uint32_t));
+         in.read(reinterpret_cast<char*>(columns.data() + m * local_nnz), local_nnz * sizeof(std::uint32_t));
+      }
+
+      if (type == tensor_io::TensorType::sdt)
+      {
+         in.seekg(header_size + nmodes * nnz * sizeof(std::uint32_t) + begin * sizeof(double));
+         in.read(reinterpret_cast<char*>(values.data()), local_nnz * sizeof(double));
+      }
+   }
+
+   THROWERROR_ASSERT_MSG(!in.fail(), "Error reading entries of sparse tensor " + filename);
+
+   // one-based in the files
+   for (auto& c : columns)
+      c--;
+
+   std::shared_ptr<TensorConfig> ret;
+   if (type == tensor_io::TensorType::sbt)
+      ret = std::make_shared<TensorConfig>(std::move(dims), std::move(columns), NoiseConfig(), true);
+   else
+      ret = std::make_shared<TensorConfig>(std::move(dims), std::move(columns), std::move(values), NoiseConfig(), true);
+
+   ret->setFilename(filename);
+   return ret;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Configs/TensorConfig.h>
+
+namespace smurff { namespace mpi_dist_io
+{
+   // sparse tensor files that can be read in parts: .sdt, .sbt, .tns and .sct
+   bool is_sparse_tensor_file(const std::string& filename);
+
+   // dimensions and number of entries of the sparse tensor in filename
+   void read_sparse_header(const std::string& filename, std::vector<std::uint64_t>& dims, std::uint64_t& nnz);
+
+   // entries [begin, end) of the sparse tensor in filename
+   //
+   // the binary formats are read by offset, .sct files by the chunks that
+   // overlap the range, the .tns format is parsed completely but only the
+   // entries in the range are stored
+   std::shared_ptr<TensorConfig> read_sparse_entries(const std::string& filename, std::uint64_t begin, std::uint64_t end);
+}}
@@ -42,8 +42,13 @@ std::shared_ptr<IPriorFactory> MPISession::create_prior_factory() const
 //create mpi session
 //parses args with setFromArgs, then internally calls setFromConfig (to validate, save, set config)
 std::shared_ptr<ISession> smurff::create_mpi_session(int argc, char** argv)
+{
+   return create_mpi_session(parse_options(argc, argv));
+}
+
+std::shared_ptr<ISession> smurff::create_mpi_session(const Config& cfg)
 {
    std::shared_ptr<MPISession> session(new MPISession());
-   session->fromConfig(parse_options(argc, argv));
+   session->fromConfig(cfg);
    return session;
 }
\ No newline at end of file
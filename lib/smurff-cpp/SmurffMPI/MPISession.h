@@ -23,5 +23,6 @@ public:
 };
 
 std::shared_ptr<ISession> create_mpi_session(int argc, char** argv);
+std::shared_ptr<ISession> create_mpi_session(const Config& cfg);
 
 }
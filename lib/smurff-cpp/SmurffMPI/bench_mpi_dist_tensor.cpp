@@ -0,0 +1,115 @@
+// Distributed training on a random 3-mode sparse tensor: the tensor is
+// written once as .sdt, then every rank reads its shard (MPIDistSession::read_shard)
+// and runs Gibbs iterations with three normal priors.
+//
+// Prints the entries stored per rank, compared to the nmodes * nnz entries
+// of TensorData in a single process, and the time per iteration.
+//
+// usage: mpirun -np <nranks> bench_mpi_dist_tensor [dim] [nnz] [num-latent] [iterations] [file]
+
+#include <mpi.h>
+
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <SmurffCpp/Configs/Config.h>
+#include <SmurffCpp/DataTensors/TensorData.h>
+#include <SmurffCpp/IO/TensorIO.h>
+#include <SmurffCpp/Utils/counters.h>
+#include <SmurffCpp/Utils/LatentScheduler.h>
+
+#include <Benchmarks/bench_data.h>
+
+#include "MPIDistSession.h"
+
+using namespace smurff;
+
+int main(int argc, char** argv)
+{
+   MPI_Init(NULL, NULL);
+   int world_size, world_rank;
+   MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+   MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+   std::uint64_t dim  = argc > 1 ? std::stoull(argv[1]) : 2000;
+   std::uint64_t nnz  = argc > 2 ? std::stoull(argv[2]) : 10000000;
+   int K              = argc > 3 ? std::stoi(argv[3]) : 16;
+   int iterations     = argc > 4 ? std::stoi(argv[4]) : 5;
+   std::string file   = argc > 5 ? argv[5] : "bench_mpi_dist_tensor.sdt";
+
+   const std::vector<std::uint64_t> dims = { dim, dim / 2, dim / 4 };
+   const double sample_cost = LatentScheduler::sample_cost(K);
+
+   if (world_rank == 0)
+   {
+      std::cout << "tensor: " << dims[0] << " x " << dims[1] << " x " << dims[2] << ", " << nnz
+                << " nnz, K = " << K << ", " << world_size << " ranks" << std::endl;
+      tensor_io::write_tensor(file, random_sparse_tensor_config(dims, nnz));
+   }
+   MPI_Barrier(MPI_COMM_WORLD);
+
+   // read and redistribute
+   double start = tick();
+   std::vector<std::vector<int> > bounds;
+   auto shard = MPIDistSession::read_shard(file, sample_cost, bounds);
+   MPI_Barrier(MPI_COMM_WORLD);
+   double read_time = tick() - start;
+
+   std::vector<std::uint64_t> plane_begin, plane_end;
+   for (auto& b : bounds)
+   {
+      plane_begin.push_back(b[world_rank]);
+      plane_end.push_back(b[world_rank + 1]);
+   }
+   TensorData data(*shard, plane_begin, plane_end);
+
+   // [received entries, entries in the SparseModes]
+   std::uint64_t local[2] = { shard->getNNZ(), 0 };
+   for (std::uint64_t m = 0; m < dims.size(); m++)
+      local[1] += data.Y(m)->getNNZ();
+   shard.reset();
+
+   std::vector<std::uint64_t> all(2 * world_size);
+   MPI_Gather(local, 2, MPI_UINT64_T, all.data(), 2, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+   if (world_rank == 0)
+   {
+      std::cout << "read + redistribute: " << std::fixed << std::setprecision(3) << read_time << " s" << std::endl;
+      std::cout << std::setw(6) << "rank" << std::setw(14) << "received" << std::setw(14) << "stored"
+                << std::setw(14) << "single" << std::endl;
+      for (int r = 0; r < world_size; r++)
+         std::cout << std::setw(6) << r << std::setw(14) << all[2 * r] << std::setw(14) << all[2 * r + 1]
+                   << std::setw(14) << dims.size() * nnz << std::endl;
+   }
+
+   // Gibbs iterations
+   Config config;
+   config.setPriorTypes({ PriorTypes::normal, PriorTypes::normal, PriorTypes::normal });
+   config.setNumLatent(K);
+   config.setBurnin(iterations);
+   config.setNSamples(0);
+   config.setVerbose(0);
+   config.setRandomSeed(1234);
+
+   auto session = create_mpi_dist_session(config, file);
+   session->init();
+
+   MPI_Barrier(MPI_COMM_WORLD);
+   start = tick();
+   while (session->step())
+      ;
+   MPI_Barrier(MPI_COMM_WORLD);
+   double iter_time = (tick() - start) / iterations;
+
+   if (world_rank == 0)
+   {
+      std::cout << "time per iteration: " << std::fixed << std::setprecision(3) << iter_time << " s" << std::endl;
+      std::remove(file.c_str());
+   }
+
+   MPI_Finalize();
+   return 0;
+}
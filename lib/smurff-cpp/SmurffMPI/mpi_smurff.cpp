@@ -11,11 +11,15 @@
 #include <memory>
 #include <cmath>
 #include <stdlib.h>
+#include <vector>
 
 #include <SmurffCpp/Utils/omp_util.h>
 #include <SmurffCpp/Priors/ILatentPrior.h>
+#include <SmurffCpp/IO/GenericIO.h>
 
 #include "MPISession.h"
+#include "MPIDistSession.h"
+#include "MPIDistTensorIO.h"
 
 using namespace std;
 
@@ -65,7 +69,54 @@ int main(int argc, char** argv)
     int name_len;
     MPI_Get_processor_name(processor_name, &name_len);
 
-    auto session = smurff::create_mpi_session(argc, argv);
+    // sparse tensor train files are not read by parse_options on every rank,
+    // MPIDistSession reads them in shards
+    std::string train_file;
+    std::vector<char*> args(argv, argv + argc);
+    for (auto arg = args.begin() + 1; arg != args.end(); ++arg)
+    {
+        const std::string name(*arg);
+        if (name == "--train" && arg + 1 != args.end() && smurff::mpi_dist_io::is_sparse_tensor_file(*(arg + 1)))
+        {
+            train_file = *(arg + 1);
+            args.erase(arg, arg + 2);
+            break;
+        }
+        if (name.compare(0, 8, "--train=") == 0 && smurff::mpi_dist_io::is_sparse_tensor_file(name.substr(8)))
+        {
+            train_file = name.substr(8);
+            args.erase(arg);
+            break;
+        }
+    }
+
+    // with macau priors only the block-CG solve of beta is distributed,
+    // otherwise the columns of U are sampled in parallel by all ranks, when
+    // the distributed session supports the config
+    smurff::Config config = smurff::parse_options(args.size(), args.data());
+    auto priors = config.getPriorTypes();
+    bool has_macau = std::find(priors.begin(), priors.end(), smurff::PriorTypes::macau) != priors.end();
+    bool distributed = !has_macau && smurff::MPIDistSession::isSupported(config);
+
+    std::shared_ptr<smurff::ISession> session;
+    if (!distributed)
+    {
+        if (!train_file.empty())
+        {
+            auto train = smurff::generic_io::read_data_config(train_file, true);
+            train->setNoiseConfig(smurff::NoiseConfig(smurff::NoiseConfig::NOISE_TYPE_DEFAULT_VALUE));
+            config.setTrain(train);
+        }
+        session = smurff::create_mpi_session(config);
+    }
+    else if (!train_file.empty())
+    {
+        session = smurff::create_mpi_dist_session(config, train_file);
+    }
+    else
+    {
+        session = smurff::create_mpi_dist_session(config);
+    }
     session->run();
 
     // Finalize the MPI environment.
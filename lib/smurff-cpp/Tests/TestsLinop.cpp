@@ -1,6 +1,9 @@
 #include "catch.hpp"
 
 #include <SmurffCpp/Utils/linop.h>
+#include <SmurffCpp/Utils/Preconditioner.h>
+#include <SmurffCpp/SideInfo/SparseFeatSideInfo.h>
+#include <SmurffCpp/SideInfo/DenseDoubleFeatSideInfo.h>
 #include <SmurffCpp/Utils/Distribution.h>
 
 using namespace smurff;
@@ -159,6 +162,139 @@ TEST_CASE( "SparseFeat/solve_blockcg_1_0", "BlockCG solver (3rhs separately)" )
    }
 }
 
+// the system of SparseFeat/solve_blockcg_1_0 for the three side info types
+static std::vector<std::shared_ptr<ISideInfo> > blockcg_side_infos()
+{
+   int rows[9] = { 0, 3, 3, 2, 5, 4, 1, 2, 4 };
+   int cols[9] = { 1, 0, 2, 1, 3, 0, 1, 3, 2 };
+   std::uint32_t urows[9], ucols[9];
+   auto dense = std::make_shared<Eigen::MatrixXd>(Eigen::MatrixXd::Zero(6, 4));
+   for (int i = 0; i < 9; i++) {
+      urows[i] = rows[i];
+      ucols[i] = cols[i];
+      (*dense)(rows[i], cols[i]) = 1.0;
+   }
+
+   return {
+      std::make_shared<SparseFeatSideInfo>(std::make_shared<SparseFeat>(6, 4, 9, rows, cols)),
+      std::make_shared<SparseDoubleFeatSideInfo>(6, 4, 9, urows, ucols),
+      std::make_shared<DenseDoubleFeatSideInfo>(dense)
+   };
+}
+
+TEST_CASE( "linop/solve_blockcg_precond", "preconditioned BlockCG solver for all side info types" ) 
+{
+   Eigen::MatrixXd B(3, 4), X_true(3, 4);
+ 
+   B << 0.56,  0.55,  0.3 , -1.78,
+        0.34,  0.05, -1.48,  1.11,
+        0.09,  0.51, -0.63,  1.59;
+ 
+   X_true << 0.35555556,  0.40709677, -0.16444444, -0.87483871,
+             1.69333333, -0.12709677, -1.94666667,  0.49483871,
+             0.66      , -0.04064516, -0.78      ,  0.65225806;
+
+   for (auto side_info : blockcg_side_infos()) {
+      for (auto type : { PreconditionerTypes::none, PreconditionerTypes::jacobi, PreconditionerTypes::block_jacobi, PreconditionerTypes::ichol }) {
+         linop::BlockCGParams params;
+         params.preconditioner = side_info->create_preconditioner(type);
+         REQUIRE( (type == PreconditionerTypes::none) == !params.preconditioner );
+
+         Eigen::MatrixXd X(3, 4);
+         double residual = 1.0;
+         side_info->solve_blockcg(X, 0.5, B, 1e-6, 32, 8, params, residual);
+         REQUIRE( residual < 1e-6 );
+         for (int i = 0; i < X.rows(); i++) {
+           for (int j = 0; j < X.cols(); j++) {
+             REQUIRE( X(i,j) == Approx(X_true(i,j)) );
+           }
+         }
+      }
+   }
+}
+
+TEST_CASE( "linop/block_jacobi_precond/fail", "failed Cholesky of a block-Jacobi block is thrown after the parallel loop" ) 
+{
+   // two blocks of two columns, F'F + reg is not positive definite for reg < 0
+   Eigen::MatrixXd F = Eigen::MatrixXd::Identity(4, 4);
+
+   const int block_size = Preconditioner::BLOCK_SIZE;
+   Preconditioner::BLOCK_SIZE = 2;
+   BlockJacobiPreconditioner precond(F);
+   Preconditioner::BLOCK_SIZE = block_size;
+
+   REQUIRE_THROWS( precond.update(-2.0) );
+   REQUIRE_NOTHROW( precond.update(0.5) );
+}
+
+TEST_CASE( "linop/solve_blockcg_warm_start", "BlockCG solver starting from the solution or limited to one iteration" ) 
+{
+   Eigen::MatrixXd B(1, 4), X(1, 4), X_true(1, 4);
+ 
+   B << 0.56,  0.55,  0.3 , -1.78;
+   X_true << 0.35555556,  0.40709677, -0.16444444, -0.87483871;
+
+   auto side_info = blockcg_side_infos().front();
+
+   linop::BlockCGParams params;
+   double residual;
+
+   // from zero, stopped after one iteration
+   params.max_iter = 1;
+   REQUIRE( side_info->solve_blockcg(X, 0.5, B, 1e-6, 32, 8, params, residual) == 1 );
+   REQUIRE( residual > 1e-6 );
+
+   // continue from there
+   params.max_iter = 10;
+   params.warm_start = true;
+   side_info->solve_blockcg(X, 0.5, B, 1e-6, 32, 8, params, residual);
+   REQUIRE( residual < 1e-6 );
+   for (int j = 0; j < X.cols(); j++) {
+     REQUIRE( X(0,j) == Approx(X_true(0,j)) );
+   }
+
+   // already at the solution
+   X = X_true;
+   REQUIRE( side_info->solve_blockcg(X, 0.5, B, 1e-6, 32, 8, params, residual) == 0 );
+   REQUIRE( residual < 1e-6 );
+   for (int j = 0; j < X.cols(); j++) {
+     REQUIRE( X(0,j) == Approx(X_true(0,j)) );
+   }
+}
+
+TEST_CASE( "linop/solve_blockcg_parallel_blocks", "BlockCG solver with the blocks of right-hand sides in parallel" ) 
+{
+   init_bmrng(12345);
+   // more features than samples, like side info
+   Eigen::MatrixXd K(100, 1000);
+   Eigen::MatrixXd B(10, 1000);
+   bmrandn(K);
+   bmrandn(B);
+
+   // blocks of 4 and 6 right-hand sides
+   Eigen::MatrixXd X_seq(10, 1000), X_par(10, 1000);
+   linop::BlockCGParams params;
+   params.max_iter = 100;
+   double residual_seq, residual_par;
+
+   smurff::linop::solve_blockcg(X_seq, K, 0.5, B, 1e-8, 4, 2, params, residual_seq);
+   params.parallel_blocks = true;
+   smurff::linop::solve_blockcg(X_par, K, 0.5, B, 1e-8, 4, 2, params, residual_par);
+
+   REQUIRE( residual_seq < 1e-8 );
+   REQUIRE( residual_par < 1e-8 );
+
+   Eigen::MatrixXd KtK = K.transpose() * K;
+   KtK.diagonal().array() += 0.5;
+   Eigen::MatrixXd X_true = KtK.llt().solve(B.transpose()).transpose();
+   for (int i = 0; i < X_true.rows(); i++) {
+     for (int j = 0; j < X_true.cols(); j++) {
+       REQUIRE( X_seq(i,j) == Approx(X_true(i,j)).epsilon(1e-4) );
+       REQUIRE( X_par(i,j) == Approx(X_true(i,j)).epsilon(1e-4) );
+     }
+   }
+}
+
 TEST_CASE( "MatrixXd/compute_uhat", "compute_uhat for MatrixXd" ) {
    Eigen::MatrixXd beta(2, 4), feat(6, 4), uhat(2, 6), uhat_true(2, 6);
    beta << 0.56,  0.55,  0.3 , -1.78,
@@ -247,6 +383,27 @@ TEST_CASE( "linop/A_mul_At_omp", "A_mul_At with OpenMP" )
    REQUIRE( AAt(1,0) == Approx(AAt_true(1,0)) );
 }
 
+TEST_CASE( "linop/A_mul_Bt_omp_sym", "symmetric A_mul_Bt with OpenMP over several tiles" ) 
+{
+   init_bmrng(12345);
+   Eigen::MatrixXd A(5, 1000);
+   Eigen::MatrixXd S(1000, 1000);
+   bmrandn(A);
+   bmrandn(S);
+   // B = A * (S + S') makes A * B' symmetric
+   Eigen::MatrixXd B = A * (S + S.transpose());
+
+   Eigen::MatrixXd ABt(5, 5);
+   smurff::linop::A_mul_Bt_omp_sym(ABt, A, B);
+   Eigen::MatrixXd ABt_true = A * B.transpose();
+
+   for (int i = 0; i < 5; i++) {
+     for (int j = 0; j <= i; j++) {
+       REQUIRE( ABt(i,j) == Approx(ABt_true(i,j)) );
+     }
+   }
+}
+
 TEST_CASE( "linop/A_mul_At_combo", "A_mul_At with OpenMP (returning matrix)" ) 
 {
    init_bmrng(12345);
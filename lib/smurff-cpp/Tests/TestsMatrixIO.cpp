@@ -1,6 +1,10 @@
 #include "catch.hpp"
 
 #include <sstream>
+#include <fstream>
+#include <iterator>
+#include <iomanip>
+#include <cmath>
 #include <cstdio>
 
 #include <Eigen/Core>
@@ -8,6 +12,8 @@
 
 #include <SmurffCpp/Utils/MatrixUtils.h>
 #include <SmurffCpp/IO/MatrixIO.h>
+#include <SmurffCpp/IO/TextIO.h>
+#include <SmurffCpp/Utils/omp_util.h>
 
 using namespace smurff;
 
@@ -612,6 +618,37 @@ TEST_CASE("matrix_io/eigen::read_matrix | matrix_io/eigen::write_matrix | except
    }
 }
 
+TEST_CASE("matrix_io/eigen::map_dense_float64_bin | matrix_io/eigen::write_matrix | .ddm")
+{
+   std::string matrixFilename = "mappedMatrix.ddm";
+
+   Eigen::MatrixXd expectedMatrix(3, 4);
+   expectedMatrix << 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12;
+   matrix_io::eigen::write_matrix(matrixFilename, expectedMatrix);
+
+   {
+      MappedFile file(matrixFilename);
+      Eigen::MatrixXd actualMatrix = matrix_io::eigen::map_dense_float64_bin(file);
+      REQUIRE(matrix_utils::equals(actualMatrix, expectedMatrix));
+   }
+
+   // truncated file: last value missing
+   {
+      std::ifstream in(matrixFilename, std::ios_base::binary);
+      std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      in.close();
+
+      std::ofstream out(matrixFilename, std::ios_base::binary);
+      out.write(content.data(), content.size() - sizeof(double));
+      out.close();
+
+      MappedFile file(matrixFilename);
+      REQUIRE_THROWS(matrix_io::eigen::map_dense_float64_bin(file));
+   }
+
+   std::remove(matrixFilename.c_str());
+}
+
 // ===
 
 TEST_CASE("matrix_io/eigen::read_dense_float64_bin | matrix_io/eigen::write_dense_float64_bin")
@@ -792,6 +829,83 @@ TEST_CASE("matrix_io/eigen::read_matrix_market | matrix_io/eigen::write_matrix_m
    }
 }
 
+TEST_CASE("text_io/parse")
+{
+   auto parse_double = [](const std::string& text, double& value)
+   {
+      const char* p = text.data();
+      return text_io::parse(p, text.data() + text.size(), value) && text_io::at_end(p, text.data() + text.size());
+   };
+
+   auto parse_uint32 = [](const std::string& text, std::uint32_t& value)
+   {
+      const char* p = text.data();
+      return text_io::parse(p, text.data() + text.size(), value) && text_io::at_end(p, text.data() + text.size());
+   };
+
+   // fast path and strtod give the same doubles
+   for (std::string text : { "0", "-0.5", "1.5", " 42 ", "3.14159265358979", "-2e-3", "1E+5", "0.1", "123456789012345678901234",
+                             "1e300", "-4.9406564584124654e-324", "2.2250738585072014e-308", "0.30000000000000004", "inf", "-nan" })
+   {
+      double value;
+      REQUIRE(parse_double(text, value));
+      double expected = std::strtod(text.c_str(), nullptr);
+      if (std::isnan(expected))
+         REQUIRE(std::isnan(value));
+      else
+         REQUIRE(value == expected);
+   }
+
+   for (std::string text : { "", "-", ".", "1.5x", "1e", "abc", "1..2" })
+   {
+      double value;
+      REQUIRE(!parse_double(text, value));
+   }
+
+   std::uint32_t index;
+   REQUIRE(parse_uint32("4294967295", index));
+   REQUIRE(index == 4294967295u);
+   REQUIRE(!parse_uint32("4294967296", index));
+   REQUIRE(!parse_uint32("-1", index));
+   REQUIRE(!parse_uint32("1.0", index));
+}
+
+TEST_CASE("matrix_io/read_matrix_market | parallel")
+{
+   // large enough for one chunk per thread
+   const std::uint32_t nnz = 100000;
+   std::vector<std::uint32_t> expectedRows(nnz), expectedCols(nnz);
+   std::vector<double> expectedVals(nnz);
+
+   std::stringstream matrixStream;
+   matrixStream << "%%MatrixMarket matrix coordinate real general\n% comment\n\n" << nnz << " " << nnz << " " << nnz << "\n";
+   matrixStream << std::setprecision(17);
+   for (std::uint32_t i = 0; i < nnz; i++)
+   {
+      expectedRows[i] = (i * 7919u) % nnz;
+      expectedCols[i] = i;
+      expectedVals[i] = (i - 50000.0) / 3.0;
+      matrixStream << expectedRows[i] + 1 << "\t" << expectedCols[i] + 1 << " " << expectedVals[i] << "\r\n";
+      if (i % 1000 == 0)
+         matrixStream << "% comment\n\n";
+   }
+
+   int max_threads = threads::get_max_threads();
+   threads::init(0, 4);
+   std::string text = matrixStream.str();
+   std::shared_ptr<MatrixConfig> actualMatrixConfig = matrix_io::read_matrix_market(text.data(), text.data() + text.size(), false);
+   threads::init(0, max_threads);
+
+   REQUIRE(actualMatrixConfig->getNNZ() == nnz);
+   REQUIRE(actualMatrixConfig->getRows() == expectedRows);
+   REQUIRE(actualMatrixConfig->getCols() == expectedCols);
+   REQUIRE(actualMatrixConfig->getValues() == expectedVals);
+
+   // one entry missing
+   std::string truncated = text.substr(0, text.rfind('\n', text.size() - 2) + 1);
+   REQUIRE_THROWS(matrix_io::read_matrix_market(truncated.data(), truncated.data() + truncated.size(), false));
+}
+
 TEST_CASE("Genereate matrices for Python matrix_io tests", "[!hide]")
 {
    std::uint64_t denseMatrixConfigNRow = 3;
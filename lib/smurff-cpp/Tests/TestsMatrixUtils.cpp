@@ -1,5 +1,7 @@
 #include "catch.hpp"
 
+#include <algorithm>
+
 #include <Eigen/Core>
 
 #include <SmurffCpp/Configs/TensorConfig.h>
@@ -241,3 +243,115 @@ TEST_CASE("matrix_utils::slice : 5D tensor")
       REQUIRE(matrix_utils::equals(actualTensorSlice, expectedTensorSlice));
    }
 }
+
+TEST_CASE("tensor_utils::partition : balance")
+{
+   // skewed entries per index, with one index heavier than a fair share
+   std::vector<std::vector<double> > counts = { std::vector<double>(20), std::vector<double>(7) };
+   for (std::size_t n = 0; n < counts[0].size(); n++)
+      counts[0][n] = (n * 7) % 5;
+   counts[0][3] = 60;
+   for (std::size_t n = 0; n < counts[1].size(); n++)
+      counts[1][n] = n;
+
+   const double sample_cost = 1.5;
+   for (int nparts = 1; nparts <= 7; nparts++)
+   {
+      auto bounds = tensor_utils::partition(counts, nparts, sample_cost);
+      REQUIRE(bounds.size() == counts.size());
+
+      for (std::size_t m = 0; m < counts.size(); m++)
+      {
+         const auto& b = bounds[m];
+         const int dim = counts[m].size();
+
+         // contiguous non-empty ranges that cover all indices
+         REQUIRE(b.size() == (std::size_t)nparts + 1);
+         REQUIRE(b.front() == 0);
+         REQUIRE(b.back() == dim);
+         for (int p = 0; p < nparts; p++)
+            REQUIRE(b[p] < b[p + 1]);
+
+         // no part takes more than its share plus one index
+         double total = 0.0, heaviest = 0.0;
+         for (auto c : counts[m])
+         {
+            total += c + sample_cost;
+            heaviest = std::max(heaviest, c + sample_cost);
+         }
+
+         for (int p = 0; p < nparts; p++)
+         {
+            double cost = 0.0;
+            for (int n = b[p]; n < b[p + 1]; n++)
+               cost += counts[m][n] + sample_cost;
+            REQUIRE(cost <= total / nparts + heaviest);
+         }
+      }
+   }
+
+   REQUIRE_THROWS(tensor_utils::partition(counts, 8, sample_cost));
+}
+
+TEST_CASE("tensor_utils::slice_part : every part has all entries of its ranges")
+{
+   const std::vector<std::uint64_t> dims = { 6, 9, 4 };
+   const std::uint64_t nnz = 120;
+   std::vector<std::uint32_t> columns(dims.size() * nnz);
+   std::vector<double> values(nnz);
+   for (std::uint64_t i = 0; i < nnz; i++)
+   {
+      for (std::uint64_t m = 0; m < dims.size(); m++)
+         columns[m * nnz + i] = (i * (m + 3) + i / (m + 2)) % dims[m];
+      values[i] = i;
+   }
+   TensorConfig train(dims, columns, values, fixed_ncfg, true);
+
+   // entries per index of every mode
+   std::vector<std::vector<double> > counts(dims.size());
+   for (std::uint64_t m = 0; m < dims.size(); m++)
+   {
+      counts[m].resize(dims[m], 0.0);
+      for (std::uint64_t i = 0; i < nnz; i++)
+         counts[m][columns[m * nnz + i]] += 1.0;
+   }
+
+   const int nparts = 3;
+   auto bounds = tensor_utils::partition(train, nparts, 2.0);
+   REQUIRE(bounds == tensor_utils::partition(counts, nparts, 2.0));
+
+   for (int p = 0; p < nparts; p++)
+   {
+      auto part = tensor_utils::slice_part(train, bounds, p);
+      REQUIRE(part->getDims() == dims);
+      REQUIRE(part->getNModes() == dims.size());
+
+      const auto& part_columns = part->getColumns();
+      const auto& part_values = part->getValues();
+      const std::uint64_t part_nnz = part->getNNZ();
+
+      // only entries of the part, with the value they have in train
+      std::vector<std::vector<double> > part_counts(dims.size());
+      for (std::uint64_t m = 0; m < dims.size(); m++)
+         part_counts[m].resize(dims[m], 0.0);
+
+      for (std::uint64_t j = 0; j < part_nnz; j++)
+      {
+         bool in_part = false;
+         const std::uint64_t i = part_values[j];
+         for (std::uint64_t m = 0; m < dims.size(); m++)
+         {
+            const int c = part_columns[m * part_nnz + j];
+            REQUIRE(c == (int)columns[m * nnz + i]);
+            in_part = in_part || (bounds[m][p] <= c && c < bounds[m][p + 1]);
+            part_counts[m][c] += 1.0;
+         }
+         REQUIRE(in_part);
+      }
+
+      // every index of the ranges of the part has all its entries
+      for (std::uint64_t m = 0; m < dims.size(); m++)
+         for (int c = bounds[m][p]; c < bounds[m][p + 1]; c++)
+            REQUIRE(part_counts[m][c] == counts[m][c]);
+   }
+}
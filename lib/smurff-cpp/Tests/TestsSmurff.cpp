@@ -9,6 +9,8 @@
 #include <SmurffCpp/Utils/MatrixUtils.h>
 #include <SmurffCpp/Utils/RootFile.h>
 #include <SmurffCpp/Predict/PredictSession.h>
+#include <SmurffCpp/Predict/SampleCache.h>
+#include <SmurffCpp/Predict/StackedSamples.h>
 #include <SmurffCpp/result.h>
 
 /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2897,6 +2899,61 @@ TEST_CASE(
    REQUIRE_RESULT_ITEMS(tensorRunResults, matrixRunResults);
 }
 
+//
+//      train: sparse matrix
+//       test: sparse matrix
+//     priors: macau macau
+//  side-info: row_side_info_dense_matrix col_side_info_dense_matrix
+// num-latent: 4
+//     burnin: 50
+//   nsamples: 50
+//    verbose: 0
+//       seed: 1234
+//    threads: 1 (same order of random draws)
+//
+TEST_CASE(
+   "sequential vs pipelined step"
+   "--train <train_sparse_matrix> --test <test_sparse_matrix> --prior macau macau --side-info <row_side_info_dense_matrix> <col_side_info_dense_matrix> --num-latent 4 --burnin 50 --nsamples 50 --verbose 0 --seed 1234 --num-threads 1"
+   "--train <train_sparse_matrix> --test <test_sparse_matrix> --prior macau macau --side-info <row_side_info_dense_matrix> <col_side_info_dense_matrix> --num-latent 4 --burnin 50 --nsamples 50 --verbose 0 --seed 1234 --num-threads 1 --pipeline-step 1"
+   , HIDE_VS_TESTS)
+{
+   std::shared_ptr<MatrixConfig> trainSparseMatrixConfig = getTrainSparseMatrixConfig();
+   std::shared_ptr<MatrixConfig> testSparseMatrixConfig = getTestSparseMatrixConfig();
+   std::shared_ptr<SideInfoConfig> rowSideInfoDenseMatrixConfig = getRowSideInfoDenseConfig();
+   std::shared_ptr<SideInfoConfig> colSideInfoDenseMatrixConfig = getColSideInfoDenseConfig();
+
+   Config sequentialRunConfig;
+   sequentialRunConfig.setTrain(trainSparseMatrixConfig);
+   sequentialRunConfig.setTest(testSparseMatrixConfig);
+   sequentialRunConfig.setPriorTypes({PriorTypes::macau, PriorTypes::macau});
+   sequentialRunConfig.addSideInfoConfig(0, rowSideInfoDenseMatrixConfig);
+   sequentialRunConfig.addSideInfoConfig(1, colSideInfoDenseMatrixConfig);
+   sequentialRunConfig.setNumLatent(4);
+   sequentialRunConfig.setBurnin(50);
+   sequentialRunConfig.setNSamples(50);
+   sequentialRunConfig.setVerbose(false);
+   sequentialRunConfig.setRandomSeed(1234);
+   sequentialRunConfig.setNumThreads(1);
+
+   Config pipelinedRunConfig = sequentialRunConfig;
+   pipelinedRunConfig.setPipelineStep(true);
+
+   std::shared_ptr<ISession> sequentialRunSession = SessionFactory::create_session(sequentialRunConfig);
+   sequentialRunSession->run();
+
+   std::shared_ptr<ISession> pipelinedRunSession = SessionFactory::create_session(pipelinedRunConfig);
+   pipelinedRunSession->run();
+
+   double sequentialRunRmseAvg = sequentialRunSession->getRmseAvg();
+   const std::vector<ResultItem> & sequentialRunResults = sequentialRunSession->getResultItems();
+
+   double pipelinedRunRmseAvg = pipelinedRunSession->getRmseAvg();
+   const std::vector<ResultItem> & pipelinedRunResults = pipelinedRunSession->getResultItems();
+
+   REQUIRE(pipelinedRunRmseAvg == Approx(sequentialRunRmseAvg).epsilon(APPROX_EPSILON));
+   REQUIRE_RESULT_ITEMS(pipelinedRunResults, sequentialRunResults);
+}
+
 TEST_CASE("PredictSession")
 {
    std::shared_ptr<MatrixConfig> trainDenseMatrixConfig = getTrainDenseMatrixConfig();
@@ -2929,6 +2986,12 @@ TEST_CASE("PredictSession")
 
        // std::cout << "Prediction from RootFile RMSE: " << result->rmse_avg << std::endl;
        REQUIRE(session->getRmseAvg()  == Approx(result->rmse_avg).epsilon(APPROX_EPSILON));
+
+       // test predict one element from the mapped model files
+       const ResultItem& expected = result->m_predictions.at(0);
+       ResultItem actual = s.predict(expected.coords);
+       REQUIRE(actual.pred_all.size() == expected.pred_all.size());
+       REQUIRE(actual.pred_avg == Approx(expected.pred_avg).epsilon(APPROX_EPSILON));
     }
 
     {
@@ -2940,3 +3003,335 @@ TEST_CASE("PredictSession")
         REQUIRE(session->getRmseAvg()  == Approx(result->rmse_avg).epsilon(APPROX_EPSILON));
     }
 }
+
+TEST_CASE("PredictSession | reordered", "a reordered session saves its model in the original ids")
+{
+   std::shared_ptr<MatrixConfig> trainSparseMatrixConfig = getTrainSparseMatrixConfig();
+   std::shared_ptr<MatrixConfig> testSparseMatrixConfig = getTestSparseMatrixConfig();
+   std::shared_ptr<SideInfoConfig> rowSideInfoDenseMatrixConfig = getRowSideInfoDenseConfig();
+
+   for (ReorderTypes type : { ReorderTypes::degree, ReorderTypes::rcm })
+   {
+      Config config;
+      config.setTrain(trainSparseMatrixConfig);
+      config.setTest(testSparseMatrixConfig);
+      config.setPriorTypes({PriorTypes::macau, PriorTypes::normal});
+      config.addSideInfoConfig(0, rowSideInfoDenseMatrixConfig);
+      config.setNumLatent(4);
+      config.setBurnin(10);
+      config.setNSamples(10);
+      config.setVerbose(false);
+      config.setRandomSeed(1234);
+      config.setSaveFreq(1);
+      config.setReorderType(type);
+
+      std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+      session->run();
+
+      // test items stay in the original ids
+      const std::vector<ResultItem>& sessionResults = session->getResultItems();
+      for (std::uint64_t i = 0; i < sessionResults.size(); i++)
+         REQUIRE(sessionResults[i].coords == testSparseMatrixConfig->get(i).first);
+
+      PredictSession s(std::make_shared<RootFile>(session->getRootFile()->getRootFileName()));
+      auto result = s.predict(config.getTest());
+
+      REQUIRE(session->getRmseAvg() == Approx(result->rmse_avg).epsilon(APPROX_EPSILON));
+      for (std::uint64_t i = 0; i < sessionResults.size(); i++)
+         REQUIRE(result->m_predictions[i].pred_avg == Approx(sessionResults[i].pred_avg).epsilon(APPROX_EPSILON));
+   }
+}
+
+TEST_CASE("PredictSession | sample cache", "predictions from cached, mapped and evicted samples are the same")
+{
+   std::shared_ptr<MatrixConfig> trainDenseMatrixConfig = getTrainDenseMatrixConfig();
+   std::shared_ptr<MatrixConfig> testSparseMatrixConfig = getTestSparseMatrixConfig();
+
+   Config config;
+   config.setTrain(trainDenseMatrixConfig);
+   config.setTest(testSparseMatrixConfig);
+   config.setPriorTypes({PriorTypes::normal, PriorTypes::normal});
+   config.setNumLatent(4);
+   config.setBurnin(10);
+   config.setNSamples(10);
+   config.setVerbose(false);
+   config.setRandomSeed(1234);
+   config.setSaveFreq(1);
+
+   std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+   session->run();
+
+   auto rf = std::make_shared<RootFile>(session->getRootFile()->getRootFileName());
+
+   // reference: every sample read from its step file
+   std::vector<ResultItem> expected;
+   {
+      PredictSession s(rf);
+      auto stepfiles = rf->openSampleStepFiles();
+      for (std::uint64_t i = 0; i < testSparseMatrixConfig->getNNZ(); i++)
+      {
+         ResultItem item{testSparseMatrixConfig->get(i).first};
+         for (const auto& sf : stepfiles)
+            s.predict(item, *sf);
+         expected.push_back(item);
+      }
+   }
+
+   for (bool mapped : { false, true })
+   {
+      PredictSession s(rf);
+      s.setCacheMapped(mapped);
+      s.preload();
+
+      const std::uint64_t sample_bytes = s.getCache()->bytes() / s.getNumSteps();
+      REQUIRE(s.getCache()->numCached() == (std::size_t)s.getNumSteps());
+      REQUIRE(s.getCache()->isMapped() == mapped);
+
+      for (const auto& e : expected)
+      {
+         ResultItem actual = s.predict(e.coords);
+         REQUIRE(actual.pred_all.size() == e.pred_all.size());
+         REQUIRE(actual.pred_avg == Approx(e.pred_avg).epsilon(APPROX_EPSILON));
+         REQUIRE(actual.var == Approx(e.var).epsilon(APPROX_EPSILON));
+      }
+
+      // every single prediction was served from the cache
+      REQUIRE(s.getCache()->getMisses() == 0);
+      REQUIRE(s.getCache()->getHits() == expected.size() * s.getNumSteps());
+
+      // room for three samples: the first pass reads every sample
+      s.setCacheBudget(3 * sample_bytes);
+      std::vector<ResultItem> batch;
+      for (const auto& e : expected)
+         batch.push_back(ResultItem{e.coords});
+      s.predict(batch);
+
+      REQUIRE(s.getCache()->numCached() == 3);
+      REQUIRE(s.getCache()->bytes() <= s.getCache()->getBudget());
+      REQUIRE(s.getCache()->getMisses() == (std::uint64_t)s.getNumSteps());
+
+      // room for half of the samples: the next passes are served in part
+      // from the cache, as the samples are used in order
+      s.setCacheBudget(s.getNumSteps() / 2 * sample_bytes);
+      for (int pass = 0; pass < 3; pass++)
+      {
+         std::vector<ResultItem> again;
+         for (const auto& e : expected)
+            again.push_back(ResultItem{e.coords});
+         s.predict(again);
+      }
+
+      REQUIRE(s.getCache()->getHits() > 0);
+      REQUIRE(s.getCache()->getMisses() < 3 * (std::uint64_t)s.getNumSteps());
+      REQUIRE(s.getCache()->bytes() <= s.getCache()->getBudget());
+
+      for (std::uint64_t i = 0; i < expected.size(); i++)
+      {
+         REQUIRE(batch[i].pred_all.size() == expected[i].pred_all.size());
+         REQUIRE(batch[i].pred_avg == Approx(expected[i].pred_avg).epsilon(APPROX_EPSILON));
+         REQUIRE(batch[i].var == Approx(expected[i].var).epsilon(APPROX_EPSILON));
+      }
+
+      // the same as the predictions of the full test set
+      auto result = s.predict(config.getTest());
+      REQUIRE(session->getRmseAvg() == Approx(result->rmse_avg).epsilon(APPROX_EPSILON));
+
+      // out of range
+      PVec<> dims = s.getModelDims();
+      REQUIRE_THROWS(s.predict(dims));
+   }
+}
+
+TEST_CASE("PredictSession | stacked samples", "predictions of all samples at once are the same as per sample")
+{
+   std::shared_ptr<TensorConfig> testSparseTensor3dConfig = getTestSparseTensor3dConfig();
+
+   Config config;
+   config.setTrain(getTrainDenseTensor3dConfig());
+   config.setTest(testSparseTensor3dConfig);
+   config.setPriorTypes({PriorTypes::normal, PriorTypes::normal, PriorTypes::normal});
+   config.setNumLatent(4);
+   config.setBurnin(10);
+   config.setNSamples(10);
+   config.setVerbose(false);
+   config.setRandomSeed(1234);
+   config.setSaveFreq(1);
+
+   std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+   session->run();
+
+   auto rf = std::make_shared<RootFile>(session->getRootFile()->getRootFileName());
+
+   // reference: one sample at a time
+   std::vector<ResultItem> expected;
+   std::vector<PVec<> > coords;
+   {
+      PredictSession s(rf);
+      s.setCacheBudget(0);
+      for (std::uint64_t i = 0; i < testSparseTensor3dConfig->getNNZ(); i++)
+         expected.push_back(ResultItem{testSparseTensor3dConfig->get(i).first});
+      s.predict(expected);
+
+      REQUIRE(s.getCache()->numCached() == 0);
+   }
+
+   // coordinates out of order, every first-mode entity more than once
+   for (auto it = expected.rbegin(); it != expected.rend(); ++it)
+      coords.push_back(it->coords);
+
+   PredictSession s(rf);
+   auto stacked = s.getStackedSamples();
+   REQUIRE(stacked->nsamples() == s.getNumSteps());
+
+   // the panels take the place of the cached samples in the budget
+   REQUIRE(s.getCache()->numCached() == 0);
+   REQUIRE(s.getCache()->getReserved() == stacked->bytes());
+   REQUIRE(stacked->nlatent() == 4);
+   REQUIRE(stacked->getDims() == s.getModelDims());
+
+   std::vector<ResultItem> actual;
+   for (const auto& e : expected)
+      actual.push_back(ResultItem{e.coords});
+   s.predict(actual);
+
+   for (std::uint64_t i = 0; i < expected.size(); i++)
+   {
+      REQUIRE(actual[i].pred_all.size() == expected[i].pred_all.size());
+      for (std::uint64_t j = 0; j < expected[i].pred_all.size(); j++)
+         REQUIRE(actual[i].pred_all[j] == Approx(expected[i].pred_all[j]).epsilon(APPROX_EPSILON));
+      REQUIRE(actual[i].pred_1sample == Approx(expected[i].pred_1sample).epsilon(APPROX_EPSILON));
+      REQUIRE(actual[i].pred_avg == Approx(expected[i].pred_avg).epsilon(APPROX_EPSILON));
+      REQUIRE(actual[i].var == Approx(expected[i].var).epsilon(APPROX_EPSILON));
+   }
+
+   // one element after the batch: from the panels, no sample is read again
+   const std::uint64_t misses = s.getCache()->getMisses();
+   ResultItem single = s.predict(expected.front().coords);
+   REQUIRE(s.getCache()->getMisses() == misses);
+   REQUIRE(single.pred_all.size() == expected.front().pred_all.size());
+   REQUIRE(single.pred_avg == Approx(expected.front().pred_avg).epsilon(APPROX_EPSILON));
+   REQUIRE(single.var == Approx(expected.front().var).epsilon(APPROX_EPSILON));
+
+   auto result = s.predict(config.getTest());
+   REQUIRE(result->sample_iter == s.getNumSteps());
+   REQUIRE(session->getRmseAvg() == Approx(result->rmse_avg).epsilon(APPROX_EPSILON));
+
+   Eigen::VectorXd mean, var;
+   Eigen::MatrixXd quantiles;
+   s.predict(coords, {0.0, 0.5, 1.0}, mean, var, quantiles);
+   REQUIRE(quantiles.rows() == (Eigen::Index)coords.size());
+   REQUIRE(quantiles.cols() == 3);
+
+   for (std::uint64_t i = 0; i < coords.size(); i++)
+   {
+      const ResultItem& e = expected[expected.size() - 1 - i];
+      std::vector<double> sorted = e.pred_all;
+      std::sort(sorted.begin(), sorted.end());
+
+      REQUIRE(mean(i) == Approx(e.pred_avg).epsilon(APPROX_EPSILON));
+      REQUIRE(var(i) == Approx(e.var).epsilon(APPROX_EPSILON));
+      REQUIRE(quantiles(i, 0) == Approx(sorted.front()).epsilon(APPROX_EPSILON));
+      REQUIRE(quantiles(i, 1) == Approx((sorted[4] + sorted[5]) / 2).epsilon(APPROX_EPSILON));
+      REQUIRE(quantiles(i, 2) == Approx(sorted.back()).epsilon(APPROX_EPSILON));
+   }
+
+   REQUIRE_THROWS(s.predict(coords, {1.5}, mean, var, quantiles));
+   REQUIRE_THROWS(s.predict(std::vector<PVec<> >{s.getModelDims()}, {}, mean, var, quantiles));
+
+   // no room for the panels: the same statistics one sample at a time
+   PredictSession unstacked(rf);
+   unstacked.setCacheBudget(0);
+
+   Eigen::VectorXd unstacked_mean, unstacked_var;
+   Eigen::MatrixXd unstacked_quantiles;
+   unstacked.predict(coords, {0.0, 0.5, 1.0}, unstacked_mean, unstacked_var, unstacked_quantiles);
+   REQUIRE(unstacked.getCache()->getReserved() == 0);
+   REQUIRE(unstacked_quantiles.rows() == quantiles.rows());
+   REQUIRE(unstacked_quantiles.cols() == quantiles.cols());
+
+   for (std::uint64_t i = 0; i < coords.size(); i++)
+   {
+      REQUIRE(unstacked_mean(i) == Approx(mean(i)).epsilon(APPROX_EPSILON));
+      REQUIRE(unstacked_var(i) == Approx(var(i)).epsilon(APPROX_EPSILON));
+      for (int q = 0; q < quantiles.cols(); q++)
+         REQUIRE(unstacked_quantiles(i, q) == Approx(quantiles(i, q)).epsilon(APPROX_EPSILON));
+   }
+
+   REQUIRE_THROWS(unstacked.predict(coords, {1.5}, mean, var, quantiles));
+   REQUIRE_THROWS(unstacked.predict(std::vector<PVec<> >{s.getModelDims()}, {}, mean, var, quantiles));
+}
+
+TEST_CASE("PredictSession | top-N", "top-N columns by posterior mean and upper confidence bound")
+{
+   Config config;
+   config.setTrain(getTrainDenseMatrixConfig());
+   config.setTest(getTestSparseMatrixConfig());
+   config.setPriorTypes({PriorTypes::normal, PriorTypes::normal});
+   config.setNumLatent(4);
+   config.setBurnin(10);
+   config.setNSamples(10);
+   config.setVerbose(false);
+   config.setRandomSeed(1234);
+   config.setSaveFreq(1);
+
+   std::shared_ptr<ISession> session = SessionFactory::create_session(config);
+   session->run();
+
+   PredictSession s(std::make_shared<RootFile>(session->getRootFile()->getRootFileName()));
+   s.preload();
+
+   const int nrows = config.getTrain()->getDims()[0];
+   const int ncols = config.getTrain()->getDims()[1];
+   const std::vector<int> rows = { 2, 0, 1, 2 };
+
+   // excluded entries (0, 1) and (2, 3), twice
+   NoiseConfig ncfg(NoiseTypes::fixed);
+   auto exclude = std::make_shared<MatrixConfig>(nrows, ncols,
+      std::vector<std::uint32_t>{ 0, 2, 2 }, std::vector<std::uint32_t>{ 1, 3, 3 }, ncfg, false);
+
+   for (double ucb : { 0.0, 1.5 })
+   {
+      auto all = s.topN(rows, ncols + 1, ucb);
+      auto top2 = s.topN(rows, 2, ucb);
+      auto excluded = s.topN(rows, ncols, ucb, exclude);
+      REQUIRE(all.size() == rows.size());
+
+      for (std::size_t q = 0; q < rows.size(); q++)
+      {
+         REQUIRE(all[q].size() == (std::size_t)ncols);
+         REQUIRE(top2[q].size() == 2);
+
+         // mean and std of every column from the single predictions
+         for (const auto& item : all[q])
+         {
+            ResultItem expected = s.predict(PVec<>({ rows[q], (int)item.col }));
+            const double sd = std::sqrt(expected.var / (expected.pred_all.size() - 1));
+
+            REQUIRE(item.mean == Approx(expected.pred_avg).epsilon(APPROX_EPSILON));
+            REQUIRE(item.std == Approx(sd).epsilon(APPROX_EPSILON));
+            REQUIRE(item.score == Approx(expected.pred_avg + ucb * sd).epsilon(APPROX_EPSILON));
+         }
+
+         for (std::size_t i = 1; i < all[q].size(); i++)
+            REQUIRE(all[q][i - 1].score >= all[q][i].score);
+
+         for (std::size_t i = 0; i < 2; i++)
+            REQUIRE(top2[q][i].col == all[q][i].col);
+
+         // the others in order
+         std::vector<std::uint32_t> expected_cols;
+         for (const auto& item : all[q])
+            if (!(rows[q] == 0 && item.col == 1) && !(rows[q] == 2 && item.col == 3))
+               expected_cols.push_back(item.col);
+
+         REQUIRE(excluded[q].size() == expected_cols.size());
+         for (std::size_t i = 0; i < expected_cols.size(); i++)
+            REQUIRE(excluded[q][i].col == expected_cols[i]);
+      }
+   }
+
+   REQUIRE(s.topN(rows, 0).at(0).empty());
+   REQUIRE_THROWS(s.topN({ nrows }, 1));
+   REQUIRE_THROWS(s.topN(rows, 1, 0.0, std::make_shared<MatrixConfig>(nrows + 1, ncols,
+      std::vector<std::uint32_t>{ 0 }, std::vector<std::uint32_t>{ 0 }, ncfg, false)));
+}
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <random>
 
 #include <Eigen/Core>
 #include <Eigen/SparseCore>
@@ -12,6 +13,13 @@
 #include <SmurffCpp/Configs/TensorConfig.h>
 #include <SmurffCpp/DataTensors/SparseMode.h>
 #include <SmurffCpp/DataTensors/TensorData.h>
+#include <SmurffCpp/DataTensors/CSFTensorData.h>
+#include <SmurffCpp/IO/ChunkedTensor.h>
+#include <SmurffCpp/IO/TensorIO.h>
+#include <SmurffCpp/Model.h>
+#include <SmurffCpp/Noises/NoiseFactory.h>
+#include <SmurffCpp/Utils/Distribution.h>
+#include <SmurffCpp/Utils/omp_util.h>
 
 using namespace smurff;
 
@@ -125,6 +133,318 @@ TEST_CASE("test sparse view new 2")
    */
 }
 
+TEST_CASE("TensorData/plane_range", "TensorData with a range of hyperplanes per mode")
+{
+   std::vector<std::uint64_t> dims = { 2, 3, 4 };
+   std::vector<std::uint32_t> columns =
+      {
+         0, 1, 1, 0, 1, 0, 1,
+         0, 0, 1, 2, 2, 1, 0,
+         0, 1, 2, 3, 3, 2, 1,
+      };
+   std::vector<double> values = { 1, 2, 3, 4, 5, 6, 7 };
+   TensorConfig tensorConfig(dims, columns, values, fixed_ncfg, true);
+
+   std::vector<std::uint64_t> plane_begin = { 1, 0, 2 };
+   std::vector<std::uint64_t> plane_end   = { 2, 2, 4 };
+
+   TensorData full(tensorConfig);
+   TensorData part(tensorConfig, plane_begin, plane_end);
+
+   REQUIRE(full.nnz() == 7);
+   REQUIRE(part.nnz() == 4); // entries with coordinate 1 in mode 0
+
+   for (std::uint64_t m = 0; m < dims.size(); m++)
+   {
+      REQUIRE(part.Y(m)->getNPlanes() == dims[m]);
+      for (std::uint64_t h = 0; h < dims[m]; h++)
+      {
+         if (h < plane_begin[m] || h >= plane_end[m])
+         {
+            REQUIRE(part.col_nnz(m, h) == 0);
+            continue;
+         }
+
+         REQUIRE(part.col_nnz(m, h) == full.col_nnz(m, h));
+         for (std::uint64_t n = 0; n < part.col_nnz(m, h); n++)
+         {
+            auto expected = full.item(m, h, n);
+            auto actual = part.item(m, h, n);
+            REQUIRE(actual.first == expected.first);
+            REQUIRE(actual.second == expected.second);
+         }
+      }
+   }
+
+   REQUIRE_THROWS(TensorData(tensorConfig, { 0, 0, 3 }, { 2, 3, 2 }));
+}
+
+TEST_CASE("TensorData/parallel", "modes built in parallel from the config equal the modes built from an [nnz x nmodes] matrix")
+{
+   // small dimensions, so that the items are split in several parts
+   std::vector<std::uint64_t> dims = { 5, 7, 3 };
+   const std::uint64_t nnz = 10000;
+
+   std::mt19937 gen(1234);
+   std::vector<std::uint32_t> columns(dims.size() * nnz);
+   std::vector<double> values(nnz);
+   MatrixXui32 idx(nnz, dims.size());
+   for (std::uint64_t m = 0; m < dims.size(); m++)
+   {
+      std::uniform_int_distribution<std::uint32_t> dist(0, dims[m] - 1);
+      for (std::uint64_t i = 0; i < nnz; i++)
+         idx(i, m) = columns[m * nnz + i] = dist(gen);
+   }
+   for (std::uint64_t i = 0; i < nnz; i++)
+      values[i] = (double)i;
+
+   TensorConfig tensorConfig(dims, columns, values, fixed_ncfg, true);
+
+   int max_threads = threads::get_max_threads();
+   threads::init(0, 4);
+   TensorData data(tensorConfig);
+   threads::init(0, max_threads);
+
+   for (std::uint64_t m = 0; m < dims.size(); m++)
+   {
+      SparseMode expected(idx, values, m, dims[m]);
+      auto actual = data.Y(m);
+
+      REQUIRE(actual->getNPlanes() == expected.getNPlanes());
+      for (std::uint64_t h = 0; h <= expected.getNPlanes(); h++)
+         REQUIRE(actual->beginPlane(h) == expected.beginPlane(h));
+
+      REQUIRE(actual->getIndices() == expected.getIndices());
+      REQUIRE(actual->getValues() == expected.getValues());
+   }
+
+   std::vector<std::uint32_t> invalidColumns = columns;
+   invalidColumns[2 * nnz + nnz / 2] = 3;
+   REQUIRE_THROWS(TensorData(TensorConfig(dims, invalidColumns, values, fixed_ncfg, true)));
+}
+
+TEST_CASE("TensorData/chunked", "TensorData read chunk by chunk from a .sct file")
+{
+   std::vector<std::uint64_t> dims = { 2, 3, 4 };
+   std::vector<std::uint32_t> columns =
+      {
+         0, 1, 1, 0, 1, 0, 1,
+         0, 0, 1, 2, 2, 1, 0,
+         0, 1, 2, 3, 3, 2, 1,
+      };
+   std::vector<double> values = { 1, 2, 3, 4, 5, 6, 7 };
+   auto tensorConfig = std::make_shared<TensorConfig>(dims, columns, values, fixed_ncfg, true);
+
+   std::stringstream stream;
+   tensor_io::write_sparse_chunked(stream, tensorConfig, 3, true);
+   std::string data = stream.str();
+   tensor_io::ChunkedTensorReader reader(data.data(), data.data() + data.size());
+
+   std::vector<std::uint64_t> plane_begin = { 1, 0, 2 };
+   std::vector<std::uint64_t> plane_end   = { 2, 2, 4 };
+
+   TensorData full(*tensorConfig);
+   TensorData fullChunked(reader);
+   TensorData part(*tensorConfig, plane_begin, plane_end);
+   TensorData partChunked(reader, plane_begin, plane_end);
+
+   REQUIRE(fullChunked.nnz() == full.nnz());
+   REQUIRE(partChunked.nnz() == part.nnz());
+
+   for (std::uint64_t m = 0; m < dims.size(); m++)
+   {
+      REQUIRE(fullChunked.Y(m)->getNPlanes() == dims[m]);
+      for (std::uint64_t h = 0; h < dims[m]; h++)
+      {
+         REQUIRE(fullChunked.col_nnz(m, h) == full.col_nnz(m, h));
+         REQUIRE(partChunked.col_nnz(m, h) == part.col_nnz(m, h));
+
+         for (std::uint64_t n = 0; n < full.col_nnz(m, h); n++)
+         {
+            auto expected = full.item(m, h, n);
+            auto actual = fullChunked.item(m, h, n);
+            REQUIRE(actual.first == expected.first);
+            REQUIRE(actual.second == expected.second);
+         }
+
+         for (std::uint64_t n = 0; n < part.col_nnz(m, h); n++)
+         {
+            auto expected = part.item(m, h, n);
+            auto actual = partChunked.item(m, h, n);
+            REQUIRE(actual.first == expected.first);
+            REQUIRE(actual.second == expected.second);
+         }
+      }
+   }
+
+   // coordinates larger than the dimensions
+   std::vector<std::uint64_t> smallDims = { 2, 3, 3 };
+   auto invalidConfig = std::make_shared<TensorConfig>(smallDims, columns, values, fixed_ncfg, true);
+   std::stringstream invalidStream;
+   tensor_io::write_sparse_chunked(invalidStream, invalidConfig, 3, false);
+   std::string invalidData = invalidStream.str();
+   REQUIRE_THROWS(TensorData(tensor_io::ChunkedTensorReader(invalidData.data(), invalidData.data() + invalidData.size())));
+}
+
+TEST_CASE("SparseMode/sorted", "items of a hyperplane are sorted by their coordinates")
+{
+   std::vector<std::uint64_t> dims = { 2, 3, 4 };
+   std::vector<std::uint32_t> columns =
+      {
+         0, 1, 1, 0, 1, 0, 1, 0,
+         2, 0, 1, 2, 2, 1, 0, 2,
+         0, 1, 2, 3, 3, 2, 0, 1,
+      };
+   std::vector<double> values = { 1, 2, 3, 4, 5, 6, 7, 8 };
+   TensorConfig tensorConfig(dims, columns, values, fixed_ncfg, true);
+   TensorData data(tensorConfig);
+
+   for (std::uint64_t m = 0; m < dims.size(); m++)
+   {
+      auto sview = data.Y(m);
+      for (std::uint64_t h = 0; h < sview->getNPlanes(); h++)
+      {
+         for (std::uint64_t n = 1; n < sview->nItemsOnPlane(h); n++)
+         {
+            auto prev = sview->item(h, n - 1).first.as_vector();
+            auto item = sview->item(h, n).first.as_vector();
+            REQUIRE(prev < item);
+         }
+      }
+   }
+
+   // the value stays with its coordinates
+   auto item = data.Y(2)->item(1, 1);
+   REQUIRE(item.first == PVec<>({ 1, 0, 1 }));
+   REQUIRE(item.second == 2);
+}
+
+TEST_CASE("TensorData/getMuLambda", "rr and MM of tensors with 2 to 6 modes")
+{
+   init_bmrng(1234);
+
+   for (int nmodes = 2; nmodes <= 6; nmodes++)
+   {
+      for (int num_latent : { 3, 8 })
+      {
+         const std::uint64_t nnz = 20;
+         std::vector<std::uint64_t> dims(nmodes);
+         std::vector<std::uint32_t> columns(nmodes * nnz);
+         std::vector<double> values(nnz);
+         for (int m = 0; m < nmodes; m++)
+         {
+            dims[m] = 2 + m;
+            for (std::uint64_t i = 0; i < nnz; i++)
+               columns[m * nnz + i] = (i * (m + 1) + i / dims[m]) % dims[m];
+         }
+         for (std::uint64_t i = 0; i < nnz; i++)
+            values[i] = i + 0.5;
+
+         TensorConfig tensorConfig(dims, columns, values, fixed_ncfg, true);
+         TensorData data(tensorConfig);
+         data.setNoiseModel(NoiseFactory::create_noise_model(fixed_ncfg));
+         data.init();
+
+         Model model;
+         model.init(num_latent, data.dim(), ModelInitTypes::random);
+
+         for (int mode = 0; mode < nmodes; mode++)
+         {
+            for (std::uint64_t d = 0; d < dims[mode]; d++)
+            {
+               Eigen::VectorXd rr = Eigen::VectorXd::Zero(num_latent), rr_expected = Eigen::VectorXd::Zero(num_latent);
+               Eigen::MatrixXd MM = Eigen::MatrixXd::Zero(num_latent, num_latent), MM_expected = Eigen::MatrixXd::Zero(num_latent, num_latent);
+               data.getMuLambda(model, mode, d, rr, MM);
+
+               for (std::uint64_t n = 0; n < data.col_nnz(mode, d); n++)
+               {
+                  auto item = data.item(mode, d, n);
+                  Eigen::VectorXd col = Eigen::VectorXd::Ones(num_latent);
+                  for (int m = 0; m < nmodes; m++)
+                     if (m != mode)
+                        col = col.cwiseProduct(model.U(m).col(item.first[m]));
+
+                  rr_expected += col * item.second * data.noise().getAlpha();
+                  MM_expected += col * col.transpose() * data.noise().getAlpha();
+               }
+
+               REQUIRE(rr.isApprox(rr_expected));
+               REQUIRE(MM.isApprox(MM_expected));
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("CSFTensorData/getMuLambda", "CSFTensorData gives the same rr, MM and sumsq as TensorData")
+{
+   init_bmrng(1234);
+
+   for (int nmodes = 2; nmodes <= 5; nmodes++)
+   {
+      for (int num_latent : { 3, 8 })
+      {
+         // long fibers in the largest mode, so that both the panel and the rank-1 path are used
+         std::vector<std::uint64_t> dims(nmodes, 2);
+         dims[0] = 3;
+         dims[nmodes - 1] = 50;
+
+         const std::uint64_t nnz = 400;
+         std::vector<std::uint32_t> columns(nmodes * nnz);
+         std::vector<double> values(nnz);
+         for (std::uint64_t i = 0; i < nnz; i++)
+         {
+            for (int m = 0; m < nmodes; m++)
+               columns[m * nnz + i] = rand() % dims[m];
+            values[i] = (rand() % 100) / 10.0;
+         }
+
+         TensorConfig tensorConfig(dims, columns, values, fixed_ncfg, true);
+         TensorData coo(tensorConfig);
+         CSFTensorData csf(tensorConfig);
+         for (Data* data : std::vector<Data*>{ &coo, &csf })
+         {
+            data->setNoiseModel(NoiseFactory::create_noise_model(fixed_ncfg));
+            data->init();
+         }
+
+         REQUIRE(csf.nnz() == coo.nnz());
+         REQUIRE(csf.sum() == Approx(coo.sum()));
+
+         Model model;
+         model.init(num_latent, coo.dim(), ModelInitTypes::random);
+
+         REQUIRE(csf.sumsq(model) == Approx(coo.sumsq(model)));
+
+         for (int mode = 0; mode < nmodes; mode++)
+         {
+            for (std::uint64_t d = 0; d < dims[mode]; d++)
+            {
+               REQUIRE(csf.col_nnz(mode, d) == coo.col_nnz(mode, d));
+
+               Eigen::VectorXd rr_coo = Eigen::VectorXd::Zero(num_latent), rr_csf = Eigen::VectorXd::Zero(num_latent);
+               Eigen::MatrixXd MM_coo = Eigen::MatrixXd::Zero(num_latent, num_latent), MM_csf = Eigen::MatrixXd::Zero(num_latent, num_latent);
+               coo.getMuLambda(model, mode, d, rr_coo, MM_coo);
+               csf.getMuLambda(model, mode, d, rr_csf, MM_csf);
+
+               REQUIRE(rr_csf.isApprox(rr_coo));
+               REQUIRE(MM_csf.isApprox(MM_coo));
+
+               // ranges that cut through fibers
+               Eigen::VectorXd rr_parts = Eigen::VectorXd::Zero(num_latent);
+               Eigen::MatrixXd MM_parts = Eigen::MatrixXd::Zero(num_latent, num_latent);
+               const std::uint64_t n = csf.col_nnz(mode, d);
+               for (std::uint64_t from = 0; from < n; from += 7)
+                  csf.getMuLambdaRange(model, mode, d, from, std::min(from + 7, n), rr_parts, MM_parts);
+
+               REQUIRE(rr_parts.isApprox(rr_coo));
+               REQUIRE(MM_parts.isApprox(MM_coo));
+            }
+         }
+      }
+   }
+}
+
 //smurff
 
 /*
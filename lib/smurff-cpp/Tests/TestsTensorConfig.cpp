@@ -1,5 +1,6 @@
 #include "catch.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <iostream>
@@ -12,6 +13,7 @@
 #include <SmurffCpp/Utils/MatrixUtils.h>
 #include <SmurffCpp/Utils/TensorUtils.h>
 #include <SmurffCpp/Configs/TensorConfig.h>
+#include <SmurffCpp/Utils/Reordering.h>
 
 using namespace smurff;
 
@@ -267,3 +269,69 @@ TEST_CASE("TensorConfig(std::shared_ptr<std::vector<std::uint64_t> > dims, std::
    REQUIRE(matrix_utils::equals(actualMatrix0, expectedMatrix));
    REQUIRE(matrix_utils::equals(actualMatrix1, expectedMatrix));
 }
+
+TEST_CASE("Reordering", "degree and rcm orders are permutations that map the data, the side info and the latent vectors consistently")
+{
+   // degrees of mode 0: 4, 0, 1, 1
+   std::vector<std::uint64_t> dims = { 4, 3, 2 };
+   std::vector<std::uint32_t> columns =
+      {
+         0, 0, 0, 2, 3, 0,
+         0, 1, 2, 0, 2, 0,
+         0, 0, 1, 1, 0, 1
+      };
+   std::vector<double> values = { 1, 2, 3, 4, 5, 6 };
+   TensorConfig tensorConfig(dims, columns, values, fixed_ncfg, true);
+
+   Reordering degree(tensorConfig, ReorderTypes::degree);
+   REQUIRE(degree.toOriginal(0, 0) == 0);
+   REQUIRE(degree.toOriginal(0, 1) == 2);
+   REQUIRE(degree.toOriginal(0, 2) == 3);
+   REQUIRE(degree.toOriginal(0, 3) == 1);
+
+   for (ReorderTypes type : { ReorderTypes::none, ReorderTypes::degree, ReorderTypes::rcm })
+   {
+      Reordering reordering(tensorConfig, type);
+      REQUIRE(reordering.getNModes() == dims.size());
+
+      for (std::uint64_t m = 0; m < dims.size(); m++)
+      {
+         std::vector<bool> seen(dims[m], false);
+         for (std::uint32_t id = 0; id < dims[m]; id++)
+         {
+            REQUIRE(reordering.toOriginal(m, id) < dims[m]);
+            REQUIRE(reordering.toNew(m, reordering.toOriginal(m, id)) == id);
+            seen[reordering.toOriginal(m, id)] = true;
+         }
+         REQUIRE(std::find(seen.begin(), seen.end(), false) == seen.end());
+      }
+
+      std::shared_ptr<TensorConfig> permuted = reordering.permute(tensorConfig);
+      REQUIRE(permuted->getDims() == dims);
+      REQUIRE(permuted->getNNZ() == tensorConfig.getNNZ());
+      for (std::uint64_t i = 0; i < tensorConfig.getNNZ(); i++)
+      {
+         REQUIRE(permuted->get(i).first == reordering.toNew(tensorConfig.get(i).first));
+         REQUIRE(reordering.toOriginal(permuted->get(i).first) == tensorConfig.get(i).first);
+         REQUIRE(permuted->get(i).second == tensorConfig.get(i).second);
+      }
+
+      // dense side info of mode 0, 2 features
+      MatrixConfig sideInfo(4, 2, std::vector<double>({ 1, 2, 3, 4, 5, 6, 7, 8 }), fixed_ncfg);
+      std::shared_ptr<MatrixConfig> permutedSideInfo = reordering.permuteRows(sideInfo, 0);
+      Eigen::MatrixXd sideInfoMatrix = matrix_utils::dense_to_eigen(sideInfo);
+      Eigen::MatrixXd permutedSideInfoMatrix = matrix_utils::dense_to_eigen(*permutedSideInfo);
+      for (std::uint32_t i = 0; i < 4; i++)
+         REQUIRE(permutedSideInfoMatrix.row(reordering.toNew(0, i)) == sideInfoMatrix.row(i));
+
+      // latent vectors of mode 1
+      Eigen::MatrixXd U = Eigen::MatrixXd::Random(2, 3);
+      Eigen::MatrixXd permutedU, originalU;
+      reordering.permuteColumns(U, 1, permutedU);
+      for (std::uint32_t i = 0; i < 3; i++)
+         REQUIRE(permutedU.col(reordering.toNew(1, i)) == U.col(i));
+
+      reordering.unpermuteColumns(permutedU, 1, originalU);
+      REQUIRE(originalU == U);
+   }
+}
@@ -3,9 +3,14 @@
 #include <Eigen/Core>
 #include <Eigen/SparseCore>
 
+#include <cstdio>
+#include <fstream>
+
+#include <SmurffCpp/IO/ChunkedTensor.h>
 #include <SmurffCpp/IO/TensorIO.h>
 #include <SmurffCpp/Utils/TensorUtils.h>
 #include <SmurffCpp/Utils/MatrixUtils.h>
+#include <SmurffMPI/MPIDistTensorIO.h>
 
 using namespace smurff;
 
@@ -149,3 +154,135 @@ TEST_CASE("tensor_io/read_sparse_float64_tns | tensor_io/write_sparse_float64_tn
    REQUIRE(matrix_utils::equals(actualMatrix0, expectedMatrix));
    REQUIRE(matrix_utils::equals(actualMatrix1, expectedMatrix));
 }
+
+TEST_CASE("tensor_io/read_sparse_chunked | tensor_io/write_sparse_chunked")
+{
+   // 3 x 4 x 1000, the last mode is sorted so that delta encoding pays off
+   std::vector<std::uint64_t> dims = { 3, 4, 1000 };
+   const std::uint64_t nnz = 500;
+   std::vector<std::uint32_t> columns(3 * nnz);
+   std::vector<double> values(nnz);
+   for (std::uint64_t i = 0; i < nnz; i++)
+   {
+      columns[i] = (i * 7) % 3;
+      columns[nnz + i] = (i * 5) % 4;
+      columns[2 * nnz + i] = 2 * i;
+      values[i] = 0.5 * i - 100;
+   }
+
+   auto tensorConfig = std::make_shared<TensorConfig>(dims, columns, values, fixed_ncfg, true);
+   auto binaryConfig = std::make_shared<TensorConfig>(dims, columns, fixed_ncfg, true);
+
+   for (std::uint64_t chunk_size : { 1, 64, 500, 1000 })
+   {
+      for (bool delta : { false, true })
+      {
+         for (auto expected : { tensorConfig, binaryConfig })
+         {
+            std::stringstream tensorStream;
+            tensor_io::write_sparse_chunked(tensorStream, expected, chunk_size, delta);
+
+            std::shared_ptr<TensorConfig> actual = tensor_io::read_sparse_chunked(tensorStream, true);
+
+            REQUIRE(actual->getDims() == expected->getDims());
+            REQUIRE(actual->getNNZ() == nnz);
+            REQUIRE(actual->isBinary() == expected->isBinary());
+            REQUIRE(actual->getColumns() == expected->getColumns());
+            REQUIRE(actual->getValues() == expected->getValues());
+         }
+      }
+   }
+
+   // delta encoded columns are smaller than raw ones
+   std::stringstream rawStream, deltaStream;
+   tensor_io::write_sparse_chunked(rawStream, tensorConfig, 64, false);
+   tensor_io::write_sparse_chunked(deltaStream, tensorConfig, 64, true);
+   REQUIRE(deltaStream.str().size() < rawStream.str().size());
+
+   // truncated
+   std::string data = deltaStream.str();
+   REQUIRE_THROWS(tensor_io::ChunkedTensorReader(data.data(), data.data() + data.size() - 8));
+   REQUIRE_THROWS(tensor_io::ChunkedTensorReader(data.data(), data.data() + 16));
+}
+
+TEST_CASE("tensor_io/read_tensor | tensor_io/write_tensor | .sct")
+{
+   std::vector<std::uint64_t> dims = { 3, 4 };
+   std::vector<std::uint32_t> columns = { 0, 0, 0, 0, 2, 2, 2, 2, 0, 1, 2, 3, 0, 1, 2, 3 };
+   std::vector<double> values = { 1, 2, 3, 4, 9, 10, 11, 12 };
+   auto expected = std::make_shared<TensorConfig>(dims, columns, values, fixed_ncfg, true);
+
+   const std::string filename = "tensor_io_write_tensor.sct";
+   tensor_io::write_tensor(filename, expected);
+
+   std::shared_ptr<TensorConfig> actual = tensor_io::read_tensor(filename, true);
+   REQUIRE(actual->getDims() == dims);
+   REQUIRE(actual->getColumns() == columns);
+   REQUIRE(actual->getValues() == values);
+
+   std::shared_ptr<TensorConfig> header = tensor_io::read_tensor_header(filename, true);
+   REQUIRE(header->getDims() == dims);
+   REQUIRE(header->getNNZ() == values.size());
+   REQUIRE(!header->hasData());
+   REQUIRE(actual->hasData());
+
+   std::remove(filename.c_str());
+}
+
+TEST_CASE("mpi_dist_io/read_sparse_entries | .sct")
+{
+   std::vector<std::uint64_t> dims = { 3, 4, 1000 };
+   const std::uint64_t nnz = 500;
+   std::vector<std::uint32_t> columns(3 * nnz);
+   std::vector<double> values(nnz);
+   for (std::uint64_t i = 0; i < nnz; i++)
+   {
+      columns[i] = (i * 7) % 3;
+      columns[nnz + i] = (i * 5) % 4;
+      columns[2 * nnz + i] = 2 * i;
+      values[i] = 0.5 * i - 100;
+   }
+
+   auto tensorConfig = std::make_shared<TensorConfig>(dims, columns, values, fixed_ncfg, true);
+   auto binaryConfig = std::make_shared<TensorConfig>(dims, columns, fixed_ncfg, true);
+
+   const std::string filename = "mpi_dist_io_read_sparse_entries.sct";
+   REQUIRE(mpi_dist_io::is_sparse_tensor_file(filename));
+
+   for (auto expected : { tensorConfig, binaryConfig })
+   {
+      // chunks of 64 entries, so that the ranges below start and end inside chunks
+      {
+         std::ofstream out(filename, std::ios::binary);
+         tensor_io::write_sparse_chunked(out, expected, 64, true);
+      }
+
+      std::vector<std::uint64_t> header_dims;
+      std::uint64_t header_nnz;
+      mpi_dist_io::read_sparse_header(filename, header_dims, header_nnz);
+      REQUIRE(header_dims == dims);
+      REQUIRE(header_nnz == nnz);
+
+      for (auto range : std::vector<std::pair<std::uint64_t, std::uint64_t> >{ { 0, nnz }, { 10, 200 }, { 64, 128 }, { 499, 500 } })
+      {
+         const std::uint64_t begin = range.first;
+         const std::uint64_t end = range.second;
+         std::shared_ptr<TensorConfig> actual = mpi_dist_io::read_sparse_entries(filename, begin, end);
+
+         std::vector<std::uint32_t> expected_columns;
+         for (std::uint64_t m = 0; m < dims.size(); m++)
+            expected_columns.insert(expected_columns.end(), columns.begin() + m * nnz + begin, columns.begin() + m * nnz + end);
+
+         REQUIRE(actual->getDims() == dims);
+         REQUIRE(actual->getNNZ() == end - begin);
+         REQUIRE(actual->isBinary() == expected->isBinary());
+         REQUIRE(actual->getColumns() == expected_columns);
+         if (!expected->isBinary())
+            REQUIRE(actual->getValues() == std::vector<double>(values.begin() + begin, values.begin() + end));
+      }
+
+      REQUIRE_THROWS(mpi_dist_io::read_sparse_entries(filename, 100, nnz + 1));
+   }
+
+   std::remove(filename.c_str());
+}
@@ -18,6 +18,8 @@
 #include <SmurffCpp/Utils/counters.h>
 #include <SmurffCpp/Utils/MatrixUtils.h>
 #include <SmurffCpp/Utils/linop.h>
+#include <SmurffCpp/Utils/LatentScheduler.h>
+#include <SmurffCpp/Utils/Panel.hpp>
 
 #include <SmurffCpp/Configs/MatrixConfig.h>
 
@@ -32,6 +34,8 @@
 #include <SmurffCpp/DataMatrices/FullMatrixData.hpp>
 #include <SmurffCpp/DataMatrices/SparseMatrixData.h>
 #include <SmurffCpp/DataMatrices/DenseMatrixData.h>
+#include <SmurffCpp/DataMatrices/ScarceBinaryMatrixData.h>
+#include <SmurffCpp/DataMatrices/SparseBinaryMatrixData.h>
 
 #include <SmurffCpp/SideInfo/DenseDoubleFeatSideInfo.h>
 
@@ -69,6 +73,49 @@ TEST_CASE( "chol/chol_solve_t", "[chol_solve_t]" ) {
   }
 }
 
+TEST_CASE( "chol/chol_batch", "[chol_decomp_batch] against Eigen LLT" ) {
+  const int n = 5, w = 3;
+  std::vector<Eigen::MatrixXd> A(w);
+  std::vector<Eigen::VectorXd> b(w);
+  for (int l = 0; l < w; l++) {
+    Eigen::MatrixXd X(n, n + 2);
+    for (int i = 0; i < X.rows(); i++)
+      for (int j = 0; j < X.cols(); j++)
+        X(i, j) = sin((l + 1) * (i + 0.3) * (j + 1.7));
+    A[l] = X * X.transpose() + Eigen::MatrixXd::Identity(n, n);
+    b[l] = Eigen::VectorXd::LinSpaced(n, -1.0 + l, 2.0);
+  }
+
+  // interleave
+  Eigen::VectorXd Ab(n * n * w), bb(n * w);
+  for (int l = 0; l < w; l++) {
+    for (int j = 0; j < n; j++)
+      for (int i = 0; i < n; i++)
+        Ab((j * n + i) * w + l) = A[l](i, j);
+    for (int i = 0; i < n; i++)
+      bb(i * w + l) = b[l](i);
+  }
+
+  chol_decomp_batch(Ab.data(), n, w);
+  chol_solve_L_batch(Ab.data(), bb.data(), n, w);
+  chol_solve_Lt_batch(Ab.data(), bb.data(), n, w);
+
+  for (int l = 0; l < w; l++) {
+    Eigen::LLT<Eigen::MatrixXd> chol = A[l].llt();
+    Eigen::MatrixXd L = chol.matrixL();
+    Eigen::VectorXd x = chol.solve(b[l]);
+    for (int j = 0; j < n; j++)
+      for (int i = j; i < n; i++)
+        REQUIRE( Ab((j * n + i) * w + l) == Approx(L(i, j)).epsilon(APPROX_EPSILON) );
+    for (int i = 0; i < n; i++)
+      REQUIRE( bb(i * w + l) == Approx(x(i)).epsilon(APPROX_EPSILON) );
+  }
+
+  // not positive definite
+  Ab.setZero();
+  REQUIRE_THROWS( chol_decomp_batch(Ab.data(), n, w) );
+}
+
 TEST_CASE( "mvnormal/rgamma", "generaring random gamma variable" ) {
   init_bmrng(1234);
   double g = rgamma(100.0, 0.01);
@@ -146,6 +193,25 @@ TEST_CASE( "utils/eval_rmse", "Test if prediction variance is correctly calculat
   REQUIRE(p->rmse_avg == Approx(std::sqrt(std::pow(4.5 - ((1.0 * 1.0 + 0.0 * 0.0) + (2.0 * 1.0 + 0.0 * 0.0) + (2.0 * 3.0 + 0.0 * 0.0)) / 3, 2) / 1)));
 }
 
+TEST_CASE( "model/predict", "fixed-size (num_latent = 8, 16, 32, 64) and dynamic predict for 2 to 6 modes" )
+{
+  init_bmrng(1234);
+  for (int num_latent : { 7, 8, 16, 32, 33, 64 }) {
+    for (int nmodes : { 2, 3, 4, 5, 6 }) {
+      std::shared_ptr<Model> model(new Model());
+      model->init(num_latent, PVec<>(std::vector<int>(nmodes, 3)), ModelInitTypes::random);
+
+      for (int i = 0; i < 3; i++) {
+        PVec<> pos(std::vector<int>(nmodes, i));
+        Eigen::ArrayXd expected = Eigen::ArrayXd::Ones(num_latent);
+        for (int d = 0; d < nmodes; d++)
+          expected *= model->U(d).col(i).array();
+        REQUIRE( model->predict(pos) == Approx(expected.sum()).epsilon(APPROX_EPSILON) );
+      }
+    }
+  }
+}
+
 TEST_CASE("utils/auc","AUC ROC") {
   struct TestItem {
       double pred, val;
@@ -176,6 +242,57 @@ TEST_CASE("utils/auc","AUC ROC") {
   REQUIRE ( calc_auc(items, 0.5) == Approx(0.84) );
 }
 
+TEST_CASE( "SparseStorage/init", "Rows and columns of a SparseStorage are sorted and share the values") {
+  std::vector<std::uint32_t> rows = {2, 0, 1, 0, 2, 1};
+  std::vector<std::uint32_t> cols = {1, 3, 0, 1, 3, 2};
+  std::vector<double>        vals = {1., 2., 3., 4., 5., 6.};
+
+  MatrixConfig S(3, 4, rows, cols, vals, fixed_ncfg, true);
+  SparseStorage Y(S);
+
+  REQUIRE(Y.rows() == 3);
+  REQUIRE(Y.cols() == 4);
+  REQUIRE(Y.nonZeros() == 6);
+  REQUIRE(Y.sum() == Approx(21.));
+
+  Eigen::MatrixXd expected = Eigen::MatrixXd(matrix_utils::sparse_to_eigen(S));
+  REQUIRE(matrix_utils::equals(Eigen::MatrixXd(Y.to_eigen()), expected));
+
+  for (int mode = 0; mode < 2; mode++)
+  {
+    std::uint64_t total = 0;
+    for (std::uint64_t d = 0; d < Y.dim(mode); d++)
+    {
+      for (std::uint64_t i = Y.begin(mode, d); i < Y.end(mode, d); i++)
+      {
+        if (i > Y.begin(mode, d))
+          REQUIRE(Y.index(mode, i - 1) < Y.index(mode, i));
+
+        const std::uint32_t idx = Y.index(mode, i);
+        const double val = mode == 0 ? expected(d, idx) : expected(idx, d);
+        REQUIRE(Y.value(mode, i) == val);
+      }
+      total += Y.nnz(mode, d);
+    }
+    REQUIRE(total == 6);
+  }
+
+  S.releaseData();
+  REQUIRE(S.getNNZ() == 6);
+  REQUIRE(S.getRows().empty());
+  REQUIRE_THROWS(SparseStorage{S});
+
+  std::vector<std::uint32_t> dup_rows = {0, 1, 0};
+  std::vector<std::uint32_t> dup_cols = {1, 0, 1};
+  const MatrixConfig D(2, 2, dup_rows, dup_cols, {1., 2., 3.}, fixed_ncfg, true);
+  REQUIRE_THROWS(SparseStorage{D});
+
+  // no items is not binary
+  const SparseStorage E(Eigen::SparseMatrix<double>(3, 4));
+  REQUIRE(E.nonZeros() == 0);
+  REQUIRE(!E.isBinary());
+}
+
 TEST_CASE( "ScarceMatrixData/var_total", "Test if variance of Scarce Matrix is correctly calculated") {
   std::vector<std::uint32_t> rows = {0, 1};
   std::vector<std::uint32_t> cols = {0, 0};
@@ -202,6 +319,270 @@ TEST_CASE( "DenseMatrixData/var_total", "Test if variance of Dense Matrix is cor
   REQUIRE(data->var_total() == Approx(1.25));
 }
 
+TEST_CASE( "Data/getMuLambdaRange", "Summing getMuLambdaRange over parts of a column gives getMuLambda") {
+  init_bmrng(1234);
+
+  std::vector<std::uint32_t> rows = {0, 1, 2, 3, 0, 2};
+  std::vector<std::uint32_t> cols = {0, 0, 0, 0, 1, 1};
+  std::vector<double>        vals = {1., 2., 3., 4., 5., 6.};
+
+  const MatrixConfig S(4, 3, rows, cols, vals, fixed_ncfg, false);
+  Eigen::MatrixXd Y = Eigen::MatrixXd::Random(4, 3);
+
+  std::vector<std::shared_ptr<Data> > datas = {
+     std::shared_ptr<Data>(new ScarceMatrixData(matrix_utils::sparse_to_eigen(S))),
+     std::shared_ptr<Data>(new SparseMatrixData(matrix_utils::sparse_to_eigen(S))),
+     std::shared_ptr<Data>(new DenseMatrixData(Y)),
+  };
+
+  for (auto data : datas) {
+    data->setNoiseModel(NoiseFactory::create_noise_model(fixed_ncfg));
+    data->init();
+
+    Model model;
+    model.init(3, PVec<>({4, 3}), ModelInitTypes::random);
+    for (int mode = 0; mode < 2; mode++) data->update_pnm(model, mode);
+
+    for (int mode = 0; mode < 2; mode++) {
+      for (int d = 0; d < model.U(mode).cols(); d++) {
+        Eigen::VectorXd rr = Eigen::VectorXd::Zero(3), rr_parts = Eigen::VectorXd::Zero(3);
+        Eigen::MatrixXd MM = Eigen::MatrixXd::Zero(3, 3), MM_parts = Eigen::MatrixXd::Zero(3, 3);
+        data->getMuLambda(model, mode, d, rr, MM);
+
+        const std::uint64_t nnz = data->col_nnz(mode, d);
+        for (std::uint64_t from = 0; from < std::max(nnz, (std::uint64_t)1); from += 2)
+          data->getMuLambdaRange(model, mode, d, from, std::min(from + 2, nnz), rr_parts, MM_parts);
+
+        REQUIRE(rr_parts.isApprox(rr));
+        REQUIRE(MM_parts.isApprox(MM));
+      }
+    }
+  }
+}
+
+TEST_CASE( "DenseMatrixData/getMuLambda", "rr precomputed in update_pnm equals the sum over the items of a column") {
+  init_bmrng(1234);
+
+  Eigen::MatrixXd Y = Eigen::MatrixXd::Random(5, 4);
+
+  DenseMatrixData dense(Y);
+  ScarceMatrixData scarce(Y.sparseView());
+
+  for (Data* data : std::vector<Data*>{ &dense, &scarce }) {
+    data->setNoiseModel(NoiseFactory::create_noise_model(fixed_ncfg));
+    data->init();
+  }
+
+  Model model;
+  model.init(3, PVec<>({5, 4}), ModelInitTypes::random);
+
+  for (int mode = 0; mode < 2; mode++) {
+    dense.update_pnm(model, mode);
+    scarce.update_pnm(model, mode);
+
+    for (int d = 0; d < model.U(mode).cols(); d++) {
+      Eigen::VectorXd rr_dense = Eigen::VectorXd::Zero(3), rr_scarce = Eigen::VectorXd::Zero(3);
+      Eigen::MatrixXd MM_dense = Eigen::MatrixXd::Zero(3, 3), MM_scarce = Eigen::MatrixXd::Zero(3, 3);
+      dense.getMuLambda(model, mode, d, rr_dense, MM_dense);
+      scarce.getMuLambda(model, mode, d, rr_scarce, MM_scarce);
+
+      REQUIRE(rr_dense.isApprox(rr_scarce));
+      REQUIRE(MM_dense.isApprox(MM_scarce));
+    }
+  }
+}
+
+TEST_CASE( "Data/sumsq", "sumsq of fully known matrices equals the sum over all cells") {
+  init_bmrng(1234);
+
+  std::vector<std::uint32_t> rows = {0, 1, 2, 3, 0, 2};
+  std::vector<std::uint32_t> cols = {0, 0, 0, 0, 1, 1};
+  std::vector<double>        vals = {1., 2., 3., 4., 5., 6.};
+
+  const MatrixConfig S(4, 3, rows, cols, vals, fixed_ncfg, false);
+  Eigen::MatrixXd Y = Eigen::MatrixXd::Random(4, 3);
+
+  std::vector<std::pair<std::shared_ptr<Data>, Eigen::MatrixXd> > datas = {
+     { std::shared_ptr<Data>(new SparseMatrixData(matrix_utils::sparse_to_eigen(S))), Eigen::MatrixXd(matrix_utils::sparse_to_eigen(S)) },
+     { std::shared_ptr<Data>(new DenseMatrixData(Y)), Y },
+  };
+
+  for (auto p : datas) {
+    auto data = p.first;
+    data->setNoiseModel(NoiseFactory::create_noise_model(fixed_ncfg));
+    data->init();
+
+    Model model;
+    model.init(3, PVec<>({4, 3}), ModelInitTypes::random);
+
+    double expected = 0.0;
+    for (int i = 0; i < 4; i++)
+      for (int j = 0; j < 3; j++)
+        expected += std::pow(model.predict({i, j}) - p.second(i, j), 2);
+
+    REQUIRE(data->sumsq(model) == Approx(expected).epsilon(APPROX_EPSILON));
+    REQUIRE(data->train_rmse(model) == Approx(std::sqrt(expected / 12)).epsilon(APPROX_EPSILON));
+  }
+}
+
+TEST_CASE( "BinaryMatrixData/getMuLambda", "Binary data gives the same rr, MM and sumsq as the same data with explicit 1s") {
+  init_bmrng(1234);
+
+  // a dense pattern, so that columns use the panel of ScarceBinaryMatrixData
+  std::vector<std::uint32_t> rows, cols;
+  for (int i = 0; i < 40; i++)
+    for (int j = 0; j < 6; j++)
+      if ((i * 7 + j * 3) % 5 < 3) { rows.push_back(i); cols.push_back(j); }
+
+  std::vector<double> ones(rows.size(), 1.);
+  const MatrixConfig B(40, 6, rows, cols, fixed_ncfg, true);
+  const MatrixConfig S(40, 6, rows, cols, ones, fixed_ncfg, true);
+  REQUIRE(SparseStorage(B).isBinary());
+  REQUIRE(!SparseStorage(S).isBinary());
+
+  std::vector<std::pair<std::shared_ptr<Data>, std::shared_ptr<Data> > > datas = {
+     { std::make_shared<ScarceBinaryMatrixData>(SparseStorage(B)), std::make_shared<ScarceMatrixData>(SparseStorage(S)) },
+     { std::make_shared<SparseBinaryMatrixData>(SparseStorage(B)), std::make_shared<SparseMatrixData>(SparseStorage(S)) },
+  };
+
+  for (auto noise : { NoiseTypes::fixed, NoiseTypes::probit }) {
+    for (auto p : datas) {
+      for (auto data : { p.first, p.second }) {
+        data->setNoiseModel(NoiseFactory::create_noise_model(NoiseConfig(noise)));
+        data->init();
+      }
+
+      Model model;
+      model.init(4, PVec<>({40, 6}), ModelInitTypes::random);
+
+      for (int mode = 0; mode < 2; mode++) {
+        p.first->update_pnm(model, mode);
+        p.second->update_pnm(model, mode);
+
+        for (int d = 0; d < model.U(mode).cols(); d++) {
+          Eigen::VectorXd rr_binary = Eigen::VectorXd::Zero(4), rr = Eigen::VectorXd::Zero(4);
+          Eigen::MatrixXd MM_binary = Eigen::MatrixXd::Zero(4, 4), MM = Eigen::MatrixXd::Zero(4, 4);
+
+          // same draws for the probit noise
+          init_bmrng(d);
+          p.first->getMuLambda(model, mode, d, rr_binary, MM_binary);
+          init_bmrng(d);
+          p.second->getMuLambda(model, mode, d, rr, MM);
+
+          REQUIRE(rr_binary.isApprox(rr));
+          REQUIRE(MM_binary.isApprox(MM));
+        }
+      }
+
+      REQUIRE(p.first->sumsq(model) == Approx(p.second->sumsq(model)).epsilon(APPROX_EPSILON));
+    }
+  }
+
+  // all known values are 1 / a fraction of 1s in the fully known matrix
+  const double frac = (double)rows.size() / 240;
+  REQUIRE(datas[0].first->var_total() == Approx(1.0));
+  REQUIRE(datas[1].first->var_total() == Approx(frac * (1. - frac)));
+}
+
+TEST_CASE( "ScarceMatrixData/getMuLambda", "The panel and the one-item-at-a-time kernel give the rank-1 sums") {
+  init_bmrng(1234);
+
+  // column 0 is longer than the widest panel, column 1 just uses a panel,
+  // column 2 and every row are below PANEL_MIN_ITEMS
+  const int nrows = PANEL_MAX_WIDTH + 44;
+  const std::vector<int> col_nnz = { nrows, PANEL_MIN_ITEMS + 4, PANEL_MIN_ITEMS - 1 };
+
+  std::vector<std::uint32_t> rows, cols;
+  std::vector<double> vals;
+  for (int j = 0; j < (int)col_nnz.size(); j++)
+    for (int i = 0; i < col_nnz[j]; i++) { rows.push_back(i); cols.push_back(j); vals.push_back(rand() % 2); }
+
+  const MatrixConfig S(nrows, col_nnz.size(), rows, cols, vals, fixed_ncfg, true);
+  const Eigen::MatrixXd Y = Eigen::MatrixXd(matrix_utils::sparse_to_eigen(S));
+  REQUIRE(col_nnz[1] >= PANEL_MIN_ITEMS);
+  REQUIRE(col_nnz[2] < PANEL_MIN_ITEMS);
+
+  for (auto noise : { NoiseTypes::fixed, NoiseTypes::probit }) {
+    for (int num_latent : { 3, 8 }) {
+      ScarceMatrixData data{SparseStorage(S)};
+      data.setNoiseModel(NoiseFactory::create_noise_model(NoiseConfig(noise)));
+      data.init();
+      REQUIRE(data.noise().isGaussian() == (noise == NoiseTypes::fixed));
+
+      Model model;
+      model.init(num_latent, PVec<>({nrows, (int)col_nnz.size()}), ModelInitTypes::random);
+
+      for (int mode = 0; mode < 2; mode++) {
+        const Eigen::MatrixXd& V = model.U(1 - mode);
+        const double alpha = data.noise().getAlpha();
+
+        for (int d = 0; d < model.U(mode).cols(); d++) {
+          Eigen::VectorXd rr = Eigen::VectorXd::Zero(num_latent);
+          Eigen::MatrixXd MM = Eigen::MatrixXd::Zero(num_latent, num_latent);
+
+          // same draws for the probit noise
+          init_bmrng(d);
+          data.getMuLambda(model, mode, d, rr, MM);
+
+          // reference: one rank-1 update per item, in the order of the items
+          Eigen::VectorXd rr_ref = Eigen::VectorXd::Zero(num_latent);
+          Eigen::MatrixXd MM_ref = Eigen::MatrixXd::Zero(num_latent, num_latent);
+          init_bmrng(d);
+          for (int j = 0; j < V.cols(); j++) {
+            const PVec<> pos = mode == 0 ? PVec<>({d, j}) : PVec<>({j, d});
+            const int r = pos[0], c = pos[1];
+            if (c >= (int)col_nnz.size() || r >= col_nnz[c])
+              continue;
+
+            const double noisy_val = data.noise().isGaussian() ? alpha * Y(r, c) : data.noise().sample(model, pos, Y(r, c));
+            rr_ref += V.col(j) * noisy_val;
+            MM_ref += alpha * V.col(j) * V.col(j).transpose();
+          }
+
+          REQUIRE(rr.isApprox(rr_ref));
+          REQUIRE(MM.isApprox(MM_ref));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE( "LatentScheduler/init", "Every column is sampled exactly once, heavy columns are split") {
+  std::vector<std::uint64_t> nnz = { 1, 2, 1000, 3, 0, 5, 4, 1, 0, 2 };
+  LatentScheduler scheduler;
+  scheduler.init(nnz, 1.0, 4, true);
+
+  std::vector<int> count(nnz.size(), 0);
+  for (auto c : scheduler.chunks())
+     for (int n = c.from; n < c.to; n++) count[n]++;
+  for (auto n : scheduler.heavy()) count[n]++;
+  for (auto c : count) REQUIRE(c == 1);
+
+  REQUIRE(scheduler.heavy() == std::vector<int>({2}));
+  std::uint64_t expected_from = 0;
+  for (int i = scheduler.heavy_begin(0); i < scheduler.heavy_begin(1); i++) {
+     REQUIRE(scheduler.parts()[i].from == expected_from);
+     expected_from = scheduler.parts()[i].to;
+  }
+  REQUIRE(expected_from == 1000);
+  REQUIRE(scheduler.parts().size() > 1);
+}
+
+TEST_CASE( "LatentScheduler/init_range", "Columns of a range of U are scheduled with their absolute index") {
+  // columns 100 .. 109
+  std::vector<std::uint64_t> nnz = { 1, 2, 1000, 3, 0, 5, 4, 1, 0, 2 };
+  LatentScheduler scheduler;
+  scheduler.init(nnz, 1.0, 4, true, 100);
+
+  std::vector<int> count(nnz.size(), 0);
+  for (auto c : scheduler.chunks())
+     for (int n = c.from; n < c.to; n++) count.at(n - 100)++;
+  for (auto n : scheduler.heavy()) count.at(n - 100)++;
+  for (auto c : count) REQUIRE(c == 1);
+
+  REQUIRE(scheduler.heavy() == std::vector<int>({102}));
+}
+
 using namespace Eigen;
 using namespace std;
 
@@ -220,8 +601,7 @@ MacauPrior* make_dense_prior(int nlatent, double* ptr, int nrows, int ncols, boo
    std::shared_ptr<Eigen::MatrixXd> Fmat_ptr = std::shared_ptr<MatrixXd>(Fmat);
    std::shared_ptr<DenseDoubleFeatSideInfo> side_info = std::make_shared<DenseDoubleFeatSideInfo>(Fmat_ptr);
    ret->addSideInfo(side_info, 10.0, 1e-6, comp_FtF, true, false);
-   ret->FtF_plus_beta.resize(Fmat->cols(), Fmat->cols());
-   ret->Features->At_mul_A(ret->FtF_plus_beta);
+   ret->decompose_FtF();
    return ret;
 }
 
@@ -235,9 +615,8 @@ TEST_CASE("macauprior/make_dense_prior", "Making MacauPrior with MatrixXd") {
     Ftrue <<  0.1, 0.3, 0.4, 0.11, -0.7, 0.23;
     auto features_downcast1 = std::dynamic_pointer_cast<DenseDoubleFeatSideInfo>(prior->Features); //for the purpose of the test
     REQUIRE( (*(features_downcast1->get_features()) - Ftrue).norm() == Approx(0) );
-    Eigen::MatrixXd tmp = Eigen::MatrixXd::Zero(2, 2);
-    tmp.triangularView<Eigen::Lower>()  = prior->FtF_plus_beta;
-    tmp.triangularView<Eigen::Lower>() -= Ftrue.transpose() * Ftrue;
+    Eigen::MatrixXd tmp = prior->FtF_eigenvectors * prior->FtF_eigenvalues.asDiagonal() * prior->FtF_eigenvectors.transpose();
+    tmp -= Ftrue.transpose() * Ftrue;
     REQUIRE( tmp.norm() == Approx(0) );
 
     // RowMajor case
@@ -249,10 +628,18 @@ TEST_CASE("macauprior/make_dense_prior", "Making MacauPrior with MatrixXd") {
 
     auto features_downcast2 = std::dynamic_pointer_cast<DenseDoubleFeatSideInfo>(prior2->Features); //for the purpose of the test
     REQUIRE( (*(features_downcast2->get_features()) - Ftrue2).norm() == Approx(0) );
-    Eigen::MatrixXd tmp2 = Eigen::MatrixXd::Zero(2, 2);
-    tmp2.triangularView<Eigen::Lower>()  = prior2->FtF_plus_beta;
-    tmp2.triangularView<Eigen::Lower>() -= Ftrue2.transpose() * Ftrue2;
+    Eigen::MatrixXd tmp2 = prior2->FtF_eigenvectors * prior2->FtF_eigenvalues.asDiagonal() * prior2->FtF_eigenvectors.transpose();
+    tmp2 -= Ftrue2.transpose() * Ftrue2;
     REQUIRE( tmp2.norm() == Approx(0) );
+
+    // any diagonal shift is solved with the same eigendecomposition
+    for (double shift : { 0.5, 10.0 }) {
+       Eigen::MatrixXd FtF_shift = Ftrue2.transpose() * Ftrue2;
+       FtF_shift.diagonal().array() += shift;
+       Eigen::VectorXd inv_shift = (prior2->FtF_eigenvalues.array() + shift).inverse();
+       Eigen::MatrixXd inv = prior2->FtF_eigenvectors * inv_shift.asDiagonal() * prior2->FtF_eigenvectors.transpose();
+       REQUIRE( (inv * FtF_shift - Eigen::MatrixXd::Identity(2, 2)).norm() == Approx(0) );
+    }
 }
 
 TEST_CASE("inv_norm_cdf/inv_norm_cdf", "Inverse normal CDF") {
@@ -91,6 +91,119 @@ def write_sparse_float64_matrix_as_tensor(filename, Y):
         (Y.col + 1).astype(np.uint32, copy=False).tofile(f)
         Y.data.astype(np.float64, copy=False).tofile(f)
 
+# chunked sparse tensor (.sct), see SmurffCpp/IO/ChunkedTensor.h
+SCT_MAGIC = b"SMURFSCT"
+SCT_VERSION = 1
+SCT_FLAG_BINARY = 1
+SCT_RAW = 0
+SCT_DELTA_VARINT = 1
+
+def _encode_delta_varint(col):
+    d = np.diff(col.astype(np.int64), prepend=0)
+    z = ((d << 1) ^ (d >> 63)).view(np.uint64)
+    nbytes = np.ones(len(z), dtype=np.int64)
+    t = z >> np.uint64(7)
+    while t.any():
+        nbytes += t > 0
+        t >>= np.uint64(7)
+    pos = np.cumsum(nbytes) - nbytes
+    out = np.empty(nbytes.sum(), dtype=np.uint8)
+    for k in range(nbytes.max() if len(z) else 0):
+        sel = nbytes > k
+        more = (nbytes[sel] > k + 1).astype(np.uint8) << 7
+        out[pos[sel] + k] = ((z[sel] >> np.uint64(7 * k)) & np.uint64(0x7f)).astype(np.uint8) | more
+    return out.tobytes()
+
+def _decode_delta_varint(data, n):
+    b = np.frombuffer(data, dtype=np.uint8)
+    last = (b & 0x80) == 0
+    assert(last.sum() == n and (len(b) == 0 or last[-1]))
+    idx = np.cumsum(last) - last
+    start = np.flatnonzero(np.concatenate(([True], last[:-1])))
+    shift = (np.arange(len(b)) - start[idx]) * 7
+    z = np.zeros(n, dtype=np.uint64)
+    np.add.at(z, idx, (b & 0x7f).astype(np.uint64) << shift.astype(np.uint64))
+    d = (z >> np.uint64(1)).view(np.int64) ^ -(z & np.uint64(1)).view(np.int64)
+    return np.cumsum(d).astype(np.uint32)
+
+def write_sparse_chunked_tensor(filename, Y, shape = None, chunk_size = 1 << 20, delta = True):
+    # Y is a scipy sparse matrix or a tuple (coords, values) with coords
+    # [nmodes x nnz] 0-based coordinates and values None for a binary tensor
+    if scipy.sparse.issparse(Y):
+        Y = Y.tocoo(copy = False)
+        coords, values, shape = np.vstack((Y.row, Y.col)), Y.data, Y.shape
+    else:
+        coords, values = Y
+        coords = np.asarray(coords)
+
+    nmodes, nnz = coords.shape
+    nchunks = (nnz + chunk_size - 1) // chunk_size
+    binary = values is None
+
+    with open(filename, 'wb') as f:
+        f.write(SCT_MAGIC)
+        header = [SCT_VERSION, SCT_FLAG_BINARY if binary else 0, nmodes] + list(shape) + [nnz, chunk_size, nchunks]
+        np.array(header, dtype='<u8').tofile(f)
+
+        index = []
+        for begin in range(0, nnz, chunk_size):
+            index.append(f.tell())
+            end = min(begin + chunk_size, nnz)
+            for m in range(nmodes):
+                col = coords[m, begin:end].astype('<u4')
+                encoding, data = SCT_RAW, col.tobytes()
+                if delta:
+                    encoded = _encode_delta_varint(col)
+                    if len(encoded) < len(data):
+                        encoding, data = SCT_DELTA_VARINT, encoded
+                np.array([encoding, len(data)], dtype='<u8').tofile(f)
+                f.write(data)
+                f.write(b"\0" * (-len(data) % 8))
+            if not binary:
+                np.asarray(values[begin:end]).astype('<f8').tofile(f)
+
+        index.append(f.tell())
+        np.array(index, dtype='<u8').tofile(f)
+
+def read_sparse_chunked_tensor(filename):
+    # returns (coords, values, shape), values is None for a binary tensor
+    with open(filename, 'rb') as f:
+        data = f.read()
+
+    assert(data[:8] == SCT_MAGIC)
+    version, flags, nmodes = (int(v) for v in np.frombuffer(data, dtype='<u8', count=3, offset=8))
+    assert(version == SCT_VERSION)
+    shape = tuple(int(d) for d in np.frombuffer(data, dtype='<u8', count=nmodes, offset=32))
+    nnz, chunk_size, nchunks = (int(v) for v in np.frombuffer(data, dtype='<u8', count=3, offset=32 + 8 * nmodes))
+    binary = flags & SCT_FLAG_BINARY
+    index = np.frombuffer(data, dtype='<u8', count=nchunks + 1, offset=len(data) - 8 * (nchunks + 1))
+
+    coords = np.empty((nmodes, nnz), dtype=np.uint32)
+    values = None if binary else np.empty(nnz, dtype=np.float64)
+    for c in range(nchunks):
+        begin = c * chunk_size
+        n = min(chunk_size, nnz - begin)
+        pos = int(index[c])
+        for m in range(nmodes):
+            encoding, nbytes = (int(v) for v in np.frombuffer(data, dtype='<u8', count=2, offset=pos))
+            col = data[pos + 16 : pos + 16 + nbytes]
+            if encoding == SCT_RAW:
+                coords[m, begin:begin + n] = np.frombuffer(col, dtype='<u4', count=n)
+            else:
+                coords[m, begin:begin + n] = _decode_delta_varint(col, n)
+            pos += 16 + nbytes + (-nbytes % 8)
+        if not binary:
+            values[begin:begin + n] = np.frombuffer(data, dtype='<f8', count=n, offset=pos)
+
+    return coords, values, shape
+
+def read_sparse_chunked_tensor_as_matrix(filename):
+    coords, values, shape = read_sparse_chunked_tensor(filename)
+    assert(len(shape) == 2)
+    if values is None:
+        values = np.ones(coords.shape[1])
+    return scipy.sparse.coo_matrix((values, (coords[0], coords[1])), shape=shape)
+
 def my_mmwrite(filename, Y):
     with open(filename, 'wb') as f:
         sio.mmwrite(f, Y, symmetry='general')
@@ -118,6 +231,7 @@ ext_map = {
         ".sdm": ( read_sparse_float64,       write_sparse_float64 ),
         ".ddm": ( read_dense_float64,        write_dense_float64 ),
         ".csv": ( read_csv,                  write_csv ),
+        ".sct": ( read_sparse_chunked_tensor_as_matrix, write_sparse_chunked_tensor ),
 }
 
 def read_matrix(filename, **kwargs):
@@ -109,6 +109,34 @@ class TestMatrixIO(unittest.TestCase):
         actual_matrix = matrix_io.read_matrix(matrix_relative_path)
         self.assertTrue((expected_sparse_matrix != actual_matrix).nnz == 0)
 
+    def test_matrix_sct(self):
+        matrix_filename = "test_matrix_sct.sct"
+        matrix_relative_path = "{}/{}".format(self.TEMP_DIR_NAME, matrix_filename)
+        expected_matrix = scipy.sparse.rand(10, 20, 0.5)
+        matrix_io.write_matrix(matrix_relative_path, expected_matrix)
+        actual_matrix = matrix_io.read_matrix(matrix_relative_path)
+        self.assertTrue((expected_matrix != actual_matrix).nnz == 0)
+
+    def test_sparse_chunked_tensor(self):
+        tensor_filename = "test_sparse_chunked_tensor.sct"
+        tensor_relative_path = "{}/{}".format(self.TEMP_DIR_NAME, tensor_filename)
+        shape = (5, 300, 100000)
+        nnz = 1000
+        expected_coords = numpy.vstack([numpy.random.randint(0, d, size=nnz) for d in shape])
+        expected_coords[2].sort()
+        expected_values = numpy.random.randn(nnz)
+        for chunk_size in [1, 7, 1000, 2000]:
+            for delta in [False, True]:
+                for values in [expected_values, None]:
+                    matrix_io.write_sparse_chunked_tensor(tensor_relative_path, (expected_coords, values), shape, chunk_size, delta)
+                    actual_coords, actual_values, actual_shape = matrix_io.read_sparse_chunked_tensor(tensor_relative_path)
+                    self.assertEqual(actual_shape, shape)
+                    self.assertTrue(numpy.array_equal(actual_coords, expected_coords))
+                    if values is None:
+                        self.assertIsNone(actual_values)
+                    else:
+                        self.assertTrue(numpy.array_equal(actual_values, values))
+
     def test_dense_matrix_mtx(self):
         matrix_filename = "test_dense_matrix_mtx.mtx"
         matrix_relative_path = "{}/{}".format(self.TEMP_DIR_NAME, matrix_filename)
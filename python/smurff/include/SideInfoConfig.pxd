@@ -1,5 +1,6 @@
 from libcpp cimport bool
 from libcpp.memory cimport shared_ptr
+from libcpp.string cimport string
 
 from MatrixConfig cimport MatrixConfig
 
@@ -9,3 +10,7 @@ cdef extern from "<SmurffCpp/Configs/SideInfoConfig.h>" namespace "smurff":
         void setSideInfo(shared_ptr[MatrixConfig] value)
         void setTol(double value)
         void setDirect(bool value)
+        void setMaxIter(int value)
+        void setWarmStart(bool value)
+        void setPreconditioner(string value)
+        void setParallelBlocks(bool value)
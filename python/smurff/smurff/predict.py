@@ -146,9 +146,91 @@ class PredictSession:
         assert nmodes == 2
         self.nmodes = nmodes
         self.samples = []
+        self.stacked = None
 
     def add_sample(self, sample):
         self.samples.append(sample)
+        self.stacked = None
+
+    def stacked_latents(self):
+        """Latent matrices of all samples, stacked per mode
+
+        Returns
+        -------
+        list
+            One :class:`numpy.ndarray` of shape `[ T x N x K ]` per mode,
+            where T is the dimension of the mode, N the number of samples
+            and K the number of latents: the latents of one entity in all
+            samples are contiguous.
+
+        """
+        if self.stacked is None:
+            self.stacked = [ np.ascontiguousarray(np.stack([ s.latents[m] for s in self.samples ]).transpose(2, 0, 1))
+                             for m in range(self.nmodes) ]
+
+        return self.stacked
+
+    def predict_coords(self, coords):
+        """Computes the predictions of all samples for many points at once
+
+        Parameters
+        ----------
+        coords : array_like
+            Integer array of shape `[ nmodes x P ]` with the coordinates of P points
+
+        Returns
+        -------
+        numpy.ndarray
+            A :class:`numpy.ndarray` of shape `[ P x N ]` where N is the
+            number of samples in this `PredictSession`.
+
+        """
+        coords = np.asarray(coords, dtype=np.int64)
+        assert coords.shape[0] == self.nmodes
+
+        stacked = self.stacked_latents()
+        nsamples, nlatent = stacked[0].shape[1:]
+        preds = np.empty((coords.shape[1], nsamples))
+
+        # points sorted by row, in blocks of about 8 MB of latents per mode
+        order = np.argsort(coords[0], kind="stable")
+        block = max(1, (1 << 20) // (nsamples * nlatent))
+        for start in range(0, len(order), block):
+            idx = order[start:start + block]
+            P = stacked[0][coords[0, idx]]
+            for m in range(1, self.nmodes):
+                P = P * stacked[m][coords[m, idx]]
+            preds[idx] = P.sum(axis=2)
+
+        return preds
+
+    def predict_stats(self, coords, quantiles=None):
+        """Computes mean, variance and quantiles of the predictions of all samples for many points
+
+        Parameters
+        ----------
+        coords : array_like
+            Integer array of shape `[ nmodes x P ]` with the coordinates of P points
+        quantiles : array_like, optional
+            Probabilities in [0, 1] of the quantiles to compute
+
+        Returns
+        -------
+        tuple
+            Mean and variance, arrays of shape `[ P ]`, and if `quantiles`
+            is given, the quantiles, an array of shape `[ P x Q ]`. The
+            variance is the sum of squared deviations from the mean, as
+            :attr:`Prediction.var`.
+
+        """
+        preds = self.predict_coords(coords)
+        mean = preds.mean(axis=1)
+        var = np.square(preds - mean[:, None]).sum(axis=1)
+
+        if quantiles is None:
+            return mean, var
+
+        return mean, var, np.quantile(preds, quantiles, axis=1).T
 
     def num_latent(self):
         return self.samples[0].num_latent()
@@ -190,10 +272,12 @@ class PredictSession:
 
         """        
         predictions = Prediction.fromTestMatrix(test_matrix)
+        if not predictions:
+            return predictions
 
-        for s in self.samples:
-            for p in predictions:
-                p.add_sample(s.predict(p.coords))
+        preds = self.predict_coords(np.array([ p.coords for p in predictions ]).T)
+        for p, pred_all in zip(predictions, preds):
+            p.add_samples(pred_all)
 
         return predictions
 
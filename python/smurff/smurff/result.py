@@ -1,3 +1,4 @@
+import numpy as np
 from scipy import sparse
 import math
 from sklearn.metrics import mean_squared_error
@@ -67,6 +68,19 @@ class Prediction:
     def add_sample(self, pred):
         self.average(pred)
         self.pred_all.append(pred)
+
+    def add_samples(self, preds):
+        """Adds the predictions of all samples at once, in order"""
+        if self.nsamples < 0:
+            n = len(preds)
+            self.nsamples = n - 1
+            self.pred_avg = float(np.mean(preds))
+            self.var = float(np.square(preds - self.pred_avg).sum())
+            self.pred_1sample = float(preds[-1])
+            self.pred_all = list(preds)
+        else:
+            for pred in preds:
+                self.add_sample(pred)
             
     def __str__(self):
         return "%s: %.2f | 1sample: %.2f | avg: %.2f | var: %.2f | all: %s " % (self.coords, self.val, self.pred_1sample, self.pred_avg, self.var, self.pred_all)
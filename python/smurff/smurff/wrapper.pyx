@@ -100,7 +100,7 @@ cdef MatrixConfig* prepare_dense_matrix(X, NoiseConfig noise_config) except +:
     cdef MatrixConfig* matrix_config_ptr = new MatrixConfig(<uint64_t>(X.shape[0]), <uint64_t>(X.shape[1]), vals_vector_shared_ptr, noise_config)
     return matrix_config_ptr
 
-cdef shared_ptr[SideInfoConfig] prepare_sideinfo(side_info, NoiseConfig noise_config, tol, direct) except +:
+cdef shared_ptr[SideInfoConfig] prepare_sideinfo(side_info, NoiseConfig noise_config, tol, direct, max_iter, warm_start, preconditioner, parallel_blocks) except +:
     if isinstance(side_info, SPARSE_MATRIX_TYPES):
         side_info_config_matrix = prepare_sparse_matrix(side_info, noise_config, False)
     elif isinstance(side_info, DENSE_MATRIX_TYPES) and len(side_info.shape) == 2:
@@ -113,6 +113,10 @@ cdef shared_ptr[SideInfoConfig] prepare_sideinfo(side_info, NoiseConfig noise_co
     side_info_config_ptr.get().setSideInfo(shared_ptr[MatrixConfig](side_info_config_matrix))
     side_info_config_ptr.get().setTol(tol)
     side_info_config_ptr.get().setDirect(direct)
+    side_info_config_ptr.get().setMaxIter(max_iter)
+    side_info_config_ptr.get().setWarmStart(warm_start)
+    side_info_config_ptr.get().setPreconditioner(preconditioner.encode('UTF-8'))
+    side_info_config_ptr.get().setParallelBlocks(parallel_blocks)
     return side_info_config_ptr
 
 cdef TensorConfig* prepare_dense_tensor(tensor, NoiseConfig noise_config) except +:
@@ -374,7 +378,7 @@ cdef class TrainSession:
         if Ytest is not None:
             self.config.setTest(test)
 
-    def addSideInfo(self, mode, Y, noise = PyNoiseConfig(), tol = 1e-6, direct = False):
+    def addSideInfo(self, mode, Y, noise = PyNoiseConfig(), tol = 1e-6, direct = False, max_iter = 10, warm_start = False, preconditioner = "none", parallel_blocks = False):
         """Adds fully known side info, for use in with the macau or macauone prior
 
         mode : int
@@ -397,9 +401,22 @@ cdef class TrainSession:
         tol : float
             Tolerance for the CG solver.
 
+        max_iter : int
+            Maximum number of iterations of the CG solver.
+
+        warm_start : boolean
+            Start the CG solver from the previous sample of the link matrix instead of from zero.
+
+        preconditioner : str
+            Preconditioner for the CG solver: "none", "jacobi", "block-jacobi" or "ichol"
+
+        parallel_blocks : boolean
+            Solve the blocks of 32 latent dimensions in parallel, one per thread.
+            Faster when there are at least as many blocks as threads.
+
         """
         self.noise_config = prepare_noise_config(noise)
-        self.config.addSideInfoConfig(mode, prepare_sideinfo(Y, self.noise_config, tol, direct))
+        self.config.addSideInfoConfig(mode, prepare_sideinfo(Y, self.noise_config, tol, direct, max_iter, warm_start, preconditioner, parallel_blocks))
 
     def addData(self, pos, Y, is_scarce = False, noise = PyNoiseConfig()):
         """Stacks more matrices/tensors next to the main train matrix.
@@ -57,6 +57,15 @@ class TestPredictSession(unittest.TestCase):
             for p in zip(s.pred_all, p4[ecoords]):
                 self.assertAlmostEqual(*p, places=2)
 
+        # check predict_session.predict_some vs predict_session.predict_stats
+        coords = np.array([ s.coords for s in p2 ]).T
+        mean, var, quantiles = predict_session.predict_stats(coords, [0.0, 1.0])
+        for s, m, v, q in zip(p2, mean, var, quantiles):
+            self.assertAlmostEqual(s.pred_avg, m, places=2)
+            self.assertAlmostEqual(s.var, v, places=2)
+            self.assertAlmostEqual(min(s.pred_all), q[0], places=2)
+            self.assertAlmostEqual(max(s.pred_all), q[1], places=2)
+
         p1_rmse_avg = smurff.calc_rmse(p1)
         p2_rmse_avg = smurff.calc_rmse(p2)
 